@@ -1,54 +1,54 @@
-#pragma once
-
-char flower_pot[]={"\n\
-    WWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWW\n\r\
-    WWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWW\n\r\
-    WWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWW\n\r\
-    WWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWW\n\r\
-    WWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWW\n\r\
-    WWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWXNWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWW\n\r\
-    WWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWOONWWNXWWWWWWWWWWNKNWWWWWWWWWNWXXWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWW\n\r\
-    WWWWWWWWWWWWWWWWWNWWNXXNWWWWWWWWWWWW0d0WW0kNWWWWWWWWWOkNWWWWWWWWKKXO0WWWWWWWWWWWWWWWWWWWWWWWWWWWWWWW\n\r\
-    WWWWWWWWWWWWWWWWWWWWWXkONWWWWWWWWWWWXooXWkoKWWWWWWWX0odNWWWWWWWKxOkdXWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWW\n\r\
-    WWWWWWWWWWWWWWWWWWWWWWKodXWWWWWWWWWWWk:dNk:kWWWWWNNkl:oNWWWWWWKodxlkWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWW\n\r\
-    WWWWWWWWWWWWWWWWWWWNWWW0cl0NWWWWWWWWW0c:xx:lOKWWWKko:,cKWWWWWKl:o:lXWWWWWWWWNXNWWWWWWWWWWWWWWWWWWWWW\n\r\
-    WWWWWWWWWWWWWWWWWWWNWWNW0c:xXWWWWWWWWXo.:c,.:kNWNk:::,:0WWWN0l:c::OWWWWWNWW0k0NWWWWWWWWWWWWWWWWWWWWW\n\r\
-    WWWWWWWWWWWWWWWWWWWWWWN000l,cONWWWWWWNd,.:,..dXX0l,::.:OWWNkc:::,dNWWWWWN0ol0WWWWWWWWWWWWWWWWWWWWWWW\n\r\
-    WWWWWWWWWWWWWWWWWWWNWWWKodOo,,o0XXNWWNk:.,:..cOkoc::,.,xNXx::::.cKWWWWN0o:lKWWWWWWNNWWWWWWWWWWWWWWWW\n\r\
-    WWWWWWWWWWWWWWWWWWWWWWWWKlcxd:.:clkXWWO:..:...:::cc:...oOo::::.:OWWWN0l,:xNWWWWWN0OXWWWWWWWWWWWWWWWW\n\r\
-    WWWWWWWWWWWWWWWWWWNWWWWWWXo:cl:...,l0N0c..:,...,:::,...::,::,.,xNWN0l..c0WWWWN0xdkXWWWWWWWWWWWWWWWWW\n\r\
-    WWWWWWWWWWWWWWWWWWWWWWWWWWXd,.::,.,,,o0d..,,...:::,....,,,:,..lXWKo,.,dXWNX0xllxXWWWWWWWWWWWWWWWWWWW\n\r\
-    WWWWWWWWWWWWWWWWWWWWWWWNWWNOo:..::::..:c,..:..:::.......,,...:OXd:..:kX0ko::ckXWWWWWWWWWWWWWWWWWWWWW\n\r\
-    WWWWWWWWWWWWWWWWWWWWWWWNWWNKdc:..,:c:......,.:::.............ld:,:,:dxl:,:oONWWWWWWWWWWWWWWWWWWWWWWW\n\r\
-    WWWWWWWWWWWWWWWWWNNNNWWWNNWWKd::..,::,......,::..............:,,::,::,,:o0NWWWWWWWWWWWWWWWWWWWWWWWWW\n\r\
-    WWWWWWWWWWWWWWWWWNXK0OkO0XNNWNOo:,..::.......,...............,,,:....,:xXWWWWWWWWWWWWWWWWWWWWWWWWWWW\n\r\
-    WWWWWWWWWWWWWWWWWWWWNKOdlccldxxOkl:..,:.......................,,...,cxKWWWWWWWNK00KNWWWWWWWWWWWWWWWW\n\r\
-    WWWWWWWWWWWWWWWWWWNWWNWNN0xl:..,::,,..............................ckXNNXK0kdodxkOKNWWWWWWWWWWWWWWWWW\n\r\
-    WWWWWWWWWWWWWWWWWWNNNNWWWWWNKko:.................................:dxoc::.,cokKWWWWWWWWWWWWWWWWWWWWWW\n\r\
-    WWWWWWWWWWWWWWWNNXXXNNNWWWWWWWWO:.....................................:ox0NWWWWWWWWWWWWWWWWWWWWWWWWW\n\r\
-    WWWWWWWWWWWWWWWNX0kdlccloddddxkOl............::...................,cdOXNNWWWWWWWWWWWWWWWWWWWWWWWWWWW\n\r\
-    WWWWWWWWWWWWWWWWWWNNKkdl:,.....::..,........:olc:::,,,,,:::c:,:::okxddolodOXWWWWWWWWWWWWWWWWWWWWWWWW\n\r\
-    WWWWWWWWWWWWWWWWWNNNNWWNNKd::::::::::cccllooddddxxxxkkkkkkkOOOOkkkkkkkkxxOXWWWWWWWWWWWWWWWWWWWWWWWWW\n\r\
-    WWWWWWWWWWWWWWWWWWWWWWWWWNOc::::::::::ccllooodddxxxxxkkkkkkkkkkkkkkkkkkkk0NWWWWWWWWWWWWWWWWWWWWWWWWW\n\r\
-    WWWWWWWWWWWWWWWWWWWWWWWWWWOc:::::::::cccllooodddxxxxxkkkkkkkkkkkkkkkkkkkk0NWWWWWWWWWWWWWWWWWWWWWWWWW\n\r\
-    WWWWWWWWWWWWWWWWWWWWWWWWWW0l:::::::::cccllooodddxxxxxkkkkkkkkkkkkkkkkkkkk0NWWWWWWWWWWWWWWWWWWWWWWWWW\n\r\
-    WWWWWWWWWWWWWWWWWWWWWWWWNWKl:::::::::cclllooodddxxxxxxkkkkkkkkOOOOkkkkkkk0NWWWWWWWWWWWWWWWWWWWWWWWWW\n\r\
-    WWWWWWWWWWWWWWWWWWWWWWWWWWKo:::::::::cclloooddddddodxxkkkkkkkOOOOOkkkkkkk0NWWWWWWWWWWWWWWWWWWWWWWWWW\n\r\
-    WWWWWWWWWWWWWWWWWWWWWWWWWWKo:::::::::cclloooddddoooodxkkkkkkkOOOOOOkkkkkk0NWWWWWWWWWWWWWWWWWWWWWWWWW\n\r\
-    WWWWWWWWWWWWWWWWWWWWWWWWWWXo::::::::ccclloooddddoddddxkkkkkkkOOOOOOOkkkkk0WWWWWWWWWWWWWWWWWWWWWWWWWW\n\r\
-    WWWWWWWWWWWWWWWWWWWWWWWWWWXd::::::::cclloooodddxdddxxkkkkkkkkOOOOOOOOkkkkKWWWWWWWWWWWWWWWWWWWWWWWWWW\n\r\
-    WWWWWWWWWWWWWWWWWWWWWWWWWWXx:c::::::ccllooooddddddddxxkkkkkkkOOOOOOOOOOOOKWWWWWWWWWWWWWWWWWWWWWWWWWW\n\r\
-    NNNWWWWWWWWWWWWWWWWWWWWWWWNxc::::::ccclloooooooodxxxdxxxkkkkOOOOOOOOOOOOOKWWWWWWWWWWWWWWWWWWWWWWWWWW\n\r\
-    NNNNNNNNNNNWWWWWWWWWWWWWWWNxc:c::::cccllloooooddddxxxxxxkkkkkkOOOOOOOOOOOKWWWWWWWWWWWWWWWWWWWWWWWWWW\n\r\
-    NNNNNNNNNNNWWWWWWWWWWWWWWWNxccccc:ccclllloooooooodddxddxxxkkOOOOOOOOOOOOOKWWWWWWWWWWWWWWWWWWWWWWWWWW\n\r\
-    NNNNNNNNNNNNNNWWNWWWWWWWWWNkccccccccclllooddooddddddxxxxkkkkOOOOOOOOOOOOOXWWWWWWWWWWWWWWWWWWWWWWWWWW\n\r\
-    NNNNNNNNNNNNNNNNNNWWWWWWWWNkccccccccclllooodddxdddddxxkkkkkkOOOOOOOOOOOOOXWWWWWWWWWWWWWWWWWWWWWWWWWW\n\r\
-    NNNNNNNNNNNNNNNNNNNWWWWWWWNkccccccccclloooodddddddddxxkkkkkkOOOOOOOOOOOOOXWWWWWWWWWWWWWWWWWWWWWWWWWW\n\r\
-    XXXXXXXXXXXXXXXXNNNNNNNNNNNkcccccccclllooooddddxxxxxkkkkkkkkOOOOOOOOOOOOOXWWWWWWWWWWWWWWWWWWWWWWWWWW\n\r\
-    KKKKKKKXXXXXXXXXXXXXXXXXXXXkcccccccllllooooddddxxxxxxkkkkkkkOOOOOOOOOOOO0XWWWWWWWWWWWWWWWWWWWWWWWWWW\n\r\
-    NXXXXXXXXXXXXXXXXXXXXXXXXXXOlcclclllllooooddddxxxxxxkkkkkkkOOOOOOOOOOOOOKNMWWWWWWWWWWWWWWWWWWWWWWWWW\n\r\
-    WWWWWWWWWWWWWWNNNNNNNNNNNNNX0Oxl:::::::::::::::::cccccccccccccclllllokKXNWMMMMMMWMMMMMMMMMMMMMMMMMMM\n\r\
-    WWWWWWWWWWWWWWWWWWWWWWWWMMWWNNXXXK000OOOkkkkkkkxxkkkkkkkkkkkOOOO00KKXNNWWWMMMMMMMMMMMMMMMMMMMMMMMMMM\n\r\
-    WWWWWWWWWWWWWWWWWWWWWWWWMMWWWNWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWMMMMMMMMMMMMMMMMMMMMMMMMMM\n\r\
-    WWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWMMMMMMMMMMMMMMMMMMMMMMMMMM\n\r"
+#pragma once
+
+char flower_pot[]={"\n\
+    WWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWW\n\r\
+    WWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWW\n\r\
+    WWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWW\n\r\
+    WWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWW\n\r\
+    WWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWW\n\r\
+    WWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWXNWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWW\n\r\
+    WWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWOONWWNXWWWWWWWWWWNKNWWWWWWWWWNWXXWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWW\n\r\
+    WWWWWWWWWWWWWWWWWNWWNXXNWWWWWWWWWWWW0d0WW0kNWWWWWWWWWOkNWWWWWWWWKKXO0WWWWWWWWWWWWWWWWWWWWWWWWWWWWWWW\n\r\
+    WWWWWWWWWWWWWWWWWWWWWXkONWWWWWWWWWWWXooXWkoKWWWWWWWX0odNWWWWWWWKxOkdXWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWW\n\r\
+    WWWWWWWWWWWWWWWWWWWWWWKodXWWWWWWWWWWWk:dNk:kWWWWWNNkl:oNWWWWWWKodxlkWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWW\n\r\
+    WWWWWWWWWWWWWWWWWWWNWWW0cl0NWWWWWWWWW0c:xx:lOKWWWKko:,cKWWWWWKl:o:lXWWWWWWWWNXNWWWWWWWWWWWWWWWWWWWWW\n\r\
+    WWWWWWWWWWWWWWWWWWWNWWNW0c:xXWWWWWWWWXo.:c,.:kNWNk:::,:0WWWN0l:c::OWWWWWNWW0k0NWWWWWWWWWWWWWWWWWWWWW\n\r\
+    WWWWWWWWWWWWWWWWWWWWWWN000l,cONWWWWWWNd,.:,..dXX0l,::.:OWWNkc:::,dNWWWWWN0ol0WWWWWWWWWWWWWWWWWWWWWWW\n\r\
+    WWWWWWWWWWWWWWWWWWWNWWWKodOo,,o0XXNWWNk:.,:..cOkoc::,.,xNXx::::.cKWWWWN0o:lKWWWWWWNNWWWWWWWWWWWWWWWW\n\r\
+    WWWWWWWWWWWWWWWWWWWWWWWWKlcxd:.:clkXWWO:..:...:::cc:...oOo::::.:OWWWN0l,:xNWWWWWN0OXWWWWWWWWWWWWWWWW\n\r\
+    WWWWWWWWWWWWWWWWWWNWWWWWWXo:cl:...,l0N0c..:,...,:::,...::,::,.,xNWN0l..c0WWWWN0xdkXWWWWWWWWWWWWWWWWW\n\r\
+    WWWWWWWWWWWWWWWWWWWWWWWWWWXd,.::,.,,,o0d..,,...:::,....,,,:,..lXWKo,.,dXWNX0xllxXWWWWWWWWWWWWWWWWWWW\n\r\
+    WWWWWWWWWWWWWWWWWWWWWWWNWWNOo:..::::..:c,..:..:::.......,,...:OXd:..:kX0ko::ckXWWWWWWWWWWWWWWWWWWWWW\n\r\
+    WWWWWWWWWWWWWWWWWWWWWWWNWWNKdc:..,:c:......,.:::.............ld:,:,:dxl:,:oONWWWWWWWWWWWWWWWWWWWWWWW\n\r\
+    WWWWWWWWWWWWWWWWWNNNNWWWNNWWKd::..,::,......,::..............:,,::,::,,:o0NWWWWWWWWWWWWWWWWWWWWWWWWW\n\r\
+    WWWWWWWWWWWWWWWWWNXK0OkO0XNNWNOo:,..::.......,...............,,,:....,:xXWWWWWWWWWWWWWWWWWWWWWWWWWWW\n\r\
+    WWWWWWWWWWWWWWWWWWWWNKOdlccldxxOkl:..,:.......................,,...,cxKWWWWWWWNK00KNWWWWWWWWWWWWWWWW\n\r\
+    WWWWWWWWWWWWWWWWWWNWWNWNN0xl:..,::,,..............................ckXNNXK0kdodxkOKNWWWWWWWWWWWWWWWWW\n\r\
+    WWWWWWWWWWWWWWWWWWNNNNWWWWWNKko:.................................:dxoc::.,cokKWWWWWWWWWWWWWWWWWWWWWW\n\r\
+    WWWWWWWWWWWWWWWNNXXXNNNWWWWWWWWO:.....................................:ox0NWWWWWWWWWWWWWWWWWWWWWWWWW\n\r\
+    WWWWWWWWWWWWWWWNX0kdlccloddddxkOl............::...................,cdOXNNWWWWWWWWWWWWWWWWWWWWWWWWWWW\n\r\
+    WWWWWWWWWWWWWWWWWWNNKkdl:,.....::..,........:olc:::,,,,,:::c:,:::okxddolodOXWWWWWWWWWWWWWWWWWWWWWWWW\n\r\
+    WWWWWWWWWWWWWWWWWNNNNWWNNKd::::::::::cccllooddddxxxxkkkkkkkOOOOkkkkkkkkxxOXWWWWWWWWWWWWWWWWWWWWWWWWW\n\r\
+    WWWWWWWWWWWWWWWWWWWWWWWWWNOc::::::::::ccllooodddxxxxxkkkkkkkkkkkkkkkkkkkk0NWWWWWWWWWWWWWWWWWWWWWWWWW\n\r\
+    WWWWWWWWWWWWWWWWWWWWWWWWWWOc:::::::::cccllooodddxxxxxkkkkkkkkkkkkkkkkkkkk0NWWWWWWWWWWWWWWWWWWWWWWWWW\n\r\
+    WWWWWWWWWWWWWWWWWWWWWWWWWW0l:::::::::cccllooodddxxxxxkkkkkkkkkkkkkkkkkkkk0NWWWWWWWWWWWWWWWWWWWWWWWWW\n\r\
+    WWWWWWWWWWWWWWWWWWWWWWWWNWKl:::::::::cclllooodddxxxxxxkkkkkkkkOOOOkkkkkkk0NWWWWWWWWWWWWWWWWWWWWWWWWW\n\r\
+    WWWWWWWWWWWWWWWWWWWWWWWWWWKo:::::::::cclloooddddddodxxkkkkkkkOOOOOkkkkkkk0NWWWWWWWWWWWWWWWWWWWWWWWWW\n\r\
+    WWWWWWWWWWWWWWWWWWWWWWWWWWKo:::::::::cclloooddddoooodxkkkkkkkOOOOOOkkkkkk0NWWWWWWWWWWWWWWWWWWWWWWWWW\n\r\
+    WWWWWWWWWWWWWWWWWWWWWWWWWWXo::::::::ccclloooddddoddddxkkkkkkkOOOOOOOkkkkk0WWWWWWWWWWWWWWWWWWWWWWWWWW\n\r\
+    WWWWWWWWWWWWWWWWWWWWWWWWWWXd::::::::cclloooodddxdddxxkkkkkkkkOOOOOOOOkkkkKWWWWWWWWWWWWWWWWWWWWWWWWWW\n\r\
+    WWWWWWWWWWWWWWWWWWWWWWWWWWXx:c::::::ccllooooddddddddxxkkkkkkkOOOOOOOOOOOOKWWWWWWWWWWWWWWWWWWWWWWWWWW\n\r\
+    NNNWWWWWWWWWWWWWWWWWWWWWWWNxc::::::ccclloooooooodxxxdxxxkkkkOOOOOOOOOOOOOKWWWWWWWWWWWWWWWWWWWWWWWWWW\n\r\
+    NNNNNNNNNNNWWWWWWWWWWWWWWWNxc:c::::cccllloooooddddxxxxxxkkkkkkOOOOOOOOOOOKWWWWWWWWWWWWWWWWWWWWWWWWWW\n\r\
+    NNNNNNNNNNNWWWWWWWWWWWWWWWNxccccc:ccclllloooooooodddxddxxxkkOOOOOOOOOOOOOKWWWWWWWWWWWWWWWWWWWWWWWWWW\n\r\
+    NNNNNNNNNNNNNNWWNWWWWWWWWWNkccccccccclllooddooddddddxxxxkkkkOOOOOOOOOOOOOXWWWWWWWWWWWWWWWWWWWWWWWWWW\n\r\
+    NNNNNNNNNNNNNNNNNNWWWWWWWWNkccccccccclllooodddxdddddxxkkkkkkOOOOOOOOOOOOOXWWWWWWWWWWWWWWWWWWWWWWWWWW\n\r\
+    NNNNNNNNNNNNNNNNNNNWWWWWWWNkccccccccclloooodddddddddxxkkkkkkOOOOOOOOOOOOOXWWWWWWWWWWWWWWWWWWWWWWWWWW\n\r\
+    XXXXXXXXXXXXXXXXNNNNNNNNNNNkcccccccclllooooddddxxxxxkkkkkkkkOOOOOOOOOOOOOXWWWWWWWWWWWWWWWWWWWWWWWWWW\n\r\
+    KKKKKKKXXXXXXXXXXXXXXXXXXXXkcccccccllllooooddddxxxxxxkkkkkkkOOOOOOOOOOOO0XWWWWWWWWWWWWWWWWWWWWWWWWWW\n\r\
+    NXXXXXXXXXXXXXXXXXXXXXXXXXXOlcclclllllooooddddxxxxxxkkkkkkkOOOOOOOOOOOOOKNMWWWWWWWWWWWWWWWWWWWWWWWWW\n\r\
+    WWWWWWWWWWWWWWNNNNNNNNNNNNNX0Oxl:::::::::::::::::cccccccccccccclllllokKXNWMMMMMMWMMMMMMMMMMMMMMMMMMM\n\r\
+    WWWWWWWWWWWWWWWWWWWWWWWWMMWWNNXXXK000OOOkkkkkkkxxkkkkkkkkkkkOOOO00KKXNNWWWMMMMMMMMMMMMMMMMMMMMMMMMMM\n\r\
+    WWWWWWWWWWWWWWWWWWWWWWWWMMWWWNWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWMMMMMMMMMMMMMMMMMMMMMMMMMM\n\r\
+    WWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWMMMMMMMMMMMMMMMMMMMMMMMMMM\n\r"
 };
\ No newline at end of file
@@ -1,890 +1,3022 @@
-#include <stdio.h>
-#include <string.h>
-#include <ctype.h>
-#include <unistd.h>
-#include <inttypes.h>
-#include "esp_log.h"
-#include "esp_console.h"
-#include "esp_chip_info.h"
-#include "esp_sleep.h"
-#include "esp_flash.h"
-#include "driver/rtc_io.h"
-#include "driver/uart.h"
-#include "argtable3/argtable3.h"
-#include "freertos/FreeRTOS.h"
-#include "freertos/task.h"
-#include "cmd.h"
-#include "sdkconfig.h"
-#include "../outputs/cooling_pump_control.h"
-#include "../outputs/watering_pump_control.h"
-#include "../outputs/cooling_ventilator_control.h"
-#include "../outputs/dehumyfing_ventilator_control.h"
-#include "../outputs/peltier_power_control.h"
-#include "../inputs/humidity_sensor.h"
-#include "../inputs/temperature_sensor.h"
-#include "../inputs/water_tank_meas.h"
-
-
-#define CMD_FUNC_RET_SUCCESS 0
-#define CMD_FUNC_RET_FAILURE 1
-
-static struct {
-    struct arg_dbl *speed;
-    struct arg_end *end;
-} cmd_cooling_pump_set_speed_args;
-
-static struct {
-    struct arg_dbl *speed;
-    struct arg_end *end;
-} cmd_watering_pump_set_speed_args;
-
-static struct {
-    struct arg_dbl *speed;
-    struct arg_end *end;
-} cmd_cooling_ventilator_set_speed_args;
-
-static struct {
-    struct arg_dbl *speed;
-    struct arg_end *end;
-} cmd_dehumyfing_ventilator_set_speed_args;
-
-static struct {
-    struct arg_dbl *level;
-    struct arg_end *end;
-} cmd_peltier_set_power_level_args;
-
-static struct {
-    struct arg_dbl *level;
-    struct arg_end *end;
-} cmd_water_tank_define_max_level_args;
-
-static struct {
-    struct arg_dbl *level;
-    struct arg_end *end;
-} cmd_water_tank_define_min_level_args;
-
-static struct {
-    struct arg_dbl *level;
-    struct arg_end *end;
-} cmd_water_tank_calibrate_max_args;
-
-static struct {
-    struct arg_dbl *level;
-    struct arg_end *end;
-} cmd_water_tank_calibrate_min_args;
-
-static const char *TAG = "cmd";
-
-/**
- * @brief Gets version of hardware used 
- * 
- * @return CMD_FUNC_RET_SUCCESS for success or CMD_FUNC_RET_FAILURE for failure
- */
-static int get_version(void);
-
-/**
- * @brief Restarts the system
- */
-static int restart(void);
-
-/**
- * @brief Gets speed of the cooling pump in %
- * 
- * @return CMD_FUNC_RET_SUCCESS for success
- */
-static int cmd_cooling_pump_get_speed(void);
-
-/**
- * @brief Sets speed of the cooling pump in %
- * 
- * @param argc arguments count
- * @param argv arguments value
- * @return CMD_FUNC_RET_SUCCESS for success or CMD_FUNC_RET_FAILURE for failure
- */
-static int cmd_cooling_pump_set_speed(int argc, char **argv);
-
-/**
- * @brief Sets speed of the watering pump in %
- * 
- * @return CMD_FUNC_RET_SUCCESS for success
- */
-static int cmd_watering_pump_get_speed(void);
-
-/**
- * @brief Sets speed of the watering pump in %
- * 
- * @param argc arguments count
- * @param argv arguments value
- * @return CMD_FUNC_RET_SUCCESS for success or CMD_FUNC_RET_FAILURE for failure
- */
-static int cmd_watering_pump_set_speed(int argc, char **argv);
-
-/**
- * @brief Gets speed of the cooling ventilator in %
- * 
- * @return CMD_FUNC_RET_SUCCESS for success
- */
-static int cmd_cooling_ventilator_get_speed(void);
-
-/**
- * @brief Sets speed of the cooling ventilator in %
- * 
- * @param argc arguments count
- * @param argv arguments value
- * @return CMD_FUNC_RET_SUCCESS for success or CMD_FUNC_RET_FAILURE for failure
- */
-static int cmd_cooling_ventilator_set_speed(int argc, char **argv);
-
-/**
- * @brief Gets speed of the dehumyfing ventilator in %
- * 
- * @return CMD_FUNC_RET_SUCCESS for success
- */
-static int cmd_dehumyfing_ventilator_get_speed(void);
-
-/**
- * @brief Sets speed of the dehumyfing ventilator in %
- * 
- * @param argc arguments count
- * @param argv arguments value
- * @return CMD_FUNC_RET_SUCCESS for success or CMD_FUNC_RET_FAILURE for failure
- */
-static int cmd_dehumyfing_ventilator_set_speed(int argc, char **argv);
-
-/**
- * @brief Reads humidity in %, temperature in Celsius deg and dew point in Celsius deg
- * 
- * @return CMD_FUNC_RET_SUCCESS for success or CMD_FUNC_RET_FAILURE for failure
- */
-static int cmd_humidity_sensor_read(void);
-
-/**
- * @brief Rescans sensors devices, reads temperature in C deg and F deg 
- * 
- * @return CMD_FUNC_RET_SUCCESS for success or CMD_FUNC_RET_FAILURE for failure
- */
-static int cmd_temperature_sensor_read(void);
-
-/**
- * @brief Gets power level of peltier in %
- * 
- * @return CMD_FUNC_RET_SUCCESS for success
- */
-static int cmd_peltier_get_power_level(void);
-
-/**
- * @brief Sets power level of peltier in %
- * 
- * @param argc arguments count
- * @param argv arguments value
- * @return CMD_FUNC_RET_SUCCESS for success or CMD_FUNC_RET_FAILURE for failure
- */
-static int cmd_peltier_set_power_level(int argc, char **argv);
-
-/**
- * @brief Gets water tank generator frequency and current water level
- * 
- * @return CMD_FUNC_RET_SUCCESS for success
- */
-static int cmd_water_tank_get_info(void);
-
-/**
- * @brief Set up max level of the tank in mililitres 
- * 
- * @param argc argument count 
- * @param argv argument value
- * @return CMD_FUNC_RET_SUCCESS for success or CMD_FUNC_RET_FAILURE for failure 
- */
-static int cmd_water_tank_define_max_level(int argc, char **argv);
-
-/**
- * @brief Set up min level of the tank in mililitres
- * 
- * @param argc argument count
- * @param argv argument value
- * @return CMD_FUNC_RET_SUCCESS for success or CMD_FUNC_RET_FAILURE for failure 
- */
-static int cmd_water_tank_define_min_level(int argc, char **argv);
-
-/**
- * @brief Set up curretnt water level as max value of water level
- * 
- * @return CMD_FUNC_RET_SUCCESS for success
- */
-static int cmd_water_tank_calibrate_max(void);
-
-/**
- * @brief Set up curretnt water level as min value of water level
- * 
- * @return CMD_FUNC_RET_SUCCESS for success
- */
-static int cmd_water_tank_calibrate_min(void);
-
-/*Functions used to register commands above to further use*/
-static void register_version(void);
-static void register_restart(void);
-static void register_cooling_pump_get_speed(void);
-static void register_cooling_pump_set_speed(void);
-static void register_watering_pump_get_speed(void);
-static void register_watering_pump_set_speed(void);
-static void register_cooling_ventilator_get_speed(void);
-static void register_cooling_ventilator_set_speed(void);
-static void register_dehumyfing_ventilator_get_speed(void);
-static void register_dehumyfing_ventilator_set_speed(void);
-static void register_humidity_sensor_read(void);
-static void register_temperature_sensor_read(void);
-static void register_peltier_get_power_level(void);
-static void register_peltier_set_power_level(void);
-static void register_water_tank_get_info(void);
-static void register_water_tank_define_max_level(void);
-static void register_water_tank_define_min_level(void);
-static void register_water_tank_calibrate_max(void);
-static void register_water_tank_calibrate_min(void);
-
-void register_cmd(void)
-{
-    register_version();
-    register_restart();
-    register_cooling_pump_get_speed();
-    register_cooling_pump_set_speed();
-    register_watering_pump_get_speed();
-    register_watering_pump_set_speed();
-    register_cooling_ventilator_get_speed();
-    register_cooling_ventilator_set_speed();
-    register_dehumyfing_ventilator_get_speed();
-    register_dehumyfing_ventilator_set_speed();
-    register_humidity_sensor_read();
-    register_temperature_sensor_read();
-    register_peltier_get_power_level();
-    register_peltier_set_power_level();
-    register_water_tank_get_info();
-    register_water_tank_define_max_level();
-    register_water_tank_define_min_level();
-    register_water_tank_calibrate_max();
-    register_water_tank_calibrate_min();
-}
-
-static int get_version(void)
-{
-    const char *model;
-    esp_chip_info_t info;
-    uint32_t flash_size;
-
-    esp_chip_info(&info);
-
-    switch(info.model) 
-    {
-        case CHIP_ESP32:
-            model = "ESP32";
-            break;
-        case CHIP_ESP32S2:
-            model = "ESP32-S2";
-            break;
-        case CHIP_ESP32S3:
-            model = "ESP32-S3";
-            break;
-        case CHIP_ESP32C3:
-            model = "ESP32-C3";
-            break;
-        case CHIP_ESP32H2:
-            model = "ESP32-H2";
-            break;
-        // case CHIP_ESP32C2:
-        //     model = "ESP32-C2"; left deliberately, this model does not work
-        //     break;
-        default:
-            model = "Unknown";
-            break;
-    }
-
-    if(esp_flash_get_size(NULL, &flash_size) != ESP_OK) 
-    {
-        printf("Get flash size failed");
-        return CMD_FUNC_RET_FAILURE;
-    }
-    printf("IDF Version:%s\r\n", esp_get_idf_version());
-    printf("Chip info:\r\n");
-    printf("\tmodel:%s\r\n", model);
-    printf("\tcores:%d\r\n", info.cores);
-    printf("\tfeature:%s%s%s%s%d%s\r\n",
-           info.features & CHIP_FEATURE_WIFI_BGN ? "/802.11bgn" : "",
-           info.features & CHIP_FEATURE_BLE ? "/BLE" : "",
-           info.features & CHIP_FEATURE_BT ? "/BT" : "",
-           info.features & CHIP_FEATURE_EMB_FLASH ? "/Embedded-Flash:" : "/External-Flash:",
-           flash_size / (1024 * 1024), " MB");
-    printf("\trevision number:%d\r\n", info.revision);
-    return CMD_FUNC_RET_SUCCESS;
-}
-
-static void register_version(void)
-{
-    const esp_console_cmd_t cmd = {
-        .command = "version",
-        .help = "Get version of chip and SDK",
-        .hint = NULL,
-        .func = &get_version,
-    };
-    ESP_ERROR_CHECK( esp_console_cmd_register(&cmd) );
-}
-
-static int restart(void)
-{
-    ESP_LOGI(TAG, "Restarting");
-    esp_restart();
-}
-
-static void register_restart(void)
-{
-    const esp_console_cmd_t cmd = {
-        .command = "restart",
-        .help = "Software reset of the chip",
-        .hint = NULL,
-        .func = &restart,
-    };
-    ESP_ERROR_CHECK( esp_console_cmd_register(&cmd) );
-}
-
-static int cmd_cooling_pump_get_speed(void)
-{
-    float speed = cooling_pump_get_speed();
-    printf("Cooling pump speed:%.2f\n", speed);
-    return CMD_FUNC_RET_SUCCESS;
-}
-
-static void register_cooling_pump_get_speed(void)
-{
-    const esp_console_cmd_t cmd = {
-        .command = "cooling_pump_get_speed",
-        .help = "Gets speed of cooling pump",
-        .hint = NULL,
-        .func = &cmd_cooling_pump_get_speed,
-    };
-    ESP_ERROR_CHECK( esp_console_cmd_register(&cmd) );
-}
-
-static int cmd_cooling_pump_set_speed(int argc, char **argv)
-{
-    esp_err_t ret = ESP_OK;
-    int nerrors = arg_parse(argc, argv, (void **) &cmd_cooling_pump_set_speed_args);
-
-    if (0u != nerrors) 
-    {
-        arg_print_errors(stderr, cmd_cooling_pump_set_speed_args.end, argv[0u]);
-        ESP_LOGE(TAG, "Cannot set speed of cooling pump");
-        return CMD_FUNC_RET_FAILURE;
-    }
-    if(0u != cmd_cooling_pump_set_speed_args.speed->count)
-    {
-        ret = cooling_pump_set_speed((float)(cmd_cooling_pump_set_speed_args.speed->dval[0u]));
-        if(ret != ESP_OK)
-        {
-            ESP_LOGE(TAG,"Failed to set cooling pump speed");
-            return CMD_FUNC_RET_FAILURE;
-        }
-        else
-        {
-            ESP_LOGI(TAG, "Setting cooling pump speed to: %.2f", (float)(cmd_cooling_pump_set_speed_args.speed->dval[0u]));
-            return CMD_FUNC_RET_SUCCESS;
-        }
-    }
-    else
-    {
-        ESP_LOGE(TAG, "Invalid command arguments");
-        return CMD_FUNC_RET_FAILURE;
-    }
-}
-
-static void register_cooling_pump_set_speed(void)
-{
-    int num_args = 1;
-    cmd_cooling_pump_set_speed_args.speed = arg_dbl0("s", "speed", "<s>", "Speed in 0-100 percent");
-    cmd_cooling_pump_set_speed_args.end = arg_end(num_args);
-    const esp_console_cmd_t cmd = {
-        .command = "cooling_pump_set_speed",
-        .help = "Sets speed of cooling pump",
-        .hint = NULL,
-        .func = &cmd_cooling_pump_set_speed,
-        .argtable = &cmd_cooling_pump_set_speed_args
-    };
-    ESP_ERROR_CHECK( esp_console_cmd_register(&cmd) );
-}
-
-static int cmd_watering_pump_get_speed(void)
-{
-    float speed = watering_pump_get_speed();
-    printf("watering pump speed:%.2f\n", speed);
-    return CMD_FUNC_RET_SUCCESS;
-}
-
-static void register_watering_pump_get_speed(void)
-{
-    const esp_console_cmd_t cmd = {
-        .command = "watering_pump_get_speed",
-        .help = "Gets speed of watering pump",
-        .hint = NULL,
-        .func = &cmd_watering_pump_get_speed,
-    };
-    ESP_ERROR_CHECK( esp_console_cmd_register(&cmd) );
-}
-
-static int cmd_watering_pump_set_speed(int argc, char **argv)
-{
-    esp_err_t ret = ESP_OK;
-    int nerrors = arg_parse(argc, argv, (void **) &cmd_watering_pump_set_speed_args);
-
-    if (nerrors != 0) 
-    {
-        arg_print_errors(stderr, cmd_watering_pump_set_speed_args.end, argv[0u]);
-        ESP_LOGE(TAG, "Cannot set speed of watering pump");
-        return CMD_FUNC_RET_FAILURE;
-    }
-    if(0u != cmd_watering_pump_set_speed_args.speed->count)
-    {
-        ret = watering_pump_set_desired_speed((float)(cmd_watering_pump_set_speed_args.speed->dval[0u]));
-        if(ret != ESP_OK)
-        {
-            ESP_LOGE(TAG,"Failed to set watering pump speed");
-            return CMD_FUNC_RET_FAILURE;
-        }
-        else
-        {
-            ESP_LOGI(TAG, "Setting watering pump speed to: %.2f", (float)(cmd_watering_pump_set_speed_args.speed->dval[0u]));
-            return CMD_FUNC_RET_SUCCESS;
-        }
-    }
-    else
-    {
-        ESP_LOGE(TAG, "Invalid command arguments");
-        return CMD_FUNC_RET_FAILURE;
-    }
-}
-
-static void register_watering_pump_set_speed(void)
-{
-    int num_args = 1;
-    cmd_watering_pump_set_speed_args.speed = arg_dbl0("s", "speed", "<s>", "Speed in 0-100 percent");
-    cmd_watering_pump_set_speed_args.end = arg_end(num_args);
-    const esp_console_cmd_t cmd = {
-        .command = "watering_pump_set_speed",
-        .help = "Sets speed of watering pump",
-        .hint = NULL,
-        .func = &cmd_watering_pump_set_speed,
-        .argtable = &cmd_watering_pump_set_speed_args
-    };
-    ESP_ERROR_CHECK( esp_console_cmd_register(&cmd) );
-}
-
-static int cmd_cooling_ventilator_get_speed(void)
-{
-    float speed = cooling_ventilator_get_speed();
-    printf("Cooling ventilator speed:%.2f\n", speed);
-    return CMD_FUNC_RET_SUCCESS;
-}
-
-static void register_cooling_ventilator_get_speed(void)
-{
-    const esp_console_cmd_t cmd = {
-        .command = "cooling_ventilator_get_speed",
-        .help = "Gets speed of cooling ventilator",
-        .hint = NULL,
-        .func = &cmd_cooling_ventilator_get_speed,
-    };
-    ESP_ERROR_CHECK( esp_console_cmd_register(&cmd) );
-}
-
-static int cmd_cooling_ventilator_set_speed(int argc, char **argv)
-{
-    esp_err_t ret = ESP_OK;
-    int nerrors = arg_parse(argc, argv, (void **) &cmd_cooling_ventilator_set_speed_args);
-
-    if (nerrors != 0) 
-    {
-        arg_print_errors(stderr, cmd_cooling_ventilator_set_speed_args.end, argv[0u]);
-        ESP_LOGE(TAG, "Cannot set speed of cooling ventilator");
-        return CMD_FUNC_RET_FAILURE;
-    }
-    if(0u != cmd_cooling_ventilator_set_speed_args.speed->count)
-    {
-        ret = cooling_ventilator_set_speed((float)(cmd_cooling_ventilator_set_speed_args.speed->dval[0u]));
-        if(ret != ESP_OK)
-        {
-            ESP_LOGE(TAG,"Failed to set cooling ventilator speed");
-            return CMD_FUNC_RET_FAILURE;
-        }
-        else
-        {
-            ESP_LOGI(TAG, "Setting cooling ventilator speed to: %.2f", (float)(cmd_cooling_ventilator_set_speed_args.speed->dval[0u]));
-            return CMD_FUNC_RET_SUCCESS;
-        }
-    }
-    else
-    {
-        ESP_LOGE(TAG, "Invalid command arguments");
-        return CMD_FUNC_RET_FAILURE;
-    }
-}
-
-static void register_cooling_ventilator_set_speed(void)
-{
-    int num_args = 1;
-    cmd_cooling_ventilator_set_speed_args.speed = arg_dbl0("s", "speed", "<s>", "Speed in 0-100 percent");
-    cmd_cooling_ventilator_set_speed_args.end = arg_end(num_args);
-    const esp_console_cmd_t cmd = {
-        .command = "cooling_ventilator_set_speed",
-        .help = "Sets speed of cooling ventilator",
-        .hint = NULL,
-        .func = &cmd_cooling_ventilator_set_speed,
-        .argtable = &cmd_cooling_ventilator_set_speed_args
-    };
-    ESP_ERROR_CHECK( esp_console_cmd_register(&cmd) );
-}
-
-static int cmd_dehumyfing_ventilator_get_speed(void)
-{
-    float speed = dehumyfing_ventilator_get_speed();
-    printf("dehumyfing ventilator speed:%.2f\n", speed);
-    return CMD_FUNC_RET_SUCCESS;
-}
-
-static void register_dehumyfing_ventilator_get_speed(void)
-{
-    const esp_console_cmd_t cmd = {
-        .command = "dehumyfing_ventilator_get_speed",
-        .help = "Gets speed of dehumyfing ventilator",
-        .hint = NULL,
-        .func = &cmd_dehumyfing_ventilator_get_speed,
-    };
-    ESP_ERROR_CHECK( esp_console_cmd_register(&cmd) );
-}
-
-static int cmd_dehumyfing_ventilator_set_speed(int argc, char **argv)
-{
-    esp_err_t ret = ESP_OK;
-    int nerrors = arg_parse(argc, argv, (void **) &cmd_dehumyfing_ventilator_set_speed_args);
-
-    if (nerrors != 0) 
-    {
-        arg_print_errors(stderr, cmd_dehumyfing_ventilator_set_speed_args.end, argv[0u]);
-        ESP_LOGE(TAG, "Cannot set speed of dehumyfing ventilator");
-        return CMD_FUNC_RET_FAILURE;
-    }
-    if(0u != cmd_dehumyfing_ventilator_set_speed_args.speed->count)
-    {
-        ret = dehumyfing_ventilator_set_speed((float)(cmd_dehumyfing_ventilator_set_speed_args.speed->dval[0u]));
-        if(ret != ESP_OK)
-        {
-            ESP_LOGE(TAG,"Failed to set cooling ventilator speed");
-            return CMD_FUNC_RET_FAILURE;
-        }
-        else
-        {
-            ESP_LOGI(TAG, "Setting dehumyfing ventilator speed to: %.2f", (float)(cmd_dehumyfing_ventilator_set_speed_args.speed->dval[0u]));
-            return CMD_FUNC_RET_SUCCESS;
-        }
-    }
-    else
-    {
-        ESP_LOGE(TAG, "Invalid command arguments");
-        return CMD_FUNC_RET_FAILURE;
-    }
-}
-
-static void register_dehumyfing_ventilator_set_speed(void)
-{
-    int num_args = 1;
-    cmd_dehumyfing_ventilator_set_speed_args.speed = arg_dbl0("s", "speed", "<s>", "Speed in 0-100 percent");
-    cmd_dehumyfing_ventilator_set_speed_args.end = arg_end(num_args);
-    const esp_console_cmd_t cmd = {
-        .command = "dehumyfing_ventilator_set_speed",
-        .help = "Sets speed of dehumyfing ventilator",
-        .hint = NULL,
-        .func = &cmd_dehumyfing_ventilator_set_speed,
-        .argtable = &cmd_dehumyfing_ventilator_set_speed_args
-    };
-    ESP_ERROR_CHECK( esp_console_cmd_register(&cmd) );
-}
-
-static int cmd_humidity_sensor_read(void)
-{
-    static float temperature = 0u;
-    static float humidity = 0u;
-    static float dew_point = 0u;
-
-    esp_err_t ret = humidity_sensor_read(&humidity, &temperature, &dew_point);
-
-    if(ESP_OK == ret)
-    {
-        ESP_LOGI(TAG,"Sensor read success");
-        printf("Humidity: %0.1f%%,\tTemperature: %0.1fC,\tDew point: %0.1fC\n\r", humidity, temperature, dew_point);
-        return CMD_FUNC_RET_SUCCESS;
-    }
-    else
-    {
-        return CMD_FUNC_RET_FAILURE;
-    }
-}
-
-static void register_humidity_sensor_read(void)
-{
-    const esp_console_cmd_t cmd = {
-        .command = "humidity_sensor_read",
-        .help = "Reads humidity, temperature and dew point",
-        .hint = NULL,
-        .func = &cmd_humidity_sensor_read,
-    };
-    ESP_ERROR_CHECK( esp_console_cmd_register(&cmd) );
-}
-
-static int cmd_temperature_sensor_read(void)
-{
-    float temp_C = 0u;
-    float temp_F = 0u;
-    uint64_t adr = 0u;
-    uint8_t sensor_count = temperature_sensor_rescan_devices();
-    esp_err_t ret = ESP_OK;
-
-    ESP_LOGI(TAG, "Found %d sensors\n\r", sensor_count);
-
-    printf("No\tAddress\t\t\tTemp [C]\tTemp [F]\n\r");
-
-    for(int i = 0; i < sensor_count; i++)
-    {
-        ret = temperature_sensor_get_data(&temp_C, &temp_F, &adr, i);
-        if(ret != ESP_OK)
-        {
-            return CMD_FUNC_RET_FAILURE;
-        }
-        printf("%d\t%#018"PRIx64"\t%0.2f\t\t%0.2f\n\r", i, adr, temp_C, temp_F);
-    }
-    
-    return CMD_FUNC_RET_SUCCESS;
-}
-
-static void register_temperature_sensor_read(void)
-{
-    const esp_console_cmd_t cmd = {
-        .command = "temperature_sensor_read",
-        .help = "Rescans temperature sensors, reads temperature in C and F",
-        .hint = NULL,
-        .func = &cmd_temperature_sensor_read,
-    };
-    ESP_ERROR_CHECK( esp_console_cmd_register(&cmd) );
-}
-
-static int cmd_peltier_get_power_level(void)
-{
-    float level = peltier_get_power_level();
-    printf("Peltier power level:%.2f%%\n", level);
-    return CMD_FUNC_RET_SUCCESS;
-}
-
-static void register_peltier_get_power_level(void)
-{
-    const esp_console_cmd_t cmd = {
-        .command = "peltier_get_power_level",
-        .help = "Gets power level of peltier",
-        .hint = NULL,
-        .func = &cmd_peltier_get_power_level,
-    };
-    ESP_ERROR_CHECK( esp_console_cmd_register(&cmd) );
-}
-
-static int cmd_peltier_set_power_level(int argc, char **argv)
-{
-    esp_err_t ret = ESP_OK;
-
-    int nerrors = arg_parse(argc, argv, (void **) &cmd_peltier_set_power_level_args);
-    if (nerrors != 0) 
-    {
-        arg_print_errors(stderr, cmd_peltier_set_power_level_args.end, argv[0u]);
-        ESP_LOGE(TAG, "Cannot set power level of peltier");
-        return CMD_FUNC_RET_FAILURE;
-    }
-    if(1u == cmd_peltier_set_power_level_args.level->count)
-    {
-        ret = peltier_set_power_level((float)(cmd_peltier_set_power_level_args.level->dval[0u]));
-        if(ret != ESP_OK)
-        {
-            ESP_LOGE(TAG, "Failed to set peltier power level");
-            return CMD_FUNC_RET_FAILURE;
-        }
-        else
-        {
-            ESP_LOGI(TAG, "Setting peltier power level to: %.2f%%", (float)(cmd_peltier_set_power_level_args.level->dval[0u]));
-            return CMD_FUNC_RET_SUCCESS;
-        }
-    }
-    else
-    {
-        ESP_LOGE(TAG, "Invalid command arguments");
-        return CMD_FUNC_RET_FAILURE;
-    }
-}
-
-static void register_peltier_set_power_level(void)
-{
-    int num_args = 1;
-    cmd_peltier_set_power_level_args.level = arg_dbl0("l", "level", "<l>", "Power level in 0-100%%");
-    cmd_peltier_set_power_level_args.end = arg_end(num_args);
-    const esp_console_cmd_t cmd = {
-        .command = "peltier_set_power_level",
-        .help = "Sets power level of peltier",
-        .hint = NULL,
-        .func = &cmd_peltier_set_power_level,
-        .argtable = &cmd_peltier_set_power_level_args
-    };
-    ESP_ERROR_CHECK( esp_console_cmd_register(&cmd) );
-}
-
-static int cmd_water_tank_get_info(void)
-{
-    float water_tank_level;
-
-    uint32_t freq = water_tank_get_frequency();
-    water_tank_get_level(&water_tank_level);
-    printf("Water tank generator frequency: %d Hz\n", freq);
-    printf("Water tank level: %f ml\n", water_tank_level);
-    return CMD_FUNC_RET_SUCCESS;
-}
-
-static void register_water_tank_get_info(void)
-{
-    const esp_console_cmd_t cmd = {
-        .command = "water_tank_get_info",
-        .help = "Gets last measured frequency and level of water tank generator",
-        .hint = NULL,
-        .func = &cmd_water_tank_get_info,
-    };
-    ESP_ERROR_CHECK( esp_console_cmd_register(&cmd) );
-}
-
-static int cmd_water_tank_define_max_level(int argc, char **argv)
-{
-    esp_err_t ret = ESP_OK;    
-    int nerrors = arg_parse(argc, argv, (void **) &cmd_water_tank_define_max_level_args);
-    
-    if (nerrors != 0) 
-    {
-        arg_print_errors(stderr, cmd_water_tank_define_max_level_args.end, argv[0u]);
-        ESP_LOGE(TAG, "Cannot defined max water tank level");
-        return CMD_FUNC_RET_FAILURE;
-    }
-    if(1u == cmd_water_tank_define_max_level_args.level->count)
-    {
-        ret = water_tank_define_max_level((float)(cmd_water_tank_define_max_level_args.level->dval[0u]));
-        if (ret != ESP_OK)
-        {
-            ESP_LOGE(TAG,"Failed to set max water tank level");
-            return CMD_FUNC_RET_FAILURE;
-        }
-        else
-        {
-            ESP_LOGI(TAG, "Setting max water tank level: %.2f", (float)(cmd_water_tank_define_max_level_args.level->dval[0u]));
-            return CMD_FUNC_RET_SUCCESS;
-        }
-    }
-    else
-    {
-        ESP_LOGE(TAG, "Invalid command arguments");
-        return CMD_FUNC_RET_FAILURE;
-    }
-    return CMD_FUNC_RET_SUCCESS;
-}
-
-static void register_water_tank_define_max_level()
-{
-    int num_args = 1;
-    cmd_water_tank_define_max_level_args.level = arg_dbl0("l", "level", "<l>", "Level in 0-2000 mililitres");
-    cmd_water_tank_define_max_level_args.end = arg_end(num_args);
-    const esp_console_cmd_t cmd = {
-        .command = "water_tank_def_max",
-        .help = "Gets max value of water tank level",
-        .hint = NULL,
-        .func = &cmd_water_tank_define_max_level,
-    };
-    ESP_ERROR_CHECK( esp_console_cmd_register(&cmd) );
-}
-
-static int cmd_water_tank_define_min_level(int argc, char **argv)
-{
-    esp_err_t ret = ESP_OK;
-    int nerrors = arg_parse(argc, argv, (void **) &cmd_water_tank_define_min_level_args);
-    
-    if (nerrors != 0) 
-    {
-        arg_print_errors(stderr, cmd_water_tank_define_min_level_args.end, argv[0u]);
-        ESP_LOGE(TAG, "Cannot define min water tank level");
-        return CMD_FUNC_RET_FAILURE;
-    }
-    if(1u == cmd_water_tank_define_min_level_args.level->count)
-    {
-        ret = water_tank_define_min_level((float)(cmd_water_tank_define_min_level_args.level->dval[0u]));
-        
-        if (ret != ESP_OK)
-        {
-            ESP_LOGE(TAG,"Failed to set min water tank level");
-            return CMD_FUNC_RET_FAILURE;
-        }
-        else
-        {
-            ESP_LOGI(TAG, "Setting min water tank level: %.2f", (float)(cmd_water_tank_define_min_level_args.level->dval[0u]));
-            return CMD_FUNC_RET_SUCCESS;
-        }
-    }
-    else
-    {
-        ESP_LOGE(TAG, "Invalid command arguments");
-        return CMD_FUNC_RET_FAILURE;
-    }
-    return CMD_FUNC_RET_SUCCESS;
-}
-
-static void register_water_tank_define_min_level()
-{
-    int num_args = 1;
-    cmd_water_tank_define_min_level_args.level = arg_dbl0("l", "level", "<l>", "Level in 0-2000 mililitres");
-    cmd_water_tank_define_min_level_args.end = arg_end(num_args);
-    const esp_console_cmd_t cmd = {
-        .command = "water_tank_def_min",
-        .help = "Gets min value of water tank level",
-        .hint = NULL,
-        .func = &cmd_water_tank_define_min_level,
-    };
-    ESP_ERROR_CHECK( esp_console_cmd_register(&cmd) );
-}
-
-static int cmd_water_tank_calibrate_max(void)
-{
-    water_tank_calibrate_max();
-    printf("Water tank calibrate max value: %f Hz\n", water_tank_get_max_freq());
-    return CMD_FUNC_RET_SUCCESS;
-}
-
-static void register_water_tank_calibrate_max()
-{
-    const esp_console_cmd_t cmd = {
-        .command = "water_tank_calib_max",
-        .help = "Calibrate min value of water tank level",
-        .hint = NULL,
-        .func = &cmd_water_tank_calibrate_max,
-    };
-    ESP_ERROR_CHECK( esp_console_cmd_register(&cmd) );
-}
-
-static int cmd_water_tank_calibrate_min(void)
-{
-    water_tank_calibrate_min();
-    printf("Water tank calibrate min value: %f Hz\n", water_tank_get_min_freq());
-    return CMD_FUNC_RET_SUCCESS;
-}
-
-static void register_water_tank_calibrate_min()
-{
-    const esp_console_cmd_t cmd = {
-        .command = "water_tank_calib_min",
-        .help = "Calibrate max value of water tank level",
-        .hint = NULL,
-        .func = &cmd_water_tank_calibrate_min,
-    };
-    ESP_ERROR_CHECK( esp_console_cmd_register(&cmd) );
-}
\ No newline at end of file
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+#include <unistd.h>
+#include <inttypes.h>
+#include "esp_log.h"
+#include "esp_console.h"
+#include "esp_chip_info.h"
+#include "esp_sleep.h"
+#include "esp_flash.h"
+#include "esp_system.h"
+#include "esp_timer.h"
+#include "driver/rtc_io.h"
+#include "driver/uart.h"
+#include "argtable3/argtable3.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "cmd.h"
+#include "sdkconfig.h"
+#include "../outputs/cooling_pump_control.h"
+#include "../outputs/watering_pump_control.h"
+#include "../outputs/cooling_ventilator_control.h"
+#include "../outputs/dehumyfing_ventilator_control.h"
+#include "../outputs/peltier_power_control.h"
+#include "../outputs/grow_light_control.h"
+#include "../outputs/flood_protection.h"
+#include "../outputs/actuators.h"
+#include "../outputs/cooling_control.h"
+#include "../inputs/humidity_sensor.h"
+#include "../inputs/temperature_sensor.h"
+#include "../inputs/water_tank_meas.h"
+#include "../inputs/tank_level_switch.h"
+#include "../inputs/soil_moisture.h"
+#include "../inputs/power_meter.h"
+#include "../inputs/pressure_sensor.h"
+#include "../inputs/fan_tach.h"
+#include "../inputs/light_sensor.h"
+#include "../system/scheduler.h"
+#include "../system/data_store.h"
+#include "../system/task_stats.h"
+#include "../system/perf.h"
+#include "../system/trace.h"
+#include "../system/power.h"
+
+
+#define CMD_FUNC_RET_SUCCESS 0
+#define CMD_FUNC_RET_FAILURE 1
+
+static struct {
+    struct arg_dbl *speed;
+    struct arg_end *end;
+} cmd_cooling_pump_set_speed_args;
+
+static struct {
+    struct arg_dbl *speed;
+    struct arg_end *end;
+} cmd_watering_pump_set_speed_args;
+
+static struct {
+    struct arg_dbl *speed;
+    struct arg_end *end;
+} cmd_cooling_ventilator_set_speed_args;
+
+static struct {
+    struct arg_dbl *speed;
+    struct arg_end *end;
+} cmd_dehumyfing_ventilator_set_speed_args;
+
+static struct {
+    struct arg_dbl *level;
+    struct arg_end *end;
+} cmd_peltier_set_power_level_args;
+
+static struct {
+    struct arg_dbl *level;
+    struct arg_end *end;
+} cmd_water_tank_define_max_level_args;
+
+static struct {
+    struct arg_dbl *level;
+    struct arg_end *end;
+} cmd_water_tank_define_min_level_args;
+
+static struct {
+    struct arg_dbl *level;
+    struct arg_end *end;
+} cmd_water_tank_calibrate_max_args;
+
+static struct {
+    struct arg_dbl *level;
+    struct arg_end *end;
+} cmd_water_tank_calibrate_min_args;
+
+static struct {
+    struct arg_int *gate;
+    struct arg_end *end;
+} cmd_water_tank_set_gate_time_args;
+
+static struct {
+    struct arg_dbl *level;
+    struct arg_dbl *freq;
+    struct arg_end *end;
+} cmd_water_tank_add_point_args;
+
+static struct {
+    struct arg_int *index;
+    struct arg_end *end;
+} cmd_water_tank_remove_point_args;
+
+static struct {
+    struct arg_dbl *outlier;
+    struct arg_int *limit;
+    struct arg_int *median;
+    struct arg_dbl *alpha;
+    struct arg_end *end;
+} cmd_water_tank_filter_args;
+
+static struct {
+    struct arg_dbl *moisture;
+    struct arg_dbl *freq;
+    struct arg_end *end;
+} cmd_soil_moisture_add_point_args;
+
+static struct {
+    struct arg_int *index;
+    struct arg_end *end;
+} cmd_soil_moisture_remove_point_args;
+
+static struct {
+    struct arg_lit *reset;
+    struct arg_end *end;
+} cmd_power_args;
+
+static struct {
+    struct arg_lit *clear;
+    struct arg_end *end;
+} cmd_fan_tach_curve_args;
+
+static struct {
+    struct arg_str *start;
+    struct arg_dbl *length;
+    struct arg_int *ramp;
+    struct arg_str *now;
+    struct arg_end *end;
+} cmd_light_photoperiod_args;
+
+static struct {
+    struct arg_dbl *target;
+    struct arg_dbl *lamp_ppfd;
+    struct arg_end *end;
+} cmd_light_dli_args;
+
+static struct {
+    struct arg_dbl *ppfd;
+    struct arg_dbl *freq;
+    struct arg_end *end;
+} cmd_light_sensor_add_point_args;
+
+static struct {
+    struct arg_int *index;
+    struct arg_end *end;
+} cmd_light_sensor_remove_point_args;
+
+static struct {
+    struct arg_int *sensor_no;
+    struct arg_int *resolution;
+    struct arg_int *period;
+    struct arg_end *end;
+} cmd_temperature_sensor_config_args;
+
+static struct {
+    struct arg_int *period;
+    struct arg_end *end;
+} cmd_humidity_sensor_config_args;
+
+static struct {
+    struct arg_int *watch;
+    struct arg_end *end;
+} cmd_data_store_args;
+
+static struct {
+    struct arg_dbl *level[ACTUATORS_NUM];
+    struct arg_end *end;
+} cmd_outputs_args;
+
+static struct {
+    struct arg_int *delay;
+    struct arg_int *count;
+    struct arg_lit *machine;
+    struct arg_end *end;
+} cmd_top_args;
+
+static struct {
+    struct arg_lit *reset;
+    struct arg_end *end;
+} cmd_perf_args;
+
+static struct {
+    struct arg_lit *start;
+    struct arg_lit *stop;
+    struct arg_lit *dump;
+    struct arg_end *end;
+} cmd_trace_args;
+
+static struct {
+    struct arg_lit *auto_mode;
+    struct arg_lit *manual;
+    struct arg_dbl *setpoint;
+    struct arg_dbl *hot_setpoint;
+    struct arg_str *loop;
+    struct arg_dbl *kp;
+    struct arg_dbl *ki;
+    struct arg_dbl *kd;
+    struct arg_dbl *slew;
+    struct arg_lit *clear;
+    struct arg_end *end;
+} cmd_cooling_ctl_args;
+
+static const char *TAG = "cmd";
+
+/**
+ * @brief Gets version of hardware used 
+ * 
+ * @return CMD_FUNC_RET_SUCCESS for success or CMD_FUNC_RET_FAILURE for failure
+ */
+static int get_version(void);
+
+/**
+ * @brief Restarts the system
+ */
+static int restart(void);
+
+/**
+ * @brief Gets speed of the cooling pump in %
+ * 
+ * @return CMD_FUNC_RET_SUCCESS for success
+ */
+static int cmd_cooling_pump_get_speed(void);
+
+/**
+ * @brief Sets speed of the cooling pump in %
+ * 
+ * @param argc arguments count
+ * @param argv arguments value
+ * @return CMD_FUNC_RET_SUCCESS for success or CMD_FUNC_RET_FAILURE for failure
+ */
+static int cmd_cooling_pump_set_speed(int argc, char **argv);
+
+/**
+ * @brief Sets speed of the watering pump in %
+ * 
+ * @return CMD_FUNC_RET_SUCCESS for success
+ */
+static int cmd_watering_pump_get_speed(void);
+
+/**
+ * @brief Sets speed of the watering pump in %
+ * 
+ * @param argc arguments count
+ * @param argv arguments value
+ * @return CMD_FUNC_RET_SUCCESS for success or CMD_FUNC_RET_FAILURE for failure
+ */
+static int cmd_watering_pump_set_speed(int argc, char **argv);
+
+/**
+ * @brief Gets speed of the cooling ventilator in %
+ * 
+ * @return CMD_FUNC_RET_SUCCESS for success
+ */
+static int cmd_cooling_ventilator_get_speed(void);
+
+/**
+ * @brief Sets speed of the cooling ventilator in %
+ * 
+ * @param argc arguments count
+ * @param argv arguments value
+ * @return CMD_FUNC_RET_SUCCESS for success or CMD_FUNC_RET_FAILURE for failure
+ */
+static int cmd_cooling_ventilator_set_speed(int argc, char **argv);
+
+/**
+ * @brief Gets speed of the dehumyfing ventilator in %
+ * 
+ * @return CMD_FUNC_RET_SUCCESS for success
+ */
+static int cmd_dehumyfing_ventilator_get_speed(void);
+
+/**
+ * @brief Sets speed of the dehumyfing ventilator in %
+ * 
+ * @param argc arguments count
+ * @param argv arguments value
+ * @return CMD_FUNC_RET_SUCCESS for success or CMD_FUNC_RET_FAILURE for failure
+ */
+static int cmd_dehumyfing_ventilator_set_speed(int argc, char **argv);
+
+/**
+ * @brief Prints last sampled humidity in %, temperature in Celsius deg, dew point in Celsius deg,
+ *        absolute humidity in g/m3 and vapour pressure deficit in kPa
+ * 
+ * @return CMD_FUNC_RET_SUCCESS for success or CMD_FUNC_RET_FAILURE for failure
+ */
+static int cmd_humidity_sensor_read(void);
+
+/**
+ * @brief Sets sampling period of the humidity sensor
+ * 
+ * @param argc arguments count
+ * @param argv arguments value
+ * @return CMD_FUNC_RET_SUCCESS for success or CMD_FUNC_RET_FAILURE for failure
+ */
+static int cmd_humidity_sensor_config(int argc, char **argv);
+
+/**
+ * @brief Prints last published temperature of all sensors in C deg and F deg 
+ * 
+ * @return CMD_FUNC_RET_SUCCESS for success or CMD_FUNC_RET_FAILURE for failure
+ */
+static int cmd_temperature_sensor_read(void);
+
+/**
+ * @brief Rescans sensors devices and converts them immediately
+ * 
+ * @return CMD_FUNC_RET_SUCCESS for success or CMD_FUNC_RET_FAILURE for failure
+ */
+static int cmd_temperature_sensor_refresh(void);
+
+/**
+ * @brief Sets conversion resolution and sampling period of a temperature sensor
+ * 
+ * @param argc arguments count
+ * @param argv arguments value
+ * @return CMD_FUNC_RET_SUCCESS for success or CMD_FUNC_RET_FAILURE for failure
+ */
+static int cmd_temperature_sensor_config(int argc, char **argv);
+
+/**
+ * @brief Gets power level of peltier in %
+ * 
+ * @return CMD_FUNC_RET_SUCCESS for success
+ */
+static int cmd_peltier_get_power_level(void);
+
+/**
+ * @brief Sets power level of peltier in %
+ * 
+ * @param argc arguments count
+ * @param argv arguments value
+ * @return CMD_FUNC_RET_SUCCESS for success or CMD_FUNC_RET_FAILURE for failure
+ */
+static int cmd_peltier_set_power_level(int argc, char **argv);
+
+/**
+ * @brief Gets water tank generator frequency and current water level
+ * 
+ * @return CMD_FUNC_RET_SUCCESS for success
+ */
+static int cmd_water_tank_get_info(void);
+
+/**
+ * @brief Set up max level of the tank in mililitres 
+ * 
+ * @param argc argument count 
+ * @param argv argument value
+ * @return CMD_FUNC_RET_SUCCESS for success or CMD_FUNC_RET_FAILURE for failure 
+ */
+static int cmd_water_tank_define_max_level(int argc, char **argv);
+
+/**
+ * @brief Set up min level of the tank in mililitres
+ * 
+ * @param argc argument count
+ * @param argv argument value
+ * @return CMD_FUNC_RET_SUCCESS for success or CMD_FUNC_RET_FAILURE for failure 
+ */
+static int cmd_water_tank_define_min_level(int argc, char **argv);
+
+/**
+ * @brief Set up curretnt water level as max value of water level
+ * 
+ * @return CMD_FUNC_RET_SUCCESS for success
+ */
+static int cmd_water_tank_calibrate_max(void);
+
+/**
+ * @brief Set up curretnt water level as min value of water level
+ * 
+ * @return CMD_FUNC_RET_SUCCESS for success
+ */
+static int cmd_water_tank_calibrate_min(void);
+
+/**
+ * @brief Set up duration of a single frequency measurement of the tank generator
+ * 
+ * @param argc argument count
+ * @param argv argument value
+ * @return CMD_FUNC_RET_SUCCESS for success or CMD_FUNC_RET_FAILURE for failure 
+ */
+static int cmd_water_tank_set_gate_time(int argc, char **argv);
+
+/**
+ * @brief Add calibration point of the tank, at given or current frequency
+ * 
+ * @param argc argument count
+ * @param argv argument value
+ * @return CMD_FUNC_RET_SUCCESS for success or CMD_FUNC_RET_FAILURE for failure 
+ */
+static int cmd_water_tank_add_point(int argc, char **argv);
+
+/**
+ * @brief Remove calibration point of the tank
+ * 
+ * @param argc argument count
+ * @param argv argument value
+ * @return CMD_FUNC_RET_SUCCESS for success or CMD_FUNC_RET_FAILURE for failure 
+ */
+static int cmd_water_tank_remove_point(int argc, char **argv);
+
+/**
+ * @brief Print calibration points of the tank
+ * 
+ * @return CMD_FUNC_RET_SUCCESS for success
+ */
+static int cmd_water_tank_list_points(void);
+
+/**
+ * @brief Set up filter chain of the tank frequency, prints current settings without arguments
+ * 
+ * @param argc argument count
+ * @param argv argument value
+ * @return CMD_FUNC_RET_SUCCESS for success or CMD_FUNC_RET_FAILURE for failure 
+ */
+static int cmd_water_tank_filter(int argc, char **argv);
+
+/**
+ * @brief Gets soil probe frequency and current soil moisture
+ * 
+ * @return CMD_FUNC_RET_SUCCESS for success
+ */
+static int cmd_soil_moisture_get_info(void);
+
+/**
+ * @brief Add calibration point of the soil probe, at given or current frequency
+ * 
+ * @param argc argument count
+ * @param argv argument value
+ * @return CMD_FUNC_RET_SUCCESS for success or CMD_FUNC_RET_FAILURE for failure 
+ */
+static int cmd_soil_moisture_add_point(int argc, char **argv);
+
+/**
+ * @brief Remove calibration point of the soil probe
+ * 
+ * @param argc argument count
+ * @param argv argument value
+ * @return CMD_FUNC_RET_SUCCESS for success or CMD_FUNC_RET_FAILURE for failure 
+ */
+static int cmd_soil_moisture_remove_point(int argc, char **argv);
+
+/**
+ * @brief Print calibration points of the soil probe
+ * 
+ * @return CMD_FUNC_RET_SUCCESS for success
+ */
+static int cmd_soil_moisture_list_points(void);
+
+/**
+ * @brief Print supply voltage, current, power and energy attributed to the outputs
+ * 
+ * @param argc argument count
+ * @param argv argument value
+ * @return CMD_FUNC_RET_SUCCESS for success or CMD_FUNC_RET_FAILURE for failure 
+ */
+static int cmd_power(int argc, char **argv);
+
+/**
+ * @brief Print last sampled pressure and temperature of BMP280
+ * 
+ * @return CMD_FUNC_RET_SUCCESS for success or CMD_FUNC_RET_FAILURE for failure 
+ */
+static int cmd_pressure_sensor_read(void);
+
+/**
+ * @brief Print duty, measured and expected speed and state of the fans
+ * 
+ * @return CMD_FUNC_RET_SUCCESS for success
+ */
+static int cmd_fan_tach_get_info(void);
+
+/**
+ * @brief Print or clear learned duty to RPM curves of the fans
+ * 
+ * @param argc argument count
+ * @param argv argument value
+ * @return CMD_FUNC_RET_SUCCESS for success or CMD_FUNC_RET_FAILURE for failure 
+ */
+static int cmd_fan_tach_curve(int argc, char **argv);
+
+/**
+ * @brief Print state of the grow light, measured light and light integral
+ * 
+ * @return CMD_FUNC_RET_SUCCESS for success
+ */
+static int cmd_light_get_info(void);
+
+/**
+ * @brief Set photoperiod of the grow light and optionally time of day
+ * 
+ * @param argc argument count
+ * @param argv argument value
+ * @return CMD_FUNC_RET_SUCCESS for success or CMD_FUNC_RET_FAILURE for failure 
+ */
+static int cmd_light_photoperiod(int argc, char **argv);
+
+/**
+ * @brief Set target daily light integral and PPFD of the lamp
+ * 
+ * @param argc argument count
+ * @param argv argument value
+ * @return CMD_FUNC_RET_SUCCESS for success or CMD_FUNC_RET_FAILURE for failure 
+ */
+static int cmd_light_dli(int argc, char **argv);
+
+/**
+ * @brief Add calibration point of the light sensor, at given or current frequency
+ * 
+ * @param argc argument count
+ * @param argv argument value
+ * @return CMD_FUNC_RET_SUCCESS for success or CMD_FUNC_RET_FAILURE for failure 
+ */
+static int cmd_light_sensor_add_point(int argc, char **argv);
+
+/**
+ * @brief Remove calibration point of the light sensor
+ * 
+ * @param argc argument count
+ * @param argv argument value
+ * @return CMD_FUNC_RET_SUCCESS for success or CMD_FUNC_RET_FAILURE for failure 
+ */
+static int cmd_light_sensor_remove_point(int argc, char **argv);
+
+/**
+ * @brief Print calibration points of the light sensor
+ * 
+ * @return CMD_FUNC_RET_SUCCESS for success
+ */
+static int cmd_light_sensor_list_points(void);
+
+/**
+ * @brief Parse time of day given as HH:MM
+ * 
+ * @param text time of day
+ * @param minute_of_day minutes after midnight
+ * @return true if the text is a valid time of day
+ */
+static bool parse_time_of_day(const char *text, uint16_t* const minute_of_day);
+
+/**
+ * @brief Print state of tank level switches and frequencies they calibrated
+ * 
+ * @return CMD_FUNC_RET_SUCCESS for success
+ */
+static int cmd_water_tank_switches(void);
+
+/**
+ * @brief Print flood fault state and measured cut-off latencies
+ * 
+ * @return CMD_FUNC_RET_SUCCESS for success
+ */
+static int cmd_flood_status(void);
+
+/**
+ * @brief Clear latched flood fault
+ * 
+ * @return CMD_FUNC_RET_SUCCESS for success or CMD_FUNC_RET_FAILURE for failure 
+ */
+static int cmd_flood_clear(void);
+
+/**
+ * @brief Run self test of the flood cut-off and print measured latency
+ * 
+ * @return CMD_FUNC_RET_SUCCESS for success or CMD_FUNC_RET_FAILURE for failure 
+ */
+static int cmd_flood_test(void);
+
+/**
+ * @brief Print free heap, number of tasks, wake-ups of the scheduler and timing of its jobs
+ * 
+ * @return CMD_FUNC_RET_SUCCESS for success
+ */
+static int cmd_sched_stats(void);
+
+/**
+ * @brief Print all signals of the data store or changes of the signals for a while
+ * 
+ * @param argc number of arguments
+ * @param argv arguments
+ * @return CMD_FUNC_RET_SUCCESS for success or CMD_FUNC_RET_FAILURE for failure 
+ */
+static int cmd_data_store(int argc, char **argv);
+
+/**
+ * @brief Print levels of the actuator outputs or apply given levels together
+ * 
+ * @param argc number of arguments
+ * @param argv arguments
+ * @return CMD_FUNC_RET_SUCCESS for success or CMD_FUNC_RET_FAILURE for failure 
+ */
+static int cmd_outputs(int argc, char **argv);
+
+/**
+ * @brief Print CPU usage, stack and state of all tasks and heap usage, once or repeatedly
+ * 
+ * @param argc number of arguments
+ * @param argv arguments
+ * @return CMD_FUNC_RET_SUCCESS for success or CMD_FUNC_RET_FAILURE for failure 
+ */
+static int cmd_top(int argc, char **argv);
+
+/**
+ * @brief Print task statistics as a table, tasks sorted by CPU usage
+ * 
+ * @param stats the statistics, tasks are reordered
+ */
+static void cmd_top_print(task_stats_t* const stats);
+
+/**
+ * @brief Print task statistics as one line of JSON
+ * 
+ * @param stats the statistics
+ */
+static void cmd_top_print_json(const task_stats_t* const stats);
+
+/**
+ * @brief Print latency histograms of the instrumented driver calls and critical sections
+ * 
+ * @param argc number of arguments
+ * @param argv arguments
+ * @return CMD_FUNC_RET_SUCCESS for success or CMD_FUNC_RET_FAILURE for failure 
+ */
+static int cmd_perf(int argc, char **argv);
+
+/**
+ * @brief Start, stop or dump the timeline trace, print its state without arguments
+ * 
+ * @param argc number of arguments
+ * @param argv arguments
+ * @return CMD_FUNC_RET_SUCCESS for success or CMD_FUNC_RET_FAILURE for failure 
+ */
+static int cmd_trace(int argc, char **argv);
+
+/**
+ * @brief Print CPU frequency limits, power management locks, time spent in every power mode and supply power
+ * 
+ * @param argc number of arguments
+ * @param argv arguments
+ * @return CMD_FUNC_RET_SUCCESS for success or CMD_FUNC_RET_FAILURE for failure 
+ */
+static int cmd_pm_stats(int argc, char **argv);
+
+/**
+ * @brief Print state and timing of the cooling loops, switch manual and closed loop control,
+ *        set the setpoints and tune a loop
+ * 
+ * @param argc number of arguments
+ * @param argv arguments
+ * @return CMD_FUNC_RET_SUCCESS for success or CMD_FUNC_RET_FAILURE for failure 
+ */
+static int cmd_cooling_ctl(int argc, char **argv);
+
+/**
+ * @brief Print one signal of the data store
+ * 
+ * @param signal the signal
+ * @param sample content of its slot
+ */
+static void cmd_data_store_print(data_store_signal_t signal, const data_store_sample_t* const sample);
+
+/*Functions used to register commands above to further use*/
+static void register_version(void);
+static void register_restart(void);
+static void register_cooling_pump_get_speed(void);
+static void register_cooling_pump_set_speed(void);
+static void register_watering_pump_get_speed(void);
+static void register_watering_pump_set_speed(void);
+static void register_cooling_ventilator_get_speed(void);
+static void register_cooling_ventilator_set_speed(void);
+static void register_dehumyfing_ventilator_get_speed(void);
+static void register_dehumyfing_ventilator_set_speed(void);
+static void register_humidity_sensor_read(void);
+static void register_humidity_sensor_config(void);
+static void register_temperature_sensor_read(void);
+static void register_temperature_sensor_refresh(void);
+static void register_temperature_sensor_config(void);
+static void register_peltier_get_power_level(void);
+static void register_peltier_set_power_level(void);
+static void register_water_tank_get_info(void);
+static void register_water_tank_define_max_level(void);
+static void register_water_tank_define_min_level(void);
+static void register_water_tank_calibrate_max(void);
+static void register_water_tank_calibrate_min(void);
+static void register_water_tank_set_gate_time(void);
+static void register_water_tank_add_point(void);
+static void register_water_tank_remove_point(void);
+static void register_water_tank_list_points(void);
+static void register_water_tank_filter(void);
+static void register_soil_moisture_get_info(void);
+static void register_soil_moisture_add_point(void);
+static void register_soil_moisture_remove_point(void);
+static void register_soil_moisture_list_points(void);
+static void register_power(void);
+static void register_pressure_sensor_read(void);
+static void register_fan_tach_get_info(void);
+static void register_fan_tach_curve(void);
+static void register_light_get_info(void);
+static void register_light_photoperiod(void);
+static void register_light_dli(void);
+static void register_light_sensor_add_point(void);
+static void register_light_sensor_remove_point(void);
+static void register_light_sensor_list_points(void);
+static void register_water_tank_switches(void);
+static void register_flood_status(void);
+static void register_flood_clear(void);
+static void register_flood_test(void);
+static void register_sched_stats(void);
+static void register_data_store(void);
+static void register_outputs(void);
+static void register_top(void);
+static void register_perf(void);
+static void register_trace(void);
+static void register_pm_stats(void);
+static void register_cooling_ctl(void);
+
+void register_cmd(void)
+{
+    register_version();
+    register_restart();
+    register_cooling_pump_get_speed();
+    register_cooling_pump_set_speed();
+    register_watering_pump_get_speed();
+    register_watering_pump_set_speed();
+    register_cooling_ventilator_get_speed();
+    register_cooling_ventilator_set_speed();
+    register_dehumyfing_ventilator_get_speed();
+    register_dehumyfing_ventilator_set_speed();
+    register_humidity_sensor_read();
+    register_humidity_sensor_config();
+    register_temperature_sensor_read();
+    register_temperature_sensor_refresh();
+    register_temperature_sensor_config();
+    register_peltier_get_power_level();
+    register_peltier_set_power_level();
+    register_water_tank_get_info();
+    register_water_tank_define_max_level();
+    register_water_tank_define_min_level();
+    register_water_tank_calibrate_max();
+    register_water_tank_calibrate_min();
+    register_water_tank_set_gate_time();
+    register_water_tank_add_point();
+    register_water_tank_remove_point();
+    register_water_tank_list_points();
+    register_water_tank_filter();
+    register_soil_moisture_get_info();
+    register_soil_moisture_add_point();
+    register_soil_moisture_remove_point();
+    register_soil_moisture_list_points();
+    register_power();
+    register_pressure_sensor_read();
+    register_fan_tach_get_info();
+    register_fan_tach_curve();
+    register_light_get_info();
+    register_light_photoperiod();
+    register_light_dli();
+    register_light_sensor_add_point();
+    register_light_sensor_remove_point();
+    register_light_sensor_list_points();
+    register_water_tank_switches();
+    register_flood_status();
+    register_flood_clear();
+    register_flood_test();
+    register_sched_stats();
+    register_data_store();
+    register_outputs();
+    register_top();
+    register_perf();
+    register_trace();
+    register_pm_stats();
+    register_cooling_ctl();
+}
+
+static int get_version(void)
+{
+    const char *model;
+    esp_chip_info_t info;
+    uint32_t flash_size;
+
+    esp_chip_info(&info);
+
+    switch(info.model) 
+    {
+        case CHIP_ESP32:
+            model = "ESP32";
+            break;
+        case CHIP_ESP32S2:
+            model = "ESP32-S2";
+            break;
+        case CHIP_ESP32S3:
+            model = "ESP32-S3";
+            break;
+        case CHIP_ESP32C3:
+            model = "ESP32-C3";
+            break;
+        case CHIP_ESP32H2:
+            model = "ESP32-H2";
+            break;
+        // case CHIP_ESP32C2:
+        //     model = "ESP32-C2"; left deliberately, this model does not work
+        //     break;
+        default:
+            model = "Unknown";
+            break;
+    }
+
+    if(esp_flash_get_size(NULL, &flash_size) != ESP_OK) 
+    {
+        printf("Get flash size failed");
+        return CMD_FUNC_RET_FAILURE;
+    }
+    printf("IDF Version:%s\r\n", esp_get_idf_version());
+    printf("Chip info:\r\n");
+    printf("\tmodel:%s\r\n", model);
+    printf("\tcores:%d\r\n", info.cores);
+    printf("\tfeature:%s%s%s%s%d%s\r\n",
+           info.features & CHIP_FEATURE_WIFI_BGN ? "/802.11bgn" : "",
+           info.features & CHIP_FEATURE_BLE ? "/BLE" : "",
+           info.features & CHIP_FEATURE_BT ? "/BT" : "",
+           info.features & CHIP_FEATURE_EMB_FLASH ? "/Embedded-Flash:" : "/External-Flash:",
+           flash_size / (1024 * 1024), " MB");
+    printf("\trevision number:%d\r\n", info.revision);
+    return CMD_FUNC_RET_SUCCESS;
+}
+
+static void register_version(void)
+{
+    const esp_console_cmd_t cmd = {
+        .command = "version",
+        .help = "Get version of chip and SDK",
+        .hint = NULL,
+        .func = &get_version,
+    };
+    ESP_ERROR_CHECK( esp_console_cmd_register(&cmd) );
+}
+
+static int restart(void)
+{
+    ESP_LOGI(TAG, "Restarting");
+    esp_restart();
+}
+
+static void register_restart(void)
+{
+    const esp_console_cmd_t cmd = {
+        .command = "restart",
+        .help = "Software reset of the chip",
+        .hint = NULL,
+        .func = &restart,
+    };
+    ESP_ERROR_CHECK( esp_console_cmd_register(&cmd) );
+}
+
+static int cmd_cooling_pump_get_speed(void)
+{
+    float speed = cooling_pump_get_speed();
+    printf("Cooling pump speed:%.2f\n", speed);
+    return CMD_FUNC_RET_SUCCESS;
+}
+
+static void register_cooling_pump_get_speed(void)
+{
+    const esp_console_cmd_t cmd = {
+        .command = "cooling_pump_get_speed",
+        .help = "Gets speed of cooling pump",
+        .hint = NULL,
+        .func = &cmd_cooling_pump_get_speed,
+    };
+    ESP_ERROR_CHECK( esp_console_cmd_register(&cmd) );
+}
+
+static int cmd_cooling_pump_set_speed(int argc, char **argv)
+{
+    esp_err_t ret = ESP_OK;
+    int nerrors = arg_parse(argc, argv, (void **) &cmd_cooling_pump_set_speed_args);
+
+    if (0u != nerrors) 
+    {
+        arg_print_errors(stderr, cmd_cooling_pump_set_speed_args.end, argv[0u]);
+        ESP_LOGE(TAG, "Cannot set speed of cooling pump");
+        return CMD_FUNC_RET_FAILURE;
+    }
+    if(cooling_control_is_auto())
+    {
+        ESP_LOGE(TAG, "Cooling is in closed loop control, switch it to manual with cooling_ctl -m");
+        return CMD_FUNC_RET_FAILURE;
+    }
+    if(0u != cmd_cooling_pump_set_speed_args.speed->count)
+    {
+        ret = cooling_pump_set_speed((float)(cmd_cooling_pump_set_speed_args.speed->dval[0u]));
+        if(ret != ESP_OK)
+        {
+            ESP_LOGE(TAG,"Failed to set cooling pump speed");
+            return CMD_FUNC_RET_FAILURE;
+        }
+        else
+        {
+            ESP_LOGI(TAG, "Setting cooling pump speed to: %.2f", (float)(cmd_cooling_pump_set_speed_args.speed->dval[0u]));
+            return CMD_FUNC_RET_SUCCESS;
+        }
+    }
+    else
+    {
+        ESP_LOGE(TAG, "Invalid command arguments");
+        return CMD_FUNC_RET_FAILURE;
+    }
+}
+
+static void register_cooling_pump_set_speed(void)
+{
+    int num_args = 1;
+    cmd_cooling_pump_set_speed_args.speed = arg_dbl0("s", "speed", "<s>", "Speed in 0-100 percent");
+    cmd_cooling_pump_set_speed_args.end = arg_end(num_args);
+    const esp_console_cmd_t cmd = {
+        .command = "cooling_pump_set_speed",
+        .help = "Sets speed of cooling pump",
+        .hint = NULL,
+        .func = &cmd_cooling_pump_set_speed,
+        .argtable = &cmd_cooling_pump_set_speed_args
+    };
+    ESP_ERROR_CHECK( esp_console_cmd_register(&cmd) );
+}
+
+static int cmd_watering_pump_get_speed(void)
+{
+    float speed = watering_pump_get_speed();
+    printf("watering pump speed:%.2f\n", speed);
+    return CMD_FUNC_RET_SUCCESS;
+}
+
+static void register_watering_pump_get_speed(void)
+{
+    const esp_console_cmd_t cmd = {
+        .command = "watering_pump_get_speed",
+        .help = "Gets speed of watering pump",
+        .hint = NULL,
+        .func = &cmd_watering_pump_get_speed,
+    };
+    ESP_ERROR_CHECK( esp_console_cmd_register(&cmd) );
+}
+
+static int cmd_watering_pump_set_speed(int argc, char **argv)
+{
+    esp_err_t ret = ESP_OK;
+    int nerrors = arg_parse(argc, argv, (void **) &cmd_watering_pump_set_speed_args);
+
+    if (nerrors != 0) 
+    {
+        arg_print_errors(stderr, cmd_watering_pump_set_speed_args.end, argv[0u]);
+        ESP_LOGE(TAG, "Cannot set speed of watering pump");
+        return CMD_FUNC_RET_FAILURE;
+    }
+    if(0u != cmd_watering_pump_set_speed_args.speed->count)
+    {
+        ret = watering_pump_set_desired_speed((float)(cmd_watering_pump_set_speed_args.speed->dval[0u]));
+        if(ret != ESP_OK)
+        {
+            ESP_LOGE(TAG,"Failed to set watering pump speed");
+            return CMD_FUNC_RET_FAILURE;
+        }
+        else
+        {
+            ESP_LOGI(TAG, "Setting watering pump speed to: %.2f", (float)(cmd_watering_pump_set_speed_args.speed->dval[0u]));
+            return CMD_FUNC_RET_SUCCESS;
+        }
+    }
+    else
+    {
+        ESP_LOGE(TAG, "Invalid command arguments");
+        return CMD_FUNC_RET_FAILURE;
+    }
+}
+
+static void register_watering_pump_set_speed(void)
+{
+    int num_args = 1;
+    cmd_watering_pump_set_speed_args.speed = arg_dbl0("s", "speed", "<s>", "Speed in 0-100 percent");
+    cmd_watering_pump_set_speed_args.end = arg_end(num_args);
+    const esp_console_cmd_t cmd = {
+        .command = "watering_pump_set_speed",
+        .help = "Sets speed of watering pump",
+        .hint = NULL,
+        .func = &cmd_watering_pump_set_speed,
+        .argtable = &cmd_watering_pump_set_speed_args
+    };
+    ESP_ERROR_CHECK( esp_console_cmd_register(&cmd) );
+}
+
+static int cmd_cooling_ventilator_get_speed(void)
+{
+    float speed = cooling_ventilator_get_speed();
+    printf("Cooling ventilator speed:%.2f\n", speed);
+    return CMD_FUNC_RET_SUCCESS;
+}
+
+static void register_cooling_ventilator_get_speed(void)
+{
+    const esp_console_cmd_t cmd = {
+        .command = "cooling_ventilator_get_speed",
+        .help = "Gets speed of cooling ventilator",
+        .hint = NULL,
+        .func = &cmd_cooling_ventilator_get_speed,
+    };
+    ESP_ERROR_CHECK( esp_console_cmd_register(&cmd) );
+}
+
+static int cmd_cooling_ventilator_set_speed(int argc, char **argv)
+{
+    esp_err_t ret = ESP_OK;
+    int nerrors = arg_parse(argc, argv, (void **) &cmd_cooling_ventilator_set_speed_args);
+
+    if (nerrors != 0) 
+    {
+        arg_print_errors(stderr, cmd_cooling_ventilator_set_speed_args.end, argv[0u]);
+        ESP_LOGE(TAG, "Cannot set speed of cooling ventilator");
+        return CMD_FUNC_RET_FAILURE;
+    }
+    if(cooling_control_is_auto())
+    {
+        ESP_LOGE(TAG, "Cooling is in closed loop control, switch it to manual with cooling_ctl -m");
+        return CMD_FUNC_RET_FAILURE;
+    }
+    if(0u != cmd_cooling_ventilator_set_speed_args.speed->count)
+    {
+        ret = cooling_ventilator_set_speed((float)(cmd_cooling_ventilator_set_speed_args.speed->dval[0u]));
+        if(ret != ESP_OK)
+        {
+            ESP_LOGE(TAG,"Failed to set cooling ventilator speed");
+            return CMD_FUNC_RET_FAILURE;
+        }
+        else
+        {
+            ESP_LOGI(TAG, "Setting cooling ventilator speed to: %.2f", (float)(cmd_cooling_ventilator_set_speed_args.speed->dval[0u]));
+            return CMD_FUNC_RET_SUCCESS;
+        }
+    }
+    else
+    {
+        ESP_LOGE(TAG, "Invalid command arguments");
+        return CMD_FUNC_RET_FAILURE;
+    }
+}
+
+static void register_cooling_ventilator_set_speed(void)
+{
+    int num_args = 1;
+    cmd_cooling_ventilator_set_speed_args.speed = arg_dbl0("s", "speed", "<s>", "Speed in 0-100 percent");
+    cmd_cooling_ventilator_set_speed_args.end = arg_end(num_args);
+    const esp_console_cmd_t cmd = {
+        .command = "cooling_ventilator_set_speed",
+        .help = "Sets speed of cooling ventilator",
+        .hint = NULL,
+        .func = &cmd_cooling_ventilator_set_speed,
+        .argtable = &cmd_cooling_ventilator_set_speed_args
+    };
+    ESP_ERROR_CHECK( esp_console_cmd_register(&cmd) );
+}
+
+static int cmd_dehumyfing_ventilator_get_speed(void)
+{
+    float speed = dehumyfing_ventilator_get_speed();
+    printf("dehumyfing ventilator speed:%.2f\n", speed);
+    return CMD_FUNC_RET_SUCCESS;
+}
+
+static void register_dehumyfing_ventilator_get_speed(void)
+{
+    const esp_console_cmd_t cmd = {
+        .command = "dehumyfing_ventilator_get_speed",
+        .help = "Gets speed of dehumyfing ventilator",
+        .hint = NULL,
+        .func = &cmd_dehumyfing_ventilator_get_speed,
+    };
+    ESP_ERROR_CHECK( esp_console_cmd_register(&cmd) );
+}
+
+static int cmd_dehumyfing_ventilator_set_speed(int argc, char **argv)
+{
+    esp_err_t ret = ESP_OK;
+    int nerrors = arg_parse(argc, argv, (void **) &cmd_dehumyfing_ventilator_set_speed_args);
+
+    if (nerrors != 0) 
+    {
+        arg_print_errors(stderr, cmd_dehumyfing_ventilator_set_speed_args.end, argv[0u]);
+        ESP_LOGE(TAG, "Cannot set speed of dehumyfing ventilator");
+        return CMD_FUNC_RET_FAILURE;
+    }
+    if(0u != cmd_dehumyfing_ventilator_set_speed_args.speed->count)
+    {
+        ret = dehumyfing_ventilator_set_speed((float)(cmd_dehumyfing_ventilator_set_speed_args.speed->dval[0u]));
+        if(ret != ESP_OK)
+        {
+            ESP_LOGE(TAG,"Failed to set cooling ventilator speed");
+            return CMD_FUNC_RET_FAILURE;
+        }
+        else
+        {
+            ESP_LOGI(TAG, "Setting dehumyfing ventilator speed to: %.2f", (float)(cmd_dehumyfing_ventilator_set_speed_args.speed->dval[0u]));
+            return CMD_FUNC_RET_SUCCESS;
+        }
+    }
+    else
+    {
+        ESP_LOGE(TAG, "Invalid command arguments");
+        return CMD_FUNC_RET_FAILURE;
+    }
+}
+
+static void register_dehumyfing_ventilator_set_speed(void)
+{
+    int num_args = 1;
+    cmd_dehumyfing_ventilator_set_speed_args.speed = arg_dbl0("s", "speed", "<s>", "Speed in 0-100 percent");
+    cmd_dehumyfing_ventilator_set_speed_args.end = arg_end(num_args);
+    const esp_console_cmd_t cmd = {
+        .command = "dehumyfing_ventilator_set_speed",
+        .help = "Sets speed of dehumyfing ventilator",
+        .hint = NULL,
+        .func = &cmd_dehumyfing_ventilator_set_speed,
+        .argtable = &cmd_dehumyfing_ventilator_set_speed_args
+    };
+    ESP_ERROR_CHECK( esp_console_cmd_register(&cmd) );
+}
+
+static int cmd_humidity_sensor_read(void)
+{
+    humidity_sensor_snapshot_t sample;
+
+    humidity_sensor_get_snapshot(&sample);
+
+    if(0 == sample.timestamp_us)
+    {
+        ESP_LOGE(TAG, "No data read from sensor yet, %"PRIu32" errors", sample.error_count);
+        return CMD_FUNC_RET_FAILURE;
+    }
+
+    printf("Humidity: %0.1f%%,\tTemperature: %0.1fC,\tDew point: %0.1fC\n\r", sample.humidity, sample.temperature, sample.dew_point);
+    printf("Absolute humidity: %0.1fg/m3,\tVPD: %0.2fkPa\n\r", sample.absolute_humidity, sample.vpd);
+    printf("Age: %"PRId64" ms,\tPeriod: %"PRIu32" ms,\tErrors: %"PRIu32"%s\n\r", (esp_timer_get_time() - sample.timestamp_us) / 1000,
+           humidity_sensor_get_period(), sample.error_count, sample.last_read_ok ? "" : " (last read failed)");
+    return CMD_FUNC_RET_SUCCESS;
+}
+
+static void register_humidity_sensor_read(void)
+{
+    const esp_console_cmd_t cmd = {
+        .command = "humidity_sensor_read",
+        .help = "Prints last sampled humidity, temperature and dew point",
+        .hint = NULL,
+        .func = &cmd_humidity_sensor_read,
+    };
+    ESP_ERROR_CHECK( esp_console_cmd_register(&cmd) );
+}
+
+static int cmd_humidity_sensor_config(int argc, char **argv)
+{
+    int nerrors = arg_parse(argc, argv, (void **) &cmd_humidity_sensor_config_args);
+
+    if (nerrors != 0) 
+    {
+        arg_print_errors(stderr, cmd_humidity_sensor_config_args.end, argv[0u]);
+        ESP_LOGE(TAG, "Cannot configure humidity sensor");
+        return CMD_FUNC_RET_FAILURE;
+    }
+    if(1u == cmd_humidity_sensor_config_args.period->count)
+    {
+        uint32_t period = (uint32_t)cmd_humidity_sensor_config_args.period->ival[0u];
+
+        if(ESP_OK != humidity_sensor_set_period(period))
+        {
+            ESP_LOGE(TAG, "Failed to configure humidity sensor");
+            return CMD_FUNC_RET_FAILURE;
+        }
+        ESP_LOGI(TAG, "Humidity sensor sampled every %"PRIu32" ms", period);
+        return CMD_FUNC_RET_SUCCESS;
+    }
+    else
+    {
+        ESP_LOGE(TAG, "Invalid command arguments");
+        return CMD_FUNC_RET_FAILURE;
+    }
+}
+
+static void register_humidity_sensor_config(void)
+{
+    int num_args = 1;
+    cmd_humidity_sensor_config_args.period = arg_int0("p", "period", "<p>", "Sampling period in ms, at least 2000");
+    cmd_humidity_sensor_config_args.end = arg_end(num_args);
+    const esp_console_cmd_t cmd = {
+        .command = "humidity_sensor_config",
+        .help = "Sets sampling period of humidity sensor",
+        .hint = NULL,
+        .func = &cmd_humidity_sensor_config,
+        .argtable = &cmd_humidity_sensor_config_args
+    };
+    ESP_ERROR_CHECK( esp_console_cmd_register(&cmd) );
+}
+
+static int cmd_temperature_sensor_read(void)
+{
+    temperature_sensor_snapshot_t snapshot;
+    int64_t now = esp_timer_get_time();
+
+    temperature_sensor_get_snapshot(&snapshot);
+
+    ESP_LOGI(TAG, "Found %d sensors\n\r", snapshot.count);
+
+    printf("No\tAddress\t\t\tTemp [C]\tTemp [F]\tAge [ms]\tRes [bit]\tPeriod [ms]\n\r");
+
+    for(int i = 0; i < snapshot.count; i++)
+    {
+        const temperature_sensor_probe_t* probe = &snapshot.probes[i];
+
+        if(0 == probe->timestamp_us)
+        {
+            printf("%d\t%#018"PRIx64"\t-\t\t-\t\t-\t\t%d\t\t%"PRIu32"\n\r", i, probe->addr, probe->resolution_bits, probe->period_ms);
+            continue;
+        }
+        printf("%d\t%#018"PRIx64"\t%0.2f\t\t%0.2f\t\t%"PRId64"\t\t%d\t\t%"PRIu32"%s\n\r", i, probe->addr, probe->temp_C,
+               probe->temp_C * 1.8f + 32.0f, (now - probe->timestamp_us) / 1000, probe->resolution_bits, probe->period_ms,
+               probe->valid ? "" : " (read error)");
+    }
+    
+    return CMD_FUNC_RET_SUCCESS;
+}
+
+static void register_temperature_sensor_read(void)
+{
+    const esp_console_cmd_t cmd = {
+        .command = "temperature_sensor_read",
+        .help = "Prints last measured temperature in C and F of all sensors",
+        .hint = NULL,
+        .func = &cmd_temperature_sensor_read,
+    };
+    ESP_ERROR_CHECK( esp_console_cmd_register(&cmd) );
+}
+
+static int cmd_temperature_sensor_refresh(void)
+{
+    if(ESP_OK != temperature_sensor_refresh())
+    {
+        ESP_LOGE(TAG, "Failed to refresh temperature sensors");
+        return CMD_FUNC_RET_FAILURE;
+    }
+    return cmd_temperature_sensor_read();
+}
+
+static void register_temperature_sensor_refresh(void)
+{
+    const esp_console_cmd_t cmd = {
+        .command = "temperature_sensor_refresh",
+        .help = "Rescans temperature sensors and converts them immediately",
+        .hint = NULL,
+        .func = &cmd_temperature_sensor_refresh,
+    };
+    ESP_ERROR_CHECK( esp_console_cmd_register(&cmd) );
+}
+
+static int cmd_temperature_sensor_config(int argc, char **argv)
+{
+    int nerrors = arg_parse(argc, argv, (void **) &cmd_temperature_sensor_config_args);
+
+    if (nerrors != 0) 
+    {
+        arg_print_errors(stderr, cmd_temperature_sensor_config_args.end, argv[0u]);
+        ESP_LOGE(TAG, "Cannot configure temperature sensor");
+        return CMD_FUNC_RET_FAILURE;
+    }
+    if(1u == cmd_temperature_sensor_config_args.sensor_no->count && 1u == cmd_temperature_sensor_config_args.resolution->count)
+    {
+        uint8_t sensor_no = (uint8_t)cmd_temperature_sensor_config_args.sensor_no->ival[0u];
+        uint8_t resolution = (uint8_t)cmd_temperature_sensor_config_args.resolution->ival[0u];
+        uint32_t period = 0u;
+
+        if(1u == cmd_temperature_sensor_config_args.period->count)
+        {
+            period = (uint32_t)cmd_temperature_sensor_config_args.period->ival[0u];
+        }
+        if(ESP_OK != temperature_sensor_configure(sensor_no, resolution, period))
+        {
+            ESP_LOGE(TAG, "Failed to configure temperature sensor %d", sensor_no);
+            return CMD_FUNC_RET_FAILURE;
+        }
+        ESP_LOGI(TAG, "Temperature sensor %d set to %d bit", sensor_no, resolution);
+        return CMD_FUNC_RET_SUCCESS;
+    }
+    else
+    {
+        ESP_LOGE(TAG, "Invalid command arguments");
+        return CMD_FUNC_RET_FAILURE;
+    }
+}
+
+static void register_temperature_sensor_config(void)
+{
+    int num_args = 3;
+    cmd_temperature_sensor_config_args.sensor_no = arg_int0("n", "number", "<n>", "Sensor number");
+    cmd_temperature_sensor_config_args.resolution = arg_int0("r", "resolution", "<r>", "Resolution in 9-12 bits");
+    cmd_temperature_sensor_config_args.period = arg_int0("p", "period", "<p>", "Sampling period in ms, at least the conversion time");
+    cmd_temperature_sensor_config_args.end = arg_end(num_args);
+    const esp_console_cmd_t cmd = {
+        .command = "temperature_sensor_config",
+        .help = "Sets resolution and sampling period of temperature sensor",
+        .hint = NULL,
+        .func = &cmd_temperature_sensor_config,
+        .argtable = &cmd_temperature_sensor_config_args
+    };
+    ESP_ERROR_CHECK( esp_console_cmd_register(&cmd) );
+}
+
+static int cmd_peltier_get_power_level(void)
+{
+    float level = peltier_get_power_level();
+    printf("Peltier power level:%.2f%%\n", level);
+    return CMD_FUNC_RET_SUCCESS;
+}
+
+static void register_peltier_get_power_level(void)
+{
+    const esp_console_cmd_t cmd = {
+        .command = "peltier_get_power_level",
+        .help = "Gets power level of peltier",
+        .hint = NULL,
+        .func = &cmd_peltier_get_power_level,
+    };
+    ESP_ERROR_CHECK( esp_console_cmd_register(&cmd) );
+}
+
+static int cmd_peltier_set_power_level(int argc, char **argv)
+{
+    esp_err_t ret = ESP_OK;
+
+    int nerrors = arg_parse(argc, argv, (void **) &cmd_peltier_set_power_level_args);
+    if (nerrors != 0) 
+    {
+        arg_print_errors(stderr, cmd_peltier_set_power_level_args.end, argv[0u]);
+        ESP_LOGE(TAG, "Cannot set power level of peltier");
+        return CMD_FUNC_RET_FAILURE;
+    }
+    if(cooling_control_is_auto())
+    {
+        ESP_LOGE(TAG, "Cooling is in closed loop control, switch it to manual with cooling_ctl -m");
+        return CMD_FUNC_RET_FAILURE;
+    }
+    if(1u == cmd_peltier_set_power_level_args.level->count)
+    {
+        ret = peltier_set_power_level((float)(cmd_peltier_set_power_level_args.level->dval[0u]));
+        if(ret != ESP_OK)
+        {
+            ESP_LOGE(TAG, "Failed to set peltier power level");
+            return CMD_FUNC_RET_FAILURE;
+        }
+        else
+        {
+            ESP_LOGI(TAG, "Setting peltier power level to: %.2f%%", (float)(cmd_peltier_set_power_level_args.level->dval[0u]));
+            return CMD_FUNC_RET_SUCCESS;
+        }
+    }
+    else
+    {
+        ESP_LOGE(TAG, "Invalid command arguments");
+        return CMD_FUNC_RET_FAILURE;
+    }
+}
+
+static void register_peltier_set_power_level(void)
+{
+    int num_args = 1;
+    cmd_peltier_set_power_level_args.level = arg_dbl0("l", "level", "<l>", "Power level in 0-100%%");
+    cmd_peltier_set_power_level_args.end = arg_end(num_args);
+    const esp_console_cmd_t cmd = {
+        .command = "peltier_set_power_level",
+        .help = "Sets power level of peltier",
+        .hint = NULL,
+        .func = &cmd_peltier_set_power_level,
+        .argtable = &cmd_peltier_set_power_level_args
+    };
+    ESP_ERROR_CHECK( esp_console_cmd_register(&cmd) );
+}
+
+static int cmd_water_tank_get_info(void)
+{
+    float water_tank_level;
+
+    float freq = water_tank_get_frequency();
+    printf("Water tank generator frequency: %0.3f Hz (gate %"PRIu32" ms)\n", freq, water_tank_get_gate_time());
+    printf("Water tank filtered frequency: %0.3f Hz\n", water_tank_get_filtered_frequency());
+    if(ESP_OK == water_tank_get_level(&water_tank_level))
+    {
+        printf("Water tank level: %f ml\n", water_tank_level);
+    }
+    else
+    {
+        printf("Water tank level: not calibrated, at least 2 points needed\n");
+    }
+    return CMD_FUNC_RET_SUCCESS;
+}
+
+static void register_water_tank_get_info(void)
+{
+    const esp_console_cmd_t cmd = {
+        .command = "water_tank_get_info",
+        .help = "Gets last measured frequency and level of water tank generator",
+        .hint = NULL,
+        .func = &cmd_water_tank_get_info,
+    };
+    ESP_ERROR_CHECK( esp_console_cmd_register(&cmd) );
+}
+
+static int cmd_water_tank_define_max_level(int argc, char **argv)
+{
+    esp_err_t ret = ESP_OK;    
+    int nerrors = arg_parse(argc, argv, (void **) &cmd_water_tank_define_max_level_args);
+    
+    if (nerrors != 0) 
+    {
+        arg_print_errors(stderr, cmd_water_tank_define_max_level_args.end, argv[0u]);
+        ESP_LOGE(TAG, "Cannot defined max water tank level");
+        return CMD_FUNC_RET_FAILURE;
+    }
+    if(1u == cmd_water_tank_define_max_level_args.level->count)
+    {
+        ret = water_tank_define_max_level((float)(cmd_water_tank_define_max_level_args.level->dval[0u]));
+        if (ret != ESP_OK)
+        {
+            ESP_LOGE(TAG,"Failed to set max water tank level");
+            return CMD_FUNC_RET_FAILURE;
+        }
+        else
+        {
+            ESP_LOGI(TAG, "Setting max water tank level: %.2f", (float)(cmd_water_tank_define_max_level_args.level->dval[0u]));
+            return CMD_FUNC_RET_SUCCESS;
+        }
+    }
+    else
+    {
+        ESP_LOGE(TAG, "Invalid command arguments");
+        return CMD_FUNC_RET_FAILURE;
+    }
+    return CMD_FUNC_RET_SUCCESS;
+}
+
+static void register_water_tank_define_max_level()
+{
+    int num_args = 1;
+    cmd_water_tank_define_max_level_args.level = arg_dbl0("l", "level", "<l>", "Level in 0-2000 mililitres");
+    cmd_water_tank_define_max_level_args.end = arg_end(num_args);
+    const esp_console_cmd_t cmd = {
+        .command = "water_tank_def_max",
+        .help = "Gets max value of water tank level",
+        .hint = NULL,
+        .func = &cmd_water_tank_define_max_level,
+    };
+    ESP_ERROR_CHECK( esp_console_cmd_register(&cmd) );
+}
+
+static int cmd_water_tank_define_min_level(int argc, char **argv)
+{
+    esp_err_t ret = ESP_OK;
+    int nerrors = arg_parse(argc, argv, (void **) &cmd_water_tank_define_min_level_args);
+    
+    if (nerrors != 0) 
+    {
+        arg_print_errors(stderr, cmd_water_tank_define_min_level_args.end, argv[0u]);
+        ESP_LOGE(TAG, "Cannot define min water tank level");
+        return CMD_FUNC_RET_FAILURE;
+    }
+    if(1u == cmd_water_tank_define_min_level_args.level->count)
+    {
+        ret = water_tank_define_min_level((float)(cmd_water_tank_define_min_level_args.level->dval[0u]));
+        
+        if (ret != ESP_OK)
+        {
+            ESP_LOGE(TAG,"Failed to set min water tank level");
+            return CMD_FUNC_RET_FAILURE;
+        }
+        else
+        {
+            ESP_LOGI(TAG, "Setting min water tank level: %.2f", (float)(cmd_water_tank_define_min_level_args.level->dval[0u]));
+            return CMD_FUNC_RET_SUCCESS;
+        }
+    }
+    else
+    {
+        ESP_LOGE(TAG, "Invalid command arguments");
+        return CMD_FUNC_RET_FAILURE;
+    }
+    return CMD_FUNC_RET_SUCCESS;
+}
+
+static void register_water_tank_define_min_level()
+{
+    int num_args = 1;
+    cmd_water_tank_define_min_level_args.level = arg_dbl0("l", "level", "<l>", "Level in 0-2000 mililitres");
+    cmd_water_tank_define_min_level_args.end = arg_end(num_args);
+    const esp_console_cmd_t cmd = {
+        .command = "water_tank_def_min",
+        .help = "Gets min value of water tank level",
+        .hint = NULL,
+        .func = &cmd_water_tank_define_min_level,
+    };
+    ESP_ERROR_CHECK( esp_console_cmd_register(&cmd) );
+}
+
+static int cmd_water_tank_calibrate_max(void)
+{
+    water_tank_calibrate_max();
+    printf("Water tank calibrate max value: %f Hz\n", water_tank_get_max_freq());
+    return CMD_FUNC_RET_SUCCESS;
+}
+
+static void register_water_tank_calibrate_max()
+{
+    const esp_console_cmd_t cmd = {
+        .command = "water_tank_calib_max",
+        .help = "Calibrate min value of water tank level",
+        .hint = NULL,
+        .func = &cmd_water_tank_calibrate_max,
+    };
+    ESP_ERROR_CHECK( esp_console_cmd_register(&cmd) );
+}
+
+static int cmd_water_tank_calibrate_min(void)
+{
+    water_tank_calibrate_min();
+    printf("Water tank calibrate min value: %f Hz\n", water_tank_get_min_freq());
+    return CMD_FUNC_RET_SUCCESS;
+}
+
+static void register_water_tank_calibrate_min()
+{
+    const esp_console_cmd_t cmd = {
+        .command = "water_tank_calib_min",
+        .help = "Calibrate max value of water tank level",
+        .hint = NULL,
+        .func = &cmd_water_tank_calibrate_min,
+    };
+    ESP_ERROR_CHECK( esp_console_cmd_register(&cmd) );
+}
+
+static int cmd_water_tank_set_gate_time(int argc, char **argv)
+{
+    int nerrors = arg_parse(argc, argv, (void **) &cmd_water_tank_set_gate_time_args);
+
+    if (nerrors != 0) 
+    {
+        arg_print_errors(stderr, cmd_water_tank_set_gate_time_args.end, argv[0u]);
+        ESP_LOGE(TAG, "Cannot set gate time");
+        return CMD_FUNC_RET_FAILURE;
+    }
+    if(1u == cmd_water_tank_set_gate_time_args.gate->count && 0 < cmd_water_tank_set_gate_time_args.gate->ival[0u])
+    {
+        uint32_t gate = (uint32_t)cmd_water_tank_set_gate_time_args.gate->ival[0u];
+
+        if(ESP_OK != water_tank_set_gate_time(gate))
+        {
+            ESP_LOGE(TAG, "Failed to set gate time");
+            return CMD_FUNC_RET_FAILURE;
+        }
+        ESP_LOGI(TAG, "Water tank gate time: %"PRIu32" ms", gate);
+        return CMD_FUNC_RET_SUCCESS;
+    }
+    else
+    {
+        ESP_LOGE(TAG, "Invalid command arguments");
+        return CMD_FUNC_RET_FAILURE;
+    }
+}
+
+static void register_water_tank_set_gate_time(void)
+{
+    int num_args = 1;
+    cmd_water_tank_set_gate_time_args.gate = arg_int0("g", "gate", "<g>", "Gate time in ms");
+    cmd_water_tank_set_gate_time_args.end = arg_end(num_args);
+    const esp_console_cmd_t cmd = {
+        .command = "water_tank_set_gate",
+        .help = "Sets duration of a single frequency measurement of water tank generator",
+        .hint = NULL,
+        .func = &cmd_water_tank_set_gate_time,
+        .argtable = &cmd_water_tank_set_gate_time_args
+    };
+    ESP_ERROR_CHECK( esp_console_cmd_register(&cmd) );
+}
+
+static int cmd_water_tank_add_point(int argc, char **argv)
+{
+    int nerrors = arg_parse(argc, argv, (void **) &cmd_water_tank_add_point_args);
+
+    if (nerrors != 0) 
+    {
+        arg_print_errors(stderr, cmd_water_tank_add_point_args.end, argv[0u]);
+        ESP_LOGE(TAG, "Cannot add calibration point");
+        return CMD_FUNC_RET_FAILURE;
+    }
+    if(1u == cmd_water_tank_add_point_args.level->count)
+    {
+        float level = (float)cmd_water_tank_add_point_args.level->dval[0u];
+        float freq = 0.0f;
+
+        if(1u == cmd_water_tank_add_point_args.freq->count)
+        {
+            freq = (float)cmd_water_tank_add_point_args.freq->dval[0u];
+        }
+        if(ESP_OK != water_tank_add_point(freq, level))
+        {
+            ESP_LOGE(TAG, "Failed to add calibration point");
+            return CMD_FUNC_RET_FAILURE;
+        }
+        return cmd_water_tank_list_points();
+    }
+    else
+    {
+        ESP_LOGE(TAG, "Invalid command arguments");
+        return CMD_FUNC_RET_FAILURE;
+    }
+}
+
+static void register_water_tank_add_point(void)
+{
+    int num_args = 2;
+    cmd_water_tank_add_point_args.level = arg_dbl0("l", "level", "<l>", "Level in 0-2000 mililitres");
+    cmd_water_tank_add_point_args.freq = arg_dbl0("f", "freq", "<f>", "Frequency in Hz, current filtered frequency if omitted");
+    cmd_water_tank_add_point_args.end = arg_end(num_args);
+    const esp_console_cmd_t cmd = {
+        .command = "water_tank_cal_add",
+        .help = "Adds calibration point of water tank, replaces point with the same level or frequency",
+        .hint = NULL,
+        .func = &cmd_water_tank_add_point,
+        .argtable = &cmd_water_tank_add_point_args
+    };
+    ESP_ERROR_CHECK( esp_console_cmd_register(&cmd) );
+}
+
+static int cmd_water_tank_remove_point(int argc, char **argv)
+{
+    int nerrors = arg_parse(argc, argv, (void **) &cmd_water_tank_remove_point_args);
+
+    if (nerrors != 0) 
+    {
+        arg_print_errors(stderr, cmd_water_tank_remove_point_args.end, argv[0u]);
+        ESP_LOGE(TAG, "Cannot remove calibration point");
+        return CMD_FUNC_RET_FAILURE;
+    }
+    if(1u == cmd_water_tank_remove_point_args.index->count && 0 <= cmd_water_tank_remove_point_args.index->ival[0u])
+    {
+        if(ESP_OK != water_tank_remove_point((uint8_t)cmd_water_tank_remove_point_args.index->ival[0u]))
+        {
+            ESP_LOGE(TAG, "No such calibration point");
+            return CMD_FUNC_RET_FAILURE;
+        }
+        return cmd_water_tank_list_points();
+    }
+    else
+    {
+        ESP_LOGE(TAG, "Invalid command arguments");
+        return CMD_FUNC_RET_FAILURE;
+    }
+}
+
+static void register_water_tank_remove_point(void)
+{
+    int num_args = 1;
+    cmd_water_tank_remove_point_args.index = arg_int0("n", "number", "<n>", "Point number from water_tank_cal_list");
+    cmd_water_tank_remove_point_args.end = arg_end(num_args);
+    const esp_console_cmd_t cmd = {
+        .command = "water_tank_cal_del",
+        .help = "Removes calibration point of water tank",
+        .hint = NULL,
+        .func = &cmd_water_tank_remove_point,
+        .argtable = &cmd_water_tank_remove_point_args
+    };
+    ESP_ERROR_CHECK( esp_console_cmd_register(&cmd) );
+}
+
+static int cmd_water_tank_list_points(void)
+{
+    calibration_point_t points[CALIBRATION_MAX_POINTS];
+    uint8_t count = water_tank_get_points(points);
+
+    printf("No\tFrequency [Hz]\tLevel [ml]\n\r");
+    for(uint8_t i = 0u; i < count; i++)
+    {
+        printf("%d\t%0.3f\t%0.1f\n\r", i, points[i].x, points[i].y);
+    }
+    return CMD_FUNC_RET_SUCCESS;
+}
+
+static void register_water_tank_list_points(void)
+{
+    const esp_console_cmd_t cmd = {
+        .command = "water_tank_cal_list",
+        .help = "Prints calibration points of water tank",
+        .hint = NULL,
+        .func = &cmd_water_tank_list_points,
+    };
+    ESP_ERROR_CHECK( esp_console_cmd_register(&cmd) );
+}
+
+static int cmd_water_tank_filter(int argc, char **argv)
+{
+    signal_filter_config_t config;
+    int nerrors = arg_parse(argc, argv, (void **) &cmd_water_tank_filter_args);
+
+    if (nerrors != 0) 
+    {
+        arg_print_errors(stderr, cmd_water_tank_filter_args.end, argv[0u]);
+        ESP_LOGE(TAG, "Cannot set up filter");
+        return CMD_FUNC_RET_FAILURE;
+    }
+
+    water_tank_get_filter(&config);
+    if(1u == cmd_water_tank_filter_args.outlier->count)
+    {
+        config.outlier_ratio = (float)cmd_water_tank_filter_args.outlier->dval[0u] / 100.0f;
+    }
+    if(1u == cmd_water_tank_filter_args.limit->count)
+    {
+        config.outlier_limit = (uint8_t)cmd_water_tank_filter_args.limit->ival[0u];
+    }
+    if(1u == cmd_water_tank_filter_args.median->count)
+    {
+        config.median_window = (uint8_t)cmd_water_tank_filter_args.median->ival[0u];
+    }
+    if(1u == cmd_water_tank_filter_args.alpha->count)
+    {
+        config.ema_alpha = (float)cmd_water_tank_filter_args.alpha->dval[0u];
+    }
+    if(1 < argc)
+    {
+        water_tank_set_filter(&config);
+        water_tank_get_filter(&config);
+    }
+
+    printf("Outlier: %0.1f%% (accepted after %d), median: %d samples, EMA alpha: %0.2f\n\r",
+           config.outlier_ratio * 100.0f, config.outlier_limit, config.median_window, config.ema_alpha);
+    return CMD_FUNC_RET_SUCCESS;
+}
+
+static void register_water_tank_filter(void)
+{
+    int num_args = 4;
+    cmd_water_tank_filter_args.outlier = arg_dbl0("o", "outlier", "<o>", "Rejected deviation in percent, 0 disables");
+    cmd_water_tank_filter_args.limit = arg_int0("c", "count", "<c>", "Rejections in a row accepted as a step change");
+    cmd_water_tank_filter_args.median = arg_int0("m", "median", "<m>", "Median window in 1-9 samples, 1 disables");
+    cmd_water_tank_filter_args.alpha = arg_dbl0("a", "alpha", "<a>", "EMA weight of new sample in 0-1, 1 disables");
+    cmd_water_tank_filter_args.end = arg_end(num_args);
+    const esp_console_cmd_t cmd = {
+        .command = "water_tank_filter",
+        .help = "Sets up filter of water tank frequency, prints settings without arguments",
+        .hint = NULL,
+        .func = &cmd_water_tank_filter,
+        .argtable = &cmd_water_tank_filter_args
+    };
+    ESP_ERROR_CHECK( esp_console_cmd_register(&cmd) );
+}
+
+static int cmd_soil_moisture_get_info(void)
+{
+    float moisture;
+
+    printf("Soil probe frequency: %0.3f Hz, filtered: %0.3f Hz\n", soil_moisture_get_frequency(), soil_moisture_get_filtered_frequency());
+    if(ESP_OK == soil_moisture_get(&moisture))
+    {
+        printf("Soil moisture: %0.1f%%\n", moisture);
+    }
+    else
+    {
+        printf("Soil moisture: not calibrated, at least 2 points needed\n");
+    }
+    return CMD_FUNC_RET_SUCCESS;
+}
+
+static void register_soil_moisture_get_info(void)
+{
+    const esp_console_cmd_t cmd = {
+        .command = "soil_moisture_get_info",
+        .help = "Gets last measured frequency of soil probe and soil moisture",
+        .hint = NULL,
+        .func = &cmd_soil_moisture_get_info,
+    };
+    ESP_ERROR_CHECK( esp_console_cmd_register(&cmd) );
+}
+
+static int cmd_soil_moisture_add_point(int argc, char **argv)
+{
+    int nerrors = arg_parse(argc, argv, (void **) &cmd_soil_moisture_add_point_args);
+
+    if (nerrors != 0) 
+    {
+        arg_print_errors(stderr, cmd_soil_moisture_add_point_args.end, argv[0u]);
+        ESP_LOGE(TAG, "Cannot add calibration point");
+        return CMD_FUNC_RET_FAILURE;
+    }
+    if(1u == cmd_soil_moisture_add_point_args.moisture->count)
+    {
+        float moisture = (float)cmd_soil_moisture_add_point_args.moisture->dval[0u];
+        float freq = 0.0f;
+
+        if(1u == cmd_soil_moisture_add_point_args.freq->count)
+        {
+            freq = (float)cmd_soil_moisture_add_point_args.freq->dval[0u];
+        }
+        if(ESP_OK != soil_moisture_add_point(freq, moisture))
+        {
+            ESP_LOGE(TAG, "Failed to add calibration point");
+            return CMD_FUNC_RET_FAILURE;
+        }
+        return cmd_soil_moisture_list_points();
+    }
+    else
+    {
+        ESP_LOGE(TAG, "Invalid command arguments");
+        return CMD_FUNC_RET_FAILURE;
+    }
+}
+
+static void register_soil_moisture_add_point(void)
+{
+    int num_args = 2;
+    cmd_soil_moisture_add_point_args.moisture = arg_dbl0("m", "moisture", "<m>", "Soil moisture in 0-100 percent");
+    cmd_soil_moisture_add_point_args.freq = arg_dbl0("f", "freq", "<f>", "Frequency in Hz, current filtered frequency if omitted");
+    cmd_soil_moisture_add_point_args.end = arg_end(num_args);
+    const esp_console_cmd_t cmd = {
+        .command = "soil_moisture_cal_add",
+        .help = "Adds calibration point of soil probe, replaces point with the same moisture or frequency",
+        .hint = NULL,
+        .func = &cmd_soil_moisture_add_point,
+        .argtable = &cmd_soil_moisture_add_point_args
+    };
+    ESP_ERROR_CHECK( esp_console_cmd_register(&cmd) );
+}
+
+static int cmd_soil_moisture_remove_point(int argc, char **argv)
+{
+    int nerrors = arg_parse(argc, argv, (void **) &cmd_soil_moisture_remove_point_args);
+
+    if (nerrors != 0) 
+    {
+        arg_print_errors(stderr, cmd_soil_moisture_remove_point_args.end, argv[0u]);
+        ESP_LOGE(TAG, "Cannot remove calibration point");
+        return CMD_FUNC_RET_FAILURE;
+    }
+    if(1u == cmd_soil_moisture_remove_point_args.index->count && 0 <= cmd_soil_moisture_remove_point_args.index->ival[0u])
+    {
+        if(ESP_OK != soil_moisture_remove_point((uint8_t)cmd_soil_moisture_remove_point_args.index->ival[0u]))
+        {
+            ESP_LOGE(TAG, "No such calibration point");
+            return CMD_FUNC_RET_FAILURE;
+        }
+        return cmd_soil_moisture_list_points();
+    }
+    else
+    {
+        ESP_LOGE(TAG, "Invalid command arguments");
+        return CMD_FUNC_RET_FAILURE;
+    }
+}
+
+static void register_soil_moisture_remove_point(void)
+{
+    int num_args = 1;
+    cmd_soil_moisture_remove_point_args.index = arg_int0("n", "number", "<n>", "Point number from soil_moisture_cal_list");
+    cmd_soil_moisture_remove_point_args.end = arg_end(num_args);
+    const esp_console_cmd_t cmd = {
+        .command = "soil_moisture_cal_del",
+        .help = "Removes calibration point of soil probe",
+        .hint = NULL,
+        .func = &cmd_soil_moisture_remove_point,
+        .argtable = &cmd_soil_moisture_remove_point_args
+    };
+    ESP_ERROR_CHECK( esp_console_cmd_register(&cmd) );
+}
+
+static int cmd_soil_moisture_list_points(void)
+{
+    calibration_point_t points[CALIBRATION_MAX_POINTS];
+    uint8_t count = soil_moisture_get_points(points);
+
+    printf("No\tFrequency [Hz]\tMoisture [%%]\n\r");
+    for(uint8_t i = 0u; i < count; i++)
+    {
+        printf("%d\t%0.3f\t%0.1f\n\r", i, points[i].x, points[i].y);
+    }
+    return CMD_FUNC_RET_SUCCESS;
+}
+
+static void register_soil_moisture_list_points(void)
+{
+    const esp_console_cmd_t cmd = {
+        .command = "soil_moisture_cal_list",
+        .help = "Prints calibration points of soil probe",
+        .hint = NULL,
+        .func = &cmd_soil_moisture_list_points,
+    };
+    ESP_ERROR_CHECK( esp_console_cmd_register(&cmd) );
+}
+
+static int cmd_power(int argc, char **argv)
+{
+    power_meter_snapshot_t snapshot;
+    int nerrors = arg_parse(argc, argv, (void **) &cmd_power_args);
+
+    if (nerrors != 0) 
+    {
+        arg_print_errors(stderr, cmd_power_args.end, argv[0u]);
+        return CMD_FUNC_RET_FAILURE;
+    }
+    if(0 < cmd_power_args.reset->count)
+    {
+        power_meter_reset_energy();
+    }
+
+    power_meter_get_snapshot(&snapshot);
+    if(0u == snapshot.blocks)
+    {
+        ESP_LOGE(TAG, "No power measurement yet");
+        return CMD_FUNC_RET_FAILURE;
+    }
+    printf("Voltage: mean %0.3f V, RMS %0.3f V\n\r", snapshot.voltage_mean, snapshot.voltage_rms);
+    printf("Current: mean %0.3f A, RMS %0.3f A\n\r", snapshot.current_mean, snapshot.current_rms);
+    printf("Power: %0.2f W, energy: %0.3f Wh\n\r", snapshot.power, snapshot.energy_wh);
+    printf("Output\t\t\tFull [W]\tNow [W]\tEnergy [Wh]\n\r");
+    for(uint8_t i = 0u; i < POWER_METER_ACTUATORS_NUM; i++)
+    {
+        printf("%-24s%0.2f\t\t%0.2f\t%0.3f\n\r", power_meter_get_actuator_name((power_meter_actuator_t)i),
+               snapshot.full_power[i], snapshot.actuator_power[i], snapshot.actuator_energy_wh[i]);
+    }
+    printf("%-24s-\t\t%0.2f\t%0.3f\n\r", "base", snapshot.base_power, snapshot.base_energy_wh);
+    return CMD_FUNC_RET_SUCCESS;
+}
+
+static void register_power(void)
+{
+    int num_args = 1;
+    cmd_power_args.reset = arg_lit0("r", "reset", "Clear energy counters");
+    cmd_power_args.end = arg_end(num_args);
+    const esp_console_cmd_t cmd = {
+        .command = "power",
+        .help = "Prints supply voltage, current, power and energy used by the outputs",
+        .hint = NULL,
+        .func = &cmd_power,
+        .argtable = &cmd_power_args
+    };
+    ESP_ERROR_CHECK( esp_console_cmd_register(&cmd) );
+}
+
+static int cmd_pressure_sensor_read(void)
+{
+    pressure_sensor_snapshot_t sample;
+
+    if(!pressure_sensor_is_present())
+    {
+        ESP_LOGE(TAG, "Pressure sensor not available");
+        return CMD_FUNC_RET_FAILURE;
+    }
+
+    pressure_sensor_get_snapshot(&sample);
+    if(0 == sample.timestamp_us)
+    {
+        ESP_LOGE(TAG, "No data read from sensor yet, %"PRIu32" errors", sample.error_count);
+        return CMD_FUNC_RET_FAILURE;
+    }
+
+    printf("Pressure: %0.2fhPa,\tTemperature: %0.2fC\n\r", sample.pressure_hpa, sample.temperature);
+    printf("Age: %"PRId64" ms,\tErrors: %"PRIu32"%s\n\r", (esp_timer_get_time() - sample.timestamp_us) / 1000,
+           sample.error_count, sample.last_read_ok ? "" : " (last read failed)");
+    return CMD_FUNC_RET_SUCCESS;
+}
+
+static void register_pressure_sensor_read(void)
+{
+    const esp_console_cmd_t cmd = {
+        .command = "pressure_sensor_read",
+        .help = "Prints last sampled pressure and temperature of BMP280",
+        .hint = NULL,
+        .func = &cmd_pressure_sensor_read,
+    };
+    ESP_ERROR_CHECK( esp_console_cmd_register(&cmd) );
+}
+
+static int cmd_fan_tach_get_info(void)
+{
+    fan_tach_status_t status;
+
+    printf("Fan\t\tDuty [%%]\tRPM\tExpected\tState\t\tFaults\n\r");
+    for(uint8_t i = 0u; i < FAN_TACH_FANS_NUM; i++)
+    {
+        fan_tach_get_status((fan_tach_fan_t)i, &status);
+        printf("%-16s%0.1f\t\t%0.0f\t%0.0f\t\t%-16s%"PRIu32"\n\r", fan_tach_get_name((fan_tach_fan_t)i), status.duty,
+               status.rpm, status.expected_rpm, fan_tach_get_state_name(status.state), status.fault_count);
+    }
+    return CMD_FUNC_RET_SUCCESS;
+}
+
+static void register_fan_tach_get_info(void)
+{
+    const esp_console_cmd_t cmd = {
+        .command = "fan_tach_get_info",
+        .help = "Prints measured speed and state of the fans",
+        .hint = NULL,
+        .func = &cmd_fan_tach_get_info,
+    };
+    ESP_ERROR_CHECK( esp_console_cmd_register(&cmd) );
+}
+
+static int cmd_fan_tach_curve(int argc, char **argv)
+{
+    fan_tach_curve_point_t points[FAN_TACH_CURVE_POINTS];
+    int nerrors = arg_parse(argc, argv, (void **) &cmd_fan_tach_curve_args);
+
+    if (nerrors != 0) 
+    {
+        arg_print_errors(stderr, cmd_fan_tach_curve_args.end, argv[0u]);
+        return CMD_FUNC_RET_FAILURE;
+    }
+
+    for(uint8_t i = 0u; i < FAN_TACH_FANS_NUM; i++)
+    {
+        if(0 < cmd_fan_tach_curve_args.clear->count)
+        {
+            fan_tach_clear_curve((fan_tach_fan_t)i);
+        }
+        fan_tach_get_curve((fan_tach_fan_t)i, points);
+        printf("Fan %s\n\rDuty [%%]\tRPM\tWeight\n\r", fan_tach_get_name((fan_tach_fan_t)i));
+        for(uint8_t j = 0u; j < FAN_TACH_CURVE_POINTS; j++)
+        {
+            printf("%u\t\t%0.0f\t%0.1f\n\r", j * (100u / (FAN_TACH_CURVE_POINTS - 1u)), points[j].rpm, points[j].weight);
+        }
+    }
+    return CMD_FUNC_RET_SUCCESS;
+}
+
+static void register_fan_tach_curve(void)
+{
+    int num_args = 1;
+    cmd_fan_tach_curve_args.clear = arg_lit0("c", "clear", "Forget learned curves, e.g. after a fan was replaced");
+    cmd_fan_tach_curve_args.end = arg_end(num_args);
+    const esp_console_cmd_t cmd = {
+        .command = "fan_tach_curve",
+        .help = "Prints learned duty to RPM curves of the fans",
+        .hint = NULL,
+        .func = &cmd_fan_tach_curve,
+        .argtable = &cmd_fan_tach_curve_args
+    };
+    ESP_ERROR_CHECK( esp_console_cmd_register(&cmd) );
+}
+
+static int cmd_light_get_info(void)
+{
+    static const char *phase_names[] = {"night", "sunrise", "day", "sunset"};
+    grow_light_config_t config;
+    grow_light_status_t status;
+
+    grow_light_get_config(&config);
+    grow_light_get_status(&status);
+
+    printf("Light sensor frequency: %0.1f Hz, filtered: %0.1f Hz\n\r", light_sensor_get_frequency(), light_sensor_get_filtered_frequency());
+    printf("PPFD: %0.0f umol/m2/s, natural: %0.0f umol/m2/s\n\r", status.ppfd, status.natural_ppfd);
+    printf("DLI: %0.2f of %0.2f mol/m2/day\n\r", status.dli, config.target_dli);
+    printf("Phase: %s, level: %0.1f%%, target: %0.1f%%\n\r", phase_names[status.phase], status.level, status.target_level);
+    printf("Photoperiod: %02u:%02u for %u min, ramps %u min, lamp %0.0f umol/m2/s%s\n\r",
+           config.start_min / 60u, config.start_min % 60u, config.duration_min, config.ramp_min, config.lamp_ppfd,
+           status.clock_set ? "" : " (clock not set)");
+    return CMD_FUNC_RET_SUCCESS;
+}
+
+static void register_light_get_info(void)
+{
+    const esp_console_cmd_t cmd = {
+        .command = "light_get_info",
+        .help = "Prints state of grow light, measured light and daily light integral",
+        .hint = NULL,
+        .func = &cmd_light_get_info,
+    };
+    ESP_ERROR_CHECK( esp_console_cmd_register(&cmd) );
+}
+
+static int cmd_light_photoperiod(int argc, char **argv)
+{
+    grow_light_config_t config;
+    int nerrors = arg_parse(argc, argv, (void **) &cmd_light_photoperiod_args);
+
+    if (nerrors != 0) 
+    {
+        arg_print_errors(stderr, cmd_light_photoperiod_args.end, argv[0u]);
+        return CMD_FUNC_RET_FAILURE;
+    }
+
+    if(1u == cmd_light_photoperiod_args.now->count)
+    {
+        uint16_t now;
+
+        if(!parse_time_of_day(cmd_light_photoperiod_args.now->sval[0u], &now) || ESP_OK != grow_light_set_clock(now))
+        {
+            ESP_LOGE(TAG, "Invalid time of day");
+            return CMD_FUNC_RET_FAILURE;
+        }
+    }
+
+    grow_light_get_config(&config);
+    if(1u == cmd_light_photoperiod_args.start->count)
+    {
+        if(!parse_time_of_day(cmd_light_photoperiod_args.start->sval[0u], &config.start_min))
+        {
+            ESP_LOGE(TAG, "Invalid start of photoperiod");
+            return CMD_FUNC_RET_FAILURE;
+        }
+    }
+    if(1u == cmd_light_photoperiod_args.length->count)
+    {
+        config.duration_min = (uint16_t)(cmd_light_photoperiod_args.length->dval[0u] * 60.0 + 0.5);
+    }
+    if(1u == cmd_light_photoperiod_args.ramp->count)
+    {
+        config.ramp_min = (uint16_t)cmd_light_photoperiod_args.ramp->ival[0u];
+    }
+    if(ESP_OK != grow_light_set_photoperiod(config.start_min, config.duration_min, config.ramp_min))
+    {
+        ESP_LOGE(TAG, "Invalid photoperiod, ramps can take at most half of it");
+        return CMD_FUNC_RET_FAILURE;
+    }
+    return cmd_light_get_info();
+}
+
+static void register_light_photoperiod(void)
+{
+    int num_args = 4;
+    cmd_light_photoperiod_args.start = arg_str0("s", "start", "<HH:MM>", "Start of the photoperiod");
+    cmd_light_photoperiod_args.length = arg_dbl0("l", "length", "<h>", "Length of the photoperiod in hours, 0 - 24");
+    cmd_light_photoperiod_args.ramp = arg_int0("r", "ramp", "<min>", "Length of sunrise and sunset in minutes");
+    cmd_light_photoperiod_args.now = arg_str0("n", "now", "<HH:MM>", "Set current time of day");
+    cmd_light_photoperiod_args.end = arg_end(num_args);
+    const esp_console_cmd_t cmd = {
+        .command = "light_photoperiod",
+        .help = "Sets photoperiod of grow light",
+        .hint = NULL,
+        .func = &cmd_light_photoperiod,
+        .argtable = &cmd_light_photoperiod_args
+    };
+    ESP_ERROR_CHECK( esp_console_cmd_register(&cmd) );
+}
+
+static int cmd_light_dli(int argc, char **argv)
+{
+    grow_light_config_t config;
+    int nerrors = arg_parse(argc, argv, (void **) &cmd_light_dli_args);
+
+    if (nerrors != 0) 
+    {
+        arg_print_errors(stderr, cmd_light_dli_args.end, argv[0u]);
+        return CMD_FUNC_RET_FAILURE;
+    }
+
+    grow_light_get_config(&config);
+    if(1u == cmd_light_dli_args.target->count)
+    {
+        config.target_dli = (float)cmd_light_dli_args.target->dval[0u];
+    }
+    if(1u == cmd_light_dli_args.lamp_ppfd->count)
+    {
+        config.lamp_ppfd = (float)cmd_light_dli_args.lamp_ppfd->dval[0u];
+    }
+    if(ESP_OK != grow_light_set_target_dli(config.target_dli, config.lamp_ppfd))
+    {
+        ESP_LOGE(TAG, "Invalid light integral or lamp PPFD");
+        return CMD_FUNC_RET_FAILURE;
+    }
+    return cmd_light_get_info();
+}
+
+static void register_light_dli(void)
+{
+    int num_args = 2;
+    cmd_light_dli_args.target = arg_dbl0("t", "target", "<mol>", "Daily light integral in mol/m2/day");
+    cmd_light_dli_args.lamp_ppfd = arg_dbl0("m", "lamp", "<ppfd>", "PPFD of the lamp alone at full power in umol/m2/s");
+    cmd_light_dli_args.end = arg_end(num_args);
+    const esp_console_cmd_t cmd = {
+        .command = "light_dli",
+        .help = "Sets target daily light integral, grow light tops up the missing light",
+        .hint = NULL,
+        .func = &cmd_light_dli,
+        .argtable = &cmd_light_dli_args
+    };
+    ESP_ERROR_CHECK( esp_console_cmd_register(&cmd) );
+}
+
+static int cmd_light_sensor_add_point(int argc, char **argv)
+{
+    int nerrors = arg_parse(argc, argv, (void **) &cmd_light_sensor_add_point_args);
+
+    if (nerrors != 0) 
+    {
+        arg_print_errors(stderr, cmd_light_sensor_add_point_args.end, argv[0u]);
+        ESP_LOGE(TAG, "Cannot add calibration point");
+        return CMD_FUNC_RET_FAILURE;
+    }
+    if(1u == cmd_light_sensor_add_point_args.ppfd->count)
+    {
+        float ppfd = (float)cmd_light_sensor_add_point_args.ppfd->dval[0u];
+        float freq = 0.0f;
+
+        if(1u == cmd_light_sensor_add_point_args.freq->count)
+        {
+            freq = (float)cmd_light_sensor_add_point_args.freq->dval[0u];
+        }
+        if(ESP_OK != light_sensor_add_point(freq, ppfd))
+        {
+            ESP_LOGE(TAG, "Failed to add calibration point");
+            return CMD_FUNC_RET_FAILURE;
+        }
+        return cmd_light_sensor_list_points();
+    }
+    else
+    {
+        ESP_LOGE(TAG, "Invalid command arguments");
+        return CMD_FUNC_RET_FAILURE;
+    }
+}
+
+static void register_light_sensor_add_point(void)
+{
+    int num_args = 2;
+    cmd_light_sensor_add_point_args.ppfd = arg_dbl0("p", "ppfd", "<ppfd>", "Reference PPFD in umol/m2/s");
+    cmd_light_sensor_add_point_args.freq = arg_dbl0("f", "freq", "<Hz>", "Frequency, current filtered frequency if omitted");
+    cmd_light_sensor_add_point_args.end = arg_end(num_args);
+    const esp_console_cmd_t cmd = {
+        .command = "light_sensor_cal_add",
+        .help = "Adds calibration point of light sensor",
+        .hint = NULL,
+        .func = &cmd_light_sensor_add_point,
+        .argtable = &cmd_light_sensor_add_point_args
+    };
+    ESP_ERROR_CHECK( esp_console_cmd_register(&cmd) );
+}
+
+static int cmd_light_sensor_remove_point(int argc, char **argv)
+{
+    int nerrors = arg_parse(argc, argv, (void **) &cmd_light_sensor_remove_point_args);
+
+    if (nerrors != 0) 
+    {
+        arg_print_errors(stderr, cmd_light_sensor_remove_point_args.end, argv[0u]);
+        ESP_LOGE(TAG, "Cannot remove calibration point");
+        return CMD_FUNC_RET_FAILURE;
+    }
+    if(1u == cmd_light_sensor_remove_point_args.index->count && 0 <= cmd_light_sensor_remove_point_args.index->ival[0u])
+    {
+        if(ESP_OK != light_sensor_remove_point((uint8_t)cmd_light_sensor_remove_point_args.index->ival[0u]))
+        {
+            ESP_LOGE(TAG, "No such calibration point");
+            return CMD_FUNC_RET_FAILURE;
+        }
+        return cmd_light_sensor_list_points();
+    }
+    else
+    {
+        ESP_LOGE(TAG, "Invalid command arguments");
+        return CMD_FUNC_RET_FAILURE;
+    }
+}
+
+static void register_light_sensor_remove_point(void)
+{
+    int num_args = 1;
+    cmd_light_sensor_remove_point_args.index = arg_int0("n", "number", "<n>", "Point number from light_sensor_cal_list");
+    cmd_light_sensor_remove_point_args.end = arg_end(num_args);
+    const esp_console_cmd_t cmd = {
+        .command = "light_sensor_cal_del",
+        .help = "Removes calibration point of light sensor",
+        .hint = NULL,
+        .func = &cmd_light_sensor_remove_point,
+        .argtable = &cmd_light_sensor_remove_point_args
+    };
+    ESP_ERROR_CHECK( esp_console_cmd_register(&cmd) );
+}
+
+static int cmd_light_sensor_list_points(void)
+{
+    calibration_point_t points[CALIBRATION_MAX_POINTS];
+    uint8_t count = light_sensor_get_points(points);
+
+    printf("No\tFrequency [Hz]\tPPFD [umol/m2/s]\n\r");
+    for(uint8_t i = 0u; i < count; i++)
+    {
+        printf("%d\t%0.1f\t\t%0.1f\n\r", i, points[i].x, points[i].y);
+    }
+    return CMD_FUNC_RET_SUCCESS;
+}
+
+static void register_light_sensor_list_points(void)
+{
+    const esp_console_cmd_t cmd = {
+        .command = "light_sensor_cal_list",
+        .help = "Prints calibration points of light sensor",
+        .hint = NULL,
+        .func = &cmd_light_sensor_list_points,
+    };
+    ESP_ERROR_CHECK( esp_console_cmd_register(&cmd) );
+}
+
+static bool parse_time_of_day(const char *text, uint16_t* const minute_of_day)
+{
+    unsigned int hours;
+    unsigned int minutes;
+
+    if(2 != sscanf(text, "%u:%u", &hours, &minutes) || 24u <= hours || 60u <= minutes)
+    {
+        return false;
+    }
+    *minute_of_day = (uint16_t)(hours * 60u + minutes);
+    return true;
+}
+
+static int cmd_water_tank_switches(void)
+{
+    static const char *names[WATER_TANK_SWITCHES_NUM] = {"Min", "Max"};
+    const float freqs[WATER_TANK_SWITCHES_NUM] = {water_tank_get_min_freq(), water_tank_get_max_freq()};
+    tank_level_switch_state_t state;
+
+    printf("Switch\tState\tTrips\tLast trip [s ago]\tFrequency [Hz]\n\r");
+    for(uint8_t i = 0u; i < WATER_TANK_SWITCHES_NUM; i++)
+    {
+        tank_level_switch_get_state((water_tank_switch_t)i, &state);
+        printf("%s\t%s\t%"PRIu32"\t", names[i], state.active ? "active" : "idle", state.trip_count);
+        if(0 != state.last_trip_us)
+        {
+            printf("%"PRId64"\t\t\t", (esp_timer_get_time() - state.last_trip_us) / 1000000);
+        }
+        else
+        {
+            printf("-\t\t\t");
+        }
+        printf("%0.3f\n\r", freqs[i]);
+    }
+    return CMD_FUNC_RET_SUCCESS;
+}
+
+static void register_water_tank_switches(void)
+{
+    const esp_console_cmd_t cmd = {
+        .command = "water_tank_switches",
+        .help = "Prints state of tank level switches and frequencies calibrated by them",
+        .hint = NULL,
+        .func = &cmd_water_tank_switches,
+    };
+    ESP_ERROR_CHECK( esp_console_cmd_register(&cmd) );
+}
+
+static int cmd_flood_status(void)
+{
+    flood_protection_status_t status;
+
+    flood_protection_get_status(&status);
+    printf("Flood fault: %s, sensor: %s, floods: %"PRIu32"\n\r", status.latched ? "LATCHED" : "clear",
+           status.sensor_active ? "wet" : "dry", status.event_count);
+    if(0 != status.last_event_us)
+    {
+        printf("Last flood: %"PRId64" s ago\n\r", (esp_timer_get_time() - status.last_event_us) / 1000000);
+    }
+    printf("Interrupt to outputs off: last %"PRIu32" ns, worst %"PRIu32" ns\n\r", status.isr_confirm_ns, status.isr_confirm_max_ns);
+    printf("Self test detect to off: last %"PRIu32" ns, worst %"PRIu32" ns\n\r", status.test_latency_ns, status.test_latency_max_ns);
+    return CMD_FUNC_RET_SUCCESS;
+}
+
+static void register_flood_status(void)
+{
+    const esp_console_cmd_t cmd = {
+        .command = "flood_status",
+        .help = "Prints flood fault state and measured pump cut-off latency",
+        .hint = NULL,
+        .func = &cmd_flood_status,
+    };
+    ESP_ERROR_CHECK( esp_console_cmd_register(&cmd) );
+}
+
+static int cmd_flood_clear(void)
+{
+    if(ESP_OK != flood_protection_clear())
+    {
+        ESP_LOGE(TAG, "Flood sensor still detects water");
+        return CMD_FUNC_RET_FAILURE;
+    }
+    return CMD_FUNC_RET_SUCCESS;
+}
+
+static void register_flood_clear(void)
+{
+    const esp_console_cmd_t cmd = {
+        .command = "flood_clear",
+        .help = "Clears latched flood fault, pumps have to be started again",
+        .hint = NULL,
+        .func = &cmd_flood_clear,
+    };
+    ESP_ERROR_CHECK( esp_console_cmd_register(&cmd) );
+}
+
+static int cmd_flood_test(void)
+{
+    if(ESP_OK != actuators_flood_test())
+    {
+        ESP_LOGE(TAG, "Flood cut-off test failed");
+        return CMD_FUNC_RET_FAILURE;
+    }
+    return cmd_flood_status();
+}
+
+static void register_flood_test(void)
+{
+    const esp_console_cmd_t cmd = {
+        .command = "flood_test",
+        .help = "Tests flood cut-off of the pumps, runs the cooling pump at full speed for about 40 ms",
+        .hint = NULL,
+        .func = &cmd_flood_test,
+    };
+    ESP_ERROR_CHECK( esp_console_cmd_register(&cmd) );
+}
+
+static int cmd_sched_stats(void)
+{
+    scheduler_stats_t stats;
+    scheduler_job_stats_t job;
+    float uptime_s;
+
+    scheduler_get_stats(&stats);
+    uptime_s = (float)(esp_timer_get_time() - stats.started_us) * 1.0e-6f;
+    if(0.0f >= uptime_s)
+    {
+        uptime_s = 1.0f;
+    }
+
+    printf("Free heap: %"PRIu32" B, minimum: %"PRIu32" B, tasks: %u\n\r", esp_get_free_heap_size(),
+           esp_get_minimum_free_heap_size(), (unsigned)uxTaskGetNumberOfTasks());
+    printf("Scheduler wake-ups: %"PRIu32" (%0.1f/s), worker runs: %"PRIu32" (%0.1f/s), workers: %u\n\r",
+           stats.wakeups, (float)stats.wakeups / uptime_s, stats.dispatches, (float)stats.dispatches / uptime_s,
+           stats.workers_num);
+    printf("Job\t\t\tRuns on\tPeriod [ms]\tRuns\tOverruns\tMisses\tLast [us]\tMax [us]\n\r");
+    for(scheduler_job_id_t i = 0u; i < stats.jobs_num; i++)
+    {
+        if(ESP_OK == scheduler_get_job_stats(i, &job))
+        {
+            printf("%-24s%s\t%"PRIu32"\t\t%"PRIu32"\t%"PRIu32"\t\t%"PRIu32"\t%"PRIu32"\t\t%"PRIu32"\n\r", job.name,
+                   (SCHEDULER_EXEC_WORKER == job.exec) ? "worker" : "inline", job.period_ms, job.runs, job.overruns,
+                   job.deadline_misses, job.last_us, job.max_us);
+        }
+    }
+    return CMD_FUNC_RET_SUCCESS;
+}
+
+static void register_sched_stats(void)
+{
+    const esp_console_cmd_t cmd = {
+        .command = "sched_stats",
+        .help = "Prints free heap, scheduler wake-ups, execution times and deadline misses of the periodic jobs",
+        .hint = NULL,
+        .func = &cmd_sched_stats,
+    };
+    ESP_ERROR_CHECK( esp_console_cmd_register(&cmd) );
+}
+
+static int cmd_data_store(int argc, char **argv)
+{
+    data_store_snapshot_t snapshot;
+    data_store_sample_t sample;
+    TaskHandle_t self = xTaskGetCurrentTaskHandle();
+    TickType_t end;
+    uint32_t bits;
+    int nerrors = arg_parse(argc, argv, (void **) &cmd_data_store_args);
+
+    if (nerrors != 0) 
+    {
+        arg_print_errors(stderr, cmd_data_store_args.end, argv[0u]);
+        return CMD_FUNC_RET_FAILURE;
+    }
+
+    printf("Signal\t\t\tValue\t\tUnit\t\tAge [ms]\tQuality\n\r");
+    if(0 == cmd_data_store_args.watch->count)
+    {
+        data_store_get_snapshot(&snapshot);
+        for(uint8_t i = 0u; i < DATA_STORE_SIGNALS_NUM; i++)
+        {
+            cmd_data_store_print((data_store_signal_t)i, &snapshot.samples[i]);
+        }
+        return CMD_FUNC_RET_SUCCESS;
+    }
+
+    if(0 >= cmd_data_store_args.watch->ival[0u])
+    {
+        ESP_LOGE(TAG, "Watch time has to be positive");
+        return CMD_FUNC_RET_FAILURE;
+    }
+    if(ESP_OK != data_store_subscribe(self, (uint32_t)((1ull << DATA_STORE_SIGNALS_NUM) - 1u)))
+    {
+        ESP_LOGE(TAG, "No free subscription");
+        return CMD_FUNC_RET_FAILURE;
+    }
+    /* Drop changes notified before this watch */
+    xTaskNotifyWait(0u, UINT32_MAX, NULL, 0u);
+    end = xTaskGetTickCount() + pdMS_TO_TICKS((uint32_t)cmd_data_store_args.watch->ival[0u] * 1000u);
+    while(0 < (int32_t)(end - xTaskGetTickCount()))
+    {
+        if(pdTRUE != xTaskNotifyWait(0u, UINT32_MAX, &bits, end - xTaskGetTickCount()))
+        {
+            continue;
+        }
+        for(uint8_t i = 0u; i < DATA_STORE_SIGNALS_NUM; i++)
+        {
+            if(0u != (bits & DATA_STORE_BIT(i)) && ESP_OK == data_store_get((data_store_signal_t)i, &sample))
+            {
+                cmd_data_store_print((data_store_signal_t)i, &sample);
+            }
+        }
+    }
+    data_store_unsubscribe(self);
+    return CMD_FUNC_RET_SUCCESS;
+}
+
+static void cmd_data_store_print(data_store_signal_t signal, const data_store_sample_t* const sample)
+{
+    printf("%-24s", data_store_get_name(signal));
+    if(DATA_STORE_QUALITY_NONE == sample->quality)
+    {
+        printf("-\t\t%-16s-\t\t", data_store_get_unit(signal));
+    }
+    else
+    {
+        if(DATA_STORE_TYPE_BOOL == data_store_get_type(signal))
+        {
+            printf("%-16s", sample->value.b ? "yes" : "no");
+        }
+        else
+        {
+            printf("%-16.2f", sample->value.f);
+        }
+        printf("%-16s%"PRId64"\t\t", data_store_get_unit(signal), (esp_timer_get_time() - sample->timestamp_us) / 1000);
+    }
+    printf("%s\n\r", data_store_get_quality_name(sample->quality));
+}
+
+static void register_data_store(void)
+{
+    int num_args = 1;
+    cmd_data_store_args.watch = arg_int0("w", "watch", "<s>", "Print changes of the signals for given number of seconds");
+    cmd_data_store_args.end = arg_end(num_args);
+    const esp_console_cmd_t cmd = {
+        .command = "data_store",
+        .help = "Prints value, age and quality of all signals of the data store",
+        .hint = NULL,
+        .func = &cmd_data_store,
+        .argtable = &cmd_data_store_args
+    };
+    ESP_ERROR_CHECK( esp_console_cmd_register(&cmd) );
+}
+
+static int cmd_outputs(int argc, char **argv)
+{
+    actuators_batch_t batch = {0};
+    int nerrors = arg_parse(argc, argv, (void **) &cmd_outputs_args);
+
+    if (nerrors != 0) 
+    {
+        arg_print_errors(stderr, cmd_outputs_args.end, argv[0u]);
+        return CMD_FUNC_RET_FAILURE;
+    }
+
+    for(uint8_t i = 0u; i < ACTUATORS_NUM; i++)
+    {
+        if(0 != cmd_outputs_args.level[i]->count)
+        {
+            actuators_batch_set(&batch, (actuator_t)i, (float)cmd_outputs_args.level[i]->dval[0u]);
+        }
+    }
+    if(cooling_control_is_auto() && 0u != (batch.mask & (ACTUATOR_BIT(ACTUATOR_PELTIER) | ACTUATOR_BIT(ACTUATOR_COOLING_PUMP) |
+                                                         ACTUATOR_BIT(ACTUATOR_COOLING_VENTILATOR))))
+    {
+        ESP_LOGE(TAG, "Cooling outputs are in closed loop control, switch it to manual with cooling_ctl -m");
+        return CMD_FUNC_RET_FAILURE;
+    }
+    if(0u != batch.mask && ESP_OK != actuators_apply(&batch))
+    {
+        ESP_LOGE(TAG, "Levels not applied, out of range or pump inhibited by flood");
+        return CMD_FUNC_RET_FAILURE;
+    }
+
+    for(uint8_t i = 0u; i < ACTUATORS_NUM; i++)
+    {
+        printf("%-24s%.1f %%%s\n\r", actuators_get_name((actuator_t)i), actuators_get_level((actuator_t)i),
+               (0u != (actuators_get_inhibited() & ACTUATOR_BIT(i))) ? " (inhibited)" : "");
+    }
+    return CMD_FUNC_RET_SUCCESS;
+}
+
+static void register_outputs(void)
+{
+    int num_args = ACTUATORS_NUM;
+    cmd_outputs_args.level[ACTUATOR_COOLING_PUMP] = arg_dbl0("c", "cooling_pump", "<s>", "Cooling pump level in 0-100 percent");
+    cmd_outputs_args.level[ACTUATOR_WATERING_PUMP] = arg_dbl0("w", "watering_pump", "<s>", "Watering pump level in 0-100 percent");
+    cmd_outputs_args.level[ACTUATOR_COOLING_VENTILATOR] = arg_dbl0("v", "cooling_ventilator", "<s>", "Cooling ventilator level in 0-100 percent");
+    cmd_outputs_args.level[ACTUATOR_DEHUMYFING_VENTILATOR] = arg_dbl0("d", "dehumyfing_ventilator", "<s>", "Dehumyfing ventilator level in 0-100 percent");
+    cmd_outputs_args.level[ACTUATOR_PELTIER] = arg_dbl0("p", "peltier", "<s>", "Peltier level in 0-100 percent");
+    cmd_outputs_args.end = arg_end(num_args);
+    const esp_console_cmd_t cmd = {
+        .command = "outputs",
+        .help = "Prints levels of the PWM outputs, given levels are applied together in one update",
+        .hint = NULL,
+        .func = &cmd_outputs,
+        .argtable = &cmd_outputs_args
+    };
+    ESP_ERROR_CHECK( esp_console_cmd_register(&cmd) );
+}
+
+static int cmd_top(int argc, char **argv)
+{
+    static task_stats_t stats;
+    int delay_ms = 1000;
+    int count = 1;
+    int nerrors = arg_parse(argc, argv, (void **) &cmd_top_args);
+
+    if (nerrors != 0) 
+    {
+        arg_print_errors(stderr, cmd_top_args.end, argv[0u]);
+        return CMD_FUNC_RET_FAILURE;
+    }
+    if(0 != cmd_top_args.delay->count)
+    {
+        delay_ms = cmd_top_args.delay->ival[0u];
+    }
+    if(0 != cmd_top_args.count->count)
+    {
+        count = cmd_top_args.count->ival[0u];
+    }
+    if(10 > delay_ms || 0 >= count)
+    {
+        ESP_LOGE(TAG, "Delay has to be at least 10 ms and count positive");
+        return CMD_FUNC_RET_FAILURE;
+    }
+
+    /* Every refresh measures CPU usage over its own delay */
+    for(int i = 0; i < count; i++)
+    {
+        if(ESP_OK != task_stats_measure((uint32_t)delay_ms, &stats))
+        {
+            ESP_LOGE(TAG, "More than %u tasks", (unsigned)TASK_STATS_MAX_TASKS);
+            return CMD_FUNC_RET_FAILURE;
+        }
+        if(0 != cmd_top_args.machine->count)
+        {
+            cmd_top_print_json(&stats);
+        }
+        else
+        {
+            cmd_top_print(&stats);
+        }
+    }
+    return CMD_FUNC_RET_SUCCESS;
+}
+
+static void cmd_top_print(task_stats_t* const stats)
+{
+    task_stats_task_t task;
+    char core[4];
+
+    for(uint8_t i = 1u; i < stats->tasks_num; i++)
+    {
+        task = stats->tasks[i];
+        uint8_t j = i;
+        while(0u < j && stats->tasks[j - 1u].cpu < task.cpu)
+        {
+            stats->tasks[j] = stats->tasks[j - 1u];
+            j--;
+        }
+        stats->tasks[j] = task;
+    }
+
+    printf("\n\rWindow: %"PRIu32" ms, load:", stats->window_us / 1000u);
+    for(uint8_t i = 0u; i < portNUM_PROCESSORS; i++)
+    {
+        printf(" core %u %0.1f %%", (unsigned)i, stats->core_load[i]);
+    }
+    printf("\n\rHeap free: %"PRIu32" B, minimum: %"PRIu32" B, largest block: %"PRIu32" B\n\r",
+           stats->heap_free, stats->heap_min, stats->heap_largest);
+    printf("Task\t\t\tCore\tPrio\tState\tCPU [%%]\tStack free [B]\n\r");
+    for(uint8_t i = 0u; i < stats->tasks_num; i++)
+    {
+        if(tskNO_AFFINITY == stats->tasks[i].core)
+        {
+            strlcpy(core, "-", sizeof(core));
+        }
+        else
+        {
+            snprintf(core, sizeof(core), "%d", (int)stats->tasks[i].core);
+        }
+        printf("%-24s%s\t%u\t%s\t%0.1f\t%"PRIu32"\n\r", stats->tasks[i].name, core,
+               (unsigned)stats->tasks[i].priority, task_stats_get_state_name(stats->tasks[i].state),
+               stats->tasks[i].cpu, stats->tasks[i].stack_free);
+    }
+}
+
+static void cmd_top_print_json(const task_stats_t* const stats)
+{
+    printf("{\"window_us\":%"PRIu32",\"heap_free\":%"PRIu32",\"heap_min\":%"PRIu32",\"heap_largest\":%"PRIu32
+           ",\"core_load\":[", stats->window_us, stats->heap_free, stats->heap_min, stats->heap_largest);
+    for(uint8_t i = 0u; i < portNUM_PROCESSORS; i++)
+    {
+        printf("%s%0.2f", (0u == i) ? "" : ",", stats->core_load[i]);
+    }
+    printf("],\"tasks\":[");
+    for(uint8_t i = 0u; i < stats->tasks_num; i++)
+    {
+        printf("%s{\"name\":\"%s\",\"core\":%d,\"prio\":%u,\"state\":\"%s\",\"cpu\":%0.2f,\"stack_free\":%"PRIu32"}",
+               (0u == i) ? "" : ",", stats->tasks[i].name,
+               (tskNO_AFFINITY == stats->tasks[i].core) ? -1 : (int)stats->tasks[i].core,
+               (unsigned)stats->tasks[i].priority, task_stats_get_state_name(stats->tasks[i].state),
+               stats->tasks[i].cpu, stats->tasks[i].stack_free);
+    }
+    printf("]}\n\r");
+}
+
+static void register_top(void)
+{
+    int num_args = 3;
+    cmd_top_args.delay = arg_int0("d", "delay", "<ms>", "Measurement window and refresh period, 1000 ms by default");
+    cmd_top_args.count = arg_int0("n", "count", "<n>", "Number of refreshes, 1 by default");
+    cmd_top_args.machine = arg_lit0("m", "machine", "Print one line of JSON per refresh");
+    cmd_top_args.end = arg_end(num_args);
+    const esp_console_cmd_t cmd = {
+        .command = "top",
+        .help = "Prints CPU usage, priority, core, state and free stack of all tasks and heap usage",
+        .hint = NULL,
+        .func = &cmd_top,
+        .argtable = &cmd_top_args
+    };
+    ESP_ERROR_CHECK( esp_console_cmd_register(&cmd) );
+}
+
+static int cmd_perf(int argc, char **argv)
+{
+    perf_stats_t stats;
+    const float us_per_cycle = 1.0f / (float)CONFIG_ESP32_DEFAULT_CPU_FREQ_MHZ;
+    int nerrors = arg_parse(argc, argv, (void **) &cmd_perf_args);
+
+    if (nerrors != 0) 
+    {
+        arg_print_errors(stderr, cmd_perf_args.end, argv[0u]);
+        return CMD_FUNC_RET_FAILURE;
+    }
+
+    printf("Probe\t\t\tCount\tMin [us]\tP50 [us]\tP99 [us]\tMax [us]\tMax [cycles]\n\r");
+    for(uint8_t i = 0u; i < PERF_PROBES_NUM; i++)
+    {
+        if(ESP_ERR_NOT_SUPPORTED == perf_get_stats((perf_probe_t)i, &stats))
+        {
+            ESP_LOGE(TAG, "Instrumentation is disabled, enable CONFIG_DONICZKA_PERF");
+            return CMD_FUNC_RET_FAILURE;
+        }
+        printf("%-24s%"PRIu32"\t%0.1f\t\t%0.1f\t\t%0.1f\t\t%0.1f\t\t%"PRIu32"\n\r", perf_get_name((perf_probe_t)i),
+               stats.count, stats.min * us_per_cycle, stats.p50 * us_per_cycle, stats.p99 * us_per_cycle,
+               stats.max * us_per_cycle, stats.max);
+        if(0u != stats.dropped)
+        {
+            printf("\t%"PRIu32" spans ended on the other core and were dropped\n\r", stats.dropped);
+        }
+    }
+    printf("Percentiles are upper bounds of power of two buckets, times at %d MHz\n\r", CONFIG_ESP32_DEFAULT_CPU_FREQ_MHZ);
+
+    if(0 != cmd_perf_args.reset->count)
+    {
+        perf_reset();
+    }
+    return CMD_FUNC_RET_SUCCESS;
+}
+
+static void register_perf(void)
+{
+    int num_args = 1;
+    cmd_perf_args.reset = arg_lit0("r", "reset", "Clear the histograms after printing");
+    cmd_perf_args.end = arg_end(num_args);
+    const esp_console_cmd_t cmd = {
+        .command = "perf",
+        .help = "Prints min, median, 99th percentile and max duration of sensor driver calls and critical sections",
+        .hint = NULL,
+        .func = &cmd_perf,
+        .argtable = &cmd_perf_args
+    };
+    ESP_ERROR_CHECK( esp_console_cmd_register(&cmd) );
+}
+
+static int cmd_trace(int argc, char **argv)
+{
+    bool recording;
+    uint32_t records;
+    uint32_t lost;
+    int nerrors = arg_parse(argc, argv, (void **) &cmd_trace_args);
+
+    if (nerrors != 0) 
+    {
+        arg_print_errors(stderr, cmd_trace_args.end, argv[0u]);
+        return CMD_FUNC_RET_FAILURE;
+    }
+    if(ESP_OK != trace_get_status(&recording, &records, &lost))
+    {
+        ESP_LOGE(TAG, "Tracing is disabled, enable CONFIG_DONICZKA_TRACE");
+        return CMD_FUNC_RET_FAILURE;
+    }
+
+    if(0 != cmd_trace_args.start->count)
+    {
+        trace_start();
+    }
+    if(0 != cmd_trace_args.dump->count)
+    {
+        trace_dump();
+    }
+    if(0 != cmd_trace_args.stop->count)
+    {
+        trace_stop();
+    }
+    trace_get_status(&recording, &records, &lost);
+    printf("Trace %s, records: %"PRIu32", overwritten: %"PRIu32"\n\r", recording ? "recording" : "stopped", records, lost);
+    return CMD_FUNC_RET_SUCCESS;
+}
+
+static void register_trace(void)
+{
+    int num_args = 3;
+    cmd_trace_args.start = arg_lit0("s", "start", "Clear the buffer and start recording");
+    cmd_trace_args.stop = arg_lit0("t", "stop", "Stop recording, keep the buffer");
+    cmd_trace_args.dump = arg_lit0("d", "dump", "Print the buffer for tools/trace_to_chrome.py");
+    cmd_trace_args.end = arg_end(num_args);
+    const esp_console_cmd_t cmd = {
+        .command = "trace",
+        .help = "Records task switches, driver calls, commands and actuator writes of both cores",
+        .hint = NULL,
+        .func = &cmd_trace,
+        .argtable = &cmd_trace_args
+    };
+    ESP_ERROR_CHECK( esp_console_cmd_register(&cmd) );
+}
+
+static int cmd_pm_stats(int argc, char **argv)
+{
+    float power;
+    esp_err_t ret = power_dump(stdout);
+
+    if(ESP_ERR_NOT_SUPPORTED == ret)
+    {
+        ESP_LOGE(TAG, "Power management is disabled, enable CONFIG_PM_ENABLE");
+        return CMD_FUNC_RET_FAILURE;
+    }
+    if(ESP_OK != ret)
+    {
+        ESP_LOGE(TAG, "Could not read power management state");
+        return CMD_FUNC_RET_FAILURE;
+    }
+    if(ESP_OK == data_store_get_float(DATA_STORE_SUPPLY_POWER, &power))
+    {
+        printf("Supply power: %0.2f W\n\r", power);
+    }
+    else
+    {
+        printf("Supply power: no valid measurement\n\r");
+    }
+    return CMD_FUNC_RET_SUCCESS;
+}
+
+static void register_pm_stats(void)
+{
+    const esp_console_cmd_t cmd = {
+        .command = "pm_stats",
+        .help = "Prints frequency scaling limits, held locks, time spent in active and light sleep modes and supply power",
+        .hint = NULL,
+        .func = &cmd_pm_stats,
+    };
+    ESP_ERROR_CHECK( esp_console_cmd_register(&cmd) );
+}
+
+static int cmd_cooling_ctl(int argc, char **argv)
+{
+    cooling_control_status_t status;
+    int nerrors = arg_parse(argc, argv, (void **) &cmd_cooling_ctl_args);
+
+    if (nerrors != 0) 
+    {
+        arg_print_errors(stderr, cmd_cooling_ctl_args.end, argv[0u]);
+        return CMD_FUNC_RET_FAILURE;
+    }
+    if(0 != cmd_cooling_ctl_args.auto_mode->count && 0 != cmd_cooling_ctl_args.manual->count)
+    {
+        ESP_LOGE(TAG, "Choose either closed loop or manual control");
+        return CMD_FUNC_RET_FAILURE;
+    }
+
+    cooling_control_get_status(&status);
+    if(0 != cmd_cooling_ctl_args.setpoint->count || 0 != cmd_cooling_ctl_args.hot_setpoint->count)
+    {
+        float root_setpoint = status.root_setpoint;
+        float hot_setpoint = status.hot_setpoint;
+
+        if(0 != cmd_cooling_ctl_args.setpoint->count)
+        {
+            root_setpoint = (float)cmd_cooling_ctl_args.setpoint->dval[0u];
+        }
+        if(0 != cmd_cooling_ctl_args.hot_setpoint->count)
+        {
+            hot_setpoint = (float)cmd_cooling_ctl_args.hot_setpoint->dval[0u];
+        }
+        if(ESP_OK != cooling_control_set_setpoints(root_setpoint, hot_setpoint))
+        {
+            ESP_LOGE(TAG, "Setpoint out of range");
+            return CMD_FUNC_RET_FAILURE;
+        }
+    }
+    if(0 != cmd_cooling_ctl_args.kp->count || 0 != cmd_cooling_ctl_args.ki->count ||
+       0 != cmd_cooling_ctl_args.kd->count || 0 != cmd_cooling_ctl_args.slew->count)
+    {
+        cooling_loop_t loop = COOLING_LOOPS_NUM;
+        pid_config_t tuning;
+
+        for(uint8_t i = 0u; 0 != cmd_cooling_ctl_args.loop->count && i < COOLING_LOOPS_NUM; i++)
+        {
+            if(0 == strcmp(cmd_cooling_ctl_args.loop->sval[0u], cooling_control_get_loop_name((cooling_loop_t)i)))
+            {
+                loop = (cooling_loop_t)i;
+            }
+        }
+        if(COOLING_LOOPS_NUM == loop)
+        {
+            ESP_LOGE(TAG, "Give the loop to tune: root, cold or hot");
+            return CMD_FUNC_RET_FAILURE;
+        }
+        tuning = status.loops[loop].tuning;
+        if(0 != cmd_cooling_ctl_args.kp->count)
+        {
+            tuning.kp = (float)cmd_cooling_ctl_args.kp->dval[0u];
+        }
+        if(0 != cmd_cooling_ctl_args.ki->count)
+        {
+            tuning.ki = (float)cmd_cooling_ctl_args.ki->dval[0u];
+        }
+        if(0 != cmd_cooling_ctl_args.kd->count)
+        {
+            tuning.kd = (float)cmd_cooling_ctl_args.kd->dval[0u];
+        }
+        if(0 != cmd_cooling_ctl_args.slew->count)
+        {
+            tuning.slew_rate = (float)cmd_cooling_ctl_args.slew->dval[0u];
+        }
+        if(ESP_OK != cooling_control_set_tuning(loop, &tuning))
+        {
+            ESP_LOGE(TAG, "Gains and slew rate cannot be negative");
+            return CMD_FUNC_RET_FAILURE;
+        }
+    }
+    if(0 != cmd_cooling_ctl_args.auto_mode->count)
+    {
+        cooling_control_set_auto(true);
+    }
+    if(0 != cmd_cooling_ctl_args.manual->count)
+    {
+        cooling_control_set_auto(false);
+    }
+    if(0 != cmd_cooling_ctl_args.clear->count)
+    {
+        cooling_control_reset_stats();
+    }
+
+    cooling_control_get_status(&status);
+    printf("Control: %s, faults: %"PRIu32"\n\r", status.auto_mode ? "closed loop" : "manual", status.faults);
+    printf("Root zone setpoint: %0.1f C, hot side setpoint: %0.1f C\n\r", status.root_setpoint, status.hot_setpoint);
+    printf("%-6s%-7s%-9s%-9s%-9s%-9s%-8s%-8s%-8s%-8s%-9s%-9s%-11s\n\r", "Loop", "Probe", "Setp", "Meas", "Out",
+           "Integ", "Kp", "Ki", "Kd", "Slew/s", "Runs", "Max us", "Jitter us");
+    for(uint8_t i = 0u; i < COOLING_LOOPS_NUM; i++)
+    {
+        const cooling_loop_status_t *loop = &status.loops[i];
+
+        printf("%-6s%-7u%-9.2f%-9.2f%-9.2f%-9.2f%-8.3f%-8.3f%-8.3f%-8.2f%-9"PRIu32"%-9"PRIu32"%"PRIu32"/%"PRIu32"%s%s\n\r",
+               cooling_control_get_loop_name((cooling_loop_t)i), (unsigned)status.probe[i], loop->setpoint,
+               loop->measurement, loop->output, loop->integral, loop->tuning.kp, loop->tuning.ki, loop->tuning.kd,
+               loop->tuning.slew_rate, loop->runs, loop->max_us, loop->last_jitter_us, loop->max_jitter_us,
+               loop->valid ? "" : " (no probe)", loop->limited ? " (limited)" : "");
+    }
+    return CMD_FUNC_RET_SUCCESS;
+}
+
+static void register_cooling_ctl(void)
+{
+    int num_args = 10;
+    cmd_cooling_ctl_args.auto_mode = arg_lit0("a", "auto", "Closed loop control of Peltier, cooling pump and ventilator");
+    cmd_cooling_ctl_args.manual = arg_lit0("m", "manual", "Manual control, outputs keep their levels");
+    cmd_cooling_ctl_args.setpoint = arg_dbl0("s", "setpoint", "<C>", "Root zone temperature");
+    cmd_cooling_ctl_args.hot_setpoint = arg_dbl0("t", "hot", "<C>", "Hot side temperature");
+    cmd_cooling_ctl_args.loop = arg_str0("l", "loop", "<root|cold|hot>", "Loop to tune");
+    cmd_cooling_ctl_args.kp = arg_dbl0("p", "kp", "<gain>", "Proportional gain");
+    cmd_cooling_ctl_args.ki = arg_dbl0("i", "ki", "<gain>", "Integral gain per second");
+    cmd_cooling_ctl_args.kd = arg_dbl0("d", "kd", "<gain>", "Derivative gain in seconds");
+    cmd_cooling_ctl_args.slew = arg_dbl0("r", "slew", "<rate>", "Largest output change per second, 0 disables");
+    cmd_cooling_ctl_args.clear = arg_lit0("c", "clear", "Clear timing statistics and fault counter");
+    cmd_cooling_ctl_args.end = arg_end(num_args);
+    const esp_console_cmd_t cmd = {
+        .command = "cooling_ctl",
+        .help = "Prints state and timing of the cascaded cooling loops, switches closed loop control, sets setpoints and tunes the loops",
+        .hint = NULL,
+        .func = &cmd_cooling_ctl,
+        .argtable = &cmd_cooling_ctl_args
+    };
+    ESP_ERROR_CHECK( esp_console_cmd_register(&cmd) );
+}
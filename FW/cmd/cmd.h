@@ -1,6 +1,6 @@
-#pragma once
-
-/**
- * @brief Registers all defined commands
- */
+#pragma once
+
+/**
+ * @brief Registers all defined commands
+ */
 void register_cmd(void);
\ No newline at end of file
@@ -1,7 +1,7 @@
-#pragma once
-
-/**
- * @brief Console interface task
- * @param pvParamater parameter of task (not used)
- */
+#pragma once
+
+/**
+ * @brief Console interface task
+ * @param pvParamater parameter of task (not used)
+ */
 void console_interface_task(void *pvParameter);
\ No newline at end of file
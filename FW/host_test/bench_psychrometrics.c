@@ -0,0 +1,64 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+#include "psychrometrics.h"
+#include "goff_gratch.h"
+
+#define RUNS 1000000u
+
+/* Results are summed into a volatile, so the compiler keeps every call */
+static volatile double sink;
+
+/**
+ * @brief Gets time of a monotonic clock
+ *
+ * @return time in ns
+ */
+static double bench_now_ns(void);
+
+/**
+ * @brief Prints time of one call
+ *
+ * @param name name of the measured function
+ * @param start_ns time before the calls
+ */
+static void bench_report(const char *name, double start_ns);
+
+int main(void)
+{
+    double start;
+    float sum_f = 0.0f;
+    double sum_d = 0.0;
+
+    /* Inputs sweep the range of the sensor, so no branch or cache gets a constant input */
+    start = bench_now_ns();
+    for (uint32_t i = 0u; i < RUNS; i++)
+    {
+        sum_f += psychrometrics_dew_point((float)(i % 1200u) * 0.1f - 40.0f, (float)(i % 991u) * 0.1f + 1.0f);
+    }
+    sink = sum_f;
+    bench_report("psychrometrics_dew_point", start);
+
+    start = bench_now_ns();
+    for (uint32_t i = 0u; i < RUNS; i++)
+    {
+        sum_d += goff_gratch_dew_point((double)(i % 1200u) * 0.1 - 40.0, (double)(i % 991u) * 0.1 + 1.0);
+    }
+    sink = sum_d;
+    bench_report("goff_gratch_dew_point", start);
+
+    return 0;
+}
+
+static double bench_now_ns(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec * 1e9 + (double)now.tv_nsec;
+}
+
+static void bench_report(const char *name, double start_ns)
+{
+    printf("%-26s %8.1f ns per call\n", name, (bench_now_ns() - start_ns) / RUNS);
+}
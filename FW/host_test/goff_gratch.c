@@ -0,0 +1,21 @@
+#include <math.h>
+#include "goff_gratch.h"
+
+double goff_gratch_saturation_pressure(double celsius)
+{
+    double ratio = 373.15 / (273.15 + celsius);
+    double rhs = -7.90298 * (ratio - 1.0);
+    rhs += 5.02808 * log10(ratio);
+    rhs += -1.3816e-7 * (pow(10.0, 11.344 * (1.0 - 1.0 / ratio)) - 1.0);
+    rhs += 8.1328e-3 * (pow(10.0, -3.49149 * (ratio - 1.0)) - 1.0);
+    rhs += log10(1013.246);
+
+    /* Factor -1 converts hPa to kPa */
+    return pow(10.0, rhs - 1.0);
+}
+
+double goff_gratch_dew_point(double celsius, double humidity)
+{
+    double t = log(goff_gratch_saturation_pressure(celsius) * humidity * 0.01 / 0.61078);
+    return 241.88 * t / (17.558 - t);
+}
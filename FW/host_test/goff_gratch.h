@@ -0,0 +1,20 @@
+#pragma once
+
+/* Double precision Goff-Gratch formulas the firmware used before psychrometrics.c */
+
+/**
+ * @brief Saturation vapour pressure over water, Goff-Gratch formula
+ *
+ * @param celsius temperature in celsius deg
+ * @return saturation vapour pressure in kPa
+ */
+double goff_gratch_saturation_pressure(double celsius);
+
+/**
+ * @brief Dew point from the Goff-Gratch saturation vapour pressure
+ *
+ * @param celsius temperature in celsius deg
+ * @param humidity relative humidity in percent
+ * @return dew point in celsius deg
+ */
+double goff_gratch_dew_point(double celsius, double humidity);
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <stdio.h>
+
+/* Failed checks of the test program, reported by host_test_result */
+static unsigned host_test_failures;
+
+/**
+ * @brief Reports a failed condition and lets the test continue
+ */
+#define CHECK(condition)                                                        \
+    do                                                                          \
+    {                                                                           \
+        if (!(condition))                                                       \
+        {                                                                       \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+            host_test_failures++;                                               \
+        }                                                                       \
+    } while (0)
+
+/**
+ * @brief Prints the summary of the test program
+ *
+ * @param name name of the tested module
+ * @return exit code of the test program, 0 if all checks passed
+ */
+static inline int host_test_result(const char *name)
+{
+    printf("%s: %s\n", name, (0u == host_test_failures) ? "passed" : "FAILED");
+    return (0u == host_test_failures) ? 0 : 1;
+}
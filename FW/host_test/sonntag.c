@@ -0,0 +1,41 @@
+#include <math.h>
+#include "sonntag.h"
+
+/* Bisection stops once the interval is below 1e-9 C deg */
+#define SONNTAG_DEW_POINT_MIN   -100.0
+#define SONNTAG_ITERATIONS      60
+
+double sonntag_saturation_pressure(double celsius)
+{
+    double kelvin = celsius + 273.15;
+    double ln_ew = -6096.9385 / kelvin;
+    ln_ew += 16.635794;
+    ln_ew += -2.711193e-2 * kelvin;
+    ln_ew += 1.673952e-5 * kelvin * kelvin;
+    ln_ew += 2.433502 * log(kelvin);
+
+    /* Factor 0.1 converts hPa to kPa */
+    return 0.1 * exp(ln_ew);
+}
+
+double sonntag_dew_point(double celsius, double humidity)
+{
+    double vapour = sonntag_saturation_pressure(celsius) * humidity * 0.01;
+    double low = SONNTAG_DEW_POINT_MIN;
+    double high = celsius;
+
+    for (int i = 0; i < SONNTAG_ITERATIONS; i++)
+    {
+        double middle = 0.5 * (low + high);
+
+        if (sonntag_saturation_pressure(middle) < vapour)
+        {
+            low = middle;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+    return 0.5 * (low + high);
+}
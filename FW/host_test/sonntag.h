@@ -0,0 +1,20 @@
+#pragma once
+
+/* Double precision Sonntag (1990) formulas, the reference Alduchov & Eskridge fitted the Magnus coefficients to */
+
+/**
+ * @brief Saturation vapour pressure over water, Sonntag formula
+ *
+ * @param celsius temperature in celsius deg
+ * @return saturation vapour pressure in kPa
+ */
+double sonntag_saturation_pressure(double celsius);
+
+/**
+ * @brief Dew point from the Sonntag saturation vapour pressure, solved by bisection
+ *
+ * @param celsius temperature in celsius deg
+ * @param humidity relative humidity in percent
+ * @return dew point in celsius deg
+ */
+double sonntag_dew_point(double celsius, double humidity);
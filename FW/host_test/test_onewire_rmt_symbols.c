@@ -0,0 +1,277 @@
+#include <stdio.h>
+#include <string.h>
+#include "onewire_rmt_symbols.h"
+#include "host_test.h"
+
+/* Low phases of the slots as a device drives them, both sides of the read threshold */
+#define CAPTURE_SLOT_1_LOW_US   8u
+#define CAPTURE_SLOT_0_LOW_US   40u
+#define CAPTURE_SLOT_GAP_US     50u
+/* Presence pulse of a DS18B20, after the wait of the device once the master releases the bus */
+#define DEVICE_PRESENCE_WAIT_US 30u
+#define DEVICE_PRESENCE_LOW_US  120u
+
+/**
+ * @brief Level of the bus held for a time
+ */
+typedef struct
+{
+    bool level;
+    uint32_t duration_us;
+} bus_phase_t;
+
+/**
+ * @brief Builds a capture of read slots, one symbol per bit followed by the end marker
+ *
+ * @param data bits sent by the device, least significant bit of each byte first
+ * @param bit_count number of bits
+ * @param symbols destination, bit_count + 1 symbols
+ * @return number of symbols including the end marker
+ */
+static size_t capture_read(const uint8_t *data, size_t bit_count, uint32_t *symbols);
+
+/**
+ * @brief Captures the bus as the RMT receiver does, the capture ends with the end marker
+ *        once the bus has no edge for the idle threshold
+ *
+ * @param phases levels of the bus, the last one lasts until the capture ends
+ * @param count number of phases
+ * @param idle_us idle threshold of the receiver
+ * @param symbols destination, count / 2 + 1 symbols
+ * @return number of captured symbols including the end marker
+ */
+static size_t capture_bus(const bus_phase_t *phases, size_t count, uint32_t idle_us, uint32_t *symbols);
+
+static void test_encode_reset(void)
+{
+    uint32_t symbols[1];
+
+    CHECK(1u == onewire_rmt_encode_reset(symbols));
+    CHECK(0u == ONEWIRE_RMT_SYMBOL_LEVEL0(symbols[0]));
+    CHECK(ONEWIRE_RMT_RESET_LOW_US == ONEWIRE_RMT_SYMBOL_DURATION0(symbols[0]));
+    CHECK(1u == ONEWIRE_RMT_SYMBOL_LEVEL1(symbols[0]));
+    CHECK(ONEWIRE_RMT_RESET_RELEASE_US == ONEWIRE_RMT_SYMBOL_DURATION1(symbols[0]));
+}
+
+static void test_encode_write(void)
+{
+    const uint8_t data[2] = {0xA5u, 0x01u};
+    uint32_t symbols[10];
+
+    CHECK(10u == onewire_rmt_encode_write(data, 10u, symbols));
+    for (size_t i = 0u; i < 10u; i++)
+    {
+        bool one = (0u != (data[i / 8u] & (1u << (i % 8u))));
+
+        CHECK(0u == ONEWIRE_RMT_SYMBOL_LEVEL0(symbols[i]));
+        CHECK(1u == ONEWIRE_RMT_SYMBOL_LEVEL1(symbols[i]));
+        CHECK((one ? ONEWIRE_RMT_SLOT_1_LOW_US : ONEWIRE_RMT_SLOT_0_LOW_US) == ONEWIRE_RMT_SYMBOL_DURATION0(symbols[i]));
+        CHECK((one ? ONEWIRE_RMT_SLOT_1_HIGH_US : ONEWIRE_RMT_SLOT_0_HIGH_US) == ONEWIRE_RMT_SYMBOL_DURATION1(symbols[i]));
+    }
+    CHECK(0u == onewire_rmt_encode_write(data, 0u, symbols));
+}
+
+static void test_encode_read(void)
+{
+    uint32_t symbols[ONEWIRE_RMT_MAX_BITS];
+    const uint32_t slot_1 = ONEWIRE_RMT_SYMBOL(0, ONEWIRE_RMT_SLOT_1_LOW_US, 1, ONEWIRE_RMT_SLOT_1_HIGH_US);
+
+    CHECK(ONEWIRE_RMT_MAX_BITS == onewire_rmt_encode_read(ONEWIRE_RMT_MAX_BITS, symbols));
+    for (size_t i = 0u; i < ONEWIRE_RMT_MAX_BITS; i++)
+    {
+        CHECK(slot_1 == symbols[i]);
+    }
+}
+
+static void test_decode_presence(void)
+{
+    const uint32_t present[] = {
+        ONEWIRE_RMT_SYMBOL(0, 482, 1, 32),
+        ONEWIRE_RMT_SYMBOL(0, 118, 1, 260),
+        0u,
+    };
+    /* Presence pulse split over two symbols as the receiver may capture it */
+    const uint32_t split[] = {
+        ONEWIRE_RMT_SYMBOL(0, 480, 1, 30),
+        ONEWIRE_RMT_SYMBOL(0, 70, 0, 50),
+        ONEWIRE_RMT_SYMBOL(1, 250, 1, 0),
+    };
+    const uint32_t absent[] = {
+        ONEWIRE_RMT_SYMBOL(0, 480, 1, 410),
+        0u,
+    };
+
+    CHECK(onewire_rmt_decode_presence(present, 3u));
+    CHECK(onewire_rmt_decode_presence(split, 3u));
+    CHECK(!onewire_rmt_decode_presence(absent, 2u));
+    CHECK(!onewire_rmt_decode_presence(present, 1u));
+    CHECK(!onewire_rmt_decode_presence(present, 0u));
+}
+
+static void test_decode_presence_malformed(void)
+{
+    /* Reset pulse cut short, the low phase is a glitch and not a reset */
+    const uint32_t short_reset[] = {
+        ONEWIRE_RMT_SYMBOL(0, 100, 1, 30),
+        ONEWIRE_RMT_SYMBOL(0, 120, 1, 200),
+        0u,
+    };
+    /* Bus held low by a short circuit or a stuck device */
+    const uint32_t long_presence[] = {
+        ONEWIRE_RMT_SYMBOL(0, 480, 1, 30),
+        ONEWIRE_RMT_SYMBOL(0, 400, 1, 10),
+        0u,
+    };
+    const uint32_t short_presence[] = {
+        ONEWIRE_RMT_SYMBOL(0, 480, 1, 30),
+        ONEWIRE_RMT_SYMBOL(0, 10, 1, 300),
+        0u,
+    };
+    /* Symbols after the end marker are left over from an earlier capture */
+    const uint32_t stale[] = {
+        ONEWIRE_RMT_SYMBOL(0, 480, 1, 30),
+        0u,
+        ONEWIRE_RMT_SYMBOL(0, 120, 1, 260),
+    };
+
+    CHECK(!onewire_rmt_decode_presence(short_reset, 3u));
+    CHECK(!onewire_rmt_decode_presence(long_presence, 3u));
+    CHECK(!onewire_rmt_decode_presence(short_presence, 3u));
+    CHECK(!onewire_rmt_decode_presence(stale, 3u));
+}
+
+static void test_reset_capture(void)
+{
+    const bus_phase_t bus[] = {
+        {false, ONEWIRE_RMT_RESET_LOW_US},
+        {true, DEVICE_PRESENCE_WAIT_US},
+        {false, DEVICE_PRESENCE_LOW_US},
+        {true, UINT32_MAX},
+    };
+    uint32_t symbols[3];
+    size_t count;
+
+    /* Reset on the bus as the receiver with the idle threshold of the transport sees it */
+    count = capture_bus(bus, 4u, ONEWIRE_RMT_RX_IDLE_US, symbols);
+    CHECK(onewire_rmt_decode_presence(symbols, count));
+
+    /* Idle threshold shorter than the reset pulse ends the capture before the presence pulse */
+    count = capture_bus(bus, 4u, ONEWIRE_RMT_RESET_LOW_US - 1u, symbols);
+    CHECK(!onewire_rmt_decode_presence(symbols, count));
+}
+
+static void test_decode_read(void)
+{
+    const uint8_t sent[4] = {0xA5u, 0x3Cu, 0x00u, 0xFFu};
+    uint32_t symbols[ONEWIRE_RMT_MAX_BITS + 1u];
+    uint8_t data[4];
+    size_t count = capture_read(sent, ONEWIRE_RMT_MAX_BITS, symbols);
+
+    CHECK(ONEWIRE_RMT_MAX_BITS == onewire_rmt_decode_read(symbols, count, data, ONEWIRE_RMT_MAX_BITS));
+    CHECK(0 == memcmp(sent, data, sizeof(data)));
+
+    count = capture_read(sent, 8u, symbols);
+    memset(data, 0xEE, sizeof(data));
+    CHECK(8u == onewire_rmt_decode_read(symbols, count, data, 8u));
+    CHECK(0xA5u == data[0]);
+    CHECK(0xEEu == data[1]);
+}
+
+static void test_write_read_loopback(void)
+{
+    const uint8_t sent[2] = {0x5Au, 0x0Fu};
+    uint32_t symbols[16];
+    uint8_t data[2];
+
+    /* Write slots echoed back by the receiver decode to the bits written */
+    CHECK(16u == onewire_rmt_encode_write(sent, 16u, symbols));
+    CHECK(16u == onewire_rmt_decode_read(symbols, 16u, data, 16u));
+    CHECK(0 == memcmp(sent, data, sizeof(data)));
+}
+
+static void test_decode_read_malformed(void)
+{
+    const uint8_t sent[4] = {0xFFu, 0xFFu, 0xFFu, 0xFFu};
+    uint32_t symbols[ONEWIRE_RMT_MAX_BITS + 8u];
+    uint8_t data[5];
+    size_t count;
+
+    /* Capture ended early, the missing bits read as 0 */
+    count = capture_read(sent, 5u, symbols);
+    memset(data, 0xEE, sizeof(data));
+    CHECK(5u == onewire_rmt_decode_read(symbols, count, data, 8u));
+    CHECK(0x1Fu == data[0]);
+
+    /* End marker in the middle, the rest is not decoded */
+    count = capture_read(sent, 16u, symbols);
+    symbols[3] = 0u;
+    CHECK(3u == onewire_rmt_decode_read(symbols, count, data, 16u));
+    CHECK(0x07u == data[0]);
+    CHECK(0x00u == data[1]);
+
+    /* No end marker, bits stop at the count of captured symbols */
+    capture_read(sent, 16u, symbols);
+    CHECK(6u == onewire_rmt_decode_read(symbols, 6u, data, 16u));
+    CHECK(0x3Fu == data[0]);
+
+    /* Request above the limit is cut to the number of slots one transaction can hold */
+    count = capture_read(sent, ONEWIRE_RMT_MAX_BITS, symbols);
+    CHECK(ONEWIRE_RMT_MAX_BITS == onewire_rmt_decode_read(symbols, count, data, ONEWIRE_RMT_MAX_BITS + 8u));
+
+    /* Empty capture clears the destination */
+    memset(data, 0xEE, sizeof(data));
+    CHECK(0u == onewire_rmt_decode_read(symbols, 0u, data, 16u));
+    CHECK(0x00u == data[0]);
+    CHECK(0x00u == data[1]);
+    CHECK(0xEEu == data[2]);
+}
+
+static size_t capture_read(const uint8_t *data, size_t bit_count, uint32_t *symbols)
+{
+    for (size_t i = 0u; i < bit_count; i++)
+    {
+        bool one = (0u != (data[i / 8u] & (1u << (i % 8u))));
+
+        symbols[i] = ONEWIRE_RMT_SYMBOL(0, one ? CAPTURE_SLOT_1_LOW_US : CAPTURE_SLOT_0_LOW_US, 1, CAPTURE_SLOT_GAP_US);
+    }
+    symbols[bit_count] = 0u;
+    return bit_count + 1u;
+}
+
+static size_t capture_bus(const bus_phase_t *phases, size_t count, uint32_t idle_us, uint32_t *symbols)
+{
+    size_t halves = 0u;
+
+    for (size_t i = 0u; i < count; i++)
+    {
+        uint32_t duration = (phases[i].duration_us < idle_us) ? phases[i].duration_us : idle_us;
+        uint32_t half = ONEWIRE_RMT_SYMBOL(phases[i].level, duration, 0, 0) & 0xFFFFu;
+
+        symbols[halves / 2u] = (0u == halves % 2u) ? half : (symbols[halves / 2u] | (half << 16));
+        halves++;
+        if (duration == idle_us)
+        {
+            break;
+        }
+    }
+    /* End marker is a half with zero duration */
+    if (0u == halves % 2u)
+    {
+        symbols[halves / 2u] = 0u;
+    }
+    return halves / 2u + 1u;
+}
+
+int main(void)
+{
+    test_encode_reset();
+    test_encode_write();
+    test_encode_read();
+    test_decode_presence();
+    test_decode_presence_malformed();
+    test_reset_capture();
+    test_decode_read();
+    test_write_read_loopback();
+    test_decode_read_malformed();
+    return host_test_result("onewire_rmt_symbols");
+}
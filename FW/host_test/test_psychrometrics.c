@@ -0,0 +1,116 @@
+#include <math.h>
+#include <stdio.h>
+#include "psychrometrics.h"
+#include "sonntag.h"
+#include "host_test.h"
+
+/* Alduchov & Eskridge (1996) state the error of their Magnus coefficients against the
+   Sonntag formula as below 0.384 % of the saturation vapour pressure for -40 - 50 C deg */
+#define PUBLISHED_PRESSURE_ERROR    0.00384
+#define PUBLISHED_T_MIN             -40
+#define PUBLISHED_T_MAX             50
+/* Published coefficients, they give the slope of ln(pressure) the dew point error follows from */
+#define PUBLISHED_MAGNUS_A          17.625
+#define PUBLISHED_MAGNUS_B          243.04
+/* Rounding of the single precision implementation, relative for pressure and absolute in C deg */
+#define FLOAT_PRESSURE_MARGIN       1e-5
+#define FLOAT_DEW_POINT_MARGIN      1e-4
+
+/**
+ * @brief Gets the largest dew point error the published pressure error allows. The vapour
+ *        pressure computed from the temperature and the dew point found from it may each be
+ *        off by the published error, divided by the slope of ln(pressure) at the dew point.
+ *
+ * @param dew_point reference dew point in celsius deg
+ * @return largest allowed absolute error in C deg
+ */
+static double allowed_dew_point_error(double dew_point);
+
+static void test_dew_point_accuracy(void)
+{
+    double max_ratio = 0.0;
+    double max_error = 0.0;
+
+    /* Grid with steps of 0.1 C deg and 0.1 % over the range the coefficients are published for */
+    for (int t = PUBLISHED_T_MIN * 10; t <= PUBLISHED_T_MAX * 10; t++)
+    {
+        for (int rh = 10; rh <= 1000; rh++)
+        {
+            float celsius = (float)t * 0.1f;
+            float humidity = (float)rh * 0.1f;
+            double reference = sonntag_dew_point((double)celsius, (double)humidity);
+            double error;
+
+            if ((double)PUBLISHED_T_MIN > reference)
+            {
+                continue;
+            }
+            error = fabs((double)psychrometrics_dew_point(celsius, humidity) - reference);
+            if (error > max_error)
+            {
+                max_error = error;
+            }
+            if (error / allowed_dew_point_error(reference) > max_ratio)
+            {
+                max_ratio = error / allowed_dew_point_error(reference);
+            }
+        }
+    }
+    printf("max dew point error: %.4f C deg, %.0f %% of the allowed one at -40-50 C deg 1-100 %%\n",
+           max_error, max_ratio * 100.0);
+    CHECK(1.0 >= max_ratio);
+}
+
+static void test_dew_point_limits(void)
+{
+    /* Saturated air condenses at its own temperature */
+    CHECK(0.01f > fabsf(psychrometrics_dew_point(25.0f, 100.0f) - 25.0f));
+    CHECK(0.01f > fabsf(psychrometrics_dew_point(-20.0f, 100.0f) + 20.0f));
+    /* Dry air is clamped instead of giving the logarithm of zero */
+    CHECK(isfinite(psychrometrics_dew_point(20.0f, 0.0f)));
+    CHECK(psychrometrics_dew_point(20.0f, 0.0f) == psychrometrics_dew_point(20.0f, 0.1f));
+}
+
+static void test_saturation_pressure(void)
+{
+    double max_error = 0.0;
+
+    for (int t = PUBLISHED_T_MIN * 10; t <= PUBLISHED_T_MAX * 10; t++)
+    {
+        float celsius = (float)t * 0.1f;
+        double reference = sonntag_saturation_pressure((double)celsius);
+        double error = fabs((double)psychrometrics_saturation_pressure(celsius) - reference) / reference;
+
+        if (error > max_error)
+        {
+            max_error = error;
+        }
+    }
+    printf("max saturation pressure error: %.3f %% at -40-50 C deg\n", max_error * 100.0);
+    CHECK(PUBLISHED_PRESSURE_ERROR + FLOAT_PRESSURE_MARGIN >= max_error);
+}
+
+static void test_derived_values(void)
+{
+    /* Saturated air holds 17.3 g/m3 of water at 20 C deg */
+    CHECK(0.1f > fabsf(psychrometrics_absolute_humidity(20.0f, 100.0f) - 17.3f));
+    CHECK(0.0f == psychrometrics_vpd(20.0f, 100.0f));
+    CHECK(0.001f > fabsf(psychrometrics_vpd(20.0f, 40.0f) - 0.6f * psychrometrics_saturation_pressure(20.0f)));
+}
+
+static double allowed_dew_point_error(double dew_point)
+{
+    double slope = PUBLISHED_MAGNUS_A * PUBLISHED_MAGNUS_B /
+                   ((PUBLISHED_MAGNUS_B + dew_point) * (PUBLISHED_MAGNUS_B + dew_point));
+
+    return 2.0 * PUBLISHED_PRESSURE_ERROR / slope + FLOAT_DEW_POINT_MARGIN;
+}
+
+int main(void)
+{
+    test_dew_point_accuracy();
+    test_dew_point_limits();
+    test_saturation_pressure();
+    test_derived_values();
+    return host_test_result("psychrometrics");
+}
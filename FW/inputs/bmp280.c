@@ -0,0 +1,215 @@
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "bmp280.h"
+
+#define REG_CALIB       0x88u
+#define REG_CHIP_ID     0xD0u
+#define REG_RESET       0xE0u
+#define REG_STATUS      0xF3u
+#define REG_CTRL_MEAS   0xF4u
+#define REG_CONFIG      0xF5u
+#define REG_DATA        0xF7u
+
+#define CHIP_ID         0x58u
+#define RESET_VALUE     0xB6u
+#define STATUS_MEASURING 0x08u
+#define MODE_FORCED     0x01u
+
+#define CALIB_LENGTH    24u
+#define DATA_LENGTH     6u
+/* Status register directly precedes ctrl_meas, config and data, so it is read in the same burst */
+#define BURST_LENGTH    (REG_DATA - REG_STATUS + DATA_LENGTH)
+
+/* Raw value reported for a skipped measurement */
+#define RAW_SKIPPED     0x80000
+
+#define STARTUP_MS      2u
+#define I2C_TIMEOUT_MS  10u
+
+static const char *TAG = "bmp280";
+
+/**
+ * @brief Writes a single register
+ *
+ * @param dev device descriptor
+ * @param reg register address
+ * @param value register value
+ * @return ESP_OK on success, otherwise error code of I2C driver
+ */
+static esp_err_t bmp280_write_reg(const bmp280_t* const dev, uint8_t reg, uint8_t value);
+
+/**
+ * @brief Reads consecutive registers in one transaction
+ *
+ * @param dev device descriptor
+ * @param reg address of the first register
+ * @param data destination
+ * @param length number of registers
+ * @return ESP_OK on success, otherwise error code of I2C driver
+ */
+static esp_err_t bmp280_read_regs(const bmp280_t* const dev, uint8_t reg, uint8_t* data, size_t length);
+
+/**
+ * @brief Compensates raw temperature, integer algorithm of the datasheet
+ *
+ * @param calib trimming coefficients
+ * @param adc_T raw temperature
+ * @param t_fine fine temperature used by pressure compensation
+ * @return temperature in 0.01 Celsius
+ */
+static int32_t bmp280_compensate_temperature(const bmp280_calib_t* const calib, int32_t adc_T, int32_t* t_fine);
+
+/**
+ * @brief Compensates raw pressure, 64-bit integer algorithm of the datasheet
+ *
+ * @param calib trimming coefficients
+ * @param adc_P raw pressure
+ * @param t_fine fine temperature
+ * @return pressure in Pa as Q24.8
+ */
+static uint32_t bmp280_compensate_pressure(const bmp280_calib_t* const calib, int32_t adc_P, int32_t t_fine);
+
+esp_err_t bmp280_init(bmp280_t* const dev, i2c_port_t port, uint8_t addr, bmp280_oversampling_t temp_os,
+                      bmp280_oversampling_t press_os, bmp280_filter_t filter)
+{
+    uint8_t id = 0u;
+    uint8_t raw[CALIB_LENGTH];
+    uint32_t conversion_us = 1250u;
+
+    memset(dev, 0, sizeof(bmp280_t));
+    dev->port = port;
+    dev->addr = addr;
+
+    if (ESP_OK != bmp280_read_regs(dev, REG_CHIP_ID, &id, 1u) || CHIP_ID != id)
+    {
+        return ESP_ERR_NOT_FOUND;
+    }
+    if (ESP_OK != bmp280_write_reg(dev, REG_RESET, RESET_VALUE))
+    {
+        return ESP_FAIL;
+    }
+    vTaskDelay(pdMS_TO_TICKS(STARTUP_MS) + 1u);
+
+    if (ESP_OK != bmp280_read_regs(dev, REG_CALIB, raw, sizeof(raw)))
+    {
+        return ESP_FAIL;
+    }
+    dev->calib.dig_T1 = (uint16_t)(raw[0] | (raw[1] << 8));
+    dev->calib.dig_T2 = (int16_t)(raw[2] | (raw[3] << 8));
+    dev->calib.dig_T3 = (int16_t)(raw[4] | (raw[5] << 8));
+    dev->calib.dig_P1 = (uint16_t)(raw[6] | (raw[7] << 8));
+    dev->calib.dig_P2 = (int16_t)(raw[8] | (raw[9] << 8));
+    dev->calib.dig_P3 = (int16_t)(raw[10] | (raw[11] << 8));
+    dev->calib.dig_P4 = (int16_t)(raw[12] | (raw[13] << 8));
+    dev->calib.dig_P5 = (int16_t)(raw[14] | (raw[15] << 8));
+    dev->calib.dig_P6 = (int16_t)(raw[16] | (raw[17] << 8));
+    dev->calib.dig_P7 = (int16_t)(raw[18] | (raw[19] << 8));
+    dev->calib.dig_P8 = (int16_t)(raw[20] | (raw[21] << 8));
+    dev->calib.dig_P9 = (int16_t)(raw[22] | (raw[23] << 8));
+
+    /* Standby time is not used in forced mode */
+    if (ESP_OK != bmp280_write_reg(dev, REG_CONFIG, (uint8_t)(filter << 2)))
+    {
+        return ESP_FAIL;
+    }
+
+    /* Maximum measurement time from the datasheet: 1.25 ms + 2.3 ms per sample + 0.575 ms for pressure */
+    if (BMP280_OVERSAMPLING_SKIP != temp_os)
+    {
+        conversion_us += 2300u << (temp_os - 1u);
+    }
+    if (BMP280_OVERSAMPLING_SKIP != press_os)
+    {
+        conversion_us += (2300u << (press_os - 1u)) + 575u;
+    }
+    dev->conversion_ms = (conversion_us + 999u) / 1000u;
+    dev->ctrl_meas = (uint8_t)((temp_os << 5) | (press_os << 2) | MODE_FORCED);
+
+    ESP_LOGI(TAG, "Found at 0x%02x, conversion time %u ms", addr, dev->conversion_ms);
+    return ESP_OK;
+}
+
+esp_err_t bmp280_start_forced(const bmp280_t* const dev)
+{
+    return (ESP_OK == bmp280_write_reg(dev, REG_CTRL_MEAS, dev->ctrl_meas)) ? ESP_OK : ESP_FAIL;
+}
+
+uint32_t bmp280_get_conversion_time_ms(const bmp280_t* const dev)
+{
+    return dev->conversion_ms;
+}
+
+esp_err_t bmp280_read(const bmp280_t* const dev, float* const temp_C, float* const pressure_pa)
+{
+    uint8_t raw[BURST_LENGTH];
+    int32_t t_fine;
+
+    if (ESP_OK != bmp280_read_regs(dev, REG_STATUS, raw, sizeof(raw)))
+    {
+        return ESP_FAIL;
+    }
+    if (0u != (raw[0] & STATUS_MEASURING))
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    const uint8_t *data = &raw[REG_DATA - REG_STATUS];
+    int32_t adc_P = (int32_t)((data[0] << 12) | (data[1] << 4) | (data[2] >> 4));
+    int32_t adc_T = (int32_t)((data[3] << 12) | (data[4] << 4) | (data[5] >> 4));
+
+    if (RAW_SKIPPED == adc_T)
+    {
+        return ESP_FAIL;
+    }
+    *temp_C = (float)bmp280_compensate_temperature(&dev->calib, adc_T, &t_fine) * 0.01f;
+    *pressure_pa = (RAW_SKIPPED == adc_P) ? 0.0f :
+                   (float)bmp280_compensate_pressure(&dev->calib, adc_P, t_fine) * (1.0f / 256.0f);
+    return ESP_OK;
+}
+
+static esp_err_t bmp280_write_reg(const bmp280_t* const dev, uint8_t reg, uint8_t value)
+{
+    uint8_t buf[2] = {reg, value};
+
+    return i2c_master_write_to_device(dev->port, dev->addr, buf, sizeof(buf), pdMS_TO_TICKS(I2C_TIMEOUT_MS));
+}
+
+static esp_err_t bmp280_read_regs(const bmp280_t* const dev, uint8_t reg, uint8_t* data, size_t length)
+{
+    return i2c_master_write_read_device(dev->port, dev->addr, &reg, 1u, data, length, pdMS_TO_TICKS(I2C_TIMEOUT_MS));
+}
+
+static int32_t bmp280_compensate_temperature(const bmp280_calib_t* const calib, int32_t adc_T, int32_t* t_fine)
+{
+    int32_t var1 = ((((adc_T >> 3) - ((int32_t)calib->dig_T1 << 1))) * ((int32_t)calib->dig_T2)) >> 11;
+    int32_t var2 = (((((adc_T >> 4) - ((int32_t)calib->dig_T1)) * ((adc_T >> 4) - ((int32_t)calib->dig_T1))) >> 12) *
+                    ((int32_t)calib->dig_T3)) >> 14;
+
+    *t_fine = var1 + var2;
+    return (*t_fine * 5 + 128) >> 8;
+}
+
+static uint32_t bmp280_compensate_pressure(const bmp280_calib_t* const calib, int32_t adc_P, int32_t t_fine)
+{
+    int64_t var1 = ((int64_t)t_fine) - 128000;
+    int64_t var2 = var1 * var1 * (int64_t)calib->dig_P6;
+    int64_t p;
+
+    var2 = var2 + ((var1 * (int64_t)calib->dig_P5) << 17);
+    var2 = var2 + (((int64_t)calib->dig_P4) << 35);
+    var1 = ((var1 * var1 * (int64_t)calib->dig_P3) >> 8) + ((var1 * (int64_t)calib->dig_P2) << 12);
+    var1 = (((((int64_t)1) << 47) + var1)) * ((int64_t)calib->dig_P1) >> 33;
+    if (0 == var1)
+    {
+        /* Avoid division by zero with invalid trimming */
+        return 0u;
+    }
+    p = 1048576 - adc_P;
+    p = (((p << 31) - var2) * 3125) / var1;
+    var1 = (((int64_t)calib->dig_P9) * (p >> 13) * (p >> 13)) >> 25;
+    var2 = (((int64_t)calib->dig_P8) * p) >> 19;
+    p = ((p + var1 + var2) >> 8) + (((int64_t)calib->dig_P7) << 4);
+    return (uint32_t)p;
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <stdint.h>
+#include "driver/i2c.h"
+#include "esp_err.h"
+
+#define BMP280_I2C_ADDRESS_0 0x76u     /*!< SDO connected to GND */
+#define BMP280_I2C_ADDRESS_1 0x77u     /*!< SDO connected to VDDIO */
+
+/**
+ * @brief Oversampling of a measurement, skipped measurement is not converted
+ */
+typedef enum
+{
+    BMP280_OVERSAMPLING_SKIP = 0,
+    BMP280_OVERSAMPLING_X1,
+    BMP280_OVERSAMPLING_X2,
+    BMP280_OVERSAMPLING_X4,
+    BMP280_OVERSAMPLING_X8,
+    BMP280_OVERSAMPLING_X16,
+} bmp280_oversampling_t;
+
+/**
+ * @brief Coefficient of the internal IIR filter
+ */
+typedef enum
+{
+    BMP280_FILTER_OFF = 0,
+    BMP280_FILTER_2,
+    BMP280_FILTER_4,
+    BMP280_FILTER_8,
+    BMP280_FILTER_16,
+} bmp280_filter_t;
+
+/**
+ * @brief Trimming coefficients read from the device
+ */
+typedef struct
+{
+    uint16_t dig_T1;
+    int16_t dig_T2;
+    int16_t dig_T3;
+    uint16_t dig_P1;
+    int16_t dig_P2;
+    int16_t dig_P3;
+    int16_t dig_P4;
+    int16_t dig_P5;
+    int16_t dig_P6;
+    int16_t dig_P7;
+    int16_t dig_P8;
+    int16_t dig_P9;
+} bmp280_calib_t;
+
+/**
+ * @brief Device descriptor
+ */
+typedef struct
+{
+    i2c_port_t port;
+    uint8_t addr;
+    uint8_t ctrl_meas;          /*!< value written to ctrl_meas register to start a forced conversion */
+    uint32_t conversion_ms;     /*!< maximum conversion time for the configured oversampling */
+    bmp280_calib_t calib;
+} bmp280_t;
+
+/**
+ * @brief Checks chip id, resets the device, reads trimming coefficients and configures the filter.
+ *        I2C driver must be installed on the port.
+ *
+ * @param dev device descriptor
+ * @param port I2C port
+ * @param addr I2C address of the device
+ * @param temp_os oversampling of temperature
+ * @param press_os oversampling of pressure
+ * @param filter IIR filter coefficient
+ * @return ESP_OK on success, ESP_ERR_NOT_FOUND if no BMP280 answers, otherwise return ESP_FAIL
+ */
+esp_err_t bmp280_init(bmp280_t* const dev, i2c_port_t port, uint8_t addr, bmp280_oversampling_t temp_os,
+                      bmp280_oversampling_t press_os, bmp280_filter_t filter);
+
+/**
+ * @brief Starts a single conversion in forced mode and returns immediately
+ *
+ * @param dev device descriptor
+ * @return ESP_OK on success, otherwise return ESP_FAIL
+ */
+esp_err_t bmp280_start_forced(const bmp280_t* const dev);
+
+/**
+ * @brief Gets maximum time of a conversion, results can be read after that time since start
+ *
+ * @param dev device descriptor
+ * @return conversion time in ms
+ */
+uint32_t bmp280_get_conversion_time_ms(const bmp280_t* const dev);
+
+/**
+ * @brief Reads results of the last conversion with one burst read and compensates them
+ *
+ * @param dev device descriptor
+ * @param temp_C temperature in Celsius
+ * @param pressure_pa pressure in Pa
+ * @return ESP_OK on success, ESP_ERR_INVALID_STATE if the conversion is still running, otherwise return ESP_FAIL
+ */
+esp_err_t bmp280_read(const bmp280_t* const dev, float* const temp_C, float* const pressure_pa);
@@ -0,0 +1,101 @@
+#include <string.h>
+#include "calibration.h"
+
+/**
+ * @brief Precomputes slopes of all segments
+ * 
+ * @param table calibration table
+ */
+static void calibration_update_slopes(calibration_table_t* const table);
+
+void calibration_init(calibration_table_t* const table)
+{
+    memset(table, 0, sizeof(*table));
+}
+
+esp_err_t calibration_add_point(calibration_table_t* const table, float x, float y)
+{
+    uint8_t i = 0u;
+
+    /* Drop points which the new one replaces */
+    while (i < table->count)
+    {
+        if (x == table->points[i].x || y == table->points[i].y)
+        {
+            calibration_remove_point(table, i);
+        }
+        else
+        {
+            i++;
+        }
+    }
+
+    if (CALIBRATION_MAX_POINTS <= table->count)
+    {
+        return ESP_FAIL;
+    }
+
+    /* Insert keeping the points sorted by x */
+    i = table->count;
+    while (0u < i && table->points[i - 1u].x > x)
+    {
+        table->points[i] = table->points[i - 1u];
+        i--;
+    }
+    table->points[i].x = x;
+    table->points[i].y = y;
+    table->count++;
+
+    calibration_update_slopes(table);
+    return ESP_OK;
+}
+
+esp_err_t calibration_remove_point(calibration_table_t* const table, uint8_t index)
+{
+    if (index >= table->count)
+    {
+        return ESP_FAIL;
+    }
+
+    memmove(&table->points[index], &table->points[index + 1u], (table->count - index - 1u) * sizeof(calibration_point_t));
+    table->count--;
+
+    calibration_update_slopes(table);
+    return ESP_OK;
+}
+
+esp_err_t calibration_apply(const calibration_table_t* const table, float x, float* const y)
+{
+    if (2u > table->count)
+    {
+        return ESP_FAIL;
+    }
+
+    /* Binary search of the segment, first and last segments are extended */
+    uint8_t low = 0u;
+    uint8_t high = table->count - 2u;
+
+    while (low < high)
+    {
+        uint8_t mid = (uint8_t)((low + high + 1u) / 2u);
+        if (table->points[mid].x <= x)
+        {
+            low = mid;
+        }
+        else
+        {
+            high = mid - 1u;
+        }
+    }
+
+    *y = table->points[low].y + table->slopes[low] * (x - table->points[low].x);
+    return ESP_OK;
+}
+
+static void calibration_update_slopes(calibration_table_t* const table)
+{
+    for (uint8_t i = 0u; i + 1u < table->count; i++)
+    {
+        table->slopes[i] = (table->points[i + 1u].y - table->points[i].y) / (table->points[i + 1u].x - table->points[i].x);
+    }
+}
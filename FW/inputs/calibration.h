@@ -0,0 +1,63 @@
+#pragma once
+
+#include <stdint.h>
+#include "esp_err.h"
+
+#define CALIBRATION_MAX_POINTS 16u
+
+/**
+ * @brief Single calibration point, raw value x maps to physical value y
+ */
+typedef struct
+{
+    float x;
+    float y;
+} calibration_point_t;
+
+/**
+ * @brief Piecewise linear calibration table. Points are kept sorted by x and the
+ *        slope of every segment is precomputed whenever the table changes.
+ */
+typedef struct
+{
+    uint8_t count;
+    calibration_point_t points[CALIBRATION_MAX_POINTS];
+    float slopes[CALIBRATION_MAX_POINTS - 1u];
+} calibration_table_t;
+
+/**
+ * @brief Clears the table
+ * 
+ * @param table calibration table
+ */
+void calibration_init(calibration_table_t* const table);
+
+/**
+ * @brief Adds a point. A point with the same x or the same y is replaced, so a level
+ *        can be recalibrated by adding it again.
+ * 
+ * @param table calibration table
+ * @param x raw value
+ * @param y physical value
+ * @return ESP_OK on success, ESP_FAIL if the table is full
+ */
+esp_err_t calibration_add_point(calibration_table_t* const table, float x, float y);
+
+/**
+ * @brief Removes a point
+ * 
+ * @param table calibration table
+ * @param index index of the point, points are sorted by x
+ * @return ESP_OK on success, ESP_FAIL if there is no such point
+ */
+esp_err_t calibration_remove_point(calibration_table_t* const table, uint8_t index);
+
+/**
+ * @brief Converts raw value with the table, outside of the table the end segments are extrapolated
+ * 
+ * @param table calibration table
+ * @param x raw value
+ * @param y physical value
+ * @return ESP_OK on success, ESP_FAIL if the table has less than two points
+ */
+esp_err_t calibration_apply(const calibration_table_t* const table, float x, float* const y);
@@ -0,0 +1,285 @@
+#include <string.h>
+#include <math.h>
+#include "freertos/FreeRTOS.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freq_meas.h"
+#include "fan_tach.h"
+#include "../mcu/pinout.h"
+#include "../mcu/peripherals.h"
+#include "../outputs/dehumyfing_ventilator_control.h"
+
+/* Common PC fans give two tachometer pulses per revolution */
+#define PULSES_PER_REV          2u
+#define GATE_MS                 500u
+
+#define CURVE_STEP              (100.0f / (FAN_TACH_CURVE_POINTS - 1u))
+/* Below this duty the fan is not expected to turn */
+#define MIN_DUTY                10.0f
+/* Speed is judged only after the fan had time to reach the new duty */
+#define SETTLE_US               5000000
+#define DUTY_CHANGE             0.5f
+/* Point of the curve is used once it collected this much sample weight */
+#define LEARNED_WEIGHT          3.0f
+/* Points keep following slow changes, e.g. of supply voltage */
+#define LEARN_MIN_ALPHA         0.02f
+#define STALL_RPM               100.0f
+#define DEGRADED_RATIO          0.75f
+/* Consecutive low measurements before a fault is reported */
+#define FAULT_SAMPLES           3u
+
+typedef struct
+{
+    const char *name;
+    pcnt_unit_t unit;
+    gpio_num_t pin;
+    float (*get_duty)(void);
+    float last_duty;
+    int64_t duty_changed_us;
+    uint8_t low_samples;
+    fan_tach_curve_point_t curve[FAN_TACH_CURVE_POINTS];
+    fan_tach_status_t status;
+} fan_tach_t;
+
+static portMUX_TYPE fans_mux = portMUX_INITIALIZER_UNLOCKED;
+static fan_tach_t fans[FAN_TACH_FANS_NUM] = {
+    [FAN_TACH_DEHUMYFING] = {
+        .name = "dehumyfing",
+        .unit = ESP_PCNT_UNIT_DEHUM_FAN,
+        .pin = ESP_PIN_DEHUM_FAN_SENSE,
+        .get_duty = dehumyfing_ventilator_get_speed,
+    },
+};
+
+static const char *state_names[] = {
+    [FAN_TACH_OFF] = "off",
+    [FAN_TACH_LEARNING] = "learning",
+    [FAN_TACH_OK] = "ok",
+    [FAN_TACH_DEGRADED] = "degraded",
+    [FAN_TACH_STALLED] = "stalled",
+};
+
+static const char *TAG = "fan_tach";
+
+/**
+ * @brief Frequency measurement callback, converts the result to RPM and judges it
+ *
+ * @param status ESP_OK with a new result, ESP_ERR_TIMEOUT when no pulses came
+ * @param result frequency measurement
+ * @param arg fan state
+ */
+static void fan_tach_on_result(esp_err_t status, const freq_meas_result_t* result, void* arg);
+
+/**
+ * @brief Interpolates the learned curve
+ *
+ * @param fan fan state
+ * @param duty duty in %
+ * @return expected RPM, 0 if the points around the duty are not learned
+ */
+static float fan_tach_expected_rpm(const fan_tach_t* const fan, float duty);
+
+/**
+ * @brief Adds a healthy measurement to the two points around the duty
+ *
+ * @param fan fan state
+ * @param duty duty in %
+ * @param rpm measured speed
+ */
+static void fan_tach_learn(fan_tach_t* const fan, float duty, float rpm);
+
+esp_err_t fan_tach_init(void)
+{
+    for (uint8_t i = 0u; i < FAN_TACH_FANS_NUM; i++)
+    {
+        if (ESP_OK != freq_meas_add_channel(fans[i].unit, fans[i].pin, GATE_MS, fan_tach_on_result, &fans[i]))
+        {
+            return ESP_FAIL;
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t fan_tach_get_status(fan_tach_fan_t fan, fan_tach_status_t* const status)
+{
+    if (fan >= FAN_TACH_FANS_NUM)
+    {
+        return ESP_FAIL;
+    }
+    taskENTER_CRITICAL(&fans_mux);
+    *status = fans[fan].status;
+    taskEXIT_CRITICAL(&fans_mux);
+    return ESP_OK;
+}
+
+bool fan_tach_is_faulty(fan_tach_fan_t fan)
+{
+    fan_tach_status_t status;
+
+    if (ESP_OK != fan_tach_get_status(fan, &status))
+    {
+        return false;
+    }
+    return (FAN_TACH_DEGRADED == status.state || FAN_TACH_STALLED == status.state);
+}
+
+esp_err_t fan_tach_get_curve(fan_tach_fan_t fan, fan_tach_curve_point_t points[FAN_TACH_CURVE_POINTS])
+{
+    if (fan >= FAN_TACH_FANS_NUM)
+    {
+        return ESP_FAIL;
+    }
+    taskENTER_CRITICAL(&fans_mux);
+    memcpy(points, fans[fan].curve, sizeof(fans[fan].curve));
+    taskEXIT_CRITICAL(&fans_mux);
+    return ESP_OK;
+}
+
+esp_err_t fan_tach_clear_curve(fan_tach_fan_t fan)
+{
+    if (fan >= FAN_TACH_FANS_NUM)
+    {
+        return ESP_FAIL;
+    }
+    taskENTER_CRITICAL(&fans_mux);
+    memset(fans[fan].curve, 0, sizeof(fans[fan].curve));
+    fans[fan].low_samples = 0u;
+    taskEXIT_CRITICAL(&fans_mux);
+    return ESP_OK;
+}
+
+const char* fan_tach_get_name(fan_tach_fan_t fan)
+{
+    return (fan < FAN_TACH_FANS_NUM) ? fans[fan].name : "";
+}
+
+const char* fan_tach_get_state_name(fan_tach_state_t state)
+{
+    return (state <= FAN_TACH_STALLED) ? state_names[state] : "";
+}
+
+static void fan_tach_on_result(esp_err_t status, const freq_meas_result_t* result, void* arg)
+{
+    fan_tach_t *fan = (fan_tach_t *)arg;
+    /* Timeout means no pulses at all, which is a stopped rotor */
+    float rpm = (ESP_OK == status) ? result->frequency_hz * 60.0f / PULSES_PER_REV : 0.0f;
+    float duty = fan->get_duty();
+    int64_t now = esp_timer_get_time();
+    fan_tach_state_t previous;
+
+    taskENTER_CRITICAL(&fans_mux);
+    previous = fan->status.state;
+    if (DUTY_CHANGE < fabsf(duty - fan->last_duty))
+    {
+        fan->last_duty = duty;
+        fan->duty_changed_us = now;
+        fan->low_samples = 0u;
+    }
+
+    float expected = fan_tach_expected_rpm(fan, duty);
+    fan_tach_state_t state = previous;
+
+    if (MIN_DUTY > duty)
+    {
+        state = FAN_TACH_OFF;
+        fan->low_samples = 0u;
+    }
+    else if (SETTLE_US <= (now - fan->duty_changed_us))
+    {
+        bool stalled = (STALL_RPM > rpm);
+        bool degraded = (0.0f < expected) && (expected * DEGRADED_RATIO > rpm);
+
+        if (stalled || degraded)
+        {
+            if (FAULT_SAMPLES <= ++fan->low_samples)
+            {
+                state = stalled ? FAN_TACH_STALLED : FAN_TACH_DEGRADED;
+            }
+        }
+        else
+        {
+            fan->low_samples = 0u;
+            fan_tach_learn(fan, duty, rpm);
+            state = (0.0f < expected) ? FAN_TACH_OK : FAN_TACH_LEARNING;
+        }
+    }
+    else if (FAN_TACH_OFF == state)
+    {
+        state = FAN_TACH_LEARNING;
+    }
+
+    if (state != previous && (FAN_TACH_DEGRADED == state || FAN_TACH_STALLED == state))
+    {
+        fan->status.fault_count++;
+    }
+    fan->status.duty = duty;
+    fan->status.rpm = rpm;
+    fan->status.expected_rpm = expected;
+    fan->status.state = state;
+    fan->status.timestamp_us = now;
+    taskEXIT_CRITICAL(&fans_mux);
+
+    if (state != previous && (FAN_TACH_DEGRADED == state || FAN_TACH_STALLED == state))
+    {
+        ESP_LOGW(TAG, "Fan %s %s at %0.0f%% duty, %0.0f RPM, expected %0.0f RPM", fan->name,
+                 state_names[state], duty, rpm, expected);
+    }
+}
+
+static float fan_tach_expected_rpm(const fan_tach_t* const fan, float duty)
+{
+    float position = duty / CURVE_STEP;
+    uint8_t index = (uint8_t)position;
+    float fraction = position - (float)index;
+
+    if (FAN_TACH_CURVE_POINTS - 1u <= index)
+    {
+        index = FAN_TACH_CURVE_POINTS - 1u;
+        fraction = 0.0f;
+    }
+    if (LEARNED_WEIGHT > fan->curve[index].weight)
+    {
+        return 0.0f;
+    }
+    if (0.0f == fraction)
+    {
+        return fan->curve[index].rpm;
+    }
+    if (LEARNED_WEIGHT > fan->curve[index + 1u].weight)
+    {
+        return 0.0f;
+    }
+    return fan->curve[index].rpm + fraction * (fan->curve[index + 1u].rpm - fan->curve[index].rpm);
+}
+
+static void fan_tach_learn(fan_tach_t* const fan, float duty, float rpm)
+{
+    float position = duty / CURVE_STEP;
+    uint8_t index = (uint8_t)position;
+    float fraction = position - (float)index;
+
+    if (FAN_TACH_CURVE_POINTS - 1u <= index)
+    {
+        index = FAN_TACH_CURVE_POINTS - 2u;
+        fraction = 1.0f;
+    }
+
+    /* Sample is shared by the neighbouring points in proportion to its distance,
+       a point averages its first samples and then follows with a minimum rate */
+    for (uint8_t i = 0u; i < 2u; i++)
+    {
+        fan_tach_curve_point_t *point = &fan->curve[index + i];
+        float weight = (0u == i) ? (1.0f - fraction) : fraction;
+
+        if (0.0f < weight)
+        {
+            float alpha = weight / (point->weight + weight);
+            if (LEARN_MIN_ALPHA * weight > alpha)
+            {
+                alpha = LEARN_MIN_ALPHA * weight;
+            }
+            point->rpm += alpha * (rpm - point->rpm);
+            point->weight += weight;
+        }
+    }
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+/* Learned duty to RPM curve has a point every 10% of duty */
+#define FAN_TACH_CURVE_POINTS 11u
+
+/**
+ * @brief Fans with tachometer feedback
+ */
+typedef enum
+{
+    FAN_TACH_DEHUMYFING = 0,
+    FAN_TACH_FANS_NUM
+} fan_tach_fan_t;
+
+/**
+ * @brief Health of a fan judged against the learned curve
+ */
+typedef enum
+{
+    FAN_TACH_OFF = 0,       /*!< duty too low to spin */
+    FAN_TACH_LEARNING,      /*!< running, curve not learned yet at this duty */
+    FAN_TACH_OK,            /*!< speed follows the learned curve */
+    FAN_TACH_DEGRADED,      /*!< speed persistently below the learned curve, e.g. worn bearing or blocked inlet */
+    FAN_TACH_STALLED,       /*!< no rotation although driven */
+} fan_tach_state_t;
+
+/**
+ * @brief Current state of a fan
+ */
+typedef struct
+{
+    float duty;                 /*!< duty of the fan output in % */
+    float rpm;                  /*!< measured speed */
+    float expected_rpm;         /*!< speed expected from the learned curve, 0 if not learned */
+    fan_tach_state_t state;
+    uint32_t fault_count;       /*!< number of transitions to degraded or stalled */
+    int64_t timestamp_us;       /*!< time of the last measurement (esp_timer_get_time), 0 if none */
+} fan_tach_status_t;
+
+/**
+ * @brief Point of the learned duty to RPM curve
+ */
+typedef struct
+{
+    float rpm;                  /*!< mean speed at the duty of the point */
+    float weight;               /*!< sum of sample weights, the point is used once it is large enough */
+} fan_tach_curve_point_t;
+
+/**
+ * @brief Adds tachometer inputs of all fans to the frequency measurement, called before freq_meas_task starts
+ *
+ * @return ESP_OK on success, otherwise return ESP_FAIL
+ */
+esp_err_t fan_tach_init(void);
+
+/**
+ * @brief Gets current state of a fan
+ *
+ * @param fan fan
+ * @param status destination of the state
+ * @return ESP_OK on success, otherwise return ESP_FAIL
+ */
+esp_err_t fan_tach_get_status(fan_tach_fan_t fan, fan_tach_status_t* const status);
+
+/**
+ * @brief Checks whether a fan is stalled or degraded
+ *
+ * @param fan fan
+ * @return true if the fan needs attention
+ */
+bool fan_tach_is_faulty(fan_tach_fan_t fan);
+
+/**
+ * @brief Copies the learned curve of a fan
+ *
+ * @param fan fan
+ * @param points destination, FAN_TACH_CURVE_POINTS points from 0% to 100% of duty
+ * @return ESP_OK on success, otherwise return ESP_FAIL
+ */
+esp_err_t fan_tach_get_curve(fan_tach_fan_t fan, fan_tach_curve_point_t points[FAN_TACH_CURVE_POINTS]);
+
+/**
+ * @brief Forgets the learned curve of a fan, e.g. after the fan was replaced
+ *
+ * @param fan fan
+ * @return ESP_OK on success, otherwise return ESP_FAIL
+ */
+esp_err_t fan_tach_clear_curve(fan_tach_fan_t fan);
+
+/**
+ * @brief Gets name of a fan
+ *
+ * @param fan fan
+ * @return name of the fan
+ */
+const char* fan_tach_get_name(fan_tach_fan_t fan);
+
+/**
+ * @brief Gets name of a fan state
+ *
+ * @param state state
+ * @return name of the state
+ */
+const char* fan_tach_get_state_name(fan_tach_state_t state);
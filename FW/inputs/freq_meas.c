@@ -0,0 +1,316 @@
+#include <stdio.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "esp_log.h"
+#include "esp_err.h"
+#include "esp_timer.h"
+#include "driver/pcnt.h"
+#include "driver/timer.h"
+#include "../mcu/peripherals.h"
+#include "freq_meas.h"
+#include "../system/perf.h"
+#include "../system/power.h"
+
+/* Free running timebase, 80 MHz APB clock divided by 2 */
+#define TIMEBASE_DIVIDER        2u
+#define TIMEBASE_TICKS_PER_US   40u
+#define TIMEBASE_HZ             (TIMEBASE_TICKS_PER_US * 1000000.0f)
+
+/* Pulse counter counts up to the watch point, which is limited to int16 */
+#define MIN_PERIODS         1u
+#define MAX_PERIODS         32767u
+
+/* Glitches shorter than this number of APB cycles are ignored */
+#define FILTER_CYCLES       10u
+
+/* Number of periods is changed only if it is off by this factor, to avoid retuning on noise */
+#define RETUNE_RATIO        2u
+
+/* Without a result for this many gate times the channel reports a timeout */
+#define TIMEOUT_GATES       10u
+#define EVENT_QUEUE_LENGTH  8u
+
+typedef struct
+{
+    uint64_t ticks;
+    uint32_t periods;
+    pcnt_unit_t unit;
+} freq_sample_t;
+
+typedef struct
+{
+    bool active;
+    pcnt_unit_t unit;
+    freq_meas_cb_t cb;
+    void *arg;
+    TickType_t last_result;
+    portMUX_TYPE lock;
+    uint64_t last_ticks;
+    bool reference_valid;
+    uint32_t periods;
+    uint32_t gate_ms;
+} freq_channel_t;
+
+static freq_channel_t channels[PCNT_UNIT_MAX];
+static QueueHandle_t events = NULL;
+
+/* Timebase and pulse filter run from APB, held from the first channel on */
+static esp_pm_lock_handle_t pm_lock = NULL;
+
+static const char *TAG = "freq_meas";
+
+/**
+ * @brief Watch point interrupt, timestamps the end of N periods and posts the
+ *        interval since the previous event to the task
+ * 
+ * @param arg channel
+ */
+static void freq_meas_isr(void *arg);
+
+/**
+ * @brief Sets number of periods after which the watch point event is raised,
+ *        discards the interval in progress
+ * 
+ * @param unit pulse counter unit of the channel
+ * @param periods number of periods
+ */
+static void freq_meas_set_periods(pcnt_unit_t unit, uint32_t periods);
+
+/**
+ * @brief Converts the interval to a result, retunes the channel and calls its callback
+ * 
+ * @param sample interval posted by the interrupt
+ */
+static void freq_meas_process(const freq_sample_t* const sample);
+
+/**
+ * @brief Reports timeout of channels which did not complete a measurement in time
+ */
+static void freq_meas_check_timeouts(void);
+
+esp_err_t freq_meas_init(void)
+{
+    if (NULL != events)
+    {
+        return ESP_OK;
+    }
+
+    timer_config_t config = {
+        .divider = TIMEBASE_DIVIDER,
+        .counter_dir = TIMER_COUNT_UP,
+        .counter_en = TIMER_PAUSE,
+        .alarm_en = TIMER_ALARM_DIS,
+        .auto_reload = TIMER_AUTORELOAD_DIS
+    };
+
+    if (ESP_OK != power_lock_create(ESP_PM_APB_FREQ_MAX, "freq_meas", &pm_lock) ||
+        ESP_OK != timer_init(ESP_TIMER_GROUP_FREQ, ESP_TIMER_FREQ, &config) ||
+        ESP_OK != timer_set_counter_value(ESP_TIMER_GROUP_FREQ, ESP_TIMER_FREQ, 0) ||
+        ESP_OK != timer_start(ESP_TIMER_GROUP_FREQ, ESP_TIMER_FREQ) ||
+        ESP_OK != pcnt_isr_service_install(0))
+    {
+        ESP_LOGE(TAG, "Timebase initialization failed");
+        return ESP_FAIL;
+    }
+
+    events = xQueueCreate(EVENT_QUEUE_LENGTH, sizeof(freq_sample_t));
+    return (NULL != events) ? ESP_OK : ESP_FAIL;
+}
+
+esp_err_t freq_meas_add_channel(pcnt_unit_t unit, gpio_num_t pin, uint32_t gate_ms, freq_meas_cb_t cb, void* arg)
+{
+    if (NULL == events || unit >= PCNT_UNIT_MAX || channels[unit].active || 0u == gate_ms || NULL == cb)
+    {
+        return ESP_FAIL;
+    }
+
+    freq_channel_t *channel = &channels[unit];
+    portMUX_INITIALIZE(&channel->lock);
+    channel->unit = unit;
+    channel->cb = cb;
+    channel->arg = arg;
+    channel->last_result = xTaskGetTickCount();
+    channel->reference_valid = false;
+    channel->gate_ms = gate_ms;
+    channel->periods = MIN_PERIODS;
+
+    pcnt_config_t pcnt_config = {
+        .pulse_gpio_num = pin,
+        .ctrl_gpio_num = PCNT_PIN_NOT_USED,
+        .channel = PCNT_CHANNEL_0,
+        .unit = unit,
+        .pos_mode = PCNT_COUNT_INC,   // Count up on the positive edge
+        .neg_mode = PCNT_COUNT_DIS,   // Keep the counter value on the negative edge
+        .lctrl_mode = PCNT_MODE_KEEP,
+        .hctrl_mode = PCNT_MODE_KEEP,
+        .counter_h_lim = (int16_t)channel->periods,
+        .counter_l_lim = 0,
+    };
+
+    if (ESP_OK != pcnt_unit_config(&pcnt_config))
+    {
+        return ESP_FAIL;
+    }
+    pcnt_set_filter_value(unit, FILTER_CYCLES);
+    pcnt_filter_enable(unit);
+
+    /* Counter is cleared by hardware when it reaches the high limit, no interval is lost between events */
+    pcnt_event_disable(unit, PCNT_EVT_L_LIM);
+    pcnt_event_disable(unit, PCNT_EVT_THRES_0);
+    pcnt_event_disable(unit, PCNT_EVT_THRES_1);
+    pcnt_event_disable(unit, PCNT_EVT_ZERO);
+    pcnt_event_enable(unit, PCNT_EVT_H_LIM);
+    pcnt_isr_handler_add(unit, freq_meas_isr, channel);
+
+    pcnt_counter_pause(unit);
+    pcnt_counter_clear(unit);
+    pcnt_intr_enable(unit);
+    pcnt_counter_resume(unit);
+
+    /* Lower APB would change the timebase and stop the counters in light sleep */
+    power_lock_acquire(pm_lock);
+    channel->active = true;
+    return ESP_OK;
+}
+
+void freq_meas_task(void *pvParameter)
+{
+    freq_sample_t sample;
+
+    while(1)
+    {
+        /* Wakes up with every result and at least every shortest gate time to detect stopped signals */
+        if (pdTRUE == xQueueReceive(events, &sample, pdMS_TO_TICKS(100u)))
+        {
+            freq_meas_process(&sample);
+        }
+        freq_meas_check_timeouts();
+    }
+}
+
+esp_err_t freq_meas_set_gate_time(pcnt_unit_t unit, uint32_t gate_ms)
+{
+    if (unit >= PCNT_UNIT_MAX || !channels[unit].active || 0u == gate_ms)
+    {
+        return ESP_FAIL;
+    }
+    channels[unit].gate_ms = gate_ms;
+    return ESP_OK;
+}
+
+uint32_t freq_meas_get_gate_time(pcnt_unit_t unit)
+{
+    if (unit >= PCNT_UNIT_MAX || !channels[unit].active)
+    {
+        return 0u;
+    }
+    return channels[unit].gate_ms;
+}
+
+static void freq_meas_set_periods(pcnt_unit_t unit, uint32_t periods)
+{
+    freq_channel_t *channel = &channels[unit];
+
+    /* New limit is taken over by the counter after clear */
+    pcnt_counter_pause(unit);
+    pcnt_set_event_value(unit, PCNT_EVT_H_LIM, (int16_t)periods);
+    taskENTER_CRITICAL(&channel->lock);
+    channel->periods = periods;
+    channel->reference_valid = false;
+    taskEXIT_CRITICAL(&channel->lock);
+    pcnt_counter_clear(unit);
+    pcnt_counter_resume(unit);
+
+    ESP_LOGD(TAG, "Unit %d measures %u periods", unit, (unsigned)periods);
+}
+
+static void freq_meas_process(const freq_sample_t* const sample)
+{
+    freq_channel_t *channel = &channels[sample->unit];
+    freq_meas_result_t result;
+
+    if (0u == sample->ticks)
+    {
+        return;
+    }
+
+    result.frequency_hz = (float)sample->periods * TIMEBASE_HZ / (float)sample->ticks;
+    result.periods = sample->periods;
+    result.gate_us = (uint32_t)(sample->ticks / TIMEBASE_TICKS_PER_US);
+    result.timestamp_us = esp_timer_get_time();
+    channel->last_result = xTaskGetTickCount();
+
+    /* Number of whole periods which fits the gate time at the measured frequency */
+    float wanted = result.frequency_hz * (float)channel->gate_ms / 1000.0f;
+    uint32_t periods = (wanted < (float)MIN_PERIODS) ? MIN_PERIODS :
+                       (wanted > (float)MAX_PERIODS) ? MAX_PERIODS : (uint32_t)wanted;
+
+    /* Results posted before the last retune are stale */
+    if (sample->periods == channel->periods &&
+        (periods > channel->periods * RETUNE_RATIO || periods * RETUNE_RATIO < channel->periods))
+    {
+        freq_meas_set_periods(sample->unit, periods);
+    }
+
+    channel->cb(ESP_OK, &result, channel->arg);
+}
+
+static void freq_meas_check_timeouts(void)
+{
+    const freq_meas_result_t empty = { 0 };
+    TickType_t now = xTaskGetTickCount();
+
+    for (int unit = 0; unit < PCNT_UNIT_MAX; unit++)
+    {
+        freq_channel_t *channel = &channels[unit];
+
+        if (!channel->active || (now - channel->last_result) < pdMS_TO_TICKS(channel->gate_ms * TIMEOUT_GATES))
+        {
+            continue;
+        }
+
+        /* Signal is slower than expected or missing, start again from a single period */
+        channel->last_result = now;
+        if (MIN_PERIODS != channel->periods)
+        {
+            freq_meas_set_periods((pcnt_unit_t)unit, MIN_PERIODS);
+        }
+        channel->cb(ESP_ERR_TIMEOUT, &empty, channel->arg);
+    }
+}
+
+static void freq_meas_isr(void *arg)
+{
+    PERF_SCOPE(PERF_PROBE_FREQ_MEAS_ISR);
+    freq_channel_t *channel = (freq_channel_t *)arg;
+    uint64_t now = timer_group_get_counter_value_in_isr(ESP_TIMER_GROUP_FREQ, ESP_TIMER_FREQ);
+    BaseType_t woken = pdFALSE;
+    freq_sample_t sample;
+    uint32_t status = 0u;
+    bool post;
+
+    pcnt_get_event_status(channel->unit, &status);
+    if (0u == (status & PCNT_EVT_H_LIM))
+    {
+        return;
+    }
+
+    taskENTER_CRITICAL_ISR(&channel->lock);
+    post = channel->reference_valid;
+    sample.ticks = now - channel->last_ticks;
+    sample.periods = channel->periods;
+    sample.unit = channel->unit;
+    channel->last_ticks = now;
+    channel->reference_valid = true;
+    taskEXIT_CRITICAL_ISR(&channel->lock);
+
+    if (post)
+    {
+        xQueueSendFromISR(events, &sample, &woken);
+    }
+    if (pdTRUE == woken)
+    {
+        portYIELD_FROM_ISR();
+    }
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "driver/gpio.h"
+#include "driver/pcnt.h"
+
+/**
+ * @brief Result of one reciprocal frequency measurement
+ */
+typedef struct
+{
+    float frequency_hz;         /*!< measured frequency */
+    uint32_t periods;           /*!< number of whole input periods measured */
+    uint32_t gate_us;           /*!< duration of the measured periods */
+    int64_t timestamp_us;       /*!< time of the end of measurement (esp_timer_get_time) */
+} freq_meas_result_t;
+
+/**
+ * @brief Called from frequency measurement task with every result of the channel
+ * 
+ * @param status ESP_OK with a new result, ESP_ERR_TIMEOUT if no periods were completed in time
+ * @param result measurement, all zero on timeout
+ * @param arg argument given when the channel was added
+ */
+typedef void (*freq_meas_cb_t)(esp_err_t status, const freq_meas_result_t* result, void* arg);
+
+/**
+ * @brief Starts the shared timebase and the PCNT interrupt service, safe to call more than once
+ * 
+ * @return ESP_OK on success, otherwise return ESP_FAIL
+ */
+esp_err_t freq_meas_init(void);
+
+/**
+ * @brief Starts reciprocal measurement of a signal. The pulse counter raises an event
+ *        every N rising edges and the interrupt timestamps it with the shared timebase,
+ *        so each result covers N whole periods. N follows the input frequency to keep
+ *        the measurement close to the gate time. Channels are added before
+ *        freq_meas_task starts.
+ * 
+ * @param unit pulse counter unit used by the channel
+ * @param pin input pin
+ * @param gate_ms requested duration of one measurement
+ * @param cb callback receiving results of the channel
+ * @param arg argument of the callback
+ * @return ESP_OK on success, otherwise return ESP_FAIL
+ */
+esp_err_t freq_meas_add_channel(pcnt_unit_t unit, gpio_num_t pin, uint32_t gate_ms, freq_meas_cb_t cb, void* arg);
+
+/**
+ * @brief Frequency measurement task, converts interrupt timestamps of all channels
+ *        to results and passes them to the callbacks
+ * 
+ * @param pvParameter parameter of task (not used)
+ */
+void freq_meas_task(void *pvParameter);
+
+/**
+ * @brief Changes gate time of the channel, applied after the next measurement
+ * 
+ * @param unit pulse counter unit of the channel
+ * @param gate_ms requested duration of one measurement
+ * @return ESP_OK on success, otherwise return ESP_FAIL
+ */
+esp_err_t freq_meas_set_gate_time(pcnt_unit_t unit, uint32_t gate_ms);
+
+/**
+ * @brief Gets gate time of the channel
+ * 
+ * @param unit pulse counter unit of the channel
+ * @return gate time in ms, 0 if the channel is not started
+ */
+uint32_t freq_meas_get_gate_time(pcnt_unit_t unit);
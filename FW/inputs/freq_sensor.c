@@ -0,0 +1,165 @@
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freq_meas.h"
+#include "freq_sensor.h"
+
+/**
+ * @brief Frequency measurement callback, runs the filter chain and the calibration
+ * 
+ * @param status result status
+ * @param result frequency measurement
+ * @param arg sensor state
+ */
+static void freq_sensor_on_result(esp_err_t status, const freq_meas_result_t* result, void* arg);
+
+esp_err_t freq_sensor_init(freq_sensor_t* const sensor, pcnt_unit_t unit, gpio_num_t pin, uint32_t gate_ms,
+                           const signal_filter_config_t* const filter_config, float min_value, float max_value,
+                           data_store_signal_t signal)
+{
+    memset(sensor, 0, sizeof(*sensor));
+    portMUX_INITIALIZE(&sensor->lock);
+    sensor->unit = unit;
+    sensor->min_value = min_value;
+    sensor->max_value = max_value;
+    sensor->signal = signal;
+    calibration_init(&sensor->calibration);
+    signal_filter_init(&sensor->filter, filter_config);
+
+    return freq_meas_add_channel(unit, pin, gate_ms, freq_sensor_on_result, sensor);
+}
+
+esp_err_t freq_sensor_get_value(freq_sensor_t* const sensor, float* const value)
+{
+    esp_err_t ret = ESP_FAIL;
+
+    taskENTER_CRITICAL(&sensor->lock);
+    *value = sensor->value;
+    if (sensor->value_valid)
+    {
+        ret = ESP_OK;
+    }
+    taskEXIT_CRITICAL(&sensor->lock);
+
+    return ret;
+}
+
+float freq_sensor_get_frequency(freq_sensor_t* const sensor)
+{
+    taskENTER_CRITICAL(&sensor->lock);
+    float freq = sensor->raw_freq;
+    taskEXIT_CRITICAL(&sensor->lock);
+
+    return freq;
+}
+
+float freq_sensor_get_filtered_frequency(freq_sensor_t* const sensor)
+{
+    taskENTER_CRITICAL(&sensor->lock);
+    float freq = sensor->filtered_freq;
+    taskEXIT_CRITICAL(&sensor->lock);
+
+    return freq;
+}
+
+esp_err_t freq_sensor_add_point(freq_sensor_t* const sensor, float freq, float value)
+{
+    if (0.0f >= freq)
+    {
+        freq = freq_sensor_get_filtered_frequency(sensor);
+    }
+    if (0.0f >= freq || sensor->min_value > value || sensor->max_value < value)
+    {
+        return ESP_FAIL;
+    }
+
+    taskENTER_CRITICAL(&sensor->lock);
+    esp_err_t ret = calibration_add_point(&sensor->calibration, freq, value);
+    taskEXIT_CRITICAL(&sensor->lock);
+
+    return ret;
+}
+
+esp_err_t freq_sensor_remove_point(freq_sensor_t* const sensor, uint8_t index)
+{
+    taskENTER_CRITICAL(&sensor->lock);
+    esp_err_t ret = calibration_remove_point(&sensor->calibration, index);
+    if (2u > sensor->calibration.count)
+    {
+        sensor->value_valid = false;
+    }
+    taskEXIT_CRITICAL(&sensor->lock);
+
+    return ret;
+}
+
+uint8_t freq_sensor_get_points(freq_sensor_t* const sensor, calibration_point_t* const points)
+{
+    taskENTER_CRITICAL(&sensor->lock);
+    uint8_t count = sensor->calibration.count;
+    memcpy(points, sensor->calibration.points, count * sizeof(calibration_point_t));
+    taskEXIT_CRITICAL(&sensor->lock);
+
+    return count;
+}
+
+void freq_sensor_set_filter(freq_sensor_t* const sensor, const signal_filter_config_t* const config)
+{
+    taskENTER_CRITICAL(&sensor->lock);
+    signal_filter_init(&sensor->filter, config);
+    taskEXIT_CRITICAL(&sensor->lock);
+}
+
+void freq_sensor_get_filter(freq_sensor_t* const sensor, signal_filter_config_t* const config)
+{
+    taskENTER_CRITICAL(&sensor->lock);
+    *config = sensor->filter.config;
+    taskEXIT_CRITICAL(&sensor->lock);
+}
+
+static void freq_sensor_on_result(esp_err_t status, const freq_meas_result_t* result, void* arg)
+{
+    freq_sensor_t *sensor = (freq_sensor_t *)arg;
+    data_store_quality_t quality = DATA_STORE_QUALITY_NONE;
+    float published = 0.0f;
+
+    taskENTER_CRITICAL(&sensor->lock);
+    if (ESP_OK != status)
+    {
+        sensor->raw_freq = 0.0f;
+    }
+    else
+    {
+        sensor->raw_freq = result->frequency_hz;
+        if (signal_filter_update(&sensor->filter, result->frequency_hz))
+        {
+            float value;
+
+            sensor->filtered_freq = signal_filter_get_output(&sensor->filter);
+            /* Segment slopes are precomputed when the table changes, this is a lookup and one multiply */
+            sensor->value_valid = (ESP_OK == calibration_apply(&sensor->calibration, sensor->filtered_freq, &value));
+            if (sensor->value_valid)
+            {
+                sensor->value = value;
+                published = value;
+                quality = DATA_STORE_QUALITY_GOOD;
+            }
+        }
+    }
+    taskEXIT_CRITICAL(&sensor->lock);
+
+    if (DATA_STORE_QUALITY_GOOD == quality)
+    {
+        data_store_publish_float(sensor->signal, published);
+    }
+    else if (ESP_OK != status)
+    {
+        if (sensor->zero_when_stopped)
+        {
+            data_store_publish_float(sensor->signal, 0.0f);
+        }
+        else
+        {
+            data_store_set_quality(sensor->signal, DATA_STORE_QUALITY_STALE);
+        }
+    }
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "esp_err.h"
+#include "driver/gpio.h"
+#include "driver/pcnt.h"
+#include "calibration.h"
+#include "signal_filter.h"
+#include "../system/data_store.h"
+
+/**
+ * @brief Sensor with frequency output: measured frequency passes the filter chain
+ *        and is converted to a physical value with the calibration table
+ */
+typedef struct
+{
+    portMUX_TYPE lock;
+    pcnt_unit_t unit;
+    calibration_table_t calibration;
+    signal_filter_t filter;
+    float min_value;
+    float max_value;
+    float raw_freq;
+    float filtered_freq;
+    float value;
+    bool value_valid;
+    data_store_signal_t signal;     /*!< slot the value is published to */
+    bool zero_when_stopped;         /*!< stopped signal means value 0 instead of a stale value */
+} freq_sensor_t;
+
+/**
+ * @brief Initializes the sensor and adds its channel to frequency measurement
+ * 
+ * @param sensor sensor state
+ * @param unit pulse counter unit
+ * @param pin input pin
+ * @param gate_ms duration of a single frequency measurement
+ * @param filter_config filter chain of the frequency
+ * @param min_value lowest value accepted for a calibration point
+ * @param max_value highest value accepted for a calibration point
+ * @param signal data store slot the value is published to with every result
+ * @return ESP_OK on success, otherwise return ESP_FAIL
+ */
+esp_err_t freq_sensor_init(freq_sensor_t* const sensor, pcnt_unit_t unit, gpio_num_t pin, uint32_t gate_ms,
+                           const signal_filter_config_t* const filter_config, float min_value, float max_value,
+                           data_store_signal_t signal);
+
+/**
+ * @brief Gets value computed from filtered frequency with the calibration table
+ * 
+ * @param sensor sensor state
+ * @param value physical value
+ * @return ESP_OK on success, ESP_FAIL if the sensor has less than two calibration points
+ */
+esp_err_t freq_sensor_get_value(freq_sensor_t* const sensor, float* const value);
+
+/**
+ * @brief Gets last measured frequency
+ * 
+ * @param sensor sensor state
+ * @return raw frequency in Hz, 0 if the signal is stopped
+ */
+float freq_sensor_get_frequency(freq_sensor_t* const sensor);
+
+/**
+ * @brief Gets output of the filter chain
+ * 
+ * @param sensor sensor state
+ * @return filtered frequency in Hz
+ */
+float freq_sensor_get_filtered_frequency(freq_sensor_t* const sensor);
+
+/**
+ * @brief Adds calibration point, a point with the same value or frequency is replaced
+ * 
+ * @param sensor sensor state
+ * @param freq frequency in Hz, 0 to use current filtered frequency
+ * @param value physical value
+ * @return ESP_OK on success, otherwise return ESP_FAIL
+ */
+esp_err_t freq_sensor_add_point(freq_sensor_t* const sensor, float freq, float value);
+
+/**
+ * @brief Removes calibration point
+ * 
+ * @param sensor sensor state
+ * @param index index of the point, points are sorted by frequency
+ * @return ESP_OK on success, otherwise return ESP_FAIL
+ */
+esp_err_t freq_sensor_remove_point(freq_sensor_t* const sensor, uint8_t index);
+
+/**
+ * @brief Copies calibration points
+ * 
+ * @param sensor sensor state
+ * @param points destination for up to CALIBRATION_MAX_POINTS points
+ * @return number of points
+ */
+uint8_t freq_sensor_get_points(freq_sensor_t* const sensor, calibration_point_t* const points);
+
+/**
+ * @brief Sets up filter chain, resets the filter
+ * 
+ * @param sensor sensor state
+ * @param config filter configuration
+ */
+void freq_sensor_set_filter(freq_sensor_t* const sensor, const signal_filter_config_t* const config);
+
+/**
+ * @brief Gets configuration of the filter chain
+ * 
+ * @param sensor sensor state
+ * @param config destination of the configuration
+ */
+void freq_sensor_get_filter(freq_sensor_t* const sensor, signal_filter_config_t* const config);
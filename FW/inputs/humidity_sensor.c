@@ -1,81 +1,155 @@
 #include <stdio.h>
+#include <string.h>
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
 #include "esp_log.h"
+#include "esp_timer.h"
 #include "../third_party/dht.h"
-#include "math.h"
 #include "humidity_sensor.h"
+#include "psychrometrics.h"
 #include "../mcu/pinout.h"
+#include "../system/scheduler.h"
+#include "../system/data_store.h"
+#include "../system/power.h"
 
 #define SENSOR_TYPE DHT_TYPE_AM2301
 #define SENSOR_GPIO ESP_PIN_DHT21_DATA
+#define DEFAULT_PERIOD_MS 5000u
 
-static float temperature = 0u;
-static float humidity = 0u;
-static float dew_point = 0u;
+static volatile uint32_t sample_period_ms = DEFAULT_PERIOD_MS;
+static scheduler_job_id_t sensor_job;
+static bool sensor_job_added = false;
+
+/* Published sample guarded by a sequence counter, odd while the task writes it.
+   Readers retry the copy if the counter changed, so nobody waits for a lock. */
+static volatile uint32_t snapshot_seq = 0u;
+static humidity_sensor_snapshot_t snapshot;
+
+/* Bits are timed by busy waits, frequency is kept and light sleep held off during a read */
+static esp_pm_lock_handle_t pm_lock = NULL;
 
 static const char *TAG = "humidity_sensor";
 
 /**
- * @brief calculate dew point
- * 
- * @param celsius temperature in celsius deg
- * @param humidity humidity in percent
- * @return calculated dew point in celsius deg
+ * @brief Reads the sensor and publishes the result, the job of the sensor
  */
-static double dew_point_calc(double celsius, double humidity);
+static void humidity_sensor_sample(void);
 
-void humidity_sensor_task(void *pvParameters)
+esp_err_t humidity_sensor_init(void)
 {
-    while (1)
+    /* The sensor needs the minimum period after power up before the first read, the first release is one period later.
+       A read blocks for the start pulse and the transfer, it runs on the worker pool. */
+    esp_err_t ret = power_lock_create(ESP_PM_CPU_FREQ_MAX, "dht", &pm_lock);
+
+    if (ESP_OK == ret)
     {
-        vTaskDelay(pdMS_TO_TICKS(100u));
+        ret = scheduler_add_job("humidity_sensor", &humidity_sensor_sample, sample_period_ms, SCHEDULER_EXEC_WORKER, &sensor_job);
     }
+    sensor_job_added = (ESP_OK == ret);
+    return ret;
+}
+
+void humidity_sensor_get_snapshot(humidity_sensor_snapshot_t* const snapshot_out)
+{
+    uint32_t seq;
+
+    do
+    {
+        seq = __atomic_load_n(&snapshot_seq, __ATOMIC_ACQUIRE);
+        memcpy(snapshot_out, &snapshot, sizeof(snapshot));
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    } while ((0u != (seq & 1u)) || (seq != __atomic_load_n(&snapshot_seq, __ATOMIC_RELAXED)));
 }
 
 esp_err_t humidity_sensor_read(float* hum, float* temp, float* dew)
 {
-    esp_err_t ret = ESP_FAIL;
+    humidity_sensor_snapshot_t sample;
 
-    if (dht_read_float_data(SENSOR_TYPE, SENSOR_GPIO, &humidity, &temperature) == ESP_OK)
+    humidity_sensor_get_snapshot(&sample);
+
+    if (0 == sample.timestamp_us)
     {
-        dew_point = (float)dew_point_calc((double)temperature, (double)humidity);
+        ESP_LOGE(TAG,"No data read from sensor yet\n");
+        return ESP_FAIL;
+    }
 
-        *temp = temperature;
-        *hum = humidity;
-        *dew = dew_point;
+    *temp = sample.temperature;
+    *hum = sample.humidity;
+    *dew = sample.dew_point;
 
-        ret = ESP_OK;
-    }     
-    else
+    return ESP_OK;
+}
+
+esp_err_t humidity_sensor_set_period(uint32_t period_ms)
+{
+    if (period_ms < HUMIDITY_SENSOR_MIN_PERIOD_MS)
     {
-        ESP_LOGE(TAG,"Could not read data from sensor\n");
-        ret = ESP_FAIL;
+        ESP_LOGE(TAG,"Sampling period shorter than %u ms\n", HUMIDITY_SENSOR_MIN_PERIOD_MS);
+        return ESP_FAIL;
     }
 
-    return ret;
+    sample_period_ms = period_ms;
+
+    if (sensor_job_added)
+    {
+        scheduler_set_period(sensor_job, period_ms);
+    }
+
+    return ESP_OK;
 }
 
-/*****************************************************
-*
-* dew point calculation, code downloaded from:
-* https://www.best-microcontroller-projects.com/dht22.html
-*
-******************************************************/
-static double dew_point_calc(double celsius, double humidity){
-
-  // (1) Saturation Vapor Pressure = ESGG(T)
-  double RATIO = 373.15 / (273.15 + celsius);
-  double RHS = -7.90298 * (RATIO - 1);
-  RHS += 5.02808 * log10(RATIO);
-  RHS += -1.3816e-7 * (pow(10, (11.344 * (1 - 1 / RATIO ))) - 1) ;
-  RHS += 8.1328e-3 * (pow(10, (-3.49149 * (RATIO - 1))) - 1) ;
-  RHS += log10(1013.246);
-
-  // factor -3 is to adjust units - Vapor Pressure SVP * humidity
-  double VP = pow(10, RHS - 3) * humidity;
-
-  // (2) DEWPOINT = F(Vapor Pressure)
-  double T = log(VP / 0.61078); // temp var
-  return (241.88 * T) / (17.558 - T);
-}
\ No newline at end of file
+uint32_t humidity_sensor_get_period(void)
+{
+    return sample_period_ms;
+}
+
+static void humidity_sensor_sample(void)
+{
+    float humidity = 0.0f;
+    float temperature = 0.0f;
+    bool ok;
+
+    power_lock_acquire(pm_lock);
+    ok = (ESP_OK == dht_read_float_data(SENSOR_TYPE, SENSOR_GPIO, &humidity, &temperature));
+    power_lock_release(pm_lock);
+
+    if (!ok)
+    {
+        ESP_LOGE(TAG,"Could not read data from sensor\n");
+    }
+
+    __atomic_store_n(&snapshot_seq, snapshot_seq + 1u, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    if (ok)
+    {
+        snapshot.humidity = humidity;
+        snapshot.temperature = temperature;
+        snapshot.dew_point = psychrometrics_dew_point(temperature, humidity);
+        snapshot.absolute_humidity = psychrometrics_absolute_humidity(temperature, humidity);
+        snapshot.vpd = psychrometrics_vpd(temperature, humidity);
+        snapshot.timestamp_us = esp_timer_get_time();
+    }
+    else
+    {
+        snapshot.error_count++;
+    }
+    snapshot.last_read_ok = ok;
+
+    __atomic_store_n(&snapshot_seq, snapshot_seq + 1u, __ATOMIC_RELEASE);
+
+    if (ok)
+    {
+        data_store_publish_float(DATA_STORE_AIR_TEMPERATURE, snapshot.temperature);
+        data_store_publish_float(DATA_STORE_AIR_HUMIDITY, snapshot.humidity);
+        data_store_publish_float(DATA_STORE_DEW_POINT, snapshot.dew_point);
+        data_store_publish_float(DATA_STORE_VPD, snapshot.vpd);
+    }
+    else
+    {
+        data_store_set_quality(DATA_STORE_AIR_TEMPERATURE, DATA_STORE_QUALITY_STALE);
+        data_store_set_quality(DATA_STORE_AIR_HUMIDITY, DATA_STORE_QUALITY_STALE);
+        data_store_set_quality(DATA_STORE_DEW_POINT, DATA_STORE_QUALITY_STALE);
+        data_store_set_quality(DATA_STORE_VPD, DATA_STORE_QUALITY_STALE);
+    }
+}
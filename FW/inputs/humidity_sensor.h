@@ -1,18 +1,62 @@
-#pragma once
-
-/**
- * @brief humidity sensor sensor task
- * 
- * @param pvParameters parameter of task (not used)
- */
-void humidity_sensor_task(void *pvParameters);
-
-/**
- * @brief read data from humidity sensor and print it to the console
- * 
- * @param hum humidity
- * @param temp teperature
- * @param dew dew point 
- * @return ESP_FAIL on fail or ESP_OK on success
- */
-esp_err_t humidity_sensor_read(float* hum, float* temp, float* dew);
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+#define HUMIDITY_SENSOR_MIN_PERIOD_MS 2000u
+
+/**
+ * @brief Last sample published by humidity sensor job
+ */
+typedef struct
+{
+    float humidity;             /*!< relative humidity in percent */
+    float temperature;          /*!< temperature in Celsius */
+    float dew_point;            /*!< dew point in Celsius */
+    float absolute_humidity;    /*!< absolute humidity in g/m3 */
+    float vpd;                  /*!< vapour pressure deficit in kPa */
+    int64_t timestamp_us;       /*!< time of the last successful read (esp_timer_get_time), 0 if none yet */
+    uint32_t error_count;       /*!< number of failed reads since start */
+    bool last_read_ok;          /*!< false if the most recent read failed, values are from an older sample */
+} humidity_sensor_snapshot_t;
+
+/**
+ * @brief Adds the sensor job to the scheduler, it reads the sensor on the worker pool
+ *        every sampling period. The first read is one period after the scheduler starts.
+ * 
+ * @return ESP_OK on success, otherwise return ESP_FAIL
+ */
+esp_err_t humidity_sensor_init(void);
+
+/**
+ * @brief Copies the last published sample, does not access the sensor and does not block
+ * 
+ * @param snapshot destination of the sample
+ */
+void humidity_sensor_get_snapshot(humidity_sensor_snapshot_t* const snapshot);
+
+/**
+ * @brief Gets last successfully read data, does not access the sensor
+ * 
+ * @param hum humidity
+ * @param temp teperature
+ * @param dew dew point 
+ * @return ESP_FAIL if no sample was read yet or ESP_OK on success
+ */
+esp_err_t humidity_sensor_read(float* hum, float* temp, float* dew);
+
+/**
+ * @brief Sets sampling period of the sensor
+ * 
+ * @param period_ms sampling period in ms, at least HUMIDITY_SENSOR_MIN_PERIOD_MS
+ * @return ESP_FAIL if period is too short or ESP_OK on success
+ */
+esp_err_t humidity_sensor_set_period(uint32_t period_ms);
+
+/**
+ * @brief Gets sampling period of the sensor
+ * 
+ * @return sampling period in ms
+ */
+uint32_t humidity_sensor_get_period(void);
@@ -0,0 +1,86 @@
+#include <stdio.h>
+#include "freertos/FreeRTOS.h"
+#include "esp_err.h"
+#include "../mcu/pinout.h"
+#include "../mcu/peripherals.h"
+#include "freq_sensor.h"
+#include "light_sensor.h"
+
+#define LIGHT_PCNT_UNIT     ESP_PCNT_UNIT_LIGHT
+#define LIGHT_INPUT_SIG_IO  ESP_PIN_LIGHT_SENSOR
+
+/* Light integral is sampled every second, a shorter gate follows clouds without aliasing */
+#define DEFAULT_GATE_MS     250u
+
+#define MIN_PPFD            0.0f
+#define MAX_PPFD            2500.0f
+
+/* Linear default of the sensor behind its diffuser, replaced by calibration against a quantum meter */
+#define DEFAULT_HZ_AT_1000_PPFD 50000.0f
+
+#define DEFAULT_OUTLIER_RATIO   0.5f
+#define DEFAULT_OUTLIER_LIMIT   3u
+#define DEFAULT_MEDIAN_WINDOW   3u
+#define DEFAULT_EMA_ALPHA       0.3f
+
+static freq_sensor_t light;
+
+esp_err_t light_sensor_init(void)
+{
+    const signal_filter_config_t filter_config = {
+        .outlier_ratio = DEFAULT_OUTLIER_RATIO,
+        .outlier_limit = DEFAULT_OUTLIER_LIMIT,
+        .median_window = DEFAULT_MEDIAN_WINDOW,
+        .ema_alpha = DEFAULT_EMA_ALPHA
+    };
+
+    if (ESP_OK != freq_sensor_init(&light, LIGHT_PCNT_UNIT, LIGHT_INPUT_SIG_IO, DEFAULT_GATE_MS, &filter_config,
+                                   MIN_PPFD, MAX_PPFD, DATA_STORE_PPFD))
+    {
+        return ESP_FAIL;
+    }
+
+    /* Sensor output goes to zero in darkness, so the default line passes through the origin */
+    taskENTER_CRITICAL(&light.lock);
+    light.zero_when_stopped = true;
+    calibration_add_point(&light.calibration, 0.0f, 0.0f);
+    calibration_add_point(&light.calibration, DEFAULT_HZ_AT_1000_PPFD, 1000.0f);
+    taskEXIT_CRITICAL(&light.lock);
+    return ESP_OK;
+}
+
+esp_err_t light_sensor_get_ppfd(float* const ppfd)
+{
+    /* In darkness the sensor stops pulsing and the measurement times out instead of giving a new value */
+    if (0.0f == freq_sensor_get_frequency(&light))
+    {
+        *ppfd = 0.0f;
+        return ESP_OK;
+    }
+    return freq_sensor_get_value(&light, ppfd);
+}
+
+float light_sensor_get_frequency(void)
+{
+    return freq_sensor_get_frequency(&light);
+}
+
+float light_sensor_get_filtered_frequency(void)
+{
+    return freq_sensor_get_filtered_frequency(&light);
+}
+
+esp_err_t light_sensor_add_point(float freq, float ppfd)
+{
+    return freq_sensor_add_point(&light, freq, ppfd);
+}
+
+esp_err_t light_sensor_remove_point(uint8_t index)
+{
+    return freq_sensor_remove_point(&light, index);
+}
+
+uint8_t light_sensor_get_points(calibration_point_t* const points)
+{
+    return freq_sensor_get_points(&light, points);
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <stdint.h>
+#include "esp_err.h"
+#include "calibration.h"
+
+/**
+ * @brief Initialize frequency input of the light-to-frequency sensor, results are processed by freq_meas_task.
+ *        The calibration starts with a linear default of the sensor.
+ * 
+ * @return ESP_OK for success
+ */
+esp_err_t light_sensor_init(void);
+
+/**
+ * @brief Get photosynthetic photon flux density computed from filtered frequency with the calibration table
+ * 
+ * @param ppfd pointer to PPFD in umol/m2/s
+ * @return ESP_OK for success, ESP_FAIL if no valid measurement yet
+ */
+esp_err_t light_sensor_get_ppfd(float* const ppfd);
+
+/**
+ * @brief Return last measured frequency of the light sensor
+ * 
+ * @return Last measured raw frequency in Hz, 0 in darkness
+ */
+float light_sensor_get_frequency(void);
+
+/**
+ * @brief Return filtered frequency of the light sensor
+ * 
+ * @return Filtered frequency in Hz
+ */
+float light_sensor_get_filtered_frequency(void);
+
+/**
+ * @brief Add calibration point, a point with the same PPFD or frequency is replaced
+ * 
+ * @param freq frequency in Hz, 0 to use current filtered frequency
+ * @param ppfd reference PPFD in umol/m2/s
+ * @return ESP_OK for success
+ */
+esp_err_t light_sensor_add_point(float freq, float ppfd);
+
+/**
+ * @brief Remove calibration point
+ * 
+ * @param index index of the point, points are sorted by frequency
+ * @return ESP_OK for success
+ */
+esp_err_t light_sensor_remove_point(uint8_t index);
+
+/**
+ * @brief Copy calibration points
+ * 
+ * @param points destination for up to CALIBRATION_MAX_POINTS points
+ * @return number of points
+ */
+uint8_t light_sensor_get_points(calibration_point_t* const points);
@@ -0,0 +1,359 @@
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "esp_err.h"
+#include "esp_timer.h"
+#include "esp_adc_cal.h"
+#include "driver/adc.h"
+#include "sdkconfig.h"
+#include "../mcu/peripherals.h"
+#include "../system/data_store.h"
+#include "power_meter.h"
+
+#define ADC_SAMPLE_RATE_HZ      CONFIG_DONICZKA_POWER_SAMPLE_RATE_HZ
+#define ADC_READ_BYTES          256u
+#define ADC_BUFFER_BYTES        4096u
+#define ADC_READ_TIMEOUT_MS     100u
+
+/* One block is a pair of voltage and current samples per frame, 100 ms of data */
+#define BLOCK_FRAMES            (ADC_SAMPLE_RATE_HZ / 2u / 10u)
+
+/* Conversion to pin millivolts is linearized between these raw values */
+#define ADC_LINEAR_RAW_LOW      500u
+#define ADC_LINEAR_RAW_HIGH     3500u
+#define ADC_DEFAULT_VREF_MV     1100u
+
+#define VOLTAGE_RATIO           (CONFIG_DONICZKA_POWER_VOLTAGE_RATIO_PERMILLE / 1000.0f)
+#define CURRENT_A_PER_V         (CONFIG_DONICZKA_POWER_CURRENT_MA_PER_V / 1000.0f)
+#define CURRENT_OFFSET_MV       ((float)CONFIG_DONICZKA_POWER_CURRENT_OFFSET_MV)
+
+/* Recursive least squares of block power against output duties: base power and power of each output at full duty */
+#define RLS_SIZE                (1u + POWER_METER_ACTUATORS_NUM)
+#define RLS_FORGETTING          0.995f
+#define RLS_INITIAL_COVARIANCE  1000.0f
+/* Forgetting is suspended above this covariance trace, constant duties would otherwise wind it up */
+#define RLS_MAX_TRACE           1.0e5f
+
+#define SECONDS_PER_HOUR        3600.0f
+
+#if CONFIG_IDF_TARGET_ESP32
+#define ADC_OUTPUT_FORMAT       ADC_DIGI_OUTPUT_FORMAT_TYPE1
+#define ADC_SAMPLE_CHANNEL(p)   ((p)->type1.channel)
+#define ADC_SAMPLE_DATA(p)      ((p)->type1.data)
+#else
+#define ADC_OUTPUT_FORMAT       ADC_DIGI_OUTPUT_FORMAT_TYPE2
+#define ADC_SAMPLE_CHANNEL(p)   ((p)->type2.channel)
+#define ADC_SAMPLE_DATA(p)      ((p)->type2.data)
+#endif
+
+typedef struct
+{
+    float sum_v;
+    float sum_v2;
+    float sum_i;
+    float sum_i2;
+    float sum_p;
+    float last_v;
+    uint32_t n_v;
+    uint32_t n_i;
+    uint32_t n_p;
+} power_block_t;
+
+static const char *actuator_names[POWER_METER_ACTUATORS_NUM] = {
+    "cooling_pump",
+    "watering_pump",
+    "cooling_ventilator",
+    "dehumyfing_ventilator",
+    "peltier"
+};
+
+/* Linear conversion of raw ADC value to pin millivolts */
+static float adc_gain_mv;
+static float adc_offset_mv;
+
+static float rls_theta[RLS_SIZE];
+static float rls_p[RLS_SIZE][RLS_SIZE];
+
+static portMUX_TYPE snapshot_mux = portMUX_INITIALIZER_UNLOCKED;
+static power_meter_snapshot_t snapshot;
+
+static const char *TAG = "power_meter";
+
+/**
+ * @brief Configures continuous ADC conversion of both channels into the DMA ring buffer
+ * 
+ * @return ESP_OK on success, otherwise return ESP_FAIL
+ */
+static esp_err_t power_meter_init(void);
+
+/**
+ * @brief Computes statistics of a finished block, updates the estimate of output power and integrates energy
+ * 
+ * @param block accumulated samples
+ * @param duration_s duration of the block
+ */
+static void power_meter_process_block(const power_block_t* const block, float duration_s);
+
+/**
+ * @brief Collects current duty of all outputs
+ * 
+ * @param duty duty of every output in 0 - 1
+ */
+static void power_meter_get_duties(float duty[POWER_METER_ACTUATORS_NUM]);
+
+/**
+ * @brief Recursive least squares update
+ * 
+ * @param x regressor, 1 followed by duties
+ * @param y measured power
+ */
+static void power_meter_rls_update(const float x[RLS_SIZE], float y);
+
+void power_meter_task(void *pvParameter)
+{
+    uint8_t buffer[ADC_READ_BYTES];
+    power_block_t block;
+    int64_t block_start;
+
+    if (ESP_OK != power_meter_init())
+    {
+        ESP_LOGE(TAG, "ADC initialization failed");
+        vTaskDelete(NULL);
+    }
+
+    memset(&block, 0, sizeof(block));
+    block_start = esp_timer_get_time();
+
+    while (1)
+    {
+        uint32_t length = 0u;
+        esp_err_t ret = adc_digi_read_bytes(buffer, sizeof(buffer), &length, ADC_READ_TIMEOUT_MS);
+
+        if (ESP_ERR_INVALID_STATE == ret)
+        {
+            /* Task did not keep up, the oldest samples were dropped, continue with the current block */
+            ESP_LOGW(TAG, "ADC buffer overflow");
+        }
+        else if (ESP_OK != ret)
+        {
+            continue;
+        }
+
+        for (uint32_t i = 0u; i + sizeof(adc_digi_output_data_t) <= length; i += sizeof(adc_digi_output_data_t))
+        {
+            const adc_digi_output_data_t *sample = (const adc_digi_output_data_t *)&buffer[i];
+            float pin_mv = (float)ADC_SAMPLE_DATA(sample) * adc_gain_mv + adc_offset_mv;
+
+            if (ESP_ADC_CH_V_MEAS == ADC_SAMPLE_CHANNEL(sample))
+            {
+                float v = pin_mv * 0.001f * VOLTAGE_RATIO;
+                block.sum_v += v;
+                block.sum_v2 += v * v;
+                block.last_v = v;
+                block.n_v++;
+            }
+            else if (ESP_ADC_CH_CURR_MEAS == ADC_SAMPLE_CHANNEL(sample))
+            {
+                float a = (pin_mv - CURRENT_OFFSET_MV) * 0.001f * CURRENT_A_PER_V;
+                block.sum_i += a;
+                block.sum_i2 += a * a;
+                block.n_i++;
+                /* Channels are converted alternately, current is paired with the voltage just before it */
+                if (0u != block.n_v)
+                {
+                    block.sum_p += block.last_v * a;
+                    block.n_p++;
+                }
+            }
+        }
+
+        if (BLOCK_FRAMES <= block.n_i && BLOCK_FRAMES <= block.n_v)
+        {
+            int64_t now = esp_timer_get_time();
+            power_meter_process_block(&block, (float)(now - block_start) * 1.0e-6f);
+            memset(&block, 0, sizeof(block));
+            block_start = now;
+        }
+    }
+}
+
+void power_meter_get_snapshot(power_meter_snapshot_t* const snapshot_out)
+{
+    taskENTER_CRITICAL(&snapshot_mux);
+    *snapshot_out = snapshot;
+    taskEXIT_CRITICAL(&snapshot_mux);
+}
+
+void power_meter_reset_energy(void)
+{
+    taskENTER_CRITICAL(&snapshot_mux);
+    snapshot.energy_wh = 0.0f;
+    snapshot.base_energy_wh = 0.0f;
+    memset(snapshot.actuator_energy_wh, 0, sizeof(snapshot.actuator_energy_wh));
+    taskEXIT_CRITICAL(&snapshot_mux);
+}
+
+const char* power_meter_get_actuator_name(power_meter_actuator_t actuator)
+{
+    return (actuator < POWER_METER_ACTUATORS_NUM) ? actuator_names[actuator] : "";
+}
+
+static esp_err_t power_meter_init(void)
+{
+    esp_adc_cal_characteristics_t characteristics;
+
+    esp_adc_cal_characterize(ADC_UNIT_1, ADC_ATTEN_DB_11, ADC_WIDTH_BIT_12, ADC_DEFAULT_VREF_MV, &characteristics);
+    float low_mv = (float)esp_adc_cal_raw_to_voltage(ADC_LINEAR_RAW_LOW, &characteristics);
+    float high_mv = (float)esp_adc_cal_raw_to_voltage(ADC_LINEAR_RAW_HIGH, &characteristics);
+    adc_gain_mv = (high_mv - low_mv) / (float)(ADC_LINEAR_RAW_HIGH - ADC_LINEAR_RAW_LOW);
+    adc_offset_mv = low_mv - adc_gain_mv * (float)ADC_LINEAR_RAW_LOW;
+
+    memset(rls_theta, 0, sizeof(rls_theta));
+    memset(rls_p, 0, sizeof(rls_p));
+    for (uint8_t i = 0u; i < RLS_SIZE; i++)
+    {
+        rls_p[i][i] = RLS_INITIAL_COVARIANCE;
+    }
+
+    adc_digi_init_config_t init_config = {
+        .max_store_buf_size = ADC_BUFFER_BYTES,
+        .conv_num_each_intr = ADC_READ_BYTES,
+        .adc1_chan_mask = BIT(ESP_ADC_CH_V_MEAS) | BIT(ESP_ADC_CH_CURR_MEAS),
+        .adc2_chan_mask = 0,
+    };
+
+    adc_digi_pattern_config_t pattern[2] = {
+        {
+            .atten = ADC_ATTEN_DB_11,
+            .channel = ESP_ADC_CH_V_MEAS,
+            .unit = 0,
+            .bit_width = SOC_ADC_DIGI_MAX_BITWIDTH,
+        },
+        {
+            .atten = ADC_ATTEN_DB_11,
+            .channel = ESP_ADC_CH_CURR_MEAS,
+            .unit = 0,
+            .bit_width = SOC_ADC_DIGI_MAX_BITWIDTH,
+        },
+    };
+
+    adc_digi_configuration_t digi_config = {
+        .conv_limit_en = 1,
+        .conv_limit_num = 250,
+        .pattern_num = 2,
+        .adc_pattern = pattern,
+        .sample_freq_hz = ADC_SAMPLE_RATE_HZ,
+        .conv_mode = ADC_CONV_SINGLE_UNIT_1,
+        .format = ADC_OUTPUT_FORMAT,
+    };
+
+    if (ESP_OK != adc_digi_initialize(&init_config) ||
+        ESP_OK != adc_digi_controller_configure(&digi_config) ||
+        ESP_OK != adc_digi_start())
+    {
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+static void power_meter_process_block(const power_block_t* const block, float duration_s)
+{
+    float duty[POWER_METER_ACTUATORS_NUM];
+    float x[RLS_SIZE];
+    float actuator_power[POWER_METER_ACTUATORS_NUM];
+    float actuators_total = 0.0f;
+
+    float voltage_mean = block->sum_v / (float)block->n_v;
+    float current_mean = block->sum_i / (float)block->n_i;
+    float power = (0u != block->n_p) ? block->sum_p / (float)block->n_p : voltage_mean * current_mean;
+
+    power_meter_get_duties(duty);
+    x[0] = 1.0f;
+    memcpy(&x[1], duty, sizeof(duty));
+    power_meter_rls_update(x, power);
+
+    for (uint8_t i = 0u; i < POWER_METER_ACTUATORS_NUM; i++)
+    {
+        float full_power = (0.0f < rls_theta[i + 1u]) ? rls_theta[i + 1u] : 0.0f;
+        actuator_power[i] = full_power * duty[i];
+        actuators_total += actuator_power[i];
+    }
+    float base_power = (power > actuators_total) ? power - actuators_total : 0.0f;
+    float hours = duration_s / SECONDS_PER_HOUR;
+
+    taskENTER_CRITICAL(&snapshot_mux);
+    snapshot.voltage_mean = voltage_mean;
+    snapshot.voltage_rms = sqrtf(block->sum_v2 / (float)block->n_v);
+    snapshot.current_mean = current_mean;
+    snapshot.current_rms = sqrtf(block->sum_i2 / (float)block->n_i);
+    snapshot.power = power;
+    snapshot.energy_wh += power * hours;
+    snapshot.base_power = base_power;
+    snapshot.base_energy_wh += base_power * hours;
+    for (uint8_t i = 0u; i < POWER_METER_ACTUATORS_NUM; i++)
+    {
+        snapshot.full_power[i] = (0.0f < rls_theta[i + 1u]) ? rls_theta[i + 1u] : 0.0f;
+        snapshot.actuator_power[i] = actuator_power[i];
+        snapshot.actuator_energy_wh[i] += actuator_power[i] * hours;
+    }
+    snapshot.blocks++;
+    snapshot.timestamp_us = esp_timer_get_time();
+    taskEXIT_CRITICAL(&snapshot_mux);
+
+    data_store_publish_float(DATA_STORE_SUPPLY_POWER, power);
+}
+
+static void power_meter_get_duties(float duty[POWER_METER_ACTUATORS_NUM])
+{
+    data_store_snapshot_t outputs;
+
+    /* All outputs from one snapshot, so the block is regressed against a consistent set of duties */
+    data_store_get_snapshot(&outputs);
+    duty[POWER_METER_COOLING_PUMP] = outputs.samples[DATA_STORE_COOLING_PUMP].value.f * 0.01f;
+    duty[POWER_METER_WATERING_PUMP] = outputs.samples[DATA_STORE_WATERING_PUMP].value.f * 0.01f;
+    duty[POWER_METER_COOLING_VENTILATOR] = outputs.samples[DATA_STORE_COOLING_VENTILATOR].value.f * 0.01f;
+    duty[POWER_METER_DEHUMYFING_VENTILATOR] = outputs.samples[DATA_STORE_DEHUMYFING_VENTILATOR].value.f * 0.01f;
+    duty[POWER_METER_PELTIER] = outputs.samples[DATA_STORE_PELTIER].value.f * 0.01f;
+}
+
+static void power_meter_rls_update(const float x[RLS_SIZE], float y)
+{
+    float px[RLS_SIZE];
+    float forgetting;
+    float denominator;
+    float error = y;
+    float trace = 0.0f;
+
+    /* Forgetting stops while P is large, the same factor must go to the gain and the update of P */
+    for (uint8_t i = 0u; i < RLS_SIZE; i++)
+    {
+        trace += rls_p[i][i];
+    }
+    forgetting = (RLS_MAX_TRACE > trace) ? RLS_FORGETTING : 1.0f;
+    denominator = forgetting;
+
+    for (uint8_t i = 0u; i < RLS_SIZE; i++)
+    {
+        px[i] = 0.0f;
+        for (uint8_t j = 0u; j < RLS_SIZE; j++)
+        {
+            px[i] += rls_p[i][j] * x[j];
+        }
+        denominator += x[i] * px[i];
+        error -= rls_theta[i] * x[i];
+    }
+
+    for (uint8_t i = 0u; i < RLS_SIZE; i++)
+    {
+        float gain = px[i] / denominator;
+        rls_theta[i] += gain * error;
+        for (uint8_t j = 0u; j < RLS_SIZE; j++)
+        {
+            /* P is symmetric, so (P x)^T = x^T P */
+            rls_p[i][j] = (rls_p[i][j] - gain * px[j]) / forgetting;
+        }
+    }
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <stdint.h>
+#include "esp_err.h"
+
+/**
+ * @brief Outputs whose share of the supply power is estimated
+ */
+typedef enum
+{
+    POWER_METER_COOLING_PUMP = 0,
+    POWER_METER_WATERING_PUMP,
+    POWER_METER_COOLING_VENTILATOR,
+    POWER_METER_DEHUMYFING_VENTILATOR,
+    POWER_METER_PELTIER,
+    POWER_METER_ACTUATORS_NUM
+} power_meter_actuator_t;
+
+/**
+ * @brief Last published results of the power meter
+ */
+typedef struct
+{
+    float voltage_mean;         /*!< supply voltage, mean of the block in V */
+    float voltage_rms;          /*!< supply voltage, RMS of the block in V */
+    float current_mean;         /*!< supply current, mean of the block in A */
+    float current_rms;          /*!< supply current, RMS of the block in A */
+    float power;                /*!< mean of instantaneous power in the block in W */
+    float energy_wh;            /*!< energy since start or reset in Wh */
+    float base_power;           /*!< estimated power not related to the outputs in W */
+    float base_energy_wh;       /*!< energy not related to the outputs in Wh */
+    float full_power[POWER_METER_ACTUATORS_NUM];    /*!< estimated power of the output at 100% duty in W */
+    float actuator_power[POWER_METER_ACTUATORS_NUM];/*!< estimated power of the output at current duty in W */
+    float actuator_energy_wh[POWER_METER_ACTUATORS_NUM]; /*!< energy attributed to the output in Wh */
+    uint32_t blocks;            /*!< number of processed blocks */
+    int64_t timestamp_us;       /*!< time of the last block (esp_timer_get_time) */
+} power_meter_snapshot_t;
+
+/**
+ * @brief Power meter task, reads voltage and current samples from ADC DMA in blocks,
+ *        computes block statistics and attributes the power to the outputs
+ * 
+ * @param pvParameter parameter of task (not used)
+ */
+void power_meter_task(void *pvParameter);
+
+/**
+ * @brief Copies the last published results
+ * 
+ * @param snapshot destination of the results
+ */
+void power_meter_get_snapshot(power_meter_snapshot_t* const snapshot);
+
+/**
+ * @brief Clears all energy counters
+ */
+void power_meter_reset_energy(void);
+
+/**
+ * @brief Gets name of the output
+ * 
+ * @param actuator output
+ * @return name of the output
+ */
+const char* power_meter_get_actuator_name(power_meter_actuator_t actuator);
@@ -0,0 +1,143 @@
+#include <stdio.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "driver/i2c.h"
+#include "bmp280.h"
+#include "pressure_sensor.h"
+#include "../mcu/pinout.h"
+#include "../mcu/peripherals.h"
+#include "../system/scheduler.h"
+#include "../system/data_store.h"
+#include "../system/trace.h"
+
+#define I2C_CLOCK_HZ        400000u
+#define SAMPLE_PERIOD_MS    1000u
+
+static bmp280_t sensor;
+static volatile bool present = false;
+
+static portMUX_TYPE snapshot_mux = portMUX_INITIALIZER_UNLOCKED;
+static pressure_sensor_snapshot_t snapshot;
+
+static const char *TAG = "pressure_sensor";
+
+/**
+ * @brief Installs I2C driver and looks for the sensor on both addresses
+ *
+ * @return ESP_OK if the sensor was found, otherwise return ESP_FAIL
+ */
+static esp_err_t pressure_sensor_probe(void);
+
+/**
+ * @brief Runs one forced conversion and publishes the result, the job of the sensor
+ */
+static void pressure_sensor_sample(void);
+
+esp_err_t pressure_sensor_init(void)
+{
+    /* The sensor is optional, the job is not added without it */
+    if (ESP_OK != pressure_sensor_probe())
+    {
+        data_store_set_quality(DATA_STORE_PRESSURE, DATA_STORE_QUALITY_BAD);
+        return ESP_OK;
+    }
+    present = true;
+
+    /* The worker sleeps for the conversion time, the bus is free meanwhile */
+    return scheduler_add_job("pressure_sensor", &pressure_sensor_sample, SAMPLE_PERIOD_MS, SCHEDULER_EXEC_WORKER, NULL);
+}
+
+void pressure_sensor_get_snapshot(pressure_sensor_snapshot_t* const snapshot_out)
+{
+    taskENTER_CRITICAL(&snapshot_mux);
+    *snapshot_out = snapshot;
+    taskEXIT_CRITICAL(&snapshot_mux);
+}
+
+bool pressure_sensor_is_present(void)
+{
+    return present;
+}
+
+static esp_err_t pressure_sensor_probe(void)
+{
+#if !CONFIG_DONICZKA_SHARED_PIN_I2C
+    ESP_LOGW(TAG, "No I2C bus, the clock pin is used by the flood sensor");
+    return ESP_FAIL;
+#else
+    i2c_config_t conf = {
+        .mode = I2C_MODE_MASTER,
+        .sda_io_num = ESP_PIN_BMP280_SDA,
+        .scl_io_num = ESP_PIN_BMP280_SCL,
+        .sda_pullup_en = GPIO_PULLUP_ENABLE,
+        .scl_pullup_en = GPIO_PULLUP_ENABLE,
+        .master.clk_speed = I2C_CLOCK_HZ,
+    };
+
+    if (ESP_OK != i2c_param_config(ESP_I2C_PORT_SENSORS, &conf) ||
+        ESP_OK != i2c_driver_install(ESP_I2C_PORT_SENSORS, I2C_MODE_MASTER, 0, 0, 0))
+    {
+        ESP_LOGE(TAG, "I2C initialization failed");
+        return ESP_FAIL;
+    }
+
+    /* Pressure is averaged by oversampling and the IIR filter, temperature is only needed for compensation */
+    if (ESP_OK != bmp280_init(&sensor, ESP_I2C_PORT_SENSORS, BMP280_I2C_ADDRESS_0, BMP280_OVERSAMPLING_X2,
+                              BMP280_OVERSAMPLING_X16, BMP280_FILTER_4) &&
+        ESP_OK != bmp280_init(&sensor, ESP_I2C_PORT_SENSORS, BMP280_I2C_ADDRESS_1, BMP280_OVERSAMPLING_X2,
+                              BMP280_OVERSAMPLING_X16, BMP280_FILTER_4))
+    {
+        ESP_LOGE(TAG, "BMP280 not found");
+        i2c_driver_delete(ESP_I2C_PORT_SENSORS);
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+#endif
+}
+
+static void pressure_sensor_sample(void)
+{
+    float temperature = 0.0f;
+    float pressure = 0.0f;
+    esp_err_t ret;
+
+    TRACE_BEGIN(TRACE_MARKER_BMP280_READ);
+    ret = bmp280_start_forced(&sensor);
+    if (ESP_OK == ret)
+    {
+        /* The bus is free during the conversion, the worker sleeps instead of polling the status */
+        vTaskDelay(pdMS_TO_TICKS(bmp280_get_conversion_time_ms(&sensor)) + 1u);
+        ret = bmp280_read(&sensor, &temperature, &pressure);
+    }
+    TRACE_END(TRACE_MARKER_BMP280_READ);
+    if (ESP_OK != ret)
+    {
+        ESP_LOGE(TAG, "Could not read data from sensor");
+    }
+
+    taskENTER_CRITICAL(&snapshot_mux);
+    if (ESP_OK == ret)
+    {
+        snapshot.pressure_hpa = pressure * 0.01f;
+        snapshot.temperature = temperature;
+        snapshot.timestamp_us = esp_timer_get_time();
+    }
+    else
+    {
+        snapshot.error_count++;
+    }
+    snapshot.last_read_ok = (ESP_OK == ret);
+    taskEXIT_CRITICAL(&snapshot_mux);
+
+    if (ESP_OK == ret)
+    {
+        data_store_publish_float(DATA_STORE_PRESSURE, pressure * 0.01f);
+    }
+    else
+    {
+        data_store_set_quality(DATA_STORE_PRESSURE, DATA_STORE_QUALITY_STALE);
+    }
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+/**
+ * @brief Last sample published by pressure sensor job
+ */
+typedef struct
+{
+    float pressure_hpa;         /*!< absolute pressure in hPa */
+    float temperature;          /*!< temperature of the sensor in Celsius */
+    int64_t timestamp_us;       /*!< time of the last successful read (esp_timer_get_time), 0 if none */
+    uint32_t error_count;       /*!< number of failed reads */
+    bool last_read_ok;          /*!< false if the last read failed */
+} pressure_sensor_snapshot_t;
+
+/**
+ * @brief Looks for BMP280 and adds the sensor job to the scheduler. The job starts a forced
+ *        conversion every period and sleeps for the conversion time before reading the result.
+ *        No job is added if the I2C clock pin is used by the flood sensor, see
+ *        CONFIG_DONICZKA_SHARED_PIN, or the sensor does not answer.
+ *
+ * @return ESP_OK on success or if there is no sensor, ESP_FAIL if the job could not be added
+ */
+esp_err_t pressure_sensor_init(void);
+
+/**
+ * @brief Copies the last published sample
+ *
+ * @param snapshot destination of the sample
+ */
+void pressure_sensor_get_snapshot(pressure_sensor_snapshot_t* const snapshot);
+
+/**
+ * @brief Checks whether the sensor was found
+ *
+ * @return true if the sensor is sampled
+ */
+bool pressure_sensor_is_present(void);
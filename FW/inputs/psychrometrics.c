@@ -0,0 +1,42 @@
+#include <math.h>
+#include "psychrometrics.h"
+
+/* Magnus coefficients over water (Alduchov & Eskridge), valid for -40 - 50 C deg */
+#define MAGNUS_A 17.625f
+#define MAGNUS_B 243.04f
+#define MAGNUS_C_KPA 0.61094f
+
+/* Specific gas constant of water vapour 461.5 J/(kg K), expressed for kPa and g/m3 */
+#define VAPOUR_DENSITY_FACTOR 2166.8f
+#define ZERO_CELSIUS_K 273.15f
+
+#define MIN_HUMIDITY 0.1f
+
+/*All functions use single precision only, the FPU of ESP32 does not support double*/
+
+float psychrometrics_saturation_pressure(float celsius)
+{
+    return MAGNUS_C_KPA * expf(MAGNUS_A * celsius / (MAGNUS_B + celsius));
+}
+
+float psychrometrics_dew_point(float celsius, float humidity)
+{
+    if (humidity < MIN_HUMIDITY)
+    {
+        humidity = MIN_HUMIDITY;
+    }
+
+    float gamma = logf(humidity * 0.01f) + MAGNUS_A * celsius / (MAGNUS_B + celsius);
+    return MAGNUS_B * gamma / (MAGNUS_A - gamma);
+}
+
+float psychrometrics_absolute_humidity(float celsius, float humidity)
+{
+    float vapour_pressure = psychrometrics_saturation_pressure(celsius) * humidity * 0.01f;
+    return VAPOUR_DENSITY_FACTOR * vapour_pressure / (celsius + ZERO_CELSIUS_K);
+}
+
+float psychrometrics_vpd(float celsius, float humidity)
+{
+    return psychrometrics_saturation_pressure(celsius) * (1.0f - humidity * 0.01f);
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+/**
+ * @brief Saturation vapour pressure over water, Magnus formula
+ *        (Alduchov & Eskridge coefficients), published as within 0.384 %
+ *        of the Sonntag formula for -40 - 50 C deg
+ * 
+ * @param celsius temperature in celsius deg
+ * @return saturation vapour pressure in kPa
+ */
+float psychrometrics_saturation_pressure(float celsius);
+
+/**
+ * @brief Dew point, Magnus formula. The published pressure error bounds
+ *        the error to 0.07 C deg at -40 C deg and 0.15 C deg at 50 C deg,
+ *        checked against the Sonntag formula in host_test/test_psychrometrics.c.
+ * 
+ * @param celsius temperature in celsius deg
+ * @param humidity relative humidity in percent, values below 0.1 % are clamped
+ * @return dew point in celsius deg
+ */
+float psychrometrics_dew_point(float celsius, float humidity);
+
+/**
+ * @brief Absolute humidity (water vapour density)
+ * 
+ * @param celsius temperature in celsius deg
+ * @param humidity relative humidity in percent
+ * @return absolute humidity in g/m3
+ */
+float psychrometrics_absolute_humidity(float celsius, float humidity);
+
+/**
+ * @brief Vapour pressure deficit
+ * 
+ * @param celsius temperature in celsius deg
+ * @param humidity relative humidity in percent
+ * @return vapour pressure deficit in kPa
+ */
+float psychrometrics_vpd(float celsius, float humidity);
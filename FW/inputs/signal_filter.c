@@ -0,0 +1,108 @@
+#include <math.h>
+#include <string.h>
+#include "signal_filter.h"
+
+/**
+ * @brief Median of the filled part of the window
+ * 
+ * @param filter filter state
+ * @return median value
+ */
+static float signal_filter_median(const signal_filter_t* const filter);
+
+void signal_filter_init(signal_filter_t* const filter, const signal_filter_config_t* const config)
+{
+    filter->config = *config;
+
+    if (0.0f > filter->config.outlier_ratio)
+    {
+        filter->config.outlier_ratio = 0.0f;
+    }
+    if (0u == filter->config.median_window)
+    {
+        filter->config.median_window = 1u;
+    }
+    if (SIGNAL_FILTER_MAX_MEDIAN_WINDOW < filter->config.median_window)
+    {
+        filter->config.median_window = SIGNAL_FILTER_MAX_MEDIAN_WINDOW;
+    }
+    filter->config.median_window |= 1u;
+    if (0.0f >= filter->config.ema_alpha || 1.0f < filter->config.ema_alpha)
+    {
+        filter->config.ema_alpha = 1.0f;
+    }
+
+    signal_filter_reset(filter);
+}
+
+void signal_filter_reset(signal_filter_t* const filter)
+{
+    filter->window_fill = 0u;
+    filter->window_pos = 0u;
+    filter->output = 0.0f;
+    filter->primed = false;
+    filter->rejected_in_row = 0u;
+}
+
+bool signal_filter_update(signal_filter_t* const filter, float sample)
+{
+    if (filter->primed && 0.0f < filter->config.outlier_ratio &&
+        fabsf(sample - filter->output) > filter->config.outlier_ratio * fabsf(filter->output))
+    {
+        filter->rejected_total++;
+        if (++filter->rejected_in_row <= filter->config.outlier_limit)
+        {
+            return false;
+        }
+        /* Persistent deviation is a real change, start over from it */
+        signal_filter_reset(filter);
+    }
+    filter->rejected_in_row = 0u;
+
+    filter->window[filter->window_pos] = sample;
+    filter->window_pos = (uint8_t)((filter->window_pos + 1u) % filter->config.median_window);
+    if (filter->window_fill < filter->config.median_window)
+    {
+        filter->window_fill++;
+    }
+
+    float median = signal_filter_median(filter);
+
+    if (!filter->primed)
+    {
+        filter->output = median;
+        filter->primed = true;
+    }
+    else
+    {
+        filter->output += filter->config.ema_alpha * (median - filter->output);
+    }
+    return true;
+}
+
+float signal_filter_get_output(const signal_filter_t* const filter)
+{
+    return filter->output;
+}
+
+static float signal_filter_median(const signal_filter_t* const filter)
+{
+    float sorted[SIGNAL_FILTER_MAX_MEDIAN_WINDOW];
+    uint8_t n = filter->window_fill;
+
+    memcpy(sorted, filter->window, n * sizeof(float));
+
+    /* Insertion sort, the window has at most a few samples */
+    for (uint8_t i = 1u; i < n; i++)
+    {
+        float value = sorted[i];
+        uint8_t j = i;
+        while (0u < j && sorted[j - 1u] > value)
+        {
+            sorted[j] = sorted[j - 1u];
+            j--;
+        }
+        sorted[j] = value;
+    }
+    return sorted[n / 2u];
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define SIGNAL_FILTER_MAX_MEDIAN_WINDOW 9u
+
+/**
+ * @brief Configuration of the filter chain, stages are applied in order:
+ *        outlier rejection, median, exponential moving average
+ */
+typedef struct
+{
+    float outlier_ratio;        /*!< samples deviating from the output by more than this fraction are rejected, 0 disables */
+    uint8_t outlier_limit;      /*!< after this many consecutive rejections a sample is accepted as a step change */
+    uint8_t median_window;      /*!< odd number of samples of the median, 1 disables */
+    float ema_alpha;            /*!< weight of a new sample in 0 - 1, 1 disables */
+} signal_filter_config_t;
+
+/**
+ * @brief State of the filter chain
+ */
+typedef struct
+{
+    signal_filter_config_t config;
+    float window[SIGNAL_FILTER_MAX_MEDIAN_WINDOW];
+    uint8_t window_fill;
+    uint8_t window_pos;
+    float output;
+    bool primed;
+    uint8_t rejected_in_row;
+    uint32_t rejected_total;
+} signal_filter_t;
+
+/**
+ * @brief Sets configuration and resets the filter, invalid values are corrected
+ * 
+ * @param filter filter state
+ * @param config filter configuration
+ */
+void signal_filter_init(signal_filter_t* const filter, const signal_filter_config_t* const config);
+
+/**
+ * @brief Clears history of the filter, the next sample is passed through
+ * 
+ * @param filter filter state
+ */
+void signal_filter_reset(signal_filter_t* const filter);
+
+/**
+ * @brief Passes a sample through the filter chain
+ * 
+ * @param filter filter state
+ * @param sample raw sample
+ * @return true if the sample was used, false if it was rejected as an outlier
+ */
+bool signal_filter_update(signal_filter_t* const filter, float sample);
+
+/**
+ * @brief Gets filter output
+ * 
+ * @param filter filter state
+ * @return last filtered value
+ */
+float signal_filter_get_output(const signal_filter_t* const filter);
@@ -0,0 +1,66 @@
+#include <stdio.h>
+#include "freertos/FreeRTOS.h"
+#include "esp_err.h"
+#include "../mcu/pinout.h"
+#include "../mcu/peripherals.h"
+#include "freq_sensor.h"
+#include "soil_moisture.h"
+
+#define SOIL_PCNT_UNIT      ESP_PCNT_UNIT_SOIL
+#define SOIL_INPUT_SIG_IO   ESP_PIN_FREQ_SOIL
+
+/* Moisture changes slowly, a long gate gives finer resolution */
+#define DEFAULT_GATE_MS     500u
+
+#define MIN_MOISTURE        0.0f
+#define MAX_MOISTURE        100.0f
+
+#define DEFAULT_OUTLIER_RATIO   0.2f
+#define DEFAULT_OUTLIER_LIMIT   3u
+#define DEFAULT_MEDIAN_WINDOW   5u
+#define DEFAULT_EMA_ALPHA       0.1f
+
+static freq_sensor_t soil;
+
+esp_err_t soil_moisture_init(void)
+{
+    const signal_filter_config_t filter_config = {
+        .outlier_ratio = DEFAULT_OUTLIER_RATIO,
+        .outlier_limit = DEFAULT_OUTLIER_LIMIT,
+        .median_window = DEFAULT_MEDIAN_WINDOW,
+        .ema_alpha = DEFAULT_EMA_ALPHA
+    };
+
+    return freq_sensor_init(&soil, SOIL_PCNT_UNIT, SOIL_INPUT_SIG_IO, DEFAULT_GATE_MS, &filter_config,
+                            MIN_MOISTURE, MAX_MOISTURE, DATA_STORE_SOIL_MOISTURE);
+}
+
+esp_err_t soil_moisture_get(float* const moisture)
+{
+    return freq_sensor_get_value(&soil, moisture);
+}
+
+float soil_moisture_get_frequency(void)
+{
+    return freq_sensor_get_frequency(&soil);
+}
+
+float soil_moisture_get_filtered_frequency(void)
+{
+    return freq_sensor_get_filtered_frequency(&soil);
+}
+
+esp_err_t soil_moisture_add_point(float freq, float moisture)
+{
+    return freq_sensor_add_point(&soil, freq, moisture);
+}
+
+esp_err_t soil_moisture_remove_point(uint8_t index)
+{
+    return freq_sensor_remove_point(&soil, index);
+}
+
+uint8_t soil_moisture_get_points(calibration_point_t* const points)
+{
+    return freq_sensor_get_points(&soil, points);
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <stdint.h>
+#include "esp_err.h"
+#include "calibration.h"
+
+/**
+ * @brief Initialize frequency input of the soil probe, results are processed by freq_meas_task
+ * 
+ * @return ESP_OK for success
+ */
+esp_err_t soil_moisture_init(void);
+
+/**
+ * @brief Get soil moisture computed from filtered frequency with the calibration table
+ * 
+ * @param moisture pointer to soil moisture in percent
+ * @return ESP_OK for success, ESP_FAIL if the probe has less than two calibration points
+ */
+esp_err_t soil_moisture_get(float* const moisture);
+
+/**
+ * @brief Return last measured frequency of the soil probe
+ * 
+ * @return Last measured raw frequency in Hz, 0 if the probe is stopped
+ */
+float soil_moisture_get_frequency(void);
+
+/**
+ * @brief Return filtered frequency of the soil probe
+ * 
+ * @return Filtered frequency in Hz
+ */
+float soil_moisture_get_filtered_frequency(void);
+
+/**
+ * @brief Add calibration point, a point with the same moisture or frequency is replaced
+ * 
+ * @param freq frequency in Hz, 0 to use current filtered frequency
+ * @param moisture soil moisture in percent
+ * @return ESP_OK for success
+ */
+esp_err_t soil_moisture_add_point(float freq, float moisture);
+
+/**
+ * @brief Remove calibration point
+ * 
+ * @param index index of the point, points are sorted by frequency
+ * @return ESP_OK for success
+ */
+esp_err_t soil_moisture_remove_point(uint8_t index);
+
+/**
+ * @brief Copy calibration points
+ * 
+ * @param points destination for up to CALIBRATION_MAX_POINTS points
+ * @return number of points
+ */
+uint8_t soil_moisture_get_points(calibration_point_t* const points);
@@ -0,0 +1,157 @@
+#include <stdio.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "driver/gpio.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_attr.h"
+#include "tank_level_switch.h"
+#include "../mcu/pinout.h"
+#include "../system/data_store.h"
+
+/* Switches close to ground when the water passes them: MIN when the level drops below it,
+   MAX when the level rises above it */
+#define SWITCH_ACTIVE_LEVEL 0
+/* Contacts of float switches bounce and the float wobbles on waves of the refill */
+#define DEBOUNCE_MS 50u
+#define STABLE_SAMPLES 4u
+
+static const gpio_num_t switch_pins[WATER_TANK_SWITCHES_NUM] = {
+    [WATER_TANK_SWITCH_MIN] = ESP_PIN_TANK_MIN_SENS,
+    [WATER_TANK_SWITCH_MAX] = ESP_PIN_TANK_MAX_SENS,
+};
+
+static TaskHandle_t switch_task_handle = NULL;
+static portMUX_TYPE switch_mux = portMUX_INITIALIZER_UNLOCKED;
+static tank_level_switch_state_t switch_states[WATER_TANK_SWITCHES_NUM];
+
+static const char *TAG = "tank_level_switch";
+
+/**
+ * @brief Edge interrupt of a switch, only wakes the task which does the debouncing
+ *
+ * @param arg switch index
+ */
+static void IRAM_ATTR tank_level_switch_isr(void *arg);
+
+/**
+ * @brief Samples a switch until it keeps the same level for STABLE_SAMPLES debounce intervals
+ *
+ * @param pin input pin of the switch
+ * @return true if the stable level is active
+ */
+static bool tank_level_switch_debounce(gpio_num_t pin);
+
+esp_err_t tank_level_switch_init(void)
+{
+    gpio_config_t io_conf = {
+        .pin_bit_mask = BIT64(ESP_PIN_TANK_MIN_SENS) | BIT64(ESP_PIN_TANK_MAX_SENS),
+        .mode = GPIO_MODE_INPUT,
+        .pull_up_en = GPIO_PULLUP_ENABLE,
+        .pull_down_en = GPIO_PULLDOWN_DISABLE,
+        .intr_type = GPIO_INTR_ANYEDGE,
+    };
+    esp_err_t ret = gpio_config(&io_conf);
+
+    /* Service may be already installed by another module, its handlers are all in IRAM */
+    if (ESP_OK == ret)
+    {
+        ret = gpio_install_isr_service(ESP_INTR_FLAG_IRAM);
+        ret = (ESP_ERR_INVALID_STATE == ret) ? ESP_OK : ret;
+    }
+    for (uint8_t i = 0u; ESP_OK == ret && i < WATER_TANK_SWITCHES_NUM; i++)
+    {
+        switch_states[i].active = (SWITCH_ACTIVE_LEVEL == gpio_get_level(switch_pins[i]));
+        data_store_publish_bool(DATA_STORE_TANK_SWITCH_MIN + i, switch_states[i].active);
+        ret = gpio_isr_handler_add(switch_pins[i], tank_level_switch_isr, (void *)(uint32_t)i);
+    }
+    return (ESP_OK == ret) ? ESP_OK : ESP_FAIL;
+}
+
+void tank_level_switch_task(void *pvParameter)
+{
+    switch_task_handle = xTaskGetCurrentTaskHandle();
+    /* Edges before the task started were not signalled, check both switches once */
+    xTaskNotify(switch_task_handle, BIT(WATER_TANK_SWITCHES_NUM) - 1u, eSetBits);
+
+    while (1)
+    {
+        uint32_t pending = 0u;
+
+        xTaskNotifyWait(0u, UINT32_MAX, &pending, portMAX_DELAY);
+
+        for (uint8_t i = 0u; i < WATER_TANK_SWITCHES_NUM; i++)
+        {
+            if (0u == (pending & BIT(i)))
+            {
+                continue;
+            }
+
+            bool active = tank_level_switch_debounce(switch_pins[i]);
+            bool tripped = false;
+
+            data_store_publish_bool(DATA_STORE_TANK_SWITCH_MIN + i, active);
+            taskENTER_CRITICAL(&switch_mux);
+            if (active != switch_states[i].active)
+            {
+                switch_states[i].active = active;
+                if (active)
+                {
+                    switch_states[i].trip_count++;
+                    switch_states[i].last_trip_us = esp_timer_get_time();
+                    tripped = true;
+                }
+            }
+            taskEXIT_CRITICAL(&switch_mux);
+
+            /* Only the trip edge is used, the release edge is offset by hysteresis of the float */
+            if (tripped && ESP_OK != water_tank_auto_calibrate((water_tank_switch_t)i))
+            {
+                ESP_LOGW(TAG, "%s switch tripped without valid tank frequency",
+                         (WATER_TANK_SWITCH_MAX == i) ? "Max" : "Min");
+            }
+        }
+    }
+}
+
+esp_err_t tank_level_switch_get_state(water_tank_switch_t level_switch, tank_level_switch_state_t* const state)
+{
+    if (level_switch >= WATER_TANK_SWITCHES_NUM)
+    {
+        return ESP_FAIL;
+    }
+    taskENTER_CRITICAL(&switch_mux);
+    *state = switch_states[level_switch];
+    taskEXIT_CRITICAL(&switch_mux);
+    return ESP_OK;
+}
+
+static void IRAM_ATTR tank_level_switch_isr(void *arg)
+{
+    BaseType_t woken = pdFALSE;
+
+    if (NULL != switch_task_handle)
+    {
+        xTaskNotifyFromISR(switch_task_handle, BIT((uint32_t)arg), eSetBits, &woken);
+    }
+    if (pdTRUE == woken)
+    {
+        portYIELD_FROM_ISR();
+    }
+}
+
+static bool tank_level_switch_debounce(gpio_num_t pin)
+{
+    int level = gpio_get_level(pin);
+    uint8_t stable = 0u;
+
+    /* Edges arriving meanwhile only set bits which are already being handled */
+    while (STABLE_SAMPLES > stable)
+    {
+        vTaskDelay(pdMS_TO_TICKS(DEBOUNCE_MS));
+        int sample = gpio_get_level(pin);
+        stable = (sample == level) ? stable + 1u : 0u;
+        level = sample;
+    }
+    return (SWITCH_ACTIVE_LEVEL == level);
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "water_tank_meas.h"
+
+/**
+ * @brief State of a level switch
+ */
+typedef struct
+{
+    bool active;                /*!< debounced state, true when the water level is past the switch */
+    uint32_t trip_count;        /*!< number of debounced transitions to active */
+    int64_t last_trip_us;       /*!< time of the last trip (esp_timer_get_time), 0 if none */
+} tank_level_switch_state_t;
+
+/**
+ * @brief Configures inputs of both level switches and their interrupts, must be called
+ *        before tank_level_switch_task starts
+ *
+ * @return ESP_OK on success, otherwise return ESP_FAIL
+ */
+esp_err_t tank_level_switch_init(void);
+
+/**
+ * @brief Level switch task, debounces the switches after each edge interrupt and
+ *        recalibrates the tank frequency of the level when a switch trips
+ *
+ * @param pvParameter parameter of task (not used)
+ */
+void tank_level_switch_task(void *pvParameter);
+
+/**
+ * @brief Gets debounced state of a level switch
+ *
+ * @param level_switch switch
+ * @param state destination of the state
+ * @return ESP_OK on success, otherwise return ESP_FAIL
+ */
+esp_err_t tank_level_switch_get_state(water_tank_switch_t level_switch, tank_level_switch_state_t* const state);
@@ -1,80 +1,593 @@
 #include <inttypes.h>
 #include <stdio.h>
+#include <string.h>
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
+#include <freertos/semphr.h>
 #include "../third_party/ds18x20.h"
 #include <esp_log.h>
 #include <esp_err.h>
+#include <esp_timer.h>
 #include "../mcu/pinout.h"
 #include "temperature_sensor.h"
+#include "../system/scheduler.h"
+#include "../system/data_store.h"
+#include "../system/power.h"
 
-#define MAX_SENSORS 4u
+#define MAX_SENSORS TEMPERATURE_SENSOR_MAX_PROBES
+#define DEFAULT_RESOLUTION DS18X20_RESOLUTION_12_BIT
+#define DEFAULT_PERIOD_MS 1000u
+/* Due conversions are started at least at this rate, finished ones trigger the job at once */
+#define JOB_PERIOD_MS 250u
+#define RESCAN_PERIOD_MS 1000u
+#define MIN_RESOLUTION_BITS 9u
+
+_Static_assert(MAX_SENSORS <= DATA_STORE_PROBES_NUM, "Every probe has a slot in the data store");
+
+/* Done bits: bit n - conversion of probe n finished, ALL_PROBES_BIT - bus-wide conversion finished */
+#define PROBE_BIT(n) (1u << (n))
+#define ALL_PROBES_BIT PROBE_BIT(MAX_SENSORS)
+
+typedef struct
+{
+    ds18x20_addr_t addr;
+    ds18x20_resolution_t resolution;
+    uint32_t period_ms;
+} probe_config_t;
+
+typedef struct
+{
+    ds18x20_conversion_t conv;
+    ds18x20_resolution_t resolution;
+    uint32_t period_ms;
+    int64_t next_due_us;
+    int64_t started_us;
+    bool converting;
+} probe_state_t;
 
 static const gpio_num_t SENSOR_GPIO = ESP_PIN_DS18B20_DATA;
-static uint8_t sensor_count = 0u;
+
+/* Bus state, owned by whoever holds bus_mutex */
+static SemaphoreHandle_t bus_mutex = NULL;
+/* Slot timing relies on busy waits, frequency is kept and light sleep held off while the bus is owned */
+static esp_pm_lock_handle_t pm_lock = NULL;
+static scheduler_job_id_t sensor_job;
+static size_t sensor_count = 0u;
+static int64_t next_scan_us = 0;
 static ds18x20_addr_t addrs[MAX_SENSORS];
-static float temps[MAX_SENSORS];
+static probe_state_t states[MAX_SENSORS];
+static ds18x20_conversion_t bus_conv;
+static uint32_t bus_conv_mask = 0u;
+
+/* Set by conversion callbacks, taken by the job */
+static volatile uint32_t done_bits = 0u;
+
+/* Per address settings, survive rescans */
+static probe_config_t configs[MAX_SENSORS];
+
+/* Published snapshot, readers copy it under the spinlock without touching the bus */
+static portMUX_TYPE snapshot_mux = portMUX_INITIALIZER_UNLOCKED;
+static temperature_sensor_snapshot_t snapshot;
 
 static const char *TAG = "temperature_sensor";
 
-void temperature_sensor_task(void *pvParameter)
+/**
+ * @brief Scans the bus, applies stored settings to found devices and publishes
+ *        empty snapshot with found addresses, bus_mutex must be held by the caller
+ *
+ * @return number of detected devices
+ */
+static uint8_t temperature_sensor_scan(void);
+
+/**
+ * @brief Converts all devices with one blocking skip ROM conversion, reads them and
+ *        publishes the snapshot, bus_mutex must be held by the caller
+ *
+ * @return ESP_OK if all devices were read successfully, otherwise return ESP_FAIL
+ */
+static esp_err_t temperature_sensor_acquire(void);
+
+/**
+ * @brief Starts non-blocking conversions of all idle probes which are due,
+ *        bus_mutex must be held by the caller
+ *
+ * @param now current time in microseconds
+ */
+static void temperature_sensor_start_due(int64_t now);
+
+/**
+ * @brief Reads probes whose conversion finished, bus_mutex must be held by the caller
+ *
+ * @param bits done bits of finished conversions
+ */
+static void temperature_sensor_collect(uint32_t bits);
+
+/**
+ * @brief Collects finished conversions and starts the due ones, the job of the sensor
+ */
+static void temperature_sensor_process(void);
+
+/**
+ * @brief Publishes result of a single probe into the snapshot
+ */
+static void temperature_sensor_publish(size_t sensor_no, float temp_C, bool valid, int64_t timestamp);
+
+/**
+ * @brief Finds settings stored for the address, creates default ones if there are none
+ */
+static probe_config_t* temperature_sensor_get_config(ds18x20_addr_t addr);
+
+/**
+ * @brief Advances the next conversion of the probe by one period from the last one,
+ *        a probe more than a period behind restarts its phase at its last start
+ *
+ * @param sensor_no the probe
+ */
+static void temperature_sensor_schedule_next(size_t sensor_no);
+
+/**
+ * @brief Conversion finished callback, runs in esp_timer task, triggers the job
+ *        so the probe is read and started again without waiting for a period of the job
+ */
+static void temperature_sensor_conversion_done(void *arg);
+
+/**
+ * @brief Takes bus_mutex and the power management lock
+ */
+static void temperature_sensor_bus_take(void);
+
+/**
+ * @brief Gives the power management lock and bus_mutex
+ */
+static void temperature_sensor_bus_give(void);
+
+esp_err_t temperature_sensor_init(void)
 {
     gpio_set_pull_mode(SENSOR_GPIO, GPIO_PULLUP_ONLY);
 
-    while (1)
+    ESP_ERROR_CHECK(ds18x20_conversion_init(&bus_conv, &temperature_sensor_conversion_done, (void*)(uintptr_t)ALL_PROBES_BIT));
+    for (size_t i = 0u; i < MAX_SENSORS; i++)
     {
-        vTaskDelay(pdMS_TO_TICKS(100));
+        ESP_ERROR_CHECK(ds18x20_conversion_init(&states[i].conv, &temperature_sensor_conversion_done, (void*)(uintptr_t)PROBE_BIT(i)));
     }
+
+    bus_mutex = xSemaphoreCreateMutex();
+    configASSERT(bus_mutex);
+    ESP_ERROR_CHECK(power_lock_create(ESP_PM_CPU_FREQ_MAX, "onewire", &pm_lock));
+
+    /* Bus transactions block for milliseconds, the job runs on the worker pool and scans the bus on its first run */
+    return scheduler_add_job("temperature_sensor", &temperature_sensor_process, JOB_PERIOD_MS, SCHEDULER_EXEC_WORKER, &sensor_job);
 }
 
+static void temperature_sensor_process(void)
+{
+    uint32_t bits = __atomic_exchange_n(&done_bits, 0u, __ATOMIC_RELAXED);
+    int64_t now;
 
-uint8_t temperature_sensor_rescan_devices (void)
+    temperature_sensor_bus_take();
+    now = esp_timer_get_time();
+    if (0u == sensor_count && now >= next_scan_us)
+    {
+        next_scan_us = now + (int64_t)RESCAN_PERIOD_MS * 1000;
+        temperature_sensor_scan();
+    }
+    /* A trigger coming while the job runs is dropped by the scheduler, its done bits are taken here */
+    do
+    {
+        if (0u != bits)
+        {
+            temperature_sensor_collect(bits);
+        }
+        temperature_sensor_start_due(esp_timer_get_time());
+        bits = __atomic_exchange_n(&done_bits, 0u, __ATOMIC_RELAXED);
+    } while (0u != bits);
+    temperature_sensor_bus_give();
+}
+
+static void temperature_sensor_conversion_done(void *arg)
 {
-    sensor_count = 0u;
+    __atomic_fetch_or(&done_bits, (uint32_t)(uintptr_t)arg, __ATOMIC_RELAXED);
+    scheduler_trigger(sensor_job);
+}
+
+static probe_config_t* temperature_sensor_get_config(ds18x20_addr_t addr)
+{
+    probe_config_t* free_slot = NULL;
+    bool present;
+
+    for (size_t i = 0u; i < MAX_SENSORS; i++)
+    {
+        if (configs[i].addr == addr)
+        {
+            return &configs[i];
+        }
+    }
+    /* Reuse a slot of a device which is no longer on the bus */
+    for (size_t i = 0u; (i < MAX_SENSORS) && (NULL == free_slot); i++)
+    {
+        present = false;
+        for (size_t j = 0u; j < sensor_count; j++)
+        {
+            present |= (configs[i].addr == addrs[j]);
+        }
+        if (!present)
+        {
+            free_slot = &configs[i];
+        }
+    }
+    configASSERT(free_slot);
+
+    free_slot->addr = addr;
+    free_slot->resolution = DEFAULT_RESOLUTION;
+    free_slot->period_ms = DEFAULT_PERIOD_MS;
+
+    return free_slot;
+}
+
+static uint8_t temperature_sensor_scan(void)
+{
+    size_t found = 0u;
     esp_err_t res;
+    int64_t now;
 
-    res = ds18x20_scan_devices(SENSOR_GPIO, addrs, MAX_SENSORS, &sensor_count);
+    res = ds18x20_scan_devices(SENSOR_GPIO, addrs, MAX_SENSORS, &found);
 
     if (res != ESP_OK)
     {
         ESP_LOGE(TAG, "Sensors scan error %d (%s)", res, esp_err_to_name(res));
+        found = 0u;
     }
-    if (0u == sensor_count)
+    if (0u == found)
     {
         ESP_LOGW(TAG, "No sensors detected!");
     }
-    if (sensor_count > MAX_SENSORS)
+    if (found > MAX_SENSORS)
+    {
+        found = MAX_SENSORS;
+    }
+    sensor_count = found;
+
+    /* Conversions in flight belong to the old bus layout, they are stopped so the probes can start again now */
+    ds18x20_conversion_cancel(&bus_conv);
+    for (size_t i = 0u; i < MAX_SENSORS; i++)
+    {
+        ds18x20_conversion_cancel(&states[i].conv);
+        states[i].converting = false;
+    }
+    __atomic_store_n(&done_bits, 0u, __ATOMIC_RELAXED);
+
+    now = esp_timer_get_time();
+    bus_conv_mask = 0u;
+    for (size_t i = 0u; i < sensor_count; i++)
+    {
+        const probe_config_t* config = temperature_sensor_get_config(addrs[i]);
+
+        states[i].resolution = config->resolution;
+        states[i].period_ms = config->period_ms;
+        states[i].next_due_us = now;
+        states[i].converting = false;
+
+        /* Probes start with the resolution stored in their EEPROM, always apply ours */
+        res = ds18x20_set_resolution(SENSOR_GPIO, addrs[i], states[i].resolution, false);
+        if (res != ESP_OK && res != ESP_ERR_NOT_SUPPORTED)
+        {
+            ESP_LOGW(TAG, "Cannot set resolution of sensor %d (%s)", (int)i, esp_err_to_name(res));
+        }
+    }
+
+    taskENTER_CRITICAL(&snapshot_mux);
+    memset(&snapshot, 0, sizeof(snapshot));
+    snapshot.count = (uint8_t)sensor_count;
+    for (size_t i = 0u; i < sensor_count; i++)
+    {
+        snapshot.probes[i].addr = addrs[i];
+        snapshot.probes[i].resolution_bits = MIN_RESOLUTION_BITS + states[i].resolution;
+        snapshot.probes[i].period_ms = states[i].period_ms;
+    }
+    taskEXIT_CRITICAL(&snapshot_mux);
+
+    /* Slots are numbered in scan order, values of a previous layout are no longer valid */
+    for (size_t i = 0u; i < DATA_STORE_PROBES_NUM; i++)
     {
-        sensor_count = MAX_SENSORS;
+        data_store_set_quality(DATA_STORE_PROBE_TEMPERATURE_0 + i, (i < sensor_count) ? DATA_STORE_QUALITY_NONE : DATA_STORE_QUALITY_BAD);
     }
-    
-    return sensor_count;
+
+    return (uint8_t)sensor_count;
+}
+
+static void temperature_sensor_publish(size_t sensor_no, float temp_C, bool valid, int64_t timestamp)
+{
+    taskENTER_CRITICAL(&snapshot_mux);
+    /* Keep the last good value of a probe which failed this time */
+    if (valid)
+    {
+        snapshot.probes[sensor_no].temp_C = temp_C;
+        snapshot.probes[sensor_no].timestamp_us = timestamp;
+    }
+    snapshot.probes[sensor_no].valid = valid;
+    snapshot.probes[sensor_no].resolution_bits = MIN_RESOLUTION_BITS + states[sensor_no].resolution;
+    snapshot.probes[sensor_no].period_ms = states[sensor_no].period_ms;
+    taskEXIT_CRITICAL(&snapshot_mux);
+
+    if (valid)
+    {
+        data_store_sample_t sample = {
+            .value.f = temp_C,
+            .timestamp_us = timestamp,
+            .quality = DATA_STORE_QUALITY_GOOD,
+        };
+        data_store_publish(DATA_STORE_PROBE_TEMPERATURE_0 + sensor_no, &sample);
+    }
+    else
+    {
+        data_store_set_quality(DATA_STORE_PROBE_TEMPERATURE_0 + sensor_no, DATA_STORE_QUALITY_STALE);
+    }
+}
+
+static void temperature_sensor_schedule_next(size_t sensor_no)
+{
+    probe_state_t* state = &states[sensor_no];
+
+    /* Collect time does not matter, a next start already due is made in the same run of the job */
+    state->next_due_us += (int64_t)state->period_ms * 1000;
+    if (state->next_due_us <= state->started_us)
+    {
+        state->next_due_us = state->started_us + (int64_t)state->period_ms * 1000;
+    }
+}
+
+static void temperature_sensor_start_due(int64_t now)
+{
+    uint32_t due = 0u;
+    uint32_t all = 0u;
+    ds18x20_resolution_t max_resolution = DS18X20_RESOLUTION_9_BIT;
+    esp_err_t res;
+
+    for (size_t i = 0u; i < sensor_count; i++)
+    {
+        all |= PROBE_BIT(i);
+        if (!states[i].converting && states[i].next_due_us <= now)
+        {
+            due |= PROBE_BIT(i);
+            if (states[i].resolution > max_resolution)
+            {
+                max_resolution = states[i].resolution;
+            }
+        }
+    }
+    if (0u == due)
+    {
+        return;
+    }
+
+    /* All probes due at once - one skip ROM conversion instead of one per probe */
+    if (due == all && sensor_count > 1u)
+    {
+        if (ESP_OK == ds18x20_conversion_start(&bus_conv, SENSOR_GPIO, DS18X20_ANY, max_resolution))
+        {
+            bus_conv_mask = due;
+            for (size_t i = 0u; i < sensor_count; i++)
+            {
+                states[i].converting = true;
+                states[i].started_us = now;
+            }
+            return;
+        }
+    }
+
+    for (size_t i = 0u; i < sensor_count; i++)
+    {
+        if (0u == (due & PROBE_BIT(i)))
+        {
+            continue;
+        }
+        res = ds18x20_conversion_start(&states[i].conv, SENSOR_GPIO, addrs[i], states[i].resolution);
+        if (ESP_OK == res)
+        {
+            states[i].converting = true;
+            states[i].started_us = now;
+        }
+        else
+        {
+            ESP_LOGE(TAG, "Sensor %d conversion error %d (%s)", (int)i, res, esp_err_to_name(res));
+            states[i].started_us = now;
+            temperature_sensor_publish(i, 0.0f, false, now);
+            temperature_sensor_schedule_next(i);
+        }
+    }
+}
+
+static void temperature_sensor_collect(uint32_t bits)
+{
+    float temp_C = 0.0f;
+    bool valid;
+
+    if (0u != (bits & ALL_PROBES_BIT))
+    {
+        bits |= bus_conv_mask;
+        bus_conv_mask = 0u;
+    }
+
+    for (size_t i = 0u; i < sensor_count; i++)
+    {
+        if (0u == (bits & PROBE_BIT(i)) || !states[i].converting)
+        {
+            continue;
+        }
+        states[i].converting = false;
+
+        valid = (ESP_OK == ds18x20_read_temperature(SENSOR_GPIO, addrs[i], &temp_C));
+        if (!valid)
+        {
+            ESP_LOGE(TAG, "Sensor %d read error", (int)i);
+        }
+        temperature_sensor_publish(i, temp_C, valid, states[i].started_us);
+        temperature_sensor_schedule_next(i);
+    }
+}
+
+static esp_err_t temperature_sensor_acquire(void)
+{
+    esp_err_t ret = ESP_OK;
+    esp_err_t res;
+    float temp_C = 0.0f;
+    bool valid;
+    int64_t timestamp;
+
+    res = ds18x20_measure(SENSOR_GPIO, DS18X20_ANY, true);
+    timestamp = esp_timer_get_time();
+
+    for (size_t i = 0u; i < sensor_count; i++)
+    {
+        valid = (res == ESP_OK) && (ESP_OK == ds18x20_read_temperature(SENSOR_GPIO, addrs[i], &temp_C));
+        if (!valid)
+        {
+            ret = ESP_FAIL;
+        }
+        temperature_sensor_publish(i, temp_C, valid, timestamp);
+        states[i].next_due_us = timestamp + (int64_t)states[i].period_ms * 1000;
+    }
+
+    if (ret != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Sensors read error");
+    }
+
+    return ret;
+}
+
+uint8_t temperature_sensor_rescan_devices (void)
+{
+    uint8_t count;
+
+    if (NULL == bus_mutex)
+    {
+        return 0u;
+    }
+    temperature_sensor_bus_take();
+    count = temperature_sensor_scan();
+    temperature_sensor_bus_give();
+
+    return count;
 }
 
 uint8_t temperature_sensor_get_devices_number (void)
 {
-    return sensor_count;
+    uint8_t count;
+
+    taskENTER_CRITICAL(&snapshot_mux);
+    count = snapshot.count;
+    taskEXIT_CRITICAL(&snapshot_mux);
+
+    return count;
 }
 
 esp_err_t temperature_sensor_get_data (float* temp_C, float* temp_F, uint64_t* const addr, uint8_t  sensor_no)
 {
-    esp_err_t res;
+    temperature_sensor_probe_t probe;
+    uint8_t count;
+
+    taskENTER_CRITICAL(&snapshot_mux);
+    count = snapshot.count;
+    probe = snapshot.probes[sensor_no < MAX_SENSORS ? sensor_no : 0u];
+    taskEXIT_CRITICAL(&snapshot_mux);
 
-    if (sensor_no > sensor_count)
+    if (sensor_no >= count)
     {
         ESP_LOGE(TAG, "Invalid sensor number");
         return ESP_FAIL;
     }
-    res = ds18x20_measure_and_read_multi(SENSOR_GPIO, addrs, sensor_count, temps);
-    if (res != ESP_OK)
+
+    *temp_C = probe.temp_C;
+    *temp_F = (*temp_C) * 1.8f + 32.0f;
+    *addr = probe.addr;
+
+    return probe.valid ? ESP_OK : ESP_FAIL;
+}
+
+void temperature_sensor_get_snapshot (temperature_sensor_snapshot_t* const dst)
+{
+    taskENTER_CRITICAL(&snapshot_mux);
+    *dst = snapshot;
+    taskEXIT_CRITICAL(&snapshot_mux);
+}
+
+esp_err_t temperature_sensor_refresh (void)
+{
+    esp_err_t ret = ESP_FAIL;
+
+    if (NULL == bus_mutex)
     {
-        ESP_LOGE(TAG, "Sensors read error %d (%s)", res, esp_err_to_name(res));
         return ESP_FAIL;
     }
+    temperature_sensor_bus_take();
+    if (0u != temperature_sensor_scan())
+    {
+        ret = temperature_sensor_acquire();
+    }
+    temperature_sensor_bus_give();
 
-    *temp_C = temps[sensor_no];
-    *temp_F = (*temp_C) * 1.8 + 32;
-    *addr = addrs[sensor_no];
+    /* Run the job so it reschedules the probes */
+    scheduler_trigger(sensor_job);
 
-    return ESP_OK;
-}
\ No newline at end of file
+    return ret;
+}
+
+esp_err_t temperature_sensor_configure (uint8_t sensor_no, uint8_t resolution_bits, uint32_t period_ms)
+{
+    esp_err_t ret = ESP_FAIL;
+    ds18x20_resolution_t resolution;
+    probe_config_t* config;
+    uint32_t conversion_ms;
+
+    if (NULL == bus_mutex || resolution_bits < MIN_RESOLUTION_BITS || resolution_bits > (MIN_RESOLUTION_BITS + DS18X20_RESOLUTION_12_BIT))
+    {
+        return ESP_FAIL;
+    }
+    resolution = (ds18x20_resolution_t)(resolution_bits - MIN_RESOLUTION_BITS);
+    conversion_ms = ds18x20_conversion_time_ms(resolution);
+    if (period_ms < conversion_ms)
+    {
+        period_ms = conversion_ms;
+    }
+
+    temperature_sensor_bus_take();
+    if (sensor_no < sensor_count)
+    {
+        ret = ds18x20_set_resolution(SENSOR_GPIO, addrs[sensor_no], resolution, false);
+        if (ESP_ERR_NOT_SUPPORTED == ret)
+        {
+            ESP_LOGW(TAG, "Sensor %d has fixed resolution", sensor_no);
+            resolution = DS18X20_RESOLUTION_12_BIT;
+            ret = ESP_OK;
+        }
+        if (ESP_OK == ret)
+        {
+            config = temperature_sensor_get_config(addrs[sensor_no]);
+            config->resolution = resolution;
+            config->period_ms = period_ms;
+
+            states[sensor_no].resolution = resolution;
+            states[sensor_no].period_ms = period_ms;
+            states[sensor_no].next_due_us = esp_timer_get_time();
+        }
+    }
+    temperature_sensor_bus_give();
+
+    /* Run the job so the new period takes effect immediately */
+    scheduler_trigger(sensor_job);
+
+    return (ESP_OK == ret) ? ESP_OK : ESP_FAIL;
+}
+
+static void temperature_sensor_bus_take(void)
+{
+    xSemaphoreTake(bus_mutex, portMAX_DELAY);
+    power_lock_acquire(pm_lock);
+}
+
+static void temperature_sensor_bus_give(void)
+{
+    power_lock_release(pm_lock);
+    xSemaphoreGive(bus_mutex);
+}
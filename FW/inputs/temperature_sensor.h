@@ -1,33 +1,89 @@
 #pragma once
 
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+#define TEMPERATURE_SENSOR_MAX_PROBES 4u
+
+/**
+ * @brief Last acquired data of a single probe
+ */
+typedef struct
+{
+    uint64_t addr;              /*!< 1-Wire address of the probe */
+    float temp_C;               /*!< temperature in Celsius */
+    int64_t timestamp_us;       /*!< time of the conversion (esp_timer_get_time) */
+    bool valid;                 /*!< false if the last read of the probe failed */
+    uint8_t resolution_bits;    /*!< conversion resolution, 9 - 12 bits */
+    uint32_t period_ms;         /*!< sampling period of the probe */
+} temperature_sensor_probe_t;
+
 /**
- * @brief Temperature sensor task
- * 
- * @param pvParameter parameter of task (not used)
+ * @brief Snapshot of all probes published by temperature sensor job
  */
-void temperature_sensor_task(void *pvParameter);
+typedef struct
+{
+    uint8_t count;
+    temperature_sensor_probe_t probes[TEMPERATURE_SENSOR_MAX_PROBES];
+} temperature_sensor_snapshot_t;
 
 /**
- * @brief Detects how many devices are connected 
- * 
+ * @brief Adds the sensor job to the scheduler. The job runs non-blocking conversions
+ *        of each probe at its own resolution and period and publishes the snapshot.
+ *        Probes which are due at the same time are converted with one bus-wide conversion.
+ *
+ * @return ESP_OK on success, otherwise return ESP_FAIL
+ */
+esp_err_t temperature_sensor_init(void);
+
+/**
+ * @brief Detects how many devices are connected
+ *
  * @return uint8_t up-to-date number of detected devices
  */
 uint8_t temperature_sensor_rescan_devices (void);
 
 /**
  * @brief Gets the number of devices detected during last scan
- * 
+ *
  * @return uint8_t number of devices detected during last scan
  */
 uint8_t temperature_sensor_get_devices_number (void);
 
 /**
- * @brief Gets full data of all of the devices 
- * 
+ * @brief Gets cached data of one of the devices, does not access the bus
+ *
  * @param temp_C temperature in Celsius
  * @param temp_F temperature in Fahrenheit
  * @param addr address of the device in hex
  * @param sensor_no numeric index in decimal
- * @return ESP_OK if read was successful, otherwise return ESP_FAIL
+ * @return ESP_OK if last read of the device was successful, otherwise return ESP_FAIL
  */
 esp_err_t temperature_sensor_get_data (float* temp_C, float* temp_F, uint64_t* const addr, uint8_t sensor_no);
+
+/**
+ * @brief Copies the last published snapshot of all devices, does not access the bus
+ *
+ * @param snapshot destination of the snapshot
+ */
+void temperature_sensor_get_snapshot (temperature_sensor_snapshot_t* const snapshot);
+
+/**
+ * @brief Runs a conversion of all devices immediately and publishes the result,
+ *        blocks the caller for the conversion time
+ *
+ * @return ESP_OK if all devices were read successfully, otherwise return ESP_FAIL
+ */
+esp_err_t temperature_sensor_refresh (void);
+
+/**
+ * @brief Sets conversion resolution and sampling period of a device. The setting
+ *        is kept for the device address and reapplied after every rescan.
+ *
+ * @param sensor_no numeric index in decimal
+ * @param resolution_bits conversion resolution, 9 - 12 bits
+ * @param period_ms sampling period, extended to the conversion time if shorter
+ * @return ESP_OK on success, otherwise return ESP_FAIL
+ */
+esp_err_t temperature_sensor_configure (uint8_t sensor_no, uint8_t resolution_bits, uint32_t period_ms);
@@ -1,52 +1,161 @@
 #include <stdio.h>
+#include <string.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "esp_log.h"
 #include "esp_err.h"
-#include "driver/pcnt.h"
-#include "driver/timer.h"
-#include "freertos/semphr.h"
+#include "nvs.h"
 #include "../mcu/pinout.h"
+#include "../mcu/peripherals.h"
+#include "freq_meas.h"
+#include "freq_sensor.h"
+#include "water_tank_meas.h"
 
-#define TIMER_ALARM_VALUE   80000u
-#define TIMER_DIVIDER       100u
+#define TANK_PCNT_UNIT      ESP_PCNT_UNIT_TANK
+#define TANK_INPUT_SIG_IO   ESP_PIN_FREQ_TANK
 
-#define COUNTER_CORRECTION  10u
+#define DEFAULT_GATE_MS     100u
 
-#define MEASURES_PER_SECOND (1000u/TIMER_DIVIDER)
+#define MIN_WATER_LEVEL     0u
+#define MAX_WATER_LEVEL     2000u
 
-#define PCNT_INPUT_SIG_IO   ESP_PIN_FREQ_TANK 
-#define PCNT_INPUT_CTRL_IO  0 //that pin is IO0 and it can affect on proper counting
+/* Default filter chain: reject jumps above 20% unless they last 3 samples, median of 5, light smoothing */
+#define DEFAULT_OUTLIER_RATIO   0.2f
+#define DEFAULT_OUTLIER_LIMIT   3u
+#define DEFAULT_MEDIAN_WINDOW   5u
+#define DEFAULT_EMA_ALPHA       0.3f
 
-#define PCNT_H_LIM_VAL      UINT16_MAX
-#define PCNT_L_LIM_VAL      0
+/* Frequency captured by a level switch is averaged with the previous captures */
+#define AUTO_CAL_ALPHA          0.5f
 
-#define MIN_WATER_LEVEL     0u
-#define MAX_WATER_LEVEL     2000u
+#define NVS_NAMESPACE           "water_tank"
+#define NVS_KEY_CALIBRATION     "cal"
+
+/**
+ * @brief Calibration kept in NVS
+ */
+typedef struct
+{
+    uint8_t count;
+    calibration_point_t points[CALIBRATION_MAX_POINTS];
+    float freq_min;
+    float freq_max;
+    float tank_min_ml;
+    float tank_max_ml;
+    bool tank_min_defined;
+    bool tank_max_defined;
+} water_tank_nvs_t;
 
-static volatile uint32_t last_measured_freq = 0;
-static volatile uint16_t last_pcnt_val = 0;
+static freq_sensor_t tank;
 
-static volatile float tank_level_ml;
-static volatile float a_coeff;
-static volatile float b_coeff;
-static volatile float freq_max;
-static volatile float freq_min;
-static volatile float tank_max_ml;
-static volatile float tank_min_ml;
-static volatile uint64_t last_timer_val;
+/* Legacy two point calibration, each pair is mapped onto a point of the table */
+static float freq_max;
+static float freq_min;
+static float tank_max_ml;
+static float tank_min_ml;
+static bool tank_max_defined = false;
+static bool tank_min_defined = false;
 
-portMUX_TYPE myMutex = portMUX_INITIALIZER_UNLOCKED;
+static const char *TAG = "water_tank";
 
-esp_err_t water_tank_get_level(float* const water_tank_level)
+/**
+ * @brief Adds a calibration point made by legacy min or max commands once both
+ *        its level and frequency are known
+ * 
+ * @param freq calibrated frequency, 0 if not calibrated yet
+ * @param level_ml defined level
+ * @param defined true if the level was defined
+ */
+static void water_tank_update_legacy_point(float freq, float level_ml, bool defined);
+
+/**
+ * @brief Restores calibration from NVS, NVS flash must be initialized
+ */
+static void water_tank_load(void);
+
+/**
+ * @brief Stores calibration in NVS
+ */
+static void water_tank_save(void);
+
+esp_err_t water_tank_init(void)
 {
-    *water_tank_level = tank_level_ml;
+    const signal_filter_config_t filter_config = {
+        .outlier_ratio = DEFAULT_OUTLIER_RATIO,
+        .outlier_limit = DEFAULT_OUTLIER_LIMIT,
+        .median_window = DEFAULT_MEDIAN_WINDOW,
+        .ema_alpha = DEFAULT_EMA_ALPHA
+    };
+
+    if (ESP_OK != freq_sensor_init(&tank, TANK_PCNT_UNIT, TANK_INPUT_SIG_IO, DEFAULT_GATE_MS, &filter_config,
+                                   MIN_WATER_LEVEL, MAX_WATER_LEVEL, DATA_STORE_TANK_LEVEL))
+    {
+        return ESP_FAIL;
+    }
+    water_tank_load();
     return ESP_OK;
 }
 
-uint32_t water_tank_get_frequency(void)
+esp_err_t water_tank_get_level(float* const water_tank_level)
+{
+    return freq_sensor_get_value(&tank, water_tank_level);
+}
+
+float water_tank_get_frequency(void)
 {       
-    return last_measured_freq;
+    return freq_sensor_get_frequency(&tank);
+}
+
+float water_tank_get_filtered_frequency(void)
+{
+    return freq_sensor_get_filtered_frequency(&tank);
+}
+
+esp_err_t water_tank_add_point(float freq, float level_ml)
+{
+    esp_err_t ret = freq_sensor_add_point(&tank, freq, level_ml);
+
+    if (ESP_OK == ret)
+    {
+        water_tank_save();
+    }
+    return ret;
+}
+
+esp_err_t water_tank_remove_point(uint8_t index)
+{
+    esp_err_t ret = freq_sensor_remove_point(&tank, index);
+
+    if (ESP_OK == ret)
+    {
+        water_tank_save();
+    }
+    return ret;
+}
+
+uint8_t water_tank_get_points(calibration_point_t* const points)
+{
+    return freq_sensor_get_points(&tank, points);
+}
+
+void water_tank_set_filter(const signal_filter_config_t* const config)
+{
+    freq_sensor_set_filter(&tank, config);
+}
+
+void water_tank_get_filter(signal_filter_config_t* const config)
+{
+    freq_sensor_get_filter(&tank, config);
+}
+
+esp_err_t water_tank_set_gate_time(uint32_t gate_ms)
+{
+    return freq_meas_set_gate_time(TANK_PCNT_UNIT, gate_ms);
+}
+
+uint32_t water_tank_get_gate_time(void)
+{
+    return freq_meas_get_gate_time(TANK_PCNT_UNIT);
 }
 
 esp_err_t water_tank_define_max_level(float max_level)
@@ -54,6 +163,9 @@ esp_err_t water_tank_define_max_level(float max_level)
     if (MIN_WATER_LEVEL <= max_level && MAX_WATER_LEVEL >= max_level)
     {
         tank_max_ml = max_level;
+        tank_max_defined = true;
+        water_tank_update_legacy_point(freq_max, tank_max_ml, tank_max_defined);
+        water_tank_save();
         return ESP_OK;
     }
     else
@@ -67,6 +179,9 @@ esp_err_t water_tank_define_min_level(float min_level)
     if (MIN_WATER_LEVEL <= min_level && MAX_WATER_LEVEL >= min_level)
     {
         tank_min_ml = min_level;
+        tank_min_defined = true;
+        water_tank_update_legacy_point(freq_min, tank_min_ml, tank_min_defined);
+        water_tank_save();
         return ESP_OK;
     }
     else
@@ -77,7 +192,9 @@ esp_err_t water_tank_define_min_level(float min_level)
 
 esp_err_t water_tank_calibrate_max(void)
 {
-    freq_max = last_measured_freq;
+    freq_max = water_tank_get_filtered_frequency();
+    water_tank_update_legacy_point(freq_max, tank_max_ml, tank_max_defined);
+    water_tank_save();
     return ESP_OK;
 }
 
@@ -88,7 +205,9 @@ float water_tank_get_max_freq(void)
 
 esp_err_t water_tank_calibrate_min(void)
 {
-    freq_min = last_measured_freq;
+    freq_min = water_tank_get_filtered_frequency();
+    water_tank_update_legacy_point(freq_min, tank_min_ml, tank_min_defined);
+    water_tank_save();
     return ESP_OK;
 }
 
@@ -97,72 +216,91 @@ float water_tank_get_min_freq(void)
     return freq_min;
 }
 
-static void water_tank_init()
-{    
-    //Timer----------------------------------------------
-    timer_config_t config = {
-        .divider = TIMER_DIVIDER,
-        .counter_dir = TIMER_COUNT_UP,
-        .counter_en = TIMER_PAUSE,
-        .alarm_en = TIMER_ALARM_EN,
-        .auto_reload = TIMER_AUTORELOAD_EN
-    };
-
-    timer_init(TIMER_GROUP_0, TIMER_0, &config);
-    timer_set_counter_value(TIMER_GROUP_0, TIMER_0, 0);
-    timer_start(TIMER_GROUP_0, TIMER_0);
-    //End timer------------------------------------------
-
-    /* Prepare configuration for the PCNT unit */
-    pcnt_config_t pcnt_config = {
-        // Set PCNT input signal and control GPIOs
-        .pulse_gpio_num = PCNT_INPUT_SIG_IO,        
-        .ctrl_gpio_num = PCNT_INPUT_CTRL_IO,
-        .channel = PCNT_CHANNEL_0,
-        .unit = PCNT_UNIT_0,
-        // What to do on the positive / negative edge of pulse input?
-        .pos_mode = PCNT_COUNT_INC,   // Count up on the positive edge
-        .neg_mode = PCNT_COUNT_DIS,   // Keep the counter value on the negative edge
-        // What to do when control input is low or high?
-        .lctrl_mode = PCNT_MODE_REVERSE, // Reverse counting direction if low
-        .hctrl_mode = PCNT_MODE_KEEP,    // Keep the primary counter mode if high
-        // Set the maximum and minimum limit values to watch
-        .counter_h_lim = PCNT_H_LIM_VAL,
-        .counter_l_lim = PCNT_L_LIM_VAL,
-    };
-    /* Initialize PCNT unit */
-    pcnt_unit_config(&pcnt_config);
+esp_err_t water_tank_auto_calibrate(water_tank_switch_t level_switch)
+{
+    float freq = water_tank_get_filtered_frequency();
 
-    /* Initialize PCNT's counter */
-    pcnt_counter_pause(PCNT_UNIT_0);
-    pcnt_counter_clear(PCNT_UNIT_0);
+    if (0.0f >= freq)
+    {
+        return ESP_FAIL;
+    }
 
-    /* Everything is set up, now go to counting */
-    pcnt_counter_resume(PCNT_UNIT_0);
+    /* Each refill and drain refines the point, a single capture does not overwrite it */
+    if (WATER_TANK_SWITCH_MAX == level_switch)
+    {
+        freq_max = (0.0f < freq_max) ? freq_max + AUTO_CAL_ALPHA * (freq - freq_max) : freq;
+        water_tank_update_legacy_point(freq_max, tank_max_ml, tank_max_defined);
+        ESP_LOGI(TAG, "Max level switch at %0.3f Hz, point at %0.3f Hz", freq, freq_max);
+    }
+    else
+    {
+        freq_min = (0.0f < freq_min) ? freq_min + AUTO_CAL_ALPHA * (freq - freq_min) : freq;
+        water_tank_update_legacy_point(freq_min, tank_min_ml, tank_min_defined);
+        ESP_LOGI(TAG, "Min level switch at %0.3f Hz, point at %0.3f Hz", freq, freq_min);
+    }
+    water_tank_save();
+    return ESP_OK;
 }
 
-void water_tank_task(void *pvParameter)
+static void water_tank_update_legacy_point(float freq, float level_ml, bool defined)
 {
-    water_tank_init();
-
-    while(1)
-    {        
-        taskENTER_CRITICAL(&myMutex);
-        timer_get_counter_value(TIMER_GROUP_0, TIMER_0, &last_timer_val);
-        timer_set_counter_value(TIMER_GROUP_0, TIMER_0, 0);
-        pcnt_get_counter_value(PCNT_UNIT_0, &last_pcnt_val);
-        pcnt_counter_clear(PCNT_UNIT_0);
-        taskEXIT_CRITICAL(&myMutex);
+    if (defined && 0.0f < freq && ESP_OK != freq_sensor_add_point(&tank, freq, level_ml))
+    {
+        ESP_LOGE(TAG, "Calibration table is full");
+    }
+}
 
-        last_measured_freq = ((TIMER_ALARM_VALUE * last_pcnt_val)/last_timer_val)*COUNTER_CORRECTION;
+static void water_tank_load(void)
+{
+    nvs_handle_t handle;
+    water_tank_nvs_t data;
+    size_t length = sizeof(data);
 
-        //Calculation can be done only when all parameters are set (not zeroed)
-        if(0 != freq_min && 0 != freq_max && 0 != tank_min_ml && 0 != tank_max_ml)
+    if (ESP_OK != nvs_open(NVS_NAMESPACE, NVS_READONLY, &handle))
+    {
+        return;
+    }
+    /* Blob of a different layout is ignored */
+    if (ESP_OK == nvs_get_blob(handle, NVS_KEY_CALIBRATION, &data, &length) && sizeof(data) == length &&
+        CALIBRATION_MAX_POINTS >= data.count)
+    {
+        for (uint8_t i = 0u; i < data.count; i++)
         {
-            a_coeff = (tank_max_ml - tank_min_ml)/(freq_max - freq_min);
-            b_coeff = tank_max_ml - a_coeff * freq_max;            
-            tank_level_ml = a_coeff * last_measured_freq + b_coeff;            
+            freq_sensor_add_point(&tank, data.points[i].x, data.points[i].y);
         }
-        vTaskDelay(100 / portTICK_RATE_MS); //100ms
+        freq_min = data.freq_min;
+        freq_max = data.freq_max;
+        tank_min_ml = data.tank_min_ml;
+        tank_max_ml = data.tank_max_ml;
+        tank_min_defined = data.tank_min_defined;
+        tank_max_defined = data.tank_max_defined;
+        ESP_LOGI(TAG, "Restored %u calibration points", data.count);
     }
-}
\ No newline at end of file
+    nvs_close(handle);
+}
+
+static void water_tank_save(void)
+{
+    nvs_handle_t handle;
+    water_tank_nvs_t data;
+
+    memset(&data, 0, sizeof(data));
+    data.count = freq_sensor_get_points(&tank, data.points);
+    data.freq_min = freq_min;
+    data.freq_max = freq_max;
+    data.tank_min_ml = tank_min_ml;
+    data.tank_max_ml = tank_max_ml;
+    data.tank_min_defined = tank_min_defined;
+    data.tank_max_defined = tank_max_defined;
+
+    if (ESP_OK != nvs_open(NVS_NAMESPACE, NVS_READWRITE, &handle))
+    {
+        ESP_LOGE(TAG, "Cannot open NVS");
+        return;
+    }
+    if (ESP_OK != nvs_set_blob(handle, NVS_KEY_CALIBRATION, &data, sizeof(data)) || ESP_OK != nvs_commit(handle))
+    {
+        ESP_LOGE(TAG, "Cannot store calibration");
+    }
+    nvs_close(handle);
+}
@@ -1,19 +1,95 @@
 #pragma once
 
+#include <stdint.h>
+#include "esp_err.h"
+#include "calibration.h"
+#include "signal_filter.h"
+
+/**
+ * @brief Level switches of the tank
+ */
+typedef enum
+{
+    WATER_TANK_SWITCH_MIN = 0,
+    WATER_TANK_SWITCH_MAX,
+    WATER_TANK_SWITCHES_NUM
+} water_tank_switch_t;
+
 /**
- * @brief Get water tank level
+ * @brief Get water tank level computed from filtered frequency with the calibration table
  * 
  * @param warter_tank_level pointer to water tank level
- * @return ESP_OK for success  
+ * @return ESP_OK for success, ESP_FAIL if the tank has less than two calibration points
  */
 esp_err_t water_tank_get_level(float* const warter_tank_level);
 
 /**
  * @brief Return last measured frequency
  * 
- * @return Last measured frequency
+ * @return Last measured raw frequency in Hz, 0 if the generator is stopped
  */
-uint32_t water_tank_get_frequency(void);
+float water_tank_get_frequency(void);
+
+/**
+ * @brief Return output of the filter chain
+ * 
+ * @return Filtered frequency in Hz
+ */
+float water_tank_get_filtered_frequency(void);
+
+/**
+ * @brief Add calibration point, a point with the same level or frequency is replaced
+ * 
+ * @param freq frequency in Hz, 0 to use current filtered frequency
+ * @param level_ml level of water in mililitres
+ * @return ESP_OK for success
+ */
+esp_err_t water_tank_add_point(float freq, float level_ml);
+
+/**
+ * @brief Remove calibration point
+ * 
+ * @param index index of the point, points are sorted by frequency
+ * @return ESP_OK for success
+ */
+esp_err_t water_tank_remove_point(uint8_t index);
+
+/**
+ * @brief Copy calibration points
+ * 
+ * @param points destination for up to CALIBRATION_MAX_POINTS points
+ * @return number of points
+ */
+uint8_t water_tank_get_points(calibration_point_t* const points);
+
+/**
+ * @brief Set up filter chain of the frequency, resets the filter
+ * 
+ * @param config filter configuration
+ */
+void water_tank_set_filter(const signal_filter_config_t* const config);
+
+/**
+ * @brief Get configuration of the filter chain
+ * 
+ * @param config destination of the configuration
+ */
+void water_tank_get_filter(signal_filter_config_t* const config);
+
+/**
+ * @brief Set up duration of a single frequency measurement
+ * 
+ * @param gate_ms gate time in ms
+ * @return ESP_OK for success
+ */
+esp_err_t water_tank_set_gate_time(uint32_t gate_ms);
+
+/**
+ * @brief Return duration of a single frequency measurement
+ * 
+ * @return gate time in ms
+ */
+uint32_t water_tank_get_gate_time(void);
 
 /**
  * @brief Set up max water tank level in mililitres
@@ -32,7 +108,7 @@ esp_err_t water_tank_define_max_level(float max_level);
 esp_err_t water_tank_define_min_level(float min_level);
 
 /**
- * @brief Get last measured frequency from water tank pcnt
+ * @brief Use current filtered frequency as frequency of max level, adds calibration point
  * 
  * @return ESP_OK for success 
  */
@@ -46,7 +122,7 @@ esp_err_t water_tank_calibrate_max(void);
 float water_tank_get_max_freq(void);
 
 /**
- * @brief Get last measured frequency from water tank pcnt
+ * @brief Use current filtered frequency as frequency of min level, adds calibration point
  * 
  * @return ESP_OK for success
  */
@@ -60,14 +136,18 @@ esp_err_t water_tank_calibrate_min(void);
 float water_tank_get_min_freq(void);
 
 /**
- * @brief Initialize timer and pulse counter
+ * @brief Refine frequency of min or max level with current filtered frequency, called when
+ *        the level switch trips. Adds calibration point if the level is defined and stores it.
  * 
+ * @param level_switch switch which tripped
+ * @return ESP_OK for success, ESP_FAIL if there is no valid frequency
  */
-static void water_tank_init();
+esp_err_t water_tank_auto_calibrate(water_tank_switch_t level_switch);
 
 /**
- * @brief Water tank task
+ * @brief Initialize frequency input of the tank generator, results are processed by freq_meas_task.
+ *        Restores calibration from NVS, NVS flash must be initialized.
  * 
- * @param pvParameter Parameter of task (not used)
+ * @return ESP_OK for success
  */
-void water_tank_task(void *pvParameter);
\ No newline at end of file
+esp_err_t water_tank_init(void);
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include "freertos/task.h"
 #include "driver/gpio.h"
 #include "esp_log.h"
+#include "nvs_flash.h"
 #include "sdkconfig.h"
 #include "../outputs/watering_pump_control.h"
 #include "../outputs/cooling_pump_control.h"
@@ -11,18 +12,79 @@
 #include "../inputs/temperature_sensor.h"
 #include "../outputs/dehumyfing_ventilator_control.h"
 #include "../outputs/cooling_ventilator_control.h"
+#include "../inputs/freq_meas.h"
 #include "../inputs/water_tank_meas.h"
+#include "../inputs/tank_level_switch.h"
+#include "../inputs/soil_moisture.h"
+#include "../inputs/fan_tach.h"
+#include "../inputs/light_sensor.h"
+#include "../inputs/power_meter.h"
+#include "../inputs/pressure_sensor.h"
 #include "../outputs/peltier_power_control.h"
+#include "../outputs/grow_light_control.h"
+#include "../outputs/flood_protection.h"
+#include "../outputs/actuators.h"
+#include "../outputs/cooling_control.h"
+#include "../system/scheduler.h"
+#include "../system/task_plan.h"
+#include "../system/power.h"
+
+/**
+ * @brief Initializes NVS flash, erases it if it is full or of a newer format
+ */
+static void initialize_nvs(void);
 
 void app_main()
 {
-    xTaskCreate(&watering_pump_control_task, "watering_pump_control_task", 4096, NULL, 5, NULL);
-    xTaskCreate(&cooling_pump_control_task, "cooling_pump_control_task", 4096, NULL, 5, NULL);
-    xTaskCreate(&console_interface_task, "console_interface_task", 4096, NULL, 10, NULL);
-    xTaskCreate(&humidity_sensor_task, "humidity_sensor_task", 4096, NULL, 5, NULL);
-    xTaskCreate(&temperature_sensor_task, "temperature_sensor_task", 4096, NULL, 5, NULL);
-    xTaskCreate(&cooling_ventilator_control_task, "cooling_ventilator_control_task", 4096, NULL, 5, NULL);
-    xTaskCreate(&dehumyfing_ventilator_control_task, "dehumyfing_ventilator_control_task", 4096, NULL, 5, NULL);
-    xTaskCreate(&water_tank_task, "water_tank_task", 4096, NULL, 6, NULL);
-    xTaskCreate(&peltier_power_control_task, "peltier_power_control_task", 4096, NULL, 5, NULL);
-}
\ No newline at end of file
+    /* Calibrations are restored from NVS while the inputs are initialized */
+    initialize_nvs();
+
+    /* Drivers create their power management locks in the inits, frequency scaling is configured before them */
+    ESP_ERROR_CHECK(power_init());
+
+    /* Hardware cut-off of the pumps is routed before the actuator outputs are configured */
+    ESP_ERROR_CHECK(flood_protection_init());
+    ESP_ERROR_CHECK(actuators_init());
+
+    /* Periodic jobs of the modules share one scheduler task and a small worker pool, they are added by the inits */
+    ESP_ERROR_CHECK(scheduler_init());
+
+    /* Frequency inputs share one timebase and one task, channels are added before the task starts */
+    ESP_ERROR_CHECK(freq_meas_init());
+    ESP_ERROR_CHECK(water_tank_init());
+    ESP_ERROR_CHECK(tank_level_switch_init());
+    ESP_ERROR_CHECK(soil_moisture_init());
+    ESP_ERROR_CHECK(fan_tach_init());
+    ESP_ERROR_CHECK(light_sensor_init());
+
+    ESP_ERROR_CHECK(watering_pump_control_init());
+    ESP_ERROR_CHECK(cooling_pump_control_init());
+    ESP_ERROR_CHECK(humidity_sensor_init());
+    ESP_ERROR_CHECK(temperature_sensor_init());
+    ESP_ERROR_CHECK(pressure_sensor_init());
+    ESP_ERROR_CHECK(grow_light_control_init());
+    ESP_ERROR_CHECK(cooling_control_init());
+
+    /* Control work and the frequency sampler share a core with the input interrupts, sensor buses use the other one */
+    xTaskCreatePinnedToCore(&scheduler_task, "scheduler_task", 4096, NULL, TASK_PLAN_CONTROL_PRIORITY, NULL,
+                            TASK_PLAN_CONTROL_CORE);
+    xTaskCreatePinnedToCore(&freq_meas_task, "freq_meas_task", 4096, NULL, TASK_PLAN_FREQ_MEAS_PRIORITY, NULL,
+                            TASK_PLAN_CONTROL_CORE);
+    xTaskCreatePinnedToCore(&tank_level_switch_task, "tank_level_switch_task", 4096, NULL, TASK_PLAN_CONTROL_PRIORITY,
+                            NULL, TASK_PLAN_CONTROL_CORE);
+    xTaskCreatePinnedToCore(&power_meter_task, "power_meter_task", 4096, NULL, TASK_PLAN_POWER_METER_PRIORITY, NULL,
+                            TASK_PLAN_SENSOR_BUS_CORE);
+    xTaskCreatePinnedToCore(&console_interface_task, "console_interface_task", 4096, NULL, TASK_PLAN_CONSOLE_PRIORITY,
+                            NULL, TASK_PLAN_CONSOLE_CORE);
+}
+
+static void initialize_nvs(void)
+{
+    esp_err_t err = nvs_flash_init();
+    if (err == ESP_ERR_NVS_NO_FREE_PAGES || err == ESP_ERR_NVS_NEW_VERSION_FOUND) 
+    {
+        ESP_ERROR_CHECK( nvs_flash_erase() );
+        err = nvs_flash_init();
+    }
+    ESP_ERROR_CHECK(err);
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+/*Assignment of peripheral channels shared between modules*/
+
+#if CONFIG_IDF_TARGET_ESP32
+
+#define ESP_RMT_CH_ONEWIRE_TX 0
+#define ESP_RMT_CH_ONEWIRE_RX 1
+#define ESP_RMT_CH_DHT_TX 2
+#define ESP_RMT_CH_DHT_RX 3
+
+#define ESP_PCNT_UNIT_TANK 0
+#define ESP_PCNT_UNIT_SOIL 1
+#define ESP_PCNT_UNIT_DEHUM_FAN 2
+#define ESP_PCNT_UNIT_LIGHT 3
+
+#define ESP_TIMER_GROUP_FREQ 0
+#define ESP_TIMER_FREQ 0
+
+/*ADC DMA of the power meter occupies I2S0*/
+#define ESP_ADC_CH_V_MEAS 6
+#define ESP_ADC_CH_CURR_MEAS 7
+
+#define ESP_I2C_PORT_SENSORS 0
+
+#define ESP_LEDC_TIMER_LIGHT 0
+#define ESP_LEDC_CH_LIGHT 0
+
+#elif CONFIG_IDF_TARGET_ESP32S3
+
+/*Channels 0-3 can only transmit, channels 4-7 can only receive*/
+#define ESP_RMT_CH_ONEWIRE_TX 0
+#define ESP_RMT_CH_ONEWIRE_RX 4
+#define ESP_RMT_CH_DHT_TX 1
+#define ESP_RMT_CH_DHT_RX 5
+
+#define ESP_PCNT_UNIT_TANK 0
+#define ESP_PCNT_UNIT_SOIL 1
+#define ESP_PCNT_UNIT_DEHUM_FAN 2
+#define ESP_PCNT_UNIT_LIGHT 3
+
+#define ESP_TIMER_GROUP_FREQ 0
+#define ESP_TIMER_FREQ 0
+
+#define ESP_ADC_CH_V_MEAS 5
+#define ESP_ADC_CH_CURR_MEAS 6
+
+#define ESP_I2C_PORT_SENSORS 0
+
+#define ESP_LEDC_TIMER_LIGHT 0
+#define ESP_LEDC_CH_LIGHT 0
+
+#endif
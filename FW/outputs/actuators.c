@@ -0,0 +1,338 @@
+#include <stdio.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "driver/mcpwm.h"
+#include "soc/mcpwm_struct.h"
+#include "actuators.h"
+#include "flood_protection.h"
+#include "../mcu/pinout.h"
+#include "../system/data_store.h"
+#include "../system/perf.h"
+#include "../system/trace.h"
+#include "../system/power.h"
+
+#define FAN_PWM_FREQ_HZ 10000u
+#define PUMP_PWM_FREQ_HZ 10000u
+#define WATERING_PUMP_PWM_FREQ_HZ 100u
+#define PELTIER_PWM_FREQ_HZ 10000u
+
+/* MCPWM_UPDATE_CFG_REG: bit 0 global update enable, then update enable and force bits of each operator */
+#define UPDATE_CFG_OP_UP_EN(op) (1u << (2u * (op) + 2u))
+
+/**
+ * @brief Output of an actuator, operator n of the unit is driven by timer n
+ */
+typedef struct
+{
+    const char *name;
+    mcpwm_unit_t unit;
+    mcpwm_timer_t timer;
+    mcpwm_io_signals_t io_signal;
+    gpio_num_t pin;
+    uint32_t freq_hz;
+    bool synced;                /*!< counter follows timer 0 of the unit, which has the same frequency */
+    bool flood_protected;       /*!< output forced low by flood fault, inhibited while it is latched */
+    data_store_signal_t signal;
+} actuator_info_t;
+
+static const actuator_info_t actuator_info[ACTUATORS_NUM] = {
+    [ACTUATOR_COOLING_PUMP] = {
+        "cooling_pump", MCPWM_UNIT_0, MCPWM_TIMER_0, MCPWM0A, ESP_PIN_COOL_PUMP,
+        PUMP_PWM_FREQ_HZ, false, true, DATA_STORE_COOLING_PUMP},
+    [ACTUATOR_WATERING_PUMP] = {
+        "watering_pump", MCPWM_UNIT_0, MCPWM_TIMER_1, MCPWM1A, ESP_PIN_WATER_PUMP,
+        WATERING_PUMP_PWM_FREQ_HZ, false, true, DATA_STORE_WATERING_PUMP},
+    [ACTUATOR_COOLING_VENTILATOR] = {
+        "cooling_ventilator", MCPWM_UNIT_0, MCPWM_TIMER_2, MCPWM2A, ESP_PIN_COOL_FAN,
+        FAN_PWM_FREQ_HZ, true, false, DATA_STORE_COOLING_VENTILATOR},
+    [ACTUATOR_DEHUMYFING_VENTILATOR] = {
+        "dehumyfing_ventilator", MCPWM_UNIT_1, MCPWM_TIMER_0, MCPWM0A, ESP_PIN_DEHUM_FAN,
+        FAN_PWM_FREQ_HZ, false, false, DATA_STORE_DEHUMYFING_VENTILATOR},
+    [ACTUATOR_PELTIER] = {
+        "peltier", MCPWM_UNIT_1, MCPWM_TIMER_1, MCPWM1A, ESP_PIN_PELT,
+        PELTIER_PWM_FREQ_HZ, true, false, DATA_STORE_PELTIER},
+};
+
+static mcpwm_dev_t* const mcpwm_dev[MCPWM_UNIT_MAX] = {&MCPWM0, &MCPWM1};
+
+/* Guards duty registers of all actuators, held only for the register writes */
+static portMUX_TYPE actuators_mux = portMUX_INITIALIZER_UNLOCKED;
+static uint32_t running_mask = 0u;
+static bool pm_held = false;
+/* Flood self test owns the outputs, other batches are refused */
+static bool testing = false;
+
+/* MCPWM is clocked from APB, outputs would change frequency with it and stop in light sleep */
+static esp_pm_lock_handle_t pm_lock = NULL;
+
+static const char *TAG = "actuators";
+
+/**
+ * @brief Synchronizes counter of the actuator timer to timer 0 of its unit
+ *
+ * @param info the actuator
+ * @return ESP_OK on success, otherwise return ESP_FAIL
+ */
+static esp_err_t actuators_sync(const actuator_info_t* const info);
+
+/**
+ * @brief Applies the batch, actuators_apply without the check of the self test
+ *
+ * @param batch the batch
+ * @param test true if the batch comes from the self test
+ * @return ESP_OK on success, otherwise return ESP_FAIL
+ */
+static esp_err_t actuators_write(const actuators_batch_t* const batch, bool test);
+
+esp_err_t actuators_init(void)
+{
+    esp_err_t ret = power_lock_create(ESP_PM_APB_FREQ_MAX, "actuators", &pm_lock);
+
+    for (uint8_t i = 0u; ESP_OK == ret && i < ACTUATORS_NUM; i++)
+    {
+        const actuator_info_t *info = &actuator_info[i];
+        mcpwm_config_t pwm_config = {
+            .frequency = info->freq_hz,
+            .cmpr_a = 0.0f,
+            .cmpr_b = 0.0f,
+            .counter_mode = MCPWM_UP_COUNTER,
+            .duty_mode = MCPWM_DUTY_MODE_0,
+        };
+
+        ret = mcpwm_gpio_init(info->unit, info->io_signal, info->pin);
+        if (ESP_OK == ret)
+        {
+            ret = mcpwm_init(info->unit, info->timer, &pwm_config);
+        }
+        if (ESP_OK == ret && info->synced)
+        {
+            ret = actuators_sync(info);
+        }
+        if (ESP_OK == ret && info->flood_protected)
+        {
+            ret = flood_protection_attach(info->timer, info->pin);
+        }
+        if (ESP_OK != ret)
+        {
+            ESP_LOGE(TAG, "Could not initialize %s", info->name);
+        }
+        data_store_publish_float(info->signal, 0.0f);
+    }
+    return (ESP_OK == ret) ? ESP_OK : ESP_FAIL;
+}
+
+void actuators_batch_set(actuators_batch_t* const batch, actuator_t actuator, float level)
+{
+    if (ACTUATORS_NUM > actuator)
+    {
+        batch->mask |= ACTUATOR_BIT(actuator);
+        batch->level[actuator] = level;
+    }
+}
+
+esp_err_t actuators_apply(const actuators_batch_t* const batch)
+{
+    return actuators_write(batch, false);
+}
+
+static esp_err_t actuators_write(const actuators_batch_t* const batch, bool test)
+{
+    uint32_t hold[MCPWM_UNIT_MAX] = {0u};
+    uint32_t inhibited = actuators_get_inhibited();
+    uint32_t starting = 0u;
+    bool take;
+    bool drop;
+    TRACE_SCOPE(TRACE_MARKER_ACTUATORS_APPLY);
+
+    if (0u != (batch->mask & ~(ACTUATOR_BIT(ACTUATORS_NUM) - 1u)))
+    {
+        return ESP_FAIL;
+    }
+    for (uint8_t i = 0u; i < ACTUATORS_NUM; i++)
+    {
+        if (0u == (batch->mask & ACTUATOR_BIT(i)))
+        {
+            continue;
+        }
+        if (0.0f > batch->level[i] || 100.0f < batch->level[i] ||
+            (0u != (inhibited & ACTUATOR_BIT(i)) && 0.0f != batch->level[i]))
+        {
+            return ESP_FAIL;
+        }
+        hold[actuator_info[i].unit] |= UPDATE_CFG_OP_UP_EN(actuator_info[i].timer);
+        starting |= (0.0f != batch->level[i]) ? ACTUATOR_BIT(i) : 0u;
+    }
+
+    /* Clock is at full speed before a new duty starts, the lock of the batch is dropped at the end */
+    if (0u != starting)
+    {
+        power_lock_acquire(pm_lock);
+    }
+
+    PERF_BEGIN(critical, PERF_PROBE_ACTUATORS_CRITICAL);
+    taskENTER_CRITICAL(&actuators_mux);
+    if (testing && !test)
+    {
+        taskEXIT_CRITICAL(&actuators_mux);
+        PERF_END(critical);
+        if (0u != starting)
+        {
+            power_lock_release(pm_lock);
+        }
+        return ESP_FAIL;
+    }
+    /* Shadow compare registers are not transferred while update of their operator is disabled */
+    for (uint8_t unit = 0u; unit < MCPWM_UNIT_MAX; unit++)
+    {
+        mcpwm_dev[unit]->update_cfg.val &= ~hold[unit];
+    }
+    for (uint8_t i = 0u; i < ACTUATORS_NUM; i++)
+    {
+        if (0u != (batch->mask & ACTUATOR_BIT(i)))
+        {
+            mcpwm_set_duty(actuator_info[i].unit, actuator_info[i].timer, MCPWM_OPR_A, batch->level[i]);
+        }
+    }
+    /* One write per unit releases all new duties of the unit at the next timer zero */
+    for (uint8_t unit = 0u; unit < MCPWM_UNIT_MAX; unit++)
+    {
+        mcpwm_dev[unit]->update_cfg.val |= hold[unit];
+    }
+    running_mask = (running_mask & ~batch->mask) | starting;
+    take = (0u != running_mask) && !pm_held;
+    drop = (0u == running_mask) && pm_held;
+    pm_held = (0u != running_mask);
+    taskEXIT_CRITICAL(&actuators_mux);
+    PERF_END(critical);
+
+    /* Held as long as any output runs */
+    if (take)
+    {
+        power_lock_acquire(pm_lock);
+    }
+    if (drop)
+    {
+        power_lock_release(pm_lock);
+    }
+    if (0u != starting)
+    {
+        power_lock_release(pm_lock);
+    }
+
+    for (uint8_t i = 0u; i < ACTUATORS_NUM; i++)
+    {
+        if (0u != (batch->mask & ACTUATOR_BIT(i)))
+        {
+            data_store_publish_float(actuator_info[i].signal, batch->level[i]);
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t actuators_set(actuator_t actuator, float level)
+{
+    actuators_batch_t batch = {0};
+
+    if (ACTUATORS_NUM <= actuator)
+    {
+        return ESP_FAIL;
+    }
+    actuators_batch_set(&batch, actuator, level);
+    return actuators_apply(&batch);
+}
+
+float actuators_get_level(actuator_t actuator)
+{
+    float level = 0.0f;
+
+    if (ACTUATORS_NUM > actuator)
+    {
+        data_store_get_float(actuator_info[actuator].signal, &level);
+    }
+    return level;
+}
+
+uint32_t actuators_get_inhibited(void)
+{
+    uint32_t inhibited = 0u;
+
+    if (flood_protection_is_latched())
+    {
+        for (uint8_t i = 0u; i < ACTUATORS_NUM; i++)
+        {
+            inhibited |= actuator_info[i].flood_protected ? ACTUATOR_BIT(i) : 0u;
+        }
+    }
+    return inhibited;
+}
+
+esp_err_t actuators_flood_test(void)
+{
+    actuators_batch_t batch = {0};
+    float level_before;
+    esp_err_t ret;
+
+    taskENTER_CRITICAL(&actuators_mux);
+    if (testing)
+    {
+        taskEXIT_CRITICAL(&actuators_mux);
+        return ESP_FAIL;
+    }
+    testing = true;
+    taskEXIT_CRITICAL(&actuators_mux);
+    /* Other batches are refused from now on, the level is restored after the test */
+    level_before = actuators_get_level(ACTUATOR_COOLING_PUMP);
+
+    /* Cooling pump circulates in a closed loop, the watering pump is never started by the test */
+    actuators_batch_set(&batch, ACTUATOR_COOLING_PUMP, 100.0f);
+    ret = actuators_write(&batch, true);
+    if (ESP_OK == ret)
+    {
+        ret = flood_protection_test(actuator_info[ACTUATOR_COOLING_PUMP].pin);
+    }
+
+    /* A flood which came during the test keeps the pump stopped */
+    batch.level[ACTUATOR_COOLING_PUMP] = 0.0f;
+    if (0u == (actuators_get_inhibited() & ACTUATOR_BIT(ACTUATOR_COOLING_PUMP)))
+    {
+        batch.level[ACTUATOR_COOLING_PUMP] = level_before;
+    }
+    actuators_write(&batch, true);
+
+    taskENTER_CRITICAL(&actuators_mux);
+    testing = false;
+    taskEXIT_CRITICAL(&actuators_mux);
+
+    return ret;
+}
+
+const char* actuators_get_name(actuator_t actuator)
+{
+    return (ACTUATORS_NUM > actuator) ? actuator_info[actuator].name : "unknown";
+}
+
+static esp_err_t actuators_sync(const actuator_info_t* const info)
+{
+    mcpwm_sync_config_t sync_config = {
+        .sync_sig = MCPWM_SELECT_TIMER0_SYNC,
+        .timer_val = 0u,
+        .count_direction = MCPWM_TIMER_DIRECTION_UP,
+    };
+
+    /* Timer 0 of the unit is configured first, its zero restarts the synchronized timers */
+    for (uint8_t i = 0u; i < ACTUATORS_NUM; i++)
+    {
+        if (actuator_info[i].unit == info->unit && MCPWM_TIMER_0 == actuator_info[i].timer &&
+            actuator_info[i].freq_hz != info->freq_hz)
+        {
+            ESP_LOGE(TAG, "%s has other frequency than timer 0 of its unit", info->name);
+            return ESP_FAIL;
+        }
+    }
+    if (ESP_OK != mcpwm_set_timer_sync_output(info->unit, MCPWM_TIMER_0, MCPWM_SWSYNC_SOURCE_TEZ))
+    {
+        return ESP_FAIL;
+    }
+    return mcpwm_sync_configure(info->unit, info->timer, &sync_config);
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+/**
+ * @brief PWM outputs driven by MCPWM
+ */
+typedef enum
+{
+    ACTUATOR_COOLING_PUMP = 0,
+    ACTUATOR_WATERING_PUMP,
+    ACTUATOR_COOLING_VENTILATOR,
+    ACTUATOR_DEHUMYFING_VENTILATOR,
+    ACTUATOR_PELTIER,
+    ACTUATORS_NUM
+} actuator_t;
+
+#define ACTUATOR_BIT(actuator) (1u << (actuator))
+
+/**
+ * @brief Set of output levels applied together
+ */
+typedef struct
+{
+    uint32_t mask;                  /*!< ACTUATOR_BIT of the actuators in the batch */
+    float level[ACTUATORS_NUM];     /*!< output level in %, 0 - 100 */
+} actuators_batch_t;
+
+/**
+ * @brief Configures MCPWM timers of all actuators with zero output, synchronizes
+ *        timers of the same frequency within a unit and arms flood cut-off of the pumps.
+ *        Must be called after flood_protection_init.
+ *
+ * @return ESP_OK on success, otherwise return ESP_FAIL
+ */
+esp_err_t actuators_init(void);
+
+/**
+ * @brief Adds an actuator to the batch
+ *
+ * @param batch the batch
+ * @param actuator the actuator
+ * @param level output level in %
+ */
+void actuators_batch_set(actuators_batch_t* const batch, actuator_t actuator, float level);
+
+/**
+ * @brief Applies all levels of the batch under one lock. New duties of actuators on the
+ *        same MCPWM unit take effect on the same PWM period. The whole batch is refused
+ *        if a level is out of range, starts an inhibited actuator or the flood self test runs.
+ *
+ * @param batch the batch
+ * @return ESP_OK on success, otherwise return ESP_FAIL
+ */
+esp_err_t actuators_apply(const actuators_batch_t* const batch);
+
+/**
+ * @brief Applies level of a single actuator
+ *
+ * @param actuator the actuator
+ * @param level output level in %
+ * @return ESP_OK on success, otherwise return ESP_FAIL
+ */
+esp_err_t actuators_set(actuator_t actuator, float level);
+
+/**
+ * @brief Gets output level of the actuator
+ *
+ * @param actuator the actuator
+ * @return output level in %
+ */
+float actuators_get_level(actuator_t actuator);
+
+/**
+ * @brief Gets actuators which must not be started now
+ *
+ * @return ACTUATOR_BIT of the inhibited actuators
+ */
+uint32_t actuators_get_inhibited(void);
+
+/**
+ * @brief Runs the flood cut-off self test with the cooling pump at full duty for about 40 ms.
+ *        Batches of other callers are refused during the test, the level of the pump is
+ *        restored afterwards unless a real flood latched.
+ *
+ * @return ESP_OK on success, ESP_FAIL if a flood is latched, a test runs or the pump did not turn off
+ */
+esp_err_t actuators_flood_test(void);
+
+/**
+ * @brief Gets name of the actuator
+ *
+ * @param actuator the actuator
+ * @return name
+ */
+const char* actuators_get_name(actuator_t actuator);
@@ -0,0 +1,342 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "sdkconfig.h"
+#include "cooling_control.h"
+#include "actuators.h"
+#include "../system/data_store.h"
+#include "../system/scheduler.h"
+
+#define PERIOD_MS CONFIG_DONICZKA_COOLING_PERIOD_MS
+#define ROOT_DIVIDER CONFIG_DONICZKA_COOLING_ROOT_DIVIDER
+
+#define ROOT_SETPOINT_MIN_C 5.0f
+#define ROOT_SETPOINT_MAX_C 40.0f
+#define HOT_SETPOINT_MIN_C 20.0f
+#define HOT_SETPOINT_MAX_C 80.0f
+#define COLD_SETPOINT_MIN_C 2.0f
+#define COLD_SETPOINT_MAX_C 35.0f
+
+/* Peltier is stopped when the hot side gets this far above its setpoint */
+#define HOT_TRIP_MARGIN_C 15.0f
+/* Heat pumped by a running Peltier has to be carried away even with a cool hot side */
+#define MIN_FLOW_WITH_PELTIER 30.0f
+/* Probes are read every second by default, a few missed reads are tolerated */
+#define PROBE_MAX_AGE_US 10000000
+
+_Static_assert(CONFIG_DONICZKA_COOLING_PROBE_ROOT < DATA_STORE_PROBES_NUM &&
+               CONFIG_DONICZKA_COOLING_PROBE_COLD < DATA_STORE_PROBES_NUM &&
+               CONFIG_DONICZKA_COOLING_PROBE_HOT < DATA_STORE_PROBES_NUM, "Every loop has a probe in the data store");
+
+/* Starting points for a 40 mm stack with a water block, root loop output is the cold side setpoint in Celsius */
+static const pid_config_t default_tuning[COOLING_LOOPS_NUM] = {
+    [COOLING_LOOP_ROOT] = {
+        .kp = 2.0f, .ki = 0.005f, .kd = 0.0f,
+        .out_min = COLD_SETPOINT_MIN_C, .out_max = COLD_SETPOINT_MAX_C, .slew_rate = 0.05f, .direct_acting = false},
+    [COOLING_LOOP_COLD] = {
+        .kp = 8.0f, .ki = 0.1f, .kd = 0.0f,
+        .out_min = 0.0f, .out_max = 100.0f, .slew_rate = 2.0f, .direct_acting = true},
+    [COOLING_LOOP_HOT] = {
+        .kp = 6.0f, .ki = 0.1f, .kd = 0.0f,
+        .out_min = 0.0f, .out_max = 100.0f, .slew_rate = 10.0f, .direct_acting = true},
+};
+
+static const char *loop_names[COOLING_LOOPS_NUM] = {"root", "cold", "hot"};
+
+static const uint8_t loop_probes[COOLING_LOOPS_NUM] = {
+    CONFIG_DONICZKA_COOLING_PROBE_ROOT, CONFIG_DONICZKA_COOLING_PROBE_COLD, CONFIG_DONICZKA_COOLING_PROBE_HOT};
+
+/* Settings and statistics shared with the console, guarded by the spinlock */
+static portMUX_TYPE cooling_mux = portMUX_INITIALIZER_UNLOCKED;
+static cooling_control_status_t status;
+static uint32_t tuning_changed = 0u;
+
+/* Controllers and timing are touched only by the job */
+static pid_controller_t controllers[COOLING_LOOPS_NUM];
+static int64_t last_run_us[COOLING_LOOPS_NUM];
+static uint32_t cycle = 0u;
+static bool apply_failed = false;
+
+static const char *TAG = "cooling_control";
+
+/**
+ * @brief Periodic job of the loops, called by the scheduler
+ */
+static void cooling_control_process(void);
+
+/**
+ * @brief Reads temperature of a probe from the data store
+ *
+ * @param probe index of the probe
+ * @param temperature destination of the temperature in Celsius
+ * @return true if the value is of the last read and recent
+ */
+static bool cooling_control_read_probe(uint8_t probe, float* const temperature);
+
+/**
+ * @brief Runs one loop and records its state and timing
+ *
+ * @param loop the loop
+ * @param setpoint setpoint of the loop
+ * @param measurement measured value
+ * @param valid measurement is usable
+ * @param closed true to compute a new output, false to hold the fallback
+ * @param fallback output held while the loop is open
+ * @return output of the loop
+ */
+static float cooling_control_run_loop(cooling_loop_t loop, float setpoint, float measurement, bool valid,
+                                      bool closed, float fallback);
+
+esp_err_t cooling_control_init(void)
+{
+    for (uint8_t i = 0u; i < COOLING_LOOPS_NUM; i++)
+    {
+        pid_init(&controllers[i], &default_tuning[i], default_tuning[i].out_min);
+        status.loops[i].tuning = default_tuning[i];
+        status.loops[i].period_ms = (COOLING_LOOP_ROOT == i) ? PERIOD_MS * ROOT_DIVIDER : PERIOD_MS;
+        status.probe[i] = loop_probes[i];
+    }
+    status.root_setpoint = (float)CONFIG_DONICZKA_COOLING_ROOT_SETPOINT_C;
+    status.hot_setpoint = (float)CONFIG_DONICZKA_COOLING_HOT_SETPOINT_C;
+#if CONFIG_DONICZKA_COOLING_AUTO
+    status.auto_mode = true;
+#endif
+
+    return scheduler_add_job("cooling_control", &cooling_control_process, PERIOD_MS, SCHEDULER_EXEC_INLINE, NULL);
+}
+
+void cooling_control_set_auto(bool auto_mode)
+{
+    taskENTER_CRITICAL(&cooling_mux);
+    status.auto_mode = auto_mode;
+    taskEXIT_CRITICAL(&cooling_mux);
+    ESP_LOGI(TAG, "%s control", auto_mode ? "Closed loop" : "Manual");
+}
+
+bool cooling_control_is_auto(void)
+{
+    bool auto_mode;
+
+    taskENTER_CRITICAL(&cooling_mux);
+    auto_mode = status.auto_mode;
+    taskEXIT_CRITICAL(&cooling_mux);
+
+    return auto_mode;
+}
+
+esp_err_t cooling_control_set_setpoints(float root_setpoint, float hot_setpoint)
+{
+    if (ROOT_SETPOINT_MIN_C > root_setpoint || ROOT_SETPOINT_MAX_C < root_setpoint ||
+        HOT_SETPOINT_MIN_C > hot_setpoint || HOT_SETPOINT_MAX_C < hot_setpoint)
+    {
+        return ESP_FAIL;
+    }
+
+    taskENTER_CRITICAL(&cooling_mux);
+    status.root_setpoint = root_setpoint;
+    status.hot_setpoint = hot_setpoint;
+    taskEXIT_CRITICAL(&cooling_mux);
+
+    return ESP_OK;
+}
+
+esp_err_t cooling_control_set_tuning(cooling_loop_t loop, const pid_config_t* const tuning)
+{
+    if (COOLING_LOOPS_NUM <= loop || 0.0f > tuning->kp || 0.0f > tuning->ki || 0.0f > tuning->kd ||
+        0.0f > tuning->slew_rate || tuning->out_min >= tuning->out_max)
+    {
+        return ESP_FAIL;
+    }
+    /* Range of the outputs is given by the actuators and the cold side limits */
+    if (tuning->out_min < default_tuning[loop].out_min || tuning->out_max > default_tuning[loop].out_max ||
+        tuning->direct_acting != default_tuning[loop].direct_acting)
+    {
+        return ESP_FAIL;
+    }
+
+    taskENTER_CRITICAL(&cooling_mux);
+    status.loops[loop].tuning = *tuning;
+    tuning_changed |= (1u << loop);
+    taskEXIT_CRITICAL(&cooling_mux);
+
+    return ESP_OK;
+}
+
+void cooling_control_get_status(cooling_control_status_t* const copy)
+{
+    taskENTER_CRITICAL(&cooling_mux);
+    *copy = status;
+    taskEXIT_CRITICAL(&cooling_mux);
+}
+
+void cooling_control_reset_stats(void)
+{
+    taskENTER_CRITICAL(&cooling_mux);
+    status.faults = 0u;
+    for (uint8_t i = 0u; i < COOLING_LOOPS_NUM; i++)
+    {
+        status.loops[i].runs = 0u;
+        status.loops[i].max_us = 0u;
+        status.loops[i].max_jitter_us = 0u;
+    }
+    taskEXIT_CRITICAL(&cooling_mux);
+}
+
+const char* cooling_control_get_loop_name(cooling_loop_t loop)
+{
+    return (COOLING_LOOPS_NUM > loop) ? loop_names[loop] : "unknown";
+}
+
+static void cooling_control_process(void)
+{
+    actuators_batch_t batch = {0};
+    pid_config_t tuning[COOLING_LOOPS_NUM];
+    float measurement[COOLING_LOOPS_NUM];
+    bool valid[COOLING_LOOPS_NUM];
+    uint32_t changed;
+    bool auto_mode;
+    bool root_closed;
+    bool cold_closed;
+    bool hot_ok;
+    float root_setpoint;
+    float hot_setpoint;
+    float peltier;
+    float flow;
+
+    taskENTER_CRITICAL(&cooling_mux);
+    auto_mode = status.auto_mode;
+    root_setpoint = status.root_setpoint;
+    hot_setpoint = status.hot_setpoint;
+    changed = tuning_changed;
+    tuning_changed = 0u;
+    for (uint8_t i = 0u; i < COOLING_LOOPS_NUM; i++)
+    {
+        tuning[i] = status.loops[i].tuning;
+    }
+    taskEXIT_CRITICAL(&cooling_mux);
+
+    for (uint8_t i = 0u; i < COOLING_LOOPS_NUM; i++)
+    {
+        if (0u != (changed & (1u << i)))
+        {
+            pid_set_config(&controllers[i], &tuning[i]);
+        }
+        valid[i] = cooling_control_read_probe(loop_probes[i], &measurement[i]);
+    }
+
+    hot_ok = valid[COOLING_LOOP_HOT] && (hot_setpoint + HOT_TRIP_MARGIN_C) > measurement[COOLING_LOOP_HOT];
+    root_closed = auto_mode && valid[COOLING_LOOP_ROOT] && valid[COOLING_LOOP_COLD];
+    cold_closed = root_closed && hot_ok;
+
+    /* Open loops follow what drives the outputs now, closing them later does not step the outputs */
+    if (0u == cycle % ROOT_DIVIDER)
+    {
+        cooling_control_run_loop(COOLING_LOOP_ROOT, root_setpoint, measurement[COOLING_LOOP_ROOT],
+                                 valid[COOLING_LOOP_ROOT], root_closed,
+                                 valid[COOLING_LOOP_COLD] ? measurement[COOLING_LOOP_COLD] : controllers[COOLING_LOOP_ROOT].output);
+    }
+    cycle++;
+    peltier = cooling_control_run_loop(COOLING_LOOP_COLD, controllers[COOLING_LOOP_ROOT].output,
+                                       measurement[COOLING_LOOP_COLD], valid[COOLING_LOOP_COLD], cold_closed,
+                                       auto_mode ? 0.0f : actuators_get_level(ACTUATOR_PELTIER));
+    flow = cooling_control_run_loop(COOLING_LOOP_HOT, hot_setpoint, measurement[COOLING_LOOP_HOT],
+                                    valid[COOLING_LOOP_HOT], auto_mode && valid[COOLING_LOOP_HOT],
+                                    auto_mode ? 100.0f : actuators_get_level(ACTUATOR_COOLING_VENTILATOR));
+
+    if (!auto_mode)
+    {
+        return;
+    }
+    if (!cold_closed)
+    {
+        taskENTER_CRITICAL(&cooling_mux);
+        status.faults++;
+        taskEXIT_CRITICAL(&cooling_mux);
+    }
+
+    if (0.0f < peltier)
+    {
+        flow = fmaxf(flow, MIN_FLOW_WITH_PELTIER);
+    }
+    actuators_batch_set(&batch, ACTUATOR_PELTIER, peltier);
+    actuators_batch_set(&batch, ACTUATOR_COOLING_VENTILATOR, flow);
+    actuators_batch_set(&batch, ACTUATOR_COOLING_PUMP,
+                        (0u != (actuators_get_inhibited() & ACTUATOR_BIT(ACTUATOR_COOLING_PUMP))) ? 0.0f : flow);
+    if (ESP_OK != actuators_apply(&batch))
+    {
+        if (!apply_failed)
+        {
+            ESP_LOGE(TAG, "Could not apply outputs of the loops");
+        }
+        apply_failed = true;
+        return;
+    }
+    apply_failed = false;
+}
+
+static bool cooling_control_read_probe(uint8_t probe, float* const temperature)
+{
+    data_store_sample_t sample;
+
+    if (ESP_OK != data_store_get(DATA_STORE_PROBE_TEMPERATURE_0 + probe, &sample) ||
+        DATA_STORE_QUALITY_GOOD != sample.quality || PROBE_MAX_AGE_US < esp_timer_get_time() - sample.timestamp_us)
+    {
+        *temperature = 0.0f;
+        return false;
+    }
+    *temperature = sample.value.f;
+    return true;
+}
+
+static float cooling_control_run_loop(cooling_loop_t loop, float setpoint, float measurement, bool valid,
+                                      bool closed, float fallback)
+{
+    pid_controller_t *pid = &controllers[loop];
+    cooling_loop_status_t *loop_status = &status.loops[loop];
+    int64_t start = esp_timer_get_time();
+    uint32_t period_ms = (COOLING_LOOP_ROOT == loop) ? PERIOD_MS * ROOT_DIVIDER : PERIOD_MS;
+    uint32_t jitter = 0u;
+    uint32_t elapsed;
+
+    /* Loops run at a fixed rate, the nominal period is the time step and lateness shows as jitter */
+    if (closed)
+    {
+        pid_update(pid, setpoint, measurement, (float)period_ms / 1000.0f);
+    }
+    else
+    {
+        pid_hold(pid, fallback);
+    }
+    elapsed = (uint32_t)(esp_timer_get_time() - start);
+    if (0 != last_run_us[loop])
+    {
+        jitter = (uint32_t)llabs(start - last_run_us[loop] - (int64_t)period_ms * 1000);
+    }
+    last_run_us[loop] = start;
+
+    taskENTER_CRITICAL(&cooling_mux);
+    loop_status->setpoint = setpoint;
+    loop_status->measurement = measurement;
+    loop_status->output = pid->output;
+    loop_status->integral = pid->integral;
+    loop_status->valid = valid;
+    loop_status->limited = closed && pid->limited;
+    loop_status->runs++;
+    loop_status->last_us = elapsed;
+    if (elapsed > loop_status->max_us)
+    {
+        loop_status->max_us = elapsed;
+    }
+    loop_status->last_jitter_us = jitter;
+    if (jitter > loop_status->max_jitter_us)
+    {
+        loop_status->max_jitter_us = jitter;
+    }
+    taskEXIT_CRITICAL(&cooling_mux);
+
+    return pid->output;
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "pid.h"
+
+/**
+ * @brief Loops of the cooling stack. Root zone loop sets the cold side setpoint, cold side
+ *        loop drives the Peltier, hot side loop drives the pump and the ventilator.
+ */
+typedef enum
+{
+    COOLING_LOOP_ROOT = 0,
+    COOLING_LOOP_COLD,
+    COOLING_LOOP_HOT,
+    COOLING_LOOPS_NUM
+} cooling_loop_t;
+
+/**
+ * @brief State and timing of a loop
+ */
+typedef struct
+{
+    pid_config_t tuning;
+    float setpoint;
+    float measurement;
+    float output;
+    float integral;
+    bool valid;                 /*!< measurement was usable in the last run */
+    bool limited;               /*!< output was cut by the range or the slew limit in the last run */
+    uint32_t period_ms;
+    uint32_t runs;
+    uint32_t last_us;           /*!< execution time of the last run */
+    uint32_t max_us;
+    uint32_t last_jitter_us;    /*!< deviation of the last interval between runs from the period */
+    uint32_t max_jitter_us;
+} cooling_loop_status_t;
+
+/**
+ * @brief State of the cooling control
+ */
+typedef struct
+{
+    bool auto_mode;
+    float root_setpoint;        /*!< root zone temperature in Celsius */
+    float hot_setpoint;         /*!< hot side temperature in Celsius */
+    uint8_t probe[COOLING_LOOPS_NUM];   /*!< index of the 1-Wire probe of each loop */
+    uint32_t faults;            /*!< runs with the Peltier stopped because a probe failed or the hot side overheated */
+    cooling_loop_status_t loops[COOLING_LOOPS_NUM];
+} cooling_control_status_t;
+
+/**
+ * @brief Adds the job of the cooling loops to the scheduler, starts in manual mode unless
+ *        configured otherwise. Must be called after actuators_init.
+ *
+ * @return ESP_OK on success, otherwise return ESP_FAIL
+ */
+esp_err_t cooling_control_init(void);
+
+/**
+ * @brief Switches between manual and closed loop control. In manual mode the loops follow
+ *        the outputs set from the console, so the switch does not step the outputs.
+ *
+ * @param auto_mode true for closed loop control
+ */
+void cooling_control_set_auto(bool auto_mode);
+
+/**
+ * @brief Tells if the loops drive the Peltier, the pump and the ventilator
+ *
+ * @return true in closed loop control
+ */
+bool cooling_control_is_auto(void);
+
+/**
+ * @brief Sets the root zone and hot side setpoints
+ *
+ * @param root_setpoint root zone temperature in Celsius
+ * @param hot_setpoint hot side temperature in Celsius
+ * @return ESP_OK on success, ESP_FAIL if the values are out of range
+ */
+esp_err_t cooling_control_set_setpoints(float root_setpoint, float hot_setpoint);
+
+/**
+ * @brief Changes tuning of a loop, taken over by the next run without a step of the output
+ *
+ * @param loop the loop
+ * @param tuning gains and limits
+ * @return ESP_OK on success, ESP_FAIL if the loop or the limits are invalid
+ */
+esp_err_t cooling_control_set_tuning(cooling_loop_t loop, const pid_config_t* const tuning);
+
+/**
+ * @brief Copies the current state
+ *
+ * @param status destination of the state
+ */
+void cooling_control_get_status(cooling_control_status_t* const status);
+
+/**
+ * @brief Clears timing statistics and the fault counter
+ */
+void cooling_control_reset_stats(void);
+
+/**
+ * @brief Gets name of the loop
+ *
+ * @param loop the loop
+ * @return name
+ */
+const char* cooling_control_get_loop_name(cooling_loop_t loop);
@@ -1,61 +1,42 @@
-
 #include <stdio.h>
-#include "freertos/FreeRTOS.h"
-#include "freertos/task.h"
-#include "driver/gpio.h"
-#include "esp_log.h"
-#include "sdkconfig.h"
-#include "driver/mcpwm.h"
+#include "esp_err.h"
 #include "cooling_pump_control.h"
-#include "../mcu/pinout.h"
+#include "actuators.h"
+#include "flood_protection.h"
+#include "../system/scheduler.h"
 
-#define COOLING_PUMP_PWM_OUTPUT_PIN ESP_PIN_COOL_PUMP
-#define COOLING_PUMP_PWM_FREQ_HZ 10000u
 #define COOLING_PROCESS_DELAY_MS 100u
 
-static float cooling_pump_speed;
+/**
+ * @brief Periodic job of the pump, called by the scheduler
+ */
+static void cooling_pump_control_process(void);
+
+esp_err_t cooling_pump_control_init(void)
+{
+    return scheduler_add_job("cooling_pump", &cooling_pump_control_process, COOLING_PROCESS_DELAY_MS, SCHEDULER_EXEC_INLINE, NULL);
+}
 
-void cooling_pump_control_task(void *pvParameter)
+static void cooling_pump_control_process(void)
 {
-    mcpwm_gpio_init(MCPWM_UNIT_0, MCPWM0A, COOLING_PUMP_PWM_OUTPUT_PIN);
-    mcpwm_config_t pwm_config = {
-        .frequency = COOLING_PUMP_PWM_FREQ_HZ,
-        .cmpr_a = 0,
-        .cmpr_b = 0,
-        .counter_mode = MCPWM_UP_COUNTER,
-        .duty_mode = MCPWM_DUTY_MODE_0,
-    };
-    mcpwm_init(MCPWM_UNIT_0, MCPWM_TIMER_0, &pwm_config);
-    mcpwm_set_duty(MCPWM_UNIT_0, MCPWM_TIMER_0, MCPWM_OPR_A, 0.0f);
-    while (1)
+    /* Output is already forced low by hardware, keep the pump stopped after the fault is cleared */
+    if(flood_protection_is_latched() && 0.0f != cooling_pump_get_speed())
     {
-        vTaskDelay(COOLING_PROCESS_DELAY_MS / portTICK_RATE_MS);
+        cooling_pump_stop();
     }
 }
 
 esp_err_t cooling_pump_set_speed(float speed)
 {
-    esp_err_t ret_val = ESP_FAIL;
-
-    if(0.0f <= speed)
-    {
-        if(100.0f >= speed)
-        {
-            mcpwm_set_duty(MCPWM_UNIT_0, MCPWM_TIMER_0, MCPWM_OPR_A, speed);
-            cooling_pump_speed = speed;
-            ret_val = ESP_OK;
-        }
-    }
-    return ret_val;
+    return actuators_set(ACTUATOR_COOLING_PUMP, speed);
 }
 
 void cooling_pump_stop (void)
 {
-    mcpwm_set_duty(MCPWM_UNIT_0, MCPWM_TIMER_0, MCPWM_OPR_A, 0.0f);
-    cooling_pump_speed = 0.0f;
+    actuators_set(ACTUATOR_COOLING_PUMP, 0.0f);
 }
 
 float cooling_pump_get_speed (void)
 {
-    return cooling_pump_speed;
-}
\ No newline at end of file
+    return actuators_get_level(ACTUATOR_COOLING_PUMP);
+}
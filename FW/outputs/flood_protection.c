@@ -0,0 +1,269 @@
+#include <stdio.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_attr.h"
+#include "esp_cpu.h"
+#include "esp_rom_sys.h"
+#include "hal/gpio_ll.h"
+#include "soc/gpio_struct.h"
+#include "soc/io_mux_reg.h"
+#include "soc/gpio_periph.h"
+#include "flood_protection.h"
+#include "../mcu/pinout.h"
+
+/* Sensor pulls the input to ground when wet */
+#define FLOOD_ACTIVE_LEVEL 0
+#define FLOOD_FAULT_TRIGGER MCPWM_LOW_LEVEL_TGR
+#define FLOOD_MCPWM_UNIT MCPWM_UNIT_0
+#define MAX_PUMP_OUTPUTS 2u
+/* Bound of waiting for outputs in the interrupt, the hardware cut-off is done long before */
+#define CONFIRM_MAX_CYCLES 24000u
+/* Longest PWM period of the pumps, the output is high for sure after it at full duty */
+#define TEST_SETTLE_MS 20u
+
+typedef struct
+{
+    mcpwm_timer_t timer;
+    gpio_num_t pin;
+} flood_output_t;
+
+static gpio_num_t flood_pin = GPIO_NUM_NC;
+static flood_output_t outputs[MAX_PUMP_OUTPUTS];
+static volatile uint8_t outputs_count = 0u;
+
+static portMUX_TYPE flood_mux = portMUX_INITIALIZER_UNLOCKED;
+static volatile bool latched = false;
+static volatile bool testing = false;
+static flood_protection_status_t stats;
+
+static const char *TAG = "flood_protection";
+
+/**
+ * @brief Edge interrupt of the flood sensor. Outputs are already forced low by the MCPWM
+ *        fault, the interrupt latches the fault and measures when the outputs read low.
+ *
+ * @param arg not used
+ */
+static void IRAM_ATTR flood_protection_isr(void *arg);
+
+/**
+ * @brief Waits until all attached outputs read low
+ *
+ * @param start cycle count at which waiting started
+ * @return cycles since start until outputs read low, CONFIRM_MAX_CYCLES if they did not
+ */
+static uint32_t IRAM_ATTR flood_protection_wait_outputs_off(uint32_t start);
+
+esp_err_t flood_protection_init(void)
+{
+#if CONFIG_DONICZKA_SHARED_PIN_FLOOD
+    flood_pin = ESP_PIN_FLOOD_SENS;
+#endif
+    if (GPIO_NUM_NC == flood_pin)
+    {
+        ESP_LOGW(TAG, "No flood sensor, the pin is the I2C clock of the pressure sensor");
+        return ESP_OK;
+    }
+
+    gpio_config_t io_conf = {
+        .pin_bit_mask = BIT64(flood_pin),
+        .mode = GPIO_MODE_INPUT,
+        .pull_up_en = GPIO_PULLUP_ENABLE,
+        .pull_down_en = GPIO_PULLDOWN_DISABLE,
+        .intr_type = GPIO_INTR_NEGEDGE,
+    };
+    esp_err_t ret = gpio_config(&io_conf);
+
+    /* The pad feeds both the GPIO interrupt and the MCPWM fault input through the matrix */
+    if (ESP_OK == ret)
+    {
+        ret = mcpwm_gpio_init(FLOOD_MCPWM_UNIT, MCPWM_FAULT_0, flood_pin);
+    }
+    if (ESP_OK == ret)
+    {
+        ret = mcpwm_fault_init(FLOOD_MCPWM_UNIT, FLOOD_FAULT_TRIGGER, MCPWM_SELECT_F0);
+    }
+    if (ESP_OK == ret)
+    {
+        ret = gpio_install_isr_service(ESP_INTR_FLAG_IRAM);
+        ret = (ESP_ERR_INVALID_STATE == ret) ? ESP_OK : ret;
+    }
+    if (ESP_OK == ret)
+    {
+        ret = gpio_isr_handler_add(flood_pin, flood_protection_isr, NULL);
+    }
+    if (ESP_OK != ret)
+    {
+        ESP_LOGE(TAG, "Flood sensor initialization failed");
+        return ESP_FAIL;
+    }
+
+    if (FLOOD_ACTIVE_LEVEL == gpio_get_level(flood_pin))
+    {
+        latched = true;
+        stats.event_count++;
+        stats.last_event_us = esp_timer_get_time();
+        ESP_LOGE(TAG, "Flood detected at startup");
+    }
+    return ESP_OK;
+}
+
+esp_err_t flood_protection_attach(mcpwm_timer_t timer, gpio_num_t pin)
+{
+    if (GPIO_NUM_NC == flood_pin)
+    {
+        return ESP_OK;
+    }
+    if (MAX_PUMP_OUTPUTS <= outputs_count)
+    {
+        return ESP_FAIL;
+    }
+
+    /* Output pad is read back, enabling its input does not change the MCPWM routing */
+    PIN_INPUT_ENABLE(GPIO_PIN_MUX_REG[pin]);
+
+    taskENTER_CRITICAL(&flood_mux);
+    outputs[outputs_count].timer = timer;
+    outputs[outputs_count].pin = pin;
+    outputs_count++;
+    taskEXIT_CRITICAL(&flood_mux);
+
+    /* One-shot mode keeps the outputs low after the sensor dries until the fault is cleared */
+    return mcpwm_fault_set_oneshot_mode(FLOOD_MCPWM_UNIT, timer, MCPWM_SELECT_F0,
+                                        MCPWM_FORCE_MCPWMXA_LOW, MCPWM_FORCE_MCPWMXB_LOW);
+}
+
+bool flood_protection_is_latched(void)
+{
+    return latched;
+}
+
+esp_err_t flood_protection_clear(void)
+{
+    if (GPIO_NUM_NC == flood_pin)
+    {
+        return ESP_OK;
+    }
+    if (FLOOD_ACTIVE_LEVEL == gpio_get_level(flood_pin))
+    {
+        return ESP_FAIL;
+    }
+
+    /* Setting one-shot mode again clears the hardware trip */
+    for (uint8_t i = 0u; i < outputs_count; i++)
+    {
+        mcpwm_fault_set_oneshot_mode(FLOOD_MCPWM_UNIT, outputs[i].timer, MCPWM_SELECT_F0,
+                                     MCPWM_FORCE_MCPWMXA_LOW, MCPWM_FORCE_MCPWMXB_LOW);
+    }
+    latched = false;
+    ESP_LOGI(TAG, "Flood fault cleared");
+    return ESP_OK;
+}
+
+esp_err_t flood_protection_test(gpio_num_t pin)
+{
+    uint32_t cycles;
+
+    if (latched || 0u == outputs_count)
+    {
+        return ESP_FAIL;
+    }
+
+    /* Duty set by the caller is taken over at the next timer zero */
+    vTaskDelay(pdMS_TO_TICKS(TEST_SETTLE_MS));
+    if (0 == gpio_get_level(pin))
+    {
+        ESP_LOGE(TAG, "Self test output is not running");
+        return ESP_FAIL;
+    }
+    testing = true;
+
+    /* Driving the pad low through its open drain output is seen by the fault input like a wet sensor */
+    taskENTER_CRITICAL(&flood_mux);
+    gpio_set_level(flood_pin, FLOOD_ACTIVE_LEVEL);
+    uint32_t start = esp_cpu_get_ccount();
+    gpio_set_direction(flood_pin, GPIO_MODE_INPUT_OUTPUT_OD);
+    cycles = flood_protection_wait_outputs_off(start);
+    taskEXIT_CRITICAL(&flood_mux);
+
+    gpio_set_direction(flood_pin, GPIO_MODE_INPUT);
+    /* Let the pull-up charge the sensor line before the trip is cleared */
+    vTaskDelay(pdMS_TO_TICKS(TEST_SETTLE_MS));
+    testing = false;
+
+    uint32_t latency_ns = cycles * 1000u / esp_rom_get_cpu_ticks_per_us();
+    taskENTER_CRITICAL(&flood_mux);
+    stats.test_latency_ns = latency_ns;
+    if (latency_ns > stats.test_latency_max_ns)
+    {
+        stats.test_latency_max_ns = latency_ns;
+    }
+    taskEXIT_CRITICAL(&flood_mux);
+
+    if (ESP_OK != flood_protection_clear())
+    {
+        /* Real flood during the test, the hardware trip stays and the fault is latched */
+        latched = true;
+        ESP_LOGE(TAG, "Flood detected during self test");
+        return ESP_FAIL;
+    }
+    if (CONFIRM_MAX_CYCLES <= cycles)
+    {
+        ESP_LOGE(TAG, "Self test failed, pump outputs did not turn off");
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+void flood_protection_get_status(flood_protection_status_t* const status)
+{
+    taskENTER_CRITICAL(&flood_mux);
+    *status = stats;
+    taskEXIT_CRITICAL(&flood_mux);
+    status->latched = latched;
+    status->sensor_active = (GPIO_NUM_NC != flood_pin) && (FLOOD_ACTIVE_LEVEL == gpio_get_level(flood_pin));
+}
+
+static void IRAM_ATTR flood_protection_isr(void *arg)
+{
+    uint32_t start = esp_cpu_get_ccount();
+
+    /* Self test measures the latency itself and must not latch the fault */
+    if (latched || testing || FLOOD_ACTIVE_LEVEL != gpio_ll_get_level(&GPIO, flood_pin))
+    {
+        return;
+    }
+
+    uint32_t cycles = flood_protection_wait_outputs_off(start);
+    uint32_t confirm_ns = cycles * 1000u / esp_rom_get_cpu_ticks_per_us();
+
+    latched = true;
+    portENTER_CRITICAL_ISR(&flood_mux);
+    stats.event_count++;
+    stats.last_event_us = esp_timer_get_time();
+    stats.isr_confirm_ns = confirm_ns;
+    if (confirm_ns > stats.isr_confirm_max_ns)
+    {
+        stats.isr_confirm_max_ns = confirm_ns;
+    }
+    portEXIT_CRITICAL_ISR(&flood_mux);
+}
+
+static uint32_t IRAM_ATTR flood_protection_wait_outputs_off(uint32_t start)
+{
+    uint32_t cycles = 0u;
+    bool any_high = true;
+
+    while (any_high && CONFIRM_MAX_CYCLES > cycles)
+    {
+        any_high = false;
+        for (uint8_t i = 0u; i < outputs_count; i++)
+        {
+            any_high |= (0 != gpio_ll_get_level(&GPIO, outputs[i].pin));
+        }
+        cycles = esp_cpu_get_ccount() - start;
+    }
+    return any_high ? CONFIRM_MAX_CYCLES : cycles;
+}
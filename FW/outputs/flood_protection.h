@@ -0,0 +1,72 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "driver/gpio.h"
+#include "driver/mcpwm.h"
+
+/**
+ * @brief Flood detection statistics
+ */
+typedef struct
+{
+    bool latched;               /*!< true from flood detection until the fault is cleared */
+    bool sensor_active;         /*!< current level of the flood sensor */
+    uint32_t event_count;       /*!< number of detected floods */
+    int64_t last_event_us;      /*!< time of the last detection (esp_timer_get_time), 0 if none */
+    uint32_t isr_confirm_ns;    /*!< last time from interrupt entry until pump outputs read low */
+    uint32_t isr_confirm_max_ns;/*!< worst time from interrupt entry until pump outputs read low */
+    uint32_t test_latency_ns;   /*!< last detect-to-off latency measured by the self test */
+    uint32_t test_latency_max_ns;/*!< worst detect-to-off latency measured by the self test */
+} flood_protection_status_t;
+
+/**
+ * @brief Routes the flood sensor to fault input F0 of MCPWM unit 0 and to an edge interrupt.
+ *        Must be called before the pump tasks start. Does nothing if the pin of the sensor
+ *        is the I2C clock of the pressure sensor, see CONFIG_DONICZKA_SHARED_PIN.
+ *
+ * @return ESP_OK on success, otherwise return ESP_FAIL
+ */
+esp_err_t flood_protection_init(void);
+
+/**
+ * @brief Arms one-shot fault of an MCPWM unit 0 timer, its outputs are forced low by hardware
+ *        on flood. Called by pump tasks after the timer is initialized.
+ *
+ * @param timer timer of the pump output
+ * @param pin pump output pin, read back to confirm the output is off
+ * @return ESP_OK on success, otherwise return ESP_FAIL
+ */
+esp_err_t flood_protection_attach(mcpwm_timer_t timer, gpio_num_t pin);
+
+/**
+ * @brief Checks whether the flood fault is latched, pumps refuse to start while it is
+ *
+ * @return true if latched
+ */
+bool flood_protection_is_latched(void);
+
+/**
+ * @brief Clears the latched fault and re-arms the hardware cut-off
+ *
+ * @return ESP_OK on success, ESP_FAIL if the sensor still detects water
+ */
+esp_err_t flood_protection_clear(void);
+
+/**
+ * @brief Measures detect-to-off latency by driving the sensor input to its active level.
+ *        The caller runs one attached output at full duty and keeps other writers of the
+ *        outputs off during the test, see actuators_flood_test. The fault is cleared afterwards.
+ *
+ * @param pin the attached output run at full duty
+ * @return ESP_OK on success, ESP_FAIL if a flood is latched or the outputs did not turn off
+ */
+esp_err_t flood_protection_test(gpio_num_t pin);
+
+/**
+ * @brief Copies flood detection statistics
+ *
+ * @param status destination of the statistics
+ */
+void flood_protection_get_status(flood_protection_status_t* const status);
@@ -0,0 +1,492 @@
+#include <stdio.h>
+#include <math.h>
+#include <time.h>
+#include <sys/time.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "sdkconfig.h"
+#include "driver/ledc.h"
+#include "grow_light_control.h"
+#include "../inputs/light_sensor.h"
+#include "../mcu/pinout.h"
+#include "../mcu/peripherals.h"
+#include "../system/scheduler.h"
+#include "../system/data_store.h"
+#include "../system/power.h"
+
+#define GROW_LIGHT_OUTPUT_PIN ESP_PIN_LIGHT
+#define GROW_LIGHT_LEDC_MODE LEDC_LOW_SPEED_MODE
+#define GROW_LIGHT_LEDC_TIMER ESP_LEDC_TIMER_LIGHT
+#define GROW_LIGHT_LEDC_CHANNEL ESP_LEDC_CH_LIGHT
+#define GROW_LIGHT_PWM_FREQ_HZ 5000u
+#define GROW_LIGHT_DUTY_RESOLUTION LEDC_TIMER_13_BIT
+#define GROW_LIGHT_MAX_DUTY ((1u << GROW_LIGHT_DUTY_RESOLUTION) - 1u)
+/* Fade hardware changes the duty by at most this many steps at once and waits at most this many PWM cycles per step */
+#define GROW_LIGHT_FADE_MAX_SCALE 1023u
+#define GROW_LIGHT_FADE_MAX_CYCLES 1023u
+/* Sunrise and sunset are chained from short fades, one fade cannot be slower than a duty step per 1023 cycles */
+#define GROW_LIGHT_RAMP_SEGMENT_MS 10000u
+
+/* Light integral is accumulated every run, the top-up level is recomputed less often */
+#define GROW_LIGHT_PROCESS_DELAY_MS 1000u
+#define GROW_LIGHT_CONTROL_PERIOD_US 60000000
+/* Top-up fades end before the next control period, a new fade would wait for the running one */
+#define GROW_LIGHT_TOPUP_FADE_MS 50000u
+#define GROW_LIGHT_MIN_LEVEL_CHANGE 1.0f
+
+/* Clock counts from the epoch until it is set, any later date means it was set */
+#define GROW_LIGHT_CLOCK_SET_YEAR (2020 - 1900)
+
+#define DEFAULT_START_MIN (6u * 60u)
+#define DEFAULT_DURATION_MIN (16u * 60u)
+#define DEFAULT_RAMP_MIN 30u
+#define DEFAULT_TARGET_DLI 17.0f
+#define DEFAULT_LAMP_PPFD 300.0f
+#define MAX_DLI 60.0f
+#define MAX_LAMP_PPFD 2500.0f
+
+static portMUX_TYPE grow_light_mux = portMUX_INITIALIZER_UNLOCKED;
+static grow_light_config_t config = {
+    .start_min = DEFAULT_START_MIN,
+    .duration_min = DEFAULT_DURATION_MIN,
+    .ramp_min = DEFAULT_RAMP_MIN,
+    .target_dli = DEFAULT_TARGET_DLI,
+    .lamp_ppfd = DEFAULT_LAMP_PPFD,
+};
+static grow_light_status_t status;
+static scheduler_job_id_t grow_light_job;
+static bool grow_light_job_added = false;
+static volatile bool config_changed = false;
+
+/* State of the control, owned by the job */
+static grow_light_phase_t phase = GROW_LIGHT_NIGHT;
+static int64_t last_tick;
+static int64_t last_control = 0;
+static int64_t fade_end = 0;
+static float target_level = 0.0f;
+/* Ramp towards target_level, its fades are started by the job one segment at a time */
+static float ramp_from = 0.0f;
+static int64_t ramp_start = 0;
+static int64_t ramp_end = 0;
+static int64_t segment_end = 0;
+static float dli = 0.0f;
+static uint32_t last_elapsed_s = 0u;
+
+/* LEDC timer runs from APB, held while the light is on or fading */
+static esp_pm_lock_handle_t pm_lock = NULL;
+static bool pm_held = false;
+
+static const char *TAG = "grow_light";
+
+/**
+ * @brief Configures LEDC timer, channel and fade service
+ */
+static void grow_light_output_init(void);
+
+/**
+ * @brief Integrates measured light and requests fades of the output, the job of the light
+ */
+static void grow_light_control_process(void);
+
+/**
+ * @brief Runs the job as soon as possible after a change of settings
+ */
+static void grow_light_notify_change(void);
+
+/**
+ * @brief Starts a hardware fade of the output, the call returns immediately. A fade slower
+ *        than the hardware can go ends early, the returned end is the real one.
+ * @param level target level in %
+ * @param fade_ms requested duration of the fade
+ * @return time when the fade ends (esp_timer_get_time)
+ */
+static int64_t grow_light_fade(float level, uint32_t fade_ms);
+
+/**
+ * @brief Starts a linear ramp of any length, it is run as a chain of short fades
+ * @param level target level in %
+ * @param ramp_ms duration of the ramp
+ * @param now current time (esp_timer_get_time)
+ */
+static void grow_light_ramp(float level, uint32_t ramp_ms, int64_t now);
+
+/**
+ * @brief Starts the next fade of a running ramp once the last one and its segment ended
+ * @param now current time (esp_timer_get_time)
+ */
+static void grow_light_ramp_step(int64_t now);
+
+/**
+ * @brief Level of the lamp which reaches the target integral by the end of the photoperiod,
+ *        assuming current natural light stays
+ * @param cfg settings
+ * @param dli integral so far in mol/m2
+ * @param natural_ppfd natural light in umol/m2/s
+ * @param remaining_s time to the end of the photoperiod
+ * @return level in %
+ */
+static float grow_light_topup_level(const grow_light_config_t* const cfg, float dli, float natural_ppfd, uint32_t remaining_s);
+
+esp_err_t grow_light_control_init(void)
+{
+    esp_err_t ret;
+
+    ESP_ERROR_CHECK(power_lock_create(ESP_PM_APB_FREQ_MAX, "grow_light", &pm_lock));
+    grow_light_output_init();
+    last_tick = esp_timer_get_time();
+
+    ret = scheduler_add_job("grow_light", &grow_light_control_process, GROW_LIGHT_PROCESS_DELAY_MS, SCHEDULER_EXEC_INLINE, &grow_light_job);
+    grow_light_job_added = (ESP_OK == ret);
+    return ret;
+}
+
+static void grow_light_control_process(void)
+{
+    grow_light_config_t cfg;
+    struct tm tm_now;
+    time_t now_s = time(NULL);
+    int64_t now = esp_timer_get_time();
+    float ppfd = 0.0f;
+
+    taskENTER_CRITICAL(&grow_light_mux);
+    cfg = config;
+    taskEXIT_CRITICAL(&grow_light_mux);
+    localtime_r(&now_s, &tm_now);
+
+    /* Seconds since start of the photoperiod, wrapped over midnight */
+    uint32_t day_s = (uint32_t)(tm_now.tm_hour * 3600 + tm_now.tm_min * 60 + tm_now.tm_sec);
+    uint32_t elapsed_s = (day_s + GROW_LIGHT_MINUTES_PER_DAY * 60u - cfg.start_min * 60u) % (GROW_LIGHT_MINUTES_PER_DAY * 60u);
+    uint32_t duration_s = cfg.duration_min * 60u;
+    uint32_t ramp_s = cfg.ramp_min * 60u;
+    grow_light_phase_t new_phase;
+
+    if (elapsed_s >= duration_s)
+    {
+        new_phase = GROW_LIGHT_NIGHT;
+    }
+    else if (elapsed_s < ramp_s)
+    {
+        new_phase = GROW_LIGHT_SUNRISE;
+    }
+    else if (duration_s - elapsed_s <= ramp_s)
+    {
+        new_phase = GROW_LIGHT_SUNSET;
+    }
+    else
+    {
+        new_phase = GROW_LIGHT_DAY;
+    }
+
+    if ((GROW_LIGHT_NIGHT == phase && GROW_LIGHT_NIGHT != new_phase) || elapsed_s < last_elapsed_s)
+    {
+        /* New photoperiod, the integral counts light of this day only */
+        dli = 0.0f;
+    }
+
+    float level = grow_light_get_level();
+    if (ESP_OK == light_sensor_get_ppfd(&ppfd) && GROW_LIGHT_NIGHT != new_phase)
+    {
+        dli += ppfd * (float)(now - last_tick) * 1.0e-12f;
+    }
+    last_tick = now;
+    last_elapsed_s = elapsed_s;
+    float natural_ppfd = ppfd - cfg.lamp_ppfd * level * 0.01f;
+    if (0.0f > natural_ppfd)
+    {
+        natural_ppfd = 0.0f;
+    }
+
+    /* A fade is never interrupted, the next one is requested after the running one ends */
+    grow_light_ramp_step(now);
+    if (now >= fade_end)
+    {
+        uint32_t remaining_s = duration_s - elapsed_s;
+
+        /* Settings changed during a fade are applied once it ends */
+        bool changed = __atomic_exchange_n(&config_changed, false, __ATOMIC_RELAXED);
+
+        if (GROW_LIGHT_NIGHT == new_phase)
+        {
+            if (0.0f != target_level)
+            {
+                target_level = 0.0f;
+                ramp_end = 0;
+                fade_end = grow_light_fade(target_level, 0u);
+            }
+        }
+        else if (GROW_LIGHT_SUNSET == new_phase)
+        {
+            if ((GROW_LIGHT_SUNSET != phase || changed) && 0.0f != target_level)
+            {
+                /* One ramp covers the whole rest of the sunset */
+                grow_light_ramp(0.0f, remaining_s * 1000u, now);
+            }
+        }
+        else if (GROW_LIGHT_SUNRISE == new_phase)
+        {
+            if (GROW_LIGHT_SUNRISE != phase || changed)
+            {
+                /* One ramp covers the whole rest of the sunrise */
+                grow_light_ramp(grow_light_topup_level(&cfg, dli, natural_ppfd, remaining_s), (ramp_s - elapsed_s) * 1000u, now);
+                last_control = now;
+            }
+        }
+        else if (GROW_LIGHT_DAY != phase || changed || GROW_LIGHT_CONTROL_PERIOD_US <= (now - last_control))
+        {
+            float topup = grow_light_topup_level(&cfg, dli, natural_ppfd, remaining_s);
+
+            if (GROW_LIGHT_MIN_LEVEL_CHANGE <= fabsf(topup - target_level))
+            {
+                target_level = topup;
+                ramp_end = 0;
+                fade_end = grow_light_fade(target_level, GROW_LIGHT_TOPUP_FADE_MS);
+            }
+            last_control = now;
+        }
+    }
+    phase = new_phase;
+
+    if (pm_held && 0.0f == target_level && now >= fade_end && now >= ramp_end)
+    {
+        power_lock_release(pm_lock);
+        pm_held = false;
+    }
+
+    taskENTER_CRITICAL(&grow_light_mux);
+    status.phase = phase;
+    status.level = level;
+    status.target_level = target_level;
+    status.ppfd = ppfd;
+    status.natural_ppfd = natural_ppfd;
+    status.dli = dli;
+    status.clock_set = (GROW_LIGHT_CLOCK_SET_YEAR <= tm_now.tm_year);
+    taskEXIT_CRITICAL(&grow_light_mux);
+
+    data_store_publish_float(DATA_STORE_GROW_LIGHT, level);
+}
+
+esp_err_t grow_light_set_photoperiod(uint16_t start_min, uint16_t duration_min, uint16_t ramp_min)
+{
+    if (GROW_LIGHT_MINUTES_PER_DAY <= start_min || GROW_LIGHT_MINUTES_PER_DAY < duration_min ||
+        duration_min < 2u * ramp_min)
+    {
+        return ESP_FAIL;
+    }
+
+    taskENTER_CRITICAL(&grow_light_mux);
+    config.start_min = start_min;
+    config.duration_min = duration_min;
+    config.ramp_min = ramp_min;
+    taskEXIT_CRITICAL(&grow_light_mux);
+
+    grow_light_notify_change();
+    return ESP_OK;
+}
+
+esp_err_t grow_light_set_target_dli(float target_dli, float lamp_ppfd)
+{
+    if (0.0f > target_dli || MAX_DLI < target_dli || 0.0f >= lamp_ppfd || MAX_LAMP_PPFD < lamp_ppfd)
+    {
+        return ESP_FAIL;
+    }
+
+    taskENTER_CRITICAL(&grow_light_mux);
+    config.target_dli = target_dli;
+    config.lamp_ppfd = lamp_ppfd;
+    taskEXIT_CRITICAL(&grow_light_mux);
+
+    grow_light_notify_change();
+    return ESP_OK;
+}
+
+esp_err_t grow_light_set_clock(uint16_t minute_of_day)
+{
+    struct tm tm_now;
+    time_t now_s = time(NULL);
+
+    if (GROW_LIGHT_MINUTES_PER_DAY <= minute_of_day)
+    {
+        return ESP_FAIL;
+    }
+
+    localtime_r(&now_s, &tm_now);
+    if (GROW_LIGHT_CLOCK_SET_YEAR > tm_now.tm_year)
+    {
+        /* Only time of day is used, keep the date recognizable as set */
+        tm_now.tm_year = GROW_LIGHT_CLOCK_SET_YEAR;
+        tm_now.tm_mon = 0;
+        tm_now.tm_mday = 1;
+    }
+    tm_now.tm_hour = minute_of_day / 60u;
+    tm_now.tm_min = minute_of_day % 60u;
+    tm_now.tm_sec = 0;
+
+    struct timeval tv = {.tv_sec = mktime(&tm_now), .tv_usec = 0};
+    if (0 != settimeofday(&tv, NULL))
+    {
+        return ESP_FAIL;
+    }
+
+    grow_light_notify_change();
+    return ESP_OK;
+}
+
+void grow_light_get_config(grow_light_config_t* const config_out)
+{
+    taskENTER_CRITICAL(&grow_light_mux);
+    *config_out = config;
+    taskEXIT_CRITICAL(&grow_light_mux);
+}
+
+void grow_light_get_status(grow_light_status_t* const status_out)
+{
+    taskENTER_CRITICAL(&grow_light_mux);
+    *status_out = status;
+    taskEXIT_CRITICAL(&grow_light_mux);
+}
+
+float grow_light_get_level(void)
+{
+    /* Duty register follows the fade, no need to track it in software */
+    return (float)ledc_get_duty(GROW_LIGHT_LEDC_MODE, GROW_LIGHT_LEDC_CHANNEL) * 100.0f / (float)GROW_LIGHT_MAX_DUTY;
+}
+
+static void grow_light_notify_change(void)
+{
+    config_changed = true;
+    if (grow_light_job_added)
+    {
+        scheduler_trigger(grow_light_job);
+    }
+}
+
+static void grow_light_output_init(void)
+{
+    ledc_timer_config_t timer_config = {
+        .speed_mode = GROW_LIGHT_LEDC_MODE,
+        .duty_resolution = GROW_LIGHT_DUTY_RESOLUTION,
+        .timer_num = GROW_LIGHT_LEDC_TIMER,
+        .freq_hz = GROW_LIGHT_PWM_FREQ_HZ,
+        .clk_cfg = LEDC_AUTO_CLK,
+    };
+    ledc_channel_config_t channel_config = {
+        .gpio_num = GROW_LIGHT_OUTPUT_PIN,
+        .speed_mode = GROW_LIGHT_LEDC_MODE,
+        .channel = GROW_LIGHT_LEDC_CHANNEL,
+        .intr_type = LEDC_INTR_DISABLE,
+        .timer_sel = GROW_LIGHT_LEDC_TIMER,
+        .duty = 0u,
+        .hpoint = 0,
+    };
+
+    ESP_ERROR_CHECK(ledc_timer_config(&timer_config));
+    ESP_ERROR_CHECK(ledc_channel_config(&channel_config));
+    ESP_ERROR_CHECK(ledc_fade_func_install(0));
+}
+
+static int64_t grow_light_fade(float level, uint32_t fade_ms)
+{
+    uint32_t duty = (uint32_t)(level * 0.01f * (float)GROW_LIGHT_MAX_DUTY);
+    uint32_t current = ledc_get_duty(GROW_LIGHT_LEDC_MODE, GROW_LIGHT_LEDC_CHANNEL);
+    uint32_t delta = (duty > current) ? (duty - current) : (current - duty);
+    uint64_t cycles = (uint64_t)fade_ms * GROW_LIGHT_PWM_FREQ_HZ / 1000u;
+    uint32_t scale = 1u;
+    uint32_t cycle_num = 1u;
+    uint32_t steps;
+
+    if (!pm_held && (0.0f != level || 0u != fade_ms))
+    {
+        power_lock_acquire(pm_lock);
+        pm_held = true;
+    }
+    if (0u == fade_ms || 0u == delta || 0u == cycles)
+    {
+        ledc_set_duty(GROW_LIGHT_LEDC_MODE, GROW_LIGHT_LEDC_CHANNEL, duty);
+        ledc_update_duty(GROW_LIGHT_LEDC_MODE, GROW_LIGHT_LEDC_CHANNEL);
+        return esp_timer_get_time();
+    }
+
+    /* Step size and cycles per step are computed here, the time based API overflows above 859 s at 5 kHz */
+    if (cycles >= delta)
+    {
+        cycle_num = (uint32_t)(cycles / delta);
+        cycle_num = (GROW_LIGHT_FADE_MAX_CYCLES < cycle_num) ? GROW_LIGHT_FADE_MAX_CYCLES : cycle_num;
+    }
+    else
+    {
+        scale = (uint32_t)(delta / cycles);
+        scale = (GROW_LIGHT_FADE_MAX_SCALE < scale) ? GROW_LIGHT_FADE_MAX_SCALE : scale;
+    }
+    steps = (delta + scale - 1u) / scale;
+
+    if (ESP_OK != ledc_set_fade_with_step(GROW_LIGHT_LEDC_MODE, GROW_LIGHT_LEDC_CHANNEL, duty, scale, cycle_num) ||
+        ESP_OK != ledc_fade_start(GROW_LIGHT_LEDC_MODE, GROW_LIGHT_LEDC_CHANNEL, LEDC_FADE_NO_WAIT))
+    {
+        ESP_LOGE(TAG, "Could not start fade to %0.1f%%", level);
+        return esp_timer_get_time();
+    }
+    return esp_timer_get_time() + (int64_t)steps * cycle_num * 1000000 / GROW_LIGHT_PWM_FREQ_HZ;
+}
+
+static void grow_light_ramp(float level, uint32_t ramp_ms, int64_t now)
+{
+    ramp_from = grow_light_get_level();
+    target_level = level;
+    if (0u == ramp_ms)
+    {
+        ramp_end = 0;
+        fade_end = grow_light_fade(level, 0u);
+        return;
+    }
+    ramp_start = now;
+    ramp_end = now + (int64_t)ramp_ms * 1000;
+    segment_end = now;
+    grow_light_ramp_step(now);
+}
+
+static void grow_light_ramp_step(int64_t now)
+{
+    int64_t end;
+    float level;
+
+    if (now < fade_end || now < segment_end || segment_end >= ramp_end)
+    {
+        return;
+    }
+
+    /* Level at the end of the segment lies on the line of the whole ramp, an early fade end only holds it a while */
+    end = now + (int64_t)GROW_LIGHT_RAMP_SEGMENT_MS * 1000;
+    if (end > ramp_end)
+    {
+        end = ramp_end;
+    }
+    level = ramp_from + (target_level - ramp_from) * (float)(end - ramp_start) / (float)(ramp_end - ramp_start);
+    fade_end = grow_light_fade(level, (uint32_t)((end - now) / 1000));
+    segment_end = end;
+}
+
+static float grow_light_topup_level(const grow_light_config_t* const cfg, float dli, float natural_ppfd, uint32_t remaining_s)
+{
+    float missing = cfg->target_dli - dli;
+
+    if (0.0f >= missing || 0u == remaining_s)
+    {
+        return 0.0f;
+    }
+
+    /* Mean PPFD which delivers the missing integral in the rest of the photoperiod */
+    float required_ppfd = missing * 1.0e6f / (float)remaining_s;
+    float level = (required_ppfd - natural_ppfd) * 100.0f / cfg->lamp_ppfd;
+
+    if (0.0f > level)
+    {
+        level = 0.0f;
+    }
+    else if (100.0f < level)
+    {
+        level = 100.0f;
+    }
+    return level;
+}
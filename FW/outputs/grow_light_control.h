@@ -0,0 +1,94 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+#define GROW_LIGHT_MINUTES_PER_DAY 1440u
+
+/**
+ * @brief Part of the photoperiod the light is in
+ */
+typedef enum
+{
+    GROW_LIGHT_NIGHT = 0,
+    GROW_LIGHT_SUNRISE,
+    GROW_LIGHT_DAY,
+    GROW_LIGHT_SUNSET,
+} grow_light_phase_t;
+
+/**
+ * @brief Photoperiod and light integral settings
+ */
+typedef struct
+{
+    uint16_t start_min;         /*!< start of the photoperiod, minutes after midnight */
+    uint16_t duration_min;      /*!< length of the photoperiod including ramps */
+    uint16_t ramp_min;          /*!< length of sunrise and sunset ramps */
+    float target_dli;           /*!< daily light integral to reach in mol/m2/day */
+    float lamp_ppfd;            /*!< PPFD of the lamp alone at full power in umol/m2/s */
+} grow_light_config_t;
+
+/**
+ * @brief Current state of the light
+ */
+typedef struct
+{
+    grow_light_phase_t phase;
+    float level;                /*!< current output level in %, follows the hardware fade */
+    float target_level;         /*!< level of the last requested fade in % */
+    float ppfd;                 /*!< measured PPFD in umol/m2/s */
+    float natural_ppfd;         /*!< measured PPFD without the estimated lamp share */
+    float dli;                  /*!< light integral since start of the photoperiod in mol/m2 */
+    bool clock_set;             /*!< false if time of day was not set since boot */
+} grow_light_status_t;
+
+/**
+ * @brief Configures the output and adds the job of the light to the scheduler. The job
+ *        integrates measured light and tops it up to the target light integral with
+ *        hardware fades of the LEDC
+ * @return ESP_OK on success, otherwise return ESP_FAIL
+ */
+esp_err_t grow_light_control_init(void);
+
+/**
+ * @brief Sets the photoperiod
+ * @param start_min start, minutes after midnight
+ * @param duration_min length including ramps, 0 keeps the light off
+ * @param ramp_min length of sunrise and sunset, at most half of the photoperiod
+ * @return ESP_OK on success, ESP_FAIL if the values are out of range
+ */
+esp_err_t grow_light_set_photoperiod(uint16_t start_min, uint16_t duration_min, uint16_t ramp_min);
+
+/**
+ * @brief Sets the daily light integral target
+ * @param target_dli daily light integral in mol/m2/day
+ * @param lamp_ppfd PPFD of the lamp alone at full power in umol/m2/s
+ * @return ESP_OK on success, ESP_FAIL if the values are out of range
+ */
+esp_err_t grow_light_set_target_dli(float target_dli, float lamp_ppfd);
+
+/**
+ * @brief Sets time of day used by the photoperiod
+ * @param minute_of_day minutes after midnight
+ * @return ESP_OK on success, ESP_FAIL if the value is out of range
+ */
+esp_err_t grow_light_set_clock(uint16_t minute_of_day);
+
+/**
+ * @brief Copies the settings
+ * @param config destination of the settings
+ */
+void grow_light_get_config(grow_light_config_t* const config);
+
+/**
+ * @brief Copies the current state
+ * @param status destination of the state
+ */
+void grow_light_get_status(grow_light_status_t* const status);
+
+/**
+ * @brief Returns current output level
+ * @return level in %
+ */
+float grow_light_get_level(void);
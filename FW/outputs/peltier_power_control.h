@@ -1,10 +1,6 @@
 #pragma once
 
-/** 
- * @brief Peltier power control task
- * @param pvParamater parameter of task (not used)
-*/
-void peltier_power_control_task(void *pvParameter);
+#include "esp_err.h"
 
 /** 
  * @brief Sets PWM duty cycle on peltier output pin
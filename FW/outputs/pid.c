@@ -0,0 +1,96 @@
+#include <math.h>
+#include "pid.h"
+
+/**
+ * @brief Limits the value to the range
+ *
+ * @param value the value
+ * @param low lower bound
+ * @param high upper bound
+ * @return limited value
+ */
+static float pid_clamp(float value, float low, float high);
+
+void pid_init(pid_controller_t* const pid, const pid_config_t* const config, float output)
+{
+    pid_set_config(pid, config);
+    pid->integral = 0.0f;
+    pid->last_measurement = 0.0f;
+    pid->limited = false;
+    pid_hold(pid, output);
+}
+
+void pid_set_config(pid_controller_t* const pid, const pid_config_t* const config)
+{
+    pid->config = *config;
+
+    if (pid->config.out_min > pid->config.out_max)
+    {
+        pid->config.out_max = pid->config.out_min;
+    }
+    if (0.0f > pid->config.slew_rate)
+    {
+        pid->config.slew_rate = 0.0f;
+    }
+}
+
+void pid_hold(pid_controller_t* const pid, float output)
+{
+    pid->output = pid_clamp(output, pid->config.out_min, pid->config.out_max);
+    pid->tracking = true;
+}
+
+float pid_update(pid_controller_t* const pid, float setpoint, float measurement, float dt_s)
+{
+    const pid_config_t *config = &pid->config;
+    float error = config->direct_acting ? (measurement - setpoint) : (setpoint - measurement);
+    float slope = 0.0f;
+    float low = config->out_min;
+    float high = config->out_max;
+    float proportional;
+    float derivative;
+    float integral;
+    float output;
+
+    if (0.0f >= dt_s)
+    {
+        return pid->output;
+    }
+    if (!pid->tracking)
+    {
+        slope = (measurement - pid->last_measurement) / dt_s;
+    }
+    proportional = config->kp * error;
+    derivative = config->kd * (config->direct_acting ? slope : -slope);
+
+    /* Integral takes what is left of the held output, the loop closes without a step */
+    if (pid->tracking)
+    {
+        pid->integral = pid->output - proportional;
+        pid->tracking = false;
+    }
+    if (0.0f < config->slew_rate)
+    {
+        low = fmaxf(low, pid->output - config->slew_rate * dt_s);
+        high = fminf(high, pid->output + config->slew_rate * dt_s);
+    }
+
+    integral = pid->integral + config->ki * error * dt_s;
+    output = proportional + integral + derivative;
+    if ((output > high && 0.0f < error) || (output < low && 0.0f > error))
+    {
+        integral = pid->integral;
+        output = proportional + integral + derivative;
+    }
+
+    pid->limited = (output > high || output < low);
+    pid->integral = integral;
+    pid->last_measurement = measurement;
+    pid->output = pid_clamp(output, low, high);
+    return pid->output;
+}
+
+static float pid_clamp(float value, float low, float high)
+{
+    return fminf(fmaxf(value, low), high);
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @brief Tuning and limits of a PID controller
+ */
+typedef struct
+{
+    float kp;                   /*!< proportional gain, output units per measurement unit */
+    float ki;                   /*!< integral gain, output units per measurement unit and second */
+    float kd;                   /*!< derivative gain, output units per measurement unit per second */
+    float out_min;
+    float out_max;
+    float slew_rate;            /*!< largest change of the output per second, 0 disables */
+    bool direct_acting;         /*!< output rises with the measurement, as for cooling */
+} pid_config_t;
+
+/**
+ * @brief State of a PID controller, the integral is kept in output units so a change
+ *        of the gains does not move the output
+ */
+typedef struct
+{
+    pid_config_t config;
+    float integral;
+    float last_measurement;
+    float output;
+    bool tracking;              /*!< next update continues from the held output */
+    bool limited;               /*!< output was cut by the range or the slew limit in the last update */
+} pid_controller_t;
+
+/**
+ * @brief Sets configuration and holds the output, invalid limits are corrected
+ *
+ * @param pid controller state
+ * @param config tuning and limits
+ * @param output output the first update continues from
+ */
+void pid_init(pid_controller_t* const pid, const pid_config_t* const config, float output);
+
+/**
+ * @brief Changes tuning and limits, the integral is kept
+ *
+ * @param pid controller state
+ * @param config tuning and limits
+ */
+void pid_set_config(pid_controller_t* const pid, const pid_config_t* const config);
+
+/**
+ * @brief Sets the output while the loop is open, in manual mode or on a sensor fault.
+ *        The next update presets the integral from it, so closing the loop is bumpless.
+ *
+ * @param pid controller state
+ * @param output current output driven by someone else
+ */
+void pid_hold(pid_controller_t* const pid, float output);
+
+/**
+ * @brief Computes a new output. Derivative acts on the measurement, so setpoint steps do
+ *        not kick the output. Integration stops while the output is cut by the range or
+ *        the slew limit in the direction the error pushes it.
+ *
+ * @param pid controller state
+ * @param setpoint setpoint
+ * @param measurement measured value
+ * @param dt_s time since the last update in seconds
+ * @return new output
+ */
+float pid_update(pid_controller_t* const pid, float setpoint, float measurement, float dt_s);
@@ -1,24 +1,17 @@
 
 #include <stdio.h>
-#include "freertos/FreeRTOS.h"
-#include "freertos/task.h"
-#include "driver/gpio.h"
-#include "esp_log.h"
-#include "sdkconfig.h"
-#include "driver/mcpwm.h"
+#include "esp_err.h"
 #include "watering_pump_control.h"
-#include "freertos/projdefs.h"
-#include "../mcu/pinout.h"
+#include "actuators.h"
+#include "flood_protection.h"
+#include "../system/scheduler.h"
 
-#define WATERING_PUMP_PWM_OUTPUT_PIN ESP_PIN_WATER_PUMP
-#define WATERING_PUMP_PWM_FREQ_HZ 100u
 #define MAINTENANCE_PERIOD_MS (60u*60u*24u*1000u)
 #define WATERING_PUMP_PROCESS_PERIOD_MS 50u
 #define MAINTENANCE_PERIOD_CYCLES (MAINTENANCE_PERIOD_MS/WATERING_PUMP_PROCESS_PERIOD_MS)
 #define MAINTENANCE_RUN_TIME_MS 500u
 #define MAINTENANCE_RUN_TIME_CYCLES (MAINTENANCE_RUN_TIME_MS/WATERING_PUMP_PROCESS_PERIOD_MS)
 
-static float watering_pump_actual_speed;
 static float watering_pump_desired_speed;
 static bool is_maintenance_run_active = false;
 static uint32_t maintenance_run_timer = MAINTENANCE_RUN_TIME_CYCLES;
@@ -26,57 +19,48 @@ static uint32_t maintenance_run_timer = MAINTENANCE_RUN_TIME_CYCLES;
 static void watering_pump_maintenance_run(void);
 static void watering_pump_maintenance_process(void);
 
-void watering_pump_control_task(void *pvParameter)
-{
-    TickType_t xLastWakeTime;
-    const TickType_t xFrequency = pdMS_TO_TICKS(WATERING_PUMP_PROCESS_PERIOD_MS);
-
-    mcpwm_gpio_init(MCPWM_UNIT_0, MCPWM1A, WATERING_PUMP_PWM_OUTPUT_PIN);
-    mcpwm_config_t pwm_config = {
-        .frequency = WATERING_PUMP_PWM_FREQ_HZ,
-        .cmpr_a = 0.0f,
-        .cmpr_b = 0.0f,
-        .counter_mode = MCPWM_UP_COUNTER,
-        .duty_mode = MCPWM_DUTY_MODE_0,
-    };
-    mcpwm_init(MCPWM_UNIT_0, MCPWM_TIMER_1, &pwm_config);
-    mcpwm_set_duty(MCPWM_UNIT_0, MCPWM_TIMER_1, MCPWM_OPR_A, 0.0f);
-    
-    xLastWakeTime = xTaskGetTickCount ();
+/**
+ * @brief Periodic job of the pump, called by the scheduler
+ */
+static void watering_pump_control_process(void);
 
-    while (1)
-    {
-        xTaskDelayUntil( &xLastWakeTime, xFrequency );
-
-        watering_pump_maintenance_process();
-    }
+esp_err_t watering_pump_control_init(void)
+{
+    /* Maintenance counts in periods of the job, they have to stay exact */
+    return scheduler_add_job("watering_pump", &watering_pump_control_process, WATERING_PUMP_PROCESS_PERIOD_MS,
+                             SCHEDULER_EXEC_INLINE, NULL);
 }
 
-static esp_err_t watering_pump_set_speed(float speed)
+static void watering_pump_control_process(void)
 {
-    esp_err_t ret_val = ESP_FAIL;
-
-    if(0.0f <= speed)
+    /* Output is already forced low by hardware, keep the pump stopped after the fault is cleared */
+    if(flood_protection_is_latched())
     {
-        if(100.0f >= speed)
+        if(0.0f != watering_pump_get_speed())
         {
-            mcpwm_set_duty(MCPWM_UNIT_0, MCPWM_TIMER_1, MCPWM_OPR_A, speed);
-            watering_pump_actual_speed = speed;
-            ret_val = ESP_OK;
+            watering_pump_stop();
+            watering_pump_desired_speed = 0.0f;
+            is_maintenance_run_active = false;
         }
+        return;
     }
-    return ret_val;
+
+    watering_pump_maintenance_process();
+}
+
+static esp_err_t watering_pump_set_speed(float speed)
+{
+    return actuators_set(ACTUATOR_WATERING_PUMP, speed);
 }
 
 void watering_pump_stop (void)
 {
-    mcpwm_set_duty(MCPWM_UNIT_0, MCPWM_TIMER_1, MCPWM_OPR_A, 0.0f);
-    watering_pump_actual_speed = 0.0f;
+    actuators_set(ACTUATOR_WATERING_PUMP, 0.0f);
 }
 
 float watering_pump_get_speed (void)
 {
-    return watering_pump_actual_speed;
+    return actuators_get_level(ACTUATOR_WATERING_PUMP);
 }
 
 static void watering_pump_maintenance_process(void)
@@ -85,7 +69,7 @@ static void watering_pump_maintenance_process(void)
     
     if(0u != mainetnance_timer)
     {
-        if(0.0f == watering_pump_actual_speed)
+        if(0.0f == watering_pump_get_speed())
         {
             mainetnance_timer--;
         }  
@@ -124,6 +108,11 @@ static void watering_pump_maintenance_run(void)
 
 esp_err_t watering_pump_set_desired_speed(float speed)
 {
+    if(flood_protection_is_latched() && 0.0f != speed)
+    {
+        return ESP_FAIL;
+    }
+
     esp_err_t ret_val = watering_pump_set_speed(speed);
 
     if(0.0f != speed)
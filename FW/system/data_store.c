@@ -0,0 +1,277 @@
+#include <stdio.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+#include "data_store.h"
+
+_Static_assert(DATA_STORE_SIGNALS_NUM <= 32u, "Notification value has one bit per signal");
+
+typedef struct
+{
+    const char *name;
+    const char *unit;
+    data_store_type_t type;
+} signal_info_t;
+
+typedef struct
+{
+    TaskHandle_t task;
+    uint32_t signals;
+} subscriber_t;
+
+static const signal_info_t signal_info[DATA_STORE_SIGNALS_NUM] = {
+    [DATA_STORE_AIR_TEMPERATURE]        = {"air_temperature",       "C",        DATA_STORE_TYPE_FLOAT},
+    [DATA_STORE_AIR_HUMIDITY]           = {"air_humidity",          "%RH",      DATA_STORE_TYPE_FLOAT},
+    [DATA_STORE_DEW_POINT]              = {"dew_point",             "C",        DATA_STORE_TYPE_FLOAT},
+    [DATA_STORE_VPD]                    = {"vpd",                   "kPa",      DATA_STORE_TYPE_FLOAT},
+    [DATA_STORE_PROBE_TEMPERATURE_0]    = {"probe_temperature_0",   "C",        DATA_STORE_TYPE_FLOAT},
+    [DATA_STORE_PROBE_TEMPERATURE_1]    = {"probe_temperature_1",   "C",        DATA_STORE_TYPE_FLOAT},
+    [DATA_STORE_PROBE_TEMPERATURE_2]    = {"probe_temperature_2",   "C",        DATA_STORE_TYPE_FLOAT},
+    [DATA_STORE_PROBE_TEMPERATURE_3]    = {"probe_temperature_3",   "C",        DATA_STORE_TYPE_FLOAT},
+    [DATA_STORE_PRESSURE]               = {"pressure",              "hPa",      DATA_STORE_TYPE_FLOAT},
+    [DATA_STORE_TANK_LEVEL]             = {"tank_level",            "ml",       DATA_STORE_TYPE_FLOAT},
+    [DATA_STORE_SOIL_MOISTURE]          = {"soil_moisture",         "%",        DATA_STORE_TYPE_FLOAT},
+    [DATA_STORE_PPFD]                   = {"ppfd",                  "umol/m2/s",DATA_STORE_TYPE_FLOAT},
+    [DATA_STORE_TANK_SWITCH_MIN]        = {"tank_switch_min",       "",         DATA_STORE_TYPE_BOOL},
+    [DATA_STORE_TANK_SWITCH_MAX]        = {"tank_switch_max",       "",         DATA_STORE_TYPE_BOOL},
+    [DATA_STORE_SUPPLY_POWER]           = {"supply_power",          "W",        DATA_STORE_TYPE_FLOAT},
+    [DATA_STORE_COOLING_PUMP]           = {"cooling_pump",          "%",        DATA_STORE_TYPE_FLOAT},
+    [DATA_STORE_WATERING_PUMP]          = {"watering_pump",         "%",        DATA_STORE_TYPE_FLOAT},
+    [DATA_STORE_COOLING_VENTILATOR]     = {"cooling_ventilator",    "%",        DATA_STORE_TYPE_FLOAT},
+    [DATA_STORE_DEHUMYFING_VENTILATOR]  = {"dehumyfing_ventilator", "%",        DATA_STORE_TYPE_FLOAT},
+    [DATA_STORE_PELTIER]                = {"peltier",               "%",        DATA_STORE_TYPE_FLOAT},
+    [DATA_STORE_GROW_LIGHT]             = {"grow_light",            "%",        DATA_STORE_TYPE_FLOAT},
+};
+
+static const char* const quality_names[] = {
+    [DATA_STORE_QUALITY_NONE] = "none",
+    [DATA_STORE_QUALITY_GOOD] = "good",
+    [DATA_STORE_QUALITY_STALE] = "stale",
+    [DATA_STORE_QUALITY_BAD] = "bad",
+};
+
+/* Slots and subscriptions, guarded by the spinlock, tasks are notified after it is released */
+static portMUX_TYPE data_store_mux = portMUX_INITIALIZER_UNLOCKED;
+static data_store_sample_t slots[DATA_STORE_SIGNALS_NUM];
+static subscriber_t subscribers[DATA_STORE_MAX_SUBSCRIBERS];
+
+/**
+ * @brief Writes the slot and notifies subscribers if its value or quality changed
+ *
+ * @param signal the signal
+ * @param sample new content of the slot
+ */
+static void data_store_write(data_store_signal_t signal, const data_store_sample_t* const sample);
+
+/**
+ * @brief Compares values of the type
+ *
+ * @return true if the values differ
+ */
+static bool data_store_value_changed(data_store_type_t type, const data_store_value_t* const a, const data_store_value_t* const b);
+
+esp_err_t data_store_publish_float(data_store_signal_t signal, float value)
+{
+    data_store_sample_t sample = {
+        .value.f = value,
+        .timestamp_us = esp_timer_get_time(),
+        .quality = DATA_STORE_QUALITY_GOOD,
+    };
+
+    if (DATA_STORE_SIGNALS_NUM <= signal || DATA_STORE_TYPE_FLOAT != signal_info[signal].type)
+    {
+        return ESP_FAIL;
+    }
+    data_store_write(signal, &sample);
+    return ESP_OK;
+}
+
+esp_err_t data_store_publish_bool(data_store_signal_t signal, bool value)
+{
+    data_store_sample_t sample = {
+        .value.b = value,
+        .timestamp_us = esp_timer_get_time(),
+        .quality = DATA_STORE_QUALITY_GOOD,
+    };
+
+    if (DATA_STORE_SIGNALS_NUM <= signal || DATA_STORE_TYPE_BOOL != signal_info[signal].type)
+    {
+        return ESP_FAIL;
+    }
+    data_store_write(signal, &sample);
+    return ESP_OK;
+}
+
+esp_err_t data_store_publish(data_store_signal_t signal, const data_store_sample_t* const sample)
+{
+    if (DATA_STORE_SIGNALS_NUM <= signal)
+    {
+        return ESP_FAIL;
+    }
+    data_store_write(signal, sample);
+    return ESP_OK;
+}
+
+esp_err_t data_store_set_quality(data_store_signal_t signal, data_store_quality_t quality)
+{
+    data_store_sample_t sample;
+
+    if (DATA_STORE_SIGNALS_NUM <= signal)
+    {
+        return ESP_FAIL;
+    }
+
+    taskENTER_CRITICAL(&data_store_mux);
+    sample = slots[signal];
+    taskEXIT_CRITICAL(&data_store_mux);
+
+    sample.quality = quality;
+    data_store_write(signal, &sample);
+    return ESP_OK;
+}
+
+esp_err_t data_store_get(data_store_signal_t signal, data_store_sample_t* const sample)
+{
+    if (DATA_STORE_SIGNALS_NUM <= signal)
+    {
+        return ESP_FAIL;
+    }
+
+    taskENTER_CRITICAL(&data_store_mux);
+    *sample = slots[signal];
+    taskEXIT_CRITICAL(&data_store_mux);
+
+    return ESP_OK;
+}
+
+esp_err_t data_store_get_float(data_store_signal_t signal, float* const value)
+{
+    data_store_sample_t sample;
+
+    if (ESP_OK != data_store_get(signal, &sample) || DATA_STORE_TYPE_FLOAT != signal_info[signal].type)
+    {
+        return ESP_FAIL;
+    }
+    *value = sample.value.f;
+
+    return (DATA_STORE_QUALITY_GOOD == sample.quality) ? ESP_OK : ESP_FAIL;
+}
+
+esp_err_t data_store_get_bool(data_store_signal_t signal, bool* const value)
+{
+    data_store_sample_t sample;
+
+    if (ESP_OK != data_store_get(signal, &sample) || DATA_STORE_TYPE_BOOL != signal_info[signal].type)
+    {
+        return ESP_FAIL;
+    }
+    *value = sample.value.b;
+
+    return (DATA_STORE_QUALITY_GOOD == sample.quality) ? ESP_OK : ESP_FAIL;
+}
+
+void data_store_get_snapshot(data_store_snapshot_t* const snapshot)
+{
+    taskENTER_CRITICAL(&data_store_mux);
+    memcpy(snapshot->samples, slots, sizeof(slots));
+    taskEXIT_CRITICAL(&data_store_mux);
+}
+
+esp_err_t data_store_subscribe(TaskHandle_t task, uint32_t signals)
+{
+    subscriber_t *slot = NULL;
+
+    taskENTER_CRITICAL(&data_store_mux);
+    for (uint8_t i = 0u; i < DATA_STORE_MAX_SUBSCRIBERS; i++)
+    {
+        if (task == subscribers[i].task)
+        {
+            slot = &subscribers[i];
+            break;
+        }
+        if (NULL == slot && NULL == subscribers[i].task)
+        {
+            slot = &subscribers[i];
+        }
+    }
+    if (NULL != slot)
+    {
+        slot->task = task;
+        slot->signals = signals;
+    }
+    taskEXIT_CRITICAL(&data_store_mux);
+
+    return (NULL != slot) ? ESP_OK : ESP_FAIL;
+}
+
+void data_store_unsubscribe(TaskHandle_t task)
+{
+    taskENTER_CRITICAL(&data_store_mux);
+    for (uint8_t i = 0u; i < DATA_STORE_MAX_SUBSCRIBERS; i++)
+    {
+        if (task == subscribers[i].task)
+        {
+            subscribers[i].task = NULL;
+            subscribers[i].signals = 0u;
+        }
+    }
+    taskEXIT_CRITICAL(&data_store_mux);
+}
+
+const char* data_store_get_name(data_store_signal_t signal)
+{
+    return (DATA_STORE_SIGNALS_NUM > signal) ? signal_info[signal].name : "unknown";
+}
+
+const char* data_store_get_unit(data_store_signal_t signal)
+{
+    return (DATA_STORE_SIGNALS_NUM > signal) ? signal_info[signal].unit : "";
+}
+
+data_store_type_t data_store_get_type(data_store_signal_t signal)
+{
+    return (DATA_STORE_SIGNALS_NUM > signal) ? signal_info[signal].type : DATA_STORE_TYPE_FLOAT;
+}
+
+const char* data_store_get_quality_name(data_store_quality_t quality)
+{
+    return (DATA_STORE_QUALITY_BAD >= quality) ? quality_names[quality] : "unknown";
+}
+
+static void data_store_write(data_store_signal_t signal, const data_store_sample_t* const sample)
+{
+    TaskHandle_t notify[DATA_STORE_MAX_SUBSCRIBERS];
+    uint8_t notify_num = 0u;
+    bool changed;
+
+    taskENTER_CRITICAL(&data_store_mux);
+    changed = (sample->quality != slots[signal].quality) ||
+              data_store_value_changed(signal_info[signal].type, &sample->value, &slots[signal].value);
+    slots[signal] = *sample;
+    if (changed)
+    {
+        for (uint8_t i = 0u; i < DATA_STORE_MAX_SUBSCRIBERS; i++)
+        {
+            if (NULL != subscribers[i].task && 0u != (subscribers[i].signals & DATA_STORE_BIT(signal)))
+            {
+                notify[notify_num++] = subscribers[i].task;
+            }
+        }
+    }
+    taskEXIT_CRITICAL(&data_store_mux);
+
+    for (uint8_t i = 0u; i < notify_num; i++)
+    {
+        xTaskNotify(notify[i], DATA_STORE_BIT(signal), eSetBits);
+    }
+}
+
+static bool data_store_value_changed(data_store_type_t type, const data_store_value_t* const a, const data_store_value_t* const b)
+{
+    if (DATA_STORE_TYPE_BOOL == type)
+    {
+        return a->b != b->b;
+    }
+    return a->f != b->f;
+}
@@ -0,0 +1,211 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_err.h"
+
+#define DATA_STORE_MAX_SUBSCRIBERS 8u
+#define DATA_STORE_PROBES_NUM 4u
+
+/**
+ * @brief Notification bit of the signal, subscribers receive bits of changed signals
+ */
+#define DATA_STORE_BIT(signal) (1u << (signal))
+
+/**
+ * @brief Signals kept by the store, one slot each
+ */
+typedef enum
+{
+    DATA_STORE_AIR_TEMPERATURE = 0,     /*!< Celsius, humidity sensor */
+    DATA_STORE_AIR_HUMIDITY,            /*!< %RH */
+    DATA_STORE_DEW_POINT,               /*!< Celsius */
+    DATA_STORE_VPD,                     /*!< kPa */
+    DATA_STORE_PROBE_TEMPERATURE_0,     /*!< Celsius, 1-Wire probes in order of the last scan */
+    DATA_STORE_PROBE_TEMPERATURE_1,
+    DATA_STORE_PROBE_TEMPERATURE_2,
+    DATA_STORE_PROBE_TEMPERATURE_3,
+    DATA_STORE_PRESSURE,                /*!< hPa */
+    DATA_STORE_TANK_LEVEL,              /*!< ml */
+    DATA_STORE_SOIL_MOISTURE,           /*!< % */
+    DATA_STORE_PPFD,                    /*!< umol/m2/s */
+    DATA_STORE_TANK_SWITCH_MIN,         /*!< true when the water level is past the switch */
+    DATA_STORE_TANK_SWITCH_MAX,
+    DATA_STORE_SUPPLY_POWER,            /*!< W */
+    DATA_STORE_COOLING_PUMP,            /*!< output level in % */
+    DATA_STORE_WATERING_PUMP,
+    DATA_STORE_COOLING_VENTILATOR,
+    DATA_STORE_DEHUMYFING_VENTILATOR,
+    DATA_STORE_PELTIER,
+    DATA_STORE_GROW_LIGHT,
+    DATA_STORE_SIGNALS_NUM
+} data_store_signal_t;
+
+/**
+ * @brief Type of the value of a signal
+ */
+typedef enum
+{
+    DATA_STORE_TYPE_FLOAT = 0,
+    DATA_STORE_TYPE_BOOL,
+} data_store_type_t;
+
+/**
+ * @brief Quality of the value
+ */
+typedef enum
+{
+    DATA_STORE_QUALITY_NONE = 0,        /*!< nothing published yet */
+    DATA_STORE_QUALITY_GOOD,            /*!< value of the last read */
+    DATA_STORE_QUALITY_STALE,           /*!< last read failed, value and timestamp are of an older read */
+    DATA_STORE_QUALITY_BAD,             /*!< source is missing or faulty, value is not usable */
+} data_store_quality_t;
+
+/**
+ * @brief Value of a signal, the member is given by the type of the signal
+ */
+typedef union
+{
+    float f;
+    bool b;
+} data_store_value_t;
+
+/**
+ * @brief Content of a slot
+ */
+typedef struct
+{
+    data_store_value_t value;
+    int64_t timestamp_us;               /*!< time the value was acquired (esp_timer_get_time), 0 if none */
+    data_store_quality_t quality;
+} data_store_sample_t;
+
+/**
+ * @brief Copy of all slots taken at once
+ */
+typedef struct
+{
+    data_store_sample_t samples[DATA_STORE_SIGNALS_NUM];
+} data_store_snapshot_t;
+
+/**
+ * @brief Publishes a float value acquired now with good quality
+ *
+ * @param signal the signal
+ * @param value the value
+ * @return ESP_OK on success, ESP_FAIL if the signal is not a float
+ */
+esp_err_t data_store_publish_float(data_store_signal_t signal, float value);
+
+/**
+ * @brief Publishes a bool value acquired now with good quality
+ *
+ * @param signal the signal
+ * @param value the value
+ * @return ESP_OK on success, ESP_FAIL if the signal is not a bool
+ */
+esp_err_t data_store_publish_bool(data_store_signal_t signal, bool value);
+
+/**
+ * @brief Publishes the whole slot, for producers which know when the value was acquired
+ *
+ * @param signal the signal
+ * @param sample content of the slot
+ * @return ESP_OK on success, otherwise return ESP_FAIL
+ */
+esp_err_t data_store_publish(data_store_signal_t signal, const data_store_sample_t* const sample);
+
+/**
+ * @brief Changes quality of the slot and keeps its value and timestamp
+ *
+ * @param signal the signal
+ * @param quality new quality
+ * @return ESP_OK on success, otherwise return ESP_FAIL
+ */
+esp_err_t data_store_set_quality(data_store_signal_t signal, data_store_quality_t quality);
+
+/**
+ * @brief Copies the slot
+ *
+ * @param signal the signal
+ * @param sample destination of the slot
+ * @return ESP_OK on success, otherwise return ESP_FAIL
+ */
+esp_err_t data_store_get(data_store_signal_t signal, data_store_sample_t* const sample);
+
+/**
+ * @brief Gets float value of the signal
+ *
+ * @param signal the signal
+ * @param value the value, last one published even if it is not good
+ * @return ESP_OK if the quality is good, otherwise return ESP_FAIL
+ */
+esp_err_t data_store_get_float(data_store_signal_t signal, float* const value);
+
+/**
+ * @brief Gets bool value of the signal
+ *
+ * @param signal the signal
+ * @param value the value, last one published even if it is not good
+ * @return ESP_OK if the quality is good, otherwise return ESP_FAIL
+ */
+esp_err_t data_store_get_bool(data_store_signal_t signal, bool* const value);
+
+/**
+ * @brief Copies all slots at once
+ *
+ * @param snapshot destination of the slots
+ */
+void data_store_get_snapshot(data_store_snapshot_t* const snapshot);
+
+/**
+ * @brief Subscribes the task to changes of the signals. The task is notified with
+ *        DATA_STORE_BIT of every signal whose value or quality changed, the bits are
+ *        set in its notification value. Subscribing again replaces the signals.
+ *
+ * @param task the task
+ * @param signals DATA_STORE_BIT of the signals
+ * @return ESP_OK on success, ESP_FAIL if there is no free subscription
+ */
+esp_err_t data_store_subscribe(TaskHandle_t task, uint32_t signals);
+
+/**
+ * @brief Removes subscription of the task
+ *
+ * @param task the task
+ */
+void data_store_unsubscribe(TaskHandle_t task);
+
+/**
+ * @brief Gets name of the signal
+ *
+ * @param signal the signal
+ * @return name
+ */
+const char* data_store_get_name(data_store_signal_t signal);
+
+/**
+ * @brief Gets unit of the signal
+ *
+ * @param signal the signal
+ * @return unit, empty for bool signals
+ */
+const char* data_store_get_unit(data_store_signal_t signal);
+
+/**
+ * @brief Gets type of the signal
+ *
+ * @param signal the signal
+ * @return type
+ */
+data_store_type_t data_store_get_type(data_store_signal_t signal);
+
+/**
+ * @brief Gets name of the quality
+ *
+ * @param quality the quality
+ * @return name
+ */
+const char* data_store_get_quality_name(data_store_quality_t quality);
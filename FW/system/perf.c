@@ -0,0 +1,134 @@
+#include <stdio.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "perf.h"
+
+typedef struct
+{
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint32_t dropped;
+    uint32_t buckets[PERF_BUCKETS_NUM];
+} histogram_t;
+
+static const char* const probe_names[PERF_PROBES_NUM] = {
+    [PERF_PROBE_DHT_READ] = "dht_read",
+    [PERF_PROBE_DHT_CRITICAL] = "dht_critical",
+    [PERF_PROBE_DS18X20_MEASURE] = "ds18x20_measure",
+    [PERF_PROBE_ONEWIRE_RESET] = "onewire_reset",
+    [PERF_PROBE_ONEWIRE_CRITICAL] = "onewire_critical",
+    [PERF_PROBE_FREQ_MEAS_ISR] = "freq_meas_isr",
+    [PERF_PROBE_ACTUATORS_CRITICAL] = "actuators_critical",
+};
+
+#if CONFIG_DONICZKA_PERF
+
+/* Histograms are written from tasks and interrupts of both cores */
+static portMUX_TYPE perf_mux = portMUX_INITIALIZER_UNLOCKED;
+static histogram_t histograms[PERF_PROBES_NUM];
+
+/**
+ * @brief Finds upper bound of the bucket in which the cumulative count reaches the rank
+ *
+ * @param histogram the histogram
+ * @param rank rank of the sample, from 1
+ * @return upper bound in cycles, at most the maximum
+ */
+static uint32_t perf_percentile(const histogram_t* const histogram, uint32_t rank);
+
+void perf_end(perf_span_t* const span)
+{
+    uint32_t cycles = cpu_hal_get_cycle_count() - span->start;
+    histogram_t *histogram = &histograms[span->probe];
+    uint32_t bucket = (0u == cycles) ? 0u : 31u - (uint32_t)__builtin_clz(cycles);
+
+    portENTER_CRITICAL_SAFE(&perf_mux);
+    if ((uint32_t)xPortGetCoreID() != span->core)
+    {
+        histogram->dropped++;
+    }
+    else
+    {
+        if (0u == histogram->count || cycles < histogram->min)
+        {
+            histogram->min = cycles;
+        }
+        if (cycles > histogram->max)
+        {
+            histogram->max = cycles;
+        }
+        histogram->count++;
+        histogram->buckets[bucket]++;
+    }
+    portEXIT_CRITICAL_SAFE(&perf_mux);
+}
+
+esp_err_t perf_get_stats(perf_probe_t probe, perf_stats_t* const stats)
+{
+    histogram_t histogram;
+
+    if (PERF_PROBES_NUM <= probe)
+    {
+        return ESP_FAIL;
+    }
+
+    portENTER_CRITICAL_SAFE(&perf_mux);
+    histogram = histograms[probe];
+    portEXIT_CRITICAL_SAFE(&perf_mux);
+
+    stats->count = histogram.count;
+    stats->min = histogram.min;
+    stats->max = histogram.max;
+    stats->dropped = histogram.dropped;
+    stats->p50 = perf_percentile(&histogram, (histogram.count + 1u) / 2u);
+    stats->p99 = perf_percentile(&histogram, (uint32_t)(((uint64_t)histogram.count * 99u + 99u) / 100u));
+    return ESP_OK;
+}
+
+void perf_reset(void)
+{
+    portENTER_CRITICAL_SAFE(&perf_mux);
+    memset(histograms, 0, sizeof(histograms));
+    portEXIT_CRITICAL_SAFE(&perf_mux);
+}
+
+static uint32_t perf_percentile(const histogram_t* const histogram, uint32_t rank)
+{
+    uint32_t cumulative = 0u;
+    uint32_t bound;
+
+    if (0u == histogram->count)
+    {
+        return 0u;
+    }
+    for (uint32_t i = 0u; i < PERF_BUCKETS_NUM; i++)
+    {
+        cumulative += histogram->buckets[i];
+        if (cumulative >= rank)
+        {
+            bound = (31u == i) ? UINT32_MAX : (2u << i) - 1u;
+            return (bound < histogram->max) ? bound : histogram->max;
+        }
+    }
+    return histogram->max;
+}
+
+#else
+
+esp_err_t perf_get_stats(perf_probe_t probe, perf_stats_t* const stats)
+{
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+void perf_reset(void)
+{
+}
+
+#endif /* CONFIG_DONICZKA_PERF */
+
+const char* perf_get_name(perf_probe_t probe)
+{
+    return (PERF_PROBES_NUM > probe) ? probe_names[probe] : "unknown";
+}
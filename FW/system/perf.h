@@ -0,0 +1,110 @@
+#pragma once
+
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "esp_err.h"
+#include "sdkconfig.h"
+#if CONFIG_DONICZKA_PERF
+#include "hal/cpu_hal.h"
+#endif
+
+/* One bucket per power of two of cycles, bucket n holds durations of 2^n to 2^(n+1) - 1 cycles */
+#define PERF_BUCKETS_NUM 32u
+
+/**
+ * @brief Instrumented driver calls and critical sections
+ */
+typedef enum
+{
+    PERF_PROBE_DHT_READ = 0,            /*!< dht_read_data */
+    PERF_PROBE_DHT_CRITICAL,            /*!< interrupts off during bit-banged DHT read */
+    PERF_PROBE_DS18X20_MEASURE,         /*!< ds18x20_measure_and_read_multi */
+    PERF_PROBE_ONEWIRE_RESET,           /*!< onewire_reset */
+    PERF_PROBE_ONEWIRE_CRITICAL,        /*!< interrupts off during a bit-banged 1-Wire slot */
+    PERF_PROBE_FREQ_MEAS_ISR,           /*!< pulse counter watch point interrupt */
+    PERF_PROBE_ACTUATORS_CRITICAL,      /*!< interrupts off while duties of a batch are written */
+    PERF_PROBES_NUM
+} perf_probe_t;
+
+/**
+ * @brief Statistics of a probe
+ */
+typedef struct
+{
+    uint32_t count;
+    uint32_t min;                   /*!< in CPU cycles */
+    uint32_t max;
+    uint32_t p50;                   /*!< upper bound of the bucket holding the median, at most max */
+    uint32_t p99;
+    uint32_t dropped;               /*!< spans which ended on another core, cycle counters are per core */
+} perf_stats_t;
+
+#if CONFIG_DONICZKA_PERF
+
+/**
+ * @brief Span being measured
+ */
+typedef struct
+{
+    perf_probe_t probe;
+    uint32_t start;
+    uint32_t core;
+} perf_span_t;
+
+/**
+ * @brief Starts a span on the current core
+ */
+static inline perf_span_t perf_begin(perf_probe_t probe)
+{
+    perf_span_t span = {probe, cpu_hal_get_cycle_count(), (uint32_t)xPortGetCoreID()};
+    return span;
+}
+
+/**
+ * @brief Ends the span and adds its length to the histogram of its probe, safe in interrupts
+ *        and critical sections
+ *
+ * @param span the span
+ */
+void perf_end(perf_span_t* const span);
+
+/**
+ * @brief Measures from here to the end of the enclosing block, including early returns
+ */
+#define PERF_SCOPE(probe) \
+    perf_span_t PERF_CONCAT(perf_span_, __LINE__) __attribute__((cleanup(perf_end))) = perf_begin(probe)
+#define PERF_BEGIN(span, probe) perf_span_t span = perf_begin(probe)
+#define PERF_END(span) perf_end(&(span))
+
+#define PERF_CONCAT(a, b) PERF_CONCAT_(a, b)
+#define PERF_CONCAT_(a, b) a##b
+
+#else
+
+#define PERF_SCOPE(probe)
+#define PERF_BEGIN(span, probe)
+#define PERF_END(span)
+
+#endif /* CONFIG_DONICZKA_PERF */
+
+/**
+ * @brief Copies statistics of the probe
+ *
+ * @param probe the probe
+ * @param stats destination of the statistics
+ * @return ESP_OK on success, ESP_ERR_NOT_SUPPORTED if instrumentation is compiled out
+ */
+esp_err_t perf_get_stats(perf_probe_t probe, perf_stats_t* const stats);
+
+/**
+ * @brief Clears histograms of all probes
+ */
+void perf_reset(void);
+
+/**
+ * @brief Gets name of the probe
+ *
+ * @param probe the probe
+ * @return name
+ */
+const char* perf_get_name(perf_probe_t probe);
@@ -0,0 +1,80 @@
+#include <stdio.h>
+#include "esp_log.h"
+#include "esp_pm.h"
+#include "sdkconfig.h"
+#include "power.h"
+
+#if CONFIG_IDF_TARGET_ESP32S3
+typedef esp_pm_config_esp32s3_t power_config_t;
+#define POWER_MAX_FREQ_MHZ CONFIG_ESP32S3_DEFAULT_CPU_FREQ_MHZ
+#else
+typedef esp_pm_config_esp32_t power_config_t;
+#define POWER_MAX_FREQ_MHZ CONFIG_ESP32_DEFAULT_CPU_FREQ_MHZ
+#endif
+
+static const char *TAG = "power";
+
+esp_err_t power_init(void)
+{
+#if CONFIG_PM_ENABLE
+    /* Lowest frequency is used when no lock is held, light sleep when also no task is ready */
+    power_config_t config = {
+        .max_freq_mhz = POWER_MAX_FREQ_MHZ,
+        .min_freq_mhz = CONFIG_DONICZKA_PM_MIN_FREQ_MHZ,
+        .light_sleep_enable = CONFIG_DONICZKA_PM_LIGHT_SLEEP,
+    };
+
+    if (ESP_OK != esp_pm_configure(&config))
+    {
+        ESP_LOGE(TAG, "Could not configure power management");
+        return ESP_FAIL;
+    }
+    ESP_LOGI(TAG, "CPU %d - %d MHz, light sleep %s", config.min_freq_mhz, config.max_freq_mhz,
+             config.light_sleep_enable ? "on" : "off");
+#endif
+    return ESP_OK;
+}
+
+esp_err_t power_lock_create(esp_pm_lock_type_t type, const char *name, esp_pm_lock_handle_t* const handle)
+{
+#if CONFIG_PM_ENABLE
+    return (ESP_OK == esp_pm_lock_create(type, 0, name, handle)) ? ESP_OK : ESP_FAIL;
+#else
+    *handle = NULL;
+    return ESP_OK;
+#endif
+}
+
+void power_lock_acquire(esp_pm_lock_handle_t handle)
+{
+    if (NULL != handle)
+    {
+        esp_pm_lock_acquire(handle);
+    }
+}
+
+void power_lock_release(esp_pm_lock_handle_t handle)
+{
+    if (NULL != handle)
+    {
+        esp_pm_lock_release(handle);
+    }
+}
+
+esp_err_t power_dump(FILE* stream)
+{
+#if CONFIG_PM_ENABLE
+    power_config_t config;
+
+    if (ESP_OK != esp_pm_get_configuration(&config))
+    {
+        return ESP_FAIL;
+    }
+    fprintf(stream, "CPU %d - %d MHz, light sleep %s\n\r", config.min_freq_mhz, config.max_freq_mhz,
+            config.light_sleep_enable ? "on" : "off");
+    /* With CONFIG_PM_PROFILING it also prints time spent in every mode, including light sleep */
+    return esp_pm_dump_locks(stream);
+#else
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <stdio.h>
+#include "esp_err.h"
+#include "esp_pm.h"
+
+/**
+ * @brief Configures dynamic frequency scaling and automatic light sleep, see Power
+ *        management in Doniczka configuration. Does nothing if CONFIG_PM_ENABLE is off.
+ *
+ * @return ESP_OK on success, otherwise return ESP_FAIL
+ */
+esp_err_t power_init(void);
+
+/**
+ * @brief Creates a power management lock. Without power management the handle is NULL
+ *        and the lock functions do nothing.
+ *
+ * @param type what the lock prevents
+ * @param name name shown by pm_stats
+ * @param handle the lock
+ * @return ESP_OK on success, otherwise return ESP_FAIL
+ */
+esp_err_t power_lock_create(esp_pm_lock_type_t type, const char *name, esp_pm_lock_handle_t* const handle);
+
+/**
+ * @brief Acquires the lock, locks are counted, every acquire needs a release
+ *
+ * @param handle the lock
+ */
+void power_lock_acquire(esp_pm_lock_handle_t handle);
+
+/**
+ * @brief Releases the lock
+ *
+ * @param handle the lock
+ */
+void power_lock_release(esp_pm_lock_handle_t handle);
+
+/**
+ * @brief Prints CPU frequency limits, held locks and time spent in every power mode
+ *
+ * @param stream where to print
+ * @return ESP_OK on success, ESP_ERR_NOT_SUPPORTED without power management
+ */
+esp_err_t power_dump(FILE* stream);
@@ -0,0 +1,397 @@
+#include <stdio.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "scheduler.h"
+#include "task_plan.h"
+#include "trace.h"
+
+#define WORKERS_NUM 2u
+#define WORKER_STACK_SIZE 3072u
+
+typedef struct
+{
+    const char *name;
+    scheduler_job_fn_t fn;
+    scheduler_exec_t exec;
+    TickType_t period;
+    TickType_t next_due;
+    TickType_t released;        /*!< release time of the current run, its deadline is one period later */
+    bool triggered;
+    volatile bool busy;         /*!< worker job queued or running */
+    uint32_t runs;
+    uint32_t overruns;
+    uint32_t deadline_misses;
+    uint32_t last_us;
+    uint32_t max_us;
+} job_t;
+
+/* Job table and counters, guarded by the spinlock, functions of the jobs never run under it */
+static portMUX_TYPE scheduler_mux = portMUX_INITIALIZER_UNLOCKED;
+static job_t jobs[SCHEDULER_MAX_JOBS];
+static uint8_t jobs_num = 0u;
+static bool started = false;
+static uint32_t wakeups = 0u;
+static uint32_t dispatches = 0u;
+static int64_t started_us = 0;
+
+static QueueHandle_t worker_queue = NULL;
+static TaskHandle_t scheduler_task_handle = NULL;
+
+static const char *TAG = "scheduler";
+
+/**
+ * @brief Worker task, runs jobs handed over by the scheduler task one at a time
+ *
+ * @param pvParameter parameter of task (not used)
+ */
+static void scheduler_worker_task(void *pvParameter);
+
+/**
+ * @brief Checks if the job is released at the tick and advances its next release,
+ *        releases missed while the scheduler was late are counted as overruns
+ *
+ * @param job the job
+ * @param now current tick
+ * @param released release time of the run, nominal for periodic releases
+ * @return true if the job has to run
+ */
+static bool scheduler_release(job_t* const job, TickType_t now, TickType_t* const released);
+
+/**
+ * @brief Runs the job inline or hands it to the worker pool
+ *
+ * @param id index of the job
+ * @param released release time of the run
+ */
+static void scheduler_dispatch(scheduler_job_id_t id, TickType_t released);
+
+/**
+ * @brief Calls the job function and updates its execution time statistics,
+ *        a run completed one period or more after its release misses its deadline
+ *
+ * @param job the job
+ */
+static void scheduler_run(job_t* const job);
+
+/**
+ * @brief Computes how long the scheduler can sleep until the nearest release
+ *
+ * @param now current tick
+ * @return time to wait in ticks, 0 if a job is already due
+ */
+static TickType_t scheduler_next_wait(TickType_t now);
+
+/**
+ * @brief Converts period in milliseconds to ticks, at least one tick
+ */
+static TickType_t scheduler_period_ticks(uint32_t period_ms);
+
+esp_err_t scheduler_init(void)
+{
+    char name[configMAX_TASK_NAME_LEN];
+
+    if (NULL != worker_queue)
+    {
+        return ESP_OK;
+    }
+
+    /* Every job is at most once in the queue, it never gets full */
+    worker_queue = xQueueCreate(SCHEDULER_MAX_JOBS, sizeof(scheduler_job_id_t));
+    if (NULL == worker_queue)
+    {
+        ESP_LOGE(TAG, "Could not create worker queue");
+        return ESP_FAIL;
+    }
+    for (uint32_t i = 0u; i < WORKERS_NUM; i++)
+    {
+        snprintf(name, sizeof(name), "sched_worker_%u", (unsigned)i);
+        /* Workers block on the sensor buses, they run on their own core below the control tasks */
+        if (pdPASS != xTaskCreatePinnedToCore(&scheduler_worker_task, name, WORKER_STACK_SIZE, NULL,
+                                              TASK_PLAN_SENSOR_BUS_PRIORITY, NULL, TASK_PLAN_SENSOR_BUS_CORE))
+        {
+            ESP_LOGE(TAG, "Could not create %s", name);
+            return ESP_FAIL;
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t scheduler_add_job(const char *name, scheduler_job_fn_t fn, uint32_t period_ms, scheduler_exec_t exec,
+                            scheduler_job_id_t* const id)
+{
+    job_t* job;
+
+    if (NULL == fn || (SCHEDULER_EXEC_WORKER == exec && NULL == worker_queue))
+    {
+        return ESP_FAIL;
+    }
+
+    taskENTER_CRITICAL(&scheduler_mux);
+    if (SCHEDULER_MAX_JOBS <= jobs_num)
+    {
+        taskEXIT_CRITICAL(&scheduler_mux);
+        ESP_LOGE(TAG, "No room for job %s", name);
+        return ESP_FAIL;
+    }
+    job = &jobs[jobs_num];
+    memset(job, 0, sizeof(*job));
+    job->name = name;
+    job->fn = fn;
+    job->exec = exec;
+    job->period = scheduler_period_ticks(period_ms);
+    /* Jobs added before the start are aligned by the scheduler task */
+    job->next_due = xTaskGetTickCount() + job->period;
+    if (NULL != id)
+    {
+        *id = jobs_num;
+    }
+    jobs_num++;
+    taskEXIT_CRITICAL(&scheduler_mux);
+
+    if (started)
+    {
+        xTaskNotifyGive(scheduler_task_handle);
+    }
+    return ESP_OK;
+}
+
+esp_err_t scheduler_set_period(scheduler_job_id_t id, uint32_t period_ms)
+{
+    if (jobs_num <= id)
+    {
+        return ESP_FAIL;
+    }
+
+    taskENTER_CRITICAL(&scheduler_mux);
+    jobs[id].period = scheduler_period_ticks(period_ms);
+    jobs[id].next_due = xTaskGetTickCount() + jobs[id].period;
+    taskEXIT_CRITICAL(&scheduler_mux);
+
+    if (started)
+    {
+        xTaskNotifyGive(scheduler_task_handle);
+    }
+    return ESP_OK;
+}
+
+void scheduler_trigger(scheduler_job_id_t id)
+{
+    if (jobs_num <= id)
+    {
+        return;
+    }
+
+    taskENTER_CRITICAL(&scheduler_mux);
+    jobs[id].triggered = true;
+    taskEXIT_CRITICAL(&scheduler_mux);
+
+    if (started)
+    {
+        xTaskNotifyGive(scheduler_task_handle);
+    }
+}
+
+void scheduler_task(void *pvParameter)
+{
+    TickType_t now;
+    TickType_t wait;
+    TickType_t released;
+
+    scheduler_task_handle = xTaskGetCurrentTaskHandle();
+    started_us = esp_timer_get_time();
+
+    /* Common start gives all jobs with harmonic periods the same phase */
+    taskENTER_CRITICAL(&scheduler_mux);
+    now = xTaskGetTickCount();
+    for (uint8_t i = 0u; i < jobs_num; i++)
+    {
+        jobs[i].next_due = now + jobs[i].period;
+    }
+    started = true;
+    taskEXIT_CRITICAL(&scheduler_mux);
+
+    while (1)
+    {
+        now = xTaskGetTickCount();
+        for (uint8_t i = 0u; i < jobs_num; i++)
+        {
+            if (scheduler_release(&jobs[i], now, &released))
+            {
+                scheduler_dispatch(i, released);
+            }
+        }
+
+        /* Inline jobs may have taken a tick, the releases are absolute so nothing drifts */
+        wait = scheduler_next_wait(xTaskGetTickCount());
+        if (0u != wait)
+        {
+            ulTaskNotifyTake(pdTRUE, wait);
+            wakeups++;
+        }
+    }
+}
+
+void scheduler_get_stats(scheduler_stats_t* const stats)
+{
+    taskENTER_CRITICAL(&scheduler_mux);
+    stats->jobs_num = jobs_num;
+    stats->workers_num = WORKERS_NUM;
+    stats->wakeups = wakeups;
+    stats->dispatches = dispatches;
+    stats->started_us = started_us;
+    taskEXIT_CRITICAL(&scheduler_mux);
+}
+
+esp_err_t scheduler_get_job_stats(scheduler_job_id_t id, scheduler_job_stats_t* const stats)
+{
+    if (jobs_num <= id)
+    {
+        return ESP_FAIL;
+    }
+
+    taskENTER_CRITICAL(&scheduler_mux);
+    stats->name = jobs[id].name;
+    stats->exec = jobs[id].exec;
+    stats->period_ms = jobs[id].period * portTICK_PERIOD_MS;
+    stats->runs = jobs[id].runs;
+    stats->overruns = jobs[id].overruns;
+    stats->deadline_misses = jobs[id].deadline_misses;
+    stats->last_us = jobs[id].last_us;
+    stats->max_us = jobs[id].max_us;
+    taskEXIT_CRITICAL(&scheduler_mux);
+
+    return ESP_OK;
+}
+
+static void scheduler_worker_task(void *pvParameter)
+{
+    scheduler_job_id_t id;
+
+    while (1)
+    {
+        if (pdTRUE == xQueueReceive(worker_queue, &id, portMAX_DELAY))
+        {
+            scheduler_run(&jobs[id]);
+            jobs[id].busy = false;
+        }
+    }
+}
+
+static bool scheduler_release(job_t* const job, TickType_t now, TickType_t* const released)
+{
+    bool release = false;
+    TickType_t missed;
+
+    taskENTER_CRITICAL(&scheduler_mux);
+    if (job->triggered)
+    {
+        job->triggered = false;
+        *released = now;
+        release = true;
+    }
+    if ((int32_t)(now - job->next_due) >= 0)
+    {
+        /* Deadline counts from the nominal release, lateness of the scheduler is included */
+        *released = job->next_due;
+        missed = (now - job->next_due) / job->period;
+        job->next_due += (missed + 1u) * job->period;
+        job->overruns += missed;
+        release = true;
+    }
+    taskEXIT_CRITICAL(&scheduler_mux);
+
+    return release;
+}
+
+static void scheduler_dispatch(scheduler_job_id_t id, TickType_t released)
+{
+    job_t* job = &jobs[id];
+
+    if (SCHEDULER_EXEC_INLINE == job->exec)
+    {
+        job->released = released;
+        scheduler_run(job);
+        return;
+    }
+
+    /* A blocking job is never queued twice, a release during its run is dropped */
+    if (job->busy)
+    {
+        taskENTER_CRITICAL(&scheduler_mux);
+        job->overruns++;
+        taskEXIT_CRITICAL(&scheduler_mux);
+        return;
+    }
+    job->busy = true;
+    taskENTER_CRITICAL(&scheduler_mux);
+    job->released = released;
+    dispatches++;
+    taskEXIT_CRITICAL(&scheduler_mux);
+    xQueueSend(worker_queue, &id, 0u);
+}
+
+static void scheduler_run(job_t* const job)
+{
+    int64_t start = esp_timer_get_time();
+    uint32_t elapsed;
+    bool missed;
+
+    TRACE_BEGIN(TRACE_MARKER_JOB_0 + (job - jobs));
+    job->fn();
+    TRACE_END(TRACE_MARKER_JOB_0 + (job - jobs));
+    elapsed = (uint32_t)(esp_timer_get_time() - start);
+
+    taskENTER_CRITICAL(&scheduler_mux);
+    missed = (xTaskGetTickCount() - job->released) >= job->period;
+    if (missed)
+    {
+        job->deadline_misses++;
+    }
+    job->runs++;
+    job->last_us = elapsed;
+    if (elapsed > job->max_us)
+    {
+        job->max_us = elapsed;
+    }
+    taskEXIT_CRITICAL(&scheduler_mux);
+
+    if (missed && 1u == job->deadline_misses)
+    {
+        ESP_LOGW(TAG, "Job %s missed its deadline, took %u us", job->name, (unsigned)elapsed);
+    }
+}
+
+static TickType_t scheduler_next_wait(TickType_t now)
+{
+    TickType_t wait = portMAX_DELAY;
+    int32_t until;
+
+    taskENTER_CRITICAL(&scheduler_mux);
+    for (uint8_t i = 0u; i < jobs_num; i++)
+    {
+        until = (int32_t)(jobs[i].next_due - now);
+        if (jobs[i].triggered || 0 >= until)
+        {
+            wait = 0u;
+            break;
+        }
+        if ((TickType_t)until < wait)
+        {
+            wait = (TickType_t)until;
+        }
+    }
+    taskEXIT_CRITICAL(&scheduler_mux);
+
+    return wait;
+}
+
+static TickType_t scheduler_period_ticks(uint32_t period_ms)
+{
+    TickType_t period = pdMS_TO_TICKS(period_ms);
+
+    return (0u == period) ? 1u : period;
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+#define SCHEDULER_MAX_JOBS 12u
+
+/**
+ * @brief Periodic job, called with no arguments by the scheduler
+ */
+typedef void (*scheduler_job_fn_t)(void);
+
+/**
+ * @brief Where the job runs
+ */
+typedef enum
+{
+    SCHEDULER_EXEC_INLINE = 0,  /*!< in the scheduler task, for short non-blocking jobs */
+    SCHEDULER_EXEC_WORKER,      /*!< on the worker pool, for jobs blocking on I/O */
+} scheduler_exec_t;
+
+/**
+ * @brief Index of the job returned when it is added
+ */
+typedef uint8_t scheduler_job_id_t;
+
+/**
+ * @brief Statistics of a single job
+ */
+typedef struct
+{
+    const char *name;
+    scheduler_exec_t exec;
+    uint32_t period_ms;
+    uint32_t runs;              /*!< number of completed runs */
+    uint32_t overruns;          /*!< releases dropped, the previous run was late or still running */
+    uint32_t deadline_misses;   /*!< runs completed one period or more after their release */
+    uint32_t last_us;           /*!< execution time of the last run */
+    uint32_t max_us;            /*!< longest execution time */
+} scheduler_job_stats_t;
+
+/**
+ * @brief Statistics of the scheduler
+ */
+typedef struct
+{
+    uint8_t jobs_num;
+    uint8_t workers_num;
+    uint32_t wakeups;           /*!< wake-ups of the scheduler task */
+    uint32_t dispatches;        /*!< runs handed to the worker pool, each wakes a worker */
+    int64_t started_us;         /*!< time the scheduler started (esp_timer_get_time) */
+} scheduler_stats_t;
+
+/**
+ * @brief Creates the worker pool, has to be called before jobs are added
+ *
+ * @return ESP_OK on success, otherwise return ESP_FAIL
+ */
+esp_err_t scheduler_init(void);
+
+/**
+ * @brief Adds a periodic job. Jobs added before scheduler task starts are released
+ *        together one period after the start, so jobs with harmonic periods share
+ *        wake-ups of the scheduler.
+ *
+ * @param name name of the job, has to stay valid
+ * @param fn function of the job
+ * @param period_ms period, rounded down to ticks, at least one tick
+ * @param exec where the job runs
+ * @param id index of the job, can be NULL
+ * @return ESP_OK on success, otherwise return ESP_FAIL
+ */
+esp_err_t scheduler_add_job(const char *name, scheduler_job_fn_t fn, uint32_t period_ms, scheduler_exec_t exec,
+                            scheduler_job_id_t* const id);
+
+/**
+ * @brief Changes period of the job, the next release is one new period from now
+ *
+ * @param id index of the job
+ * @param period_ms period, rounded down to ticks, at least one tick
+ * @return ESP_OK on success, otherwise return ESP_FAIL
+ */
+esp_err_t scheduler_set_period(scheduler_job_id_t id, uint32_t period_ms);
+
+/**
+ * @brief Releases the job as soon as possible, keeps its phase
+ *
+ * @param id index of the job
+ */
+void scheduler_trigger(scheduler_job_id_t id);
+
+/**
+ * @brief Scheduler task, sleeps until the nearest release, runs inline jobs and hands
+ *        the others to the worker pool. Release times are absolute, so jobs keep
+ *        their phase regardless of execution time.
+ *
+ * @param pvParameter parameter of task (not used)
+ */
+void scheduler_task(void *pvParameter);
+
+/**
+ * @brief Copies statistics of the scheduler
+ *
+ * @param stats destination of the statistics
+ */
+void scheduler_get_stats(scheduler_stats_t* const stats);
+
+/**
+ * @brief Copies statistics of the job
+ *
+ * @param id index of the job
+ * @param stats destination of the statistics
+ * @return ESP_OK on success, ESP_FAIL if there is no such job
+ */
+esp_err_t scheduler_get_job_stats(scheduler_job_id_t id, scheduler_job_stats_t* const stats);
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "sdkconfig.h"
+
+/**
+ * @brief Cores of the task groups, see Task placement in Doniczka configuration
+ */
+#if CONFIG_DONICZKA_TASK_PINNING
+#define TASK_PLAN_SENSOR_BUS_CORE   CONFIG_DONICZKA_SENSOR_BUS_CORE
+#define TASK_PLAN_CONTROL_CORE      (1 - CONFIG_DONICZKA_SENSOR_BUS_CORE)
+#else
+#define TASK_PLAN_SENSOR_BUS_CORE   tskNO_AFFINITY
+#define TASK_PLAN_CONTROL_CORE      tskNO_AFFINITY
+#endif
+
+/* Console is not time critical, it runs wherever there is time left */
+#define TASK_PLAN_CONSOLE_CORE      tskNO_AFFINITY
+
+/**
+ * @brief Priorities of the task groups
+ */
+#define TASK_PLAN_FREQ_MEAS_PRIORITY    CONFIG_DONICZKA_PRIORITY_FREQ_MEAS
+#define TASK_PLAN_CONTROL_PRIORITY      CONFIG_DONICZKA_PRIORITY_CONTROL
+#define TASK_PLAN_SENSOR_BUS_PRIORITY   CONFIG_DONICZKA_PRIORITY_SENSOR_BUS
+#define TASK_PLAN_POWER_METER_PRIORITY  CONFIG_DONICZKA_PRIORITY_POWER_METER
+#define TASK_PLAN_CONSOLE_PRIORITY      CONFIG_DONICZKA_PRIORITY_CONSOLE
+
+_Static_assert(TASK_PLAN_CONSOLE_PRIORITY < TASK_PLAN_CONTROL_PRIORITY &&
+               TASK_PLAN_CONSOLE_PRIORITY < TASK_PLAN_FREQ_MEAS_PRIORITY,
+               "Console has to run below control work");
+_Static_assert(TASK_PLAN_FREQ_MEAS_PRIORITY < configMAX_PRIORITIES &&
+               TASK_PLAN_CONTROL_PRIORITY < configMAX_PRIORITIES &&
+               TASK_PLAN_SENSOR_BUS_PRIORITY < configMAX_PRIORITIES &&
+               TASK_PLAN_POWER_METER_PRIORITY < configMAX_PRIORITIES,
+               "Priority out of range");
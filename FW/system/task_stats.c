@@ -0,0 +1,111 @@
+#include <stdio.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
+#include "sdkconfig.h"
+#include "task_stats.h"
+
+/* Run time counters are taken from esp_timer in us (CONFIG_FREERTOS_RUN_TIME_STATS_USING_ESP_TIMER),
+ * they are 32 bit, so windows up to about 71 minutes are measured correctly across a wrap */
+#if !CONFIG_FREERTOS_USE_TRACE_FACILITY || !CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS
+#error "task_stats needs FreeRTOS trace facility and run time stats"
+#endif
+
+static TaskStatus_t status_start[TASK_STATS_MAX_TASKS];
+static TaskStatus_t status_end[TASK_STATS_MAX_TASKS];
+
+static const char* const state_names[] = {
+    [eRunning] = "run",
+    [eReady] = "ready",
+    [eBlocked] = "block",
+    [eSuspended] = "susp",
+    [eDeleted] = "del",
+};
+
+/**
+ * @brief Finds run time counter of the task in the start snapshot
+ *
+ * @param number unique number of the task
+ * @param start_num number of tasks in the start snapshot
+ * @param counter run time counter of the task
+ * @return true if the task existed at the start of the window
+ */
+static bool task_stats_find_start(UBaseType_t number, UBaseType_t start_num, uint32_t* const counter);
+
+esp_err_t task_stats_measure(uint32_t window_ms, task_stats_t* const stats)
+{
+    UBaseType_t start_num;
+    UBaseType_t end_num;
+    int64_t start_us;
+    uint32_t window_us;
+    uint32_t counter;
+    float cpu;
+
+    start_us = esp_timer_get_time();
+    start_num = uxTaskGetSystemState(status_start, TASK_STATS_MAX_TASKS, NULL);
+    vTaskDelay(pdMS_TO_TICKS(window_ms));
+    end_num = uxTaskGetSystemState(status_end, TASK_STATS_MAX_TASKS, NULL);
+    window_us = (uint32_t)(esp_timer_get_time() - start_us);
+
+    /* Array too small for all tasks is reported by returning zero */
+    if (0u == start_num || 0u == end_num)
+    {
+        return ESP_FAIL;
+    }
+
+    memset(stats, 0, sizeof(*stats));
+    stats->window_us = window_us;
+    for (UBaseType_t i = 0u; i < end_num; i++)
+    {
+        const TaskStatus_t *status = &status_end[i];
+        task_stats_task_t *task = &stats->tasks[i];
+
+        /* Task created within the window started its counter from zero */
+        counter = 0u;
+        task_stats_find_start(status->xTaskNumber, start_num, &counter);
+        cpu = (0u != window_us) ? (float)(status->ulRunTimeCounter - counter) * 100.0f / (float)window_us : 0.0f;
+
+        strlcpy(task->name, status->pcTaskName, sizeof(task->name));
+        task->number = status->xTaskNumber;
+        task->state = status->eCurrentState;
+        task->priority = status->uxCurrentPriority;
+        task->core = xTaskGetAffinity(status->xHandle);
+        task->stack_free = status->usStackHighWaterMark;
+        task->cpu = cpu;
+
+        for (BaseType_t core = 0; core < portNUM_PROCESSORS; core++)
+        {
+            if (status->xHandle == xTaskGetIdleTaskHandleForCPU(core))
+            {
+                stats->core_load[core] = (cpu < 100.0f) ? 100.0f - cpu : 0.0f;
+            }
+        }
+    }
+    stats->tasks_num = (uint8_t)end_num;
+
+    stats->heap_free = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    stats->heap_min = heap_caps_get_minimum_free_size(MALLOC_CAP_8BIT);
+    stats->heap_largest = heap_caps_get_largest_free_block(MALLOC_CAP_8BIT);
+
+    return ESP_OK;
+}
+
+const char* task_stats_get_state_name(eTaskState state)
+{
+    return (eDeleted >= state) ? state_names[state] : "?";
+}
+
+static bool task_stats_find_start(UBaseType_t number, UBaseType_t start_num, uint32_t* const counter)
+{
+    for (UBaseType_t i = 0u; i < start_num; i++)
+    {
+        if (number == status_start[i].xTaskNumber)
+        {
+            *counter = status_start[i].ulRunTimeCounter;
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_err.h"
+
+#define TASK_STATS_MAX_TASKS 24u
+
+/**
+ * @brief Statistics of a single task
+ */
+typedef struct
+{
+    char name[configMAX_TASK_NAME_LEN];
+    UBaseType_t number;             /*!< unique number of the task */
+    eTaskState state;
+    UBaseType_t priority;           /*!< current priority, raised while it inherits a mutex */
+    BaseType_t core;                /*!< core the task is pinned to, tskNO_AFFINITY if it is not */
+    uint32_t stack_free;            /*!< smallest free stack since the task started, in bytes */
+    float cpu;                      /*!< share of one core used within the window, in % */
+} task_stats_task_t;
+
+/**
+ * @brief Statistics of all tasks and of the heap
+ */
+typedef struct
+{
+    uint8_t tasks_num;
+    task_stats_task_t tasks[TASK_STATS_MAX_TASKS];
+    float core_load[portNUM_PROCESSORS];    /*!< load of the core within the window, 100 % less its idle task */
+    uint32_t window_us;             /*!< length of the window */
+    uint32_t heap_free;             /*!< free heap in bytes */
+    uint32_t heap_min;              /*!< smallest free heap since boot */
+    uint32_t heap_largest;          /*!< largest block which can be allocated */
+} task_stats_t;
+
+/**
+ * @brief Measures CPU usage of all tasks over the window, blocks the caller for the window.
+ *        Uses static buffers, has to be called from one task only (the console).
+ *
+ * @param window_ms length of the window
+ * @param stats destination of the statistics
+ * @return ESP_OK on success, ESP_FAIL if there are more tasks than TASK_STATS_MAX_TASKS
+ */
+esp_err_t task_stats_measure(uint32_t window_ms, task_stats_t* const stats);
+
+/**
+ * @brief Gets short name of the task state
+ *
+ * @param state the state
+ * @return name
+ */
+const char* task_stats_get_state_name(eTaskState state);
@@ -0,0 +1,165 @@
+#include <stdio.h>
+#include <string.h>
+#include "trace_hooks.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_attr.h"
+#include "esp_timer.h"
+#include "trace.h"
+#include "scheduler.h"
+
+#define DUMP_RECORDS_PER_LINE 16u
+#define DUMP_MAX_TASKS 24u
+
+static const char* const marker_names[TRACE_MARKER_JOB_0] = {
+    [TRACE_MARKER_DHT_READ] = "dht_read",
+    [TRACE_MARKER_DS18X20_MEASURE] = "ds18x20_measure",
+    [TRACE_MARKER_ONEWIRE_RESET] = "onewire_reset",
+    [TRACE_MARKER_BMP280_READ] = "bmp280_read",
+    [TRACE_MARKER_CONSOLE_COMMAND] = "console_command",
+    [TRACE_MARKER_ACTUATORS_APPLY] = "actuators_apply",
+};
+
+#if CONFIG_DONICZKA_TRACE
+
+#define TRACE_RECORDS CONFIG_DONICZKA_TRACE_RECORDS
+
+_Static_assert(0u == (TRACE_RECORDS & (TRACE_RECORDS - 1u)), "Number of records has to be a power of two");
+
+/* Writers of both cores reserve slots by incrementing the head, the buffer is read only while
+ * recording is stopped */
+static trace_record_t records[TRACE_RECORDS];
+static volatile uint32_t head = 0u;
+static volatile bool recording = true;
+
+static TaskStatus_t dump_tasks[DUMP_MAX_TASKS];
+
+void IRAM_ATTR trace_record(trace_type_t type, uint16_t id)
+{
+    trace_record_t *record;
+
+    if (!recording)
+    {
+        return;
+    }
+    record = &records[__atomic_fetch_add(&head, 1u, __ATOMIC_RELAXED) & (TRACE_RECORDS - 1u)];
+    record->timestamp_us = (uint32_t)esp_timer_get_time();
+    record->type = (uint8_t)type;
+    record->core = (uint8_t)xPortGetCoreID();
+    record->id = id;
+}
+
+void IRAM_ATTR trace_task_switched_in(void)
+{
+    trace_record(TRACE_TYPE_SWITCH, (uint16_t)uxTaskGetTaskNumber(xTaskGetCurrentTaskHandle()));
+}
+
+void trace_scope_end(const uint16_t* const marker)
+{
+    trace_record(TRACE_TYPE_END, *marker);
+}
+
+void trace_start(void)
+{
+    recording = false;
+    head = 0u;
+    recording = true;
+}
+
+void trace_stop(void)
+{
+    recording = false;
+}
+
+esp_err_t trace_get_status(bool* const is_recording, uint32_t* const num, uint32_t* const lost)
+{
+    uint32_t written = head;
+
+    *is_recording = recording;
+    *num = (written < TRACE_RECORDS) ? written : TRACE_RECORDS;
+    *lost = written - *num;
+    return ESP_OK;
+}
+
+esp_err_t trace_dump(void)
+{
+    bool was_recording = recording;
+    scheduler_stats_t sched;
+    scheduler_job_stats_t job;
+    UBaseType_t tasks_num;
+    uint32_t written;
+    uint32_t num;
+    uint32_t first;
+
+    /* Writers which passed the check before the stop finish within microseconds */
+    recording = false;
+    vTaskDelay(1u);
+
+    written = head;
+    num = (written < TRACE_RECORDS) ? written : TRACE_RECORDS;
+    first = written - num;
+
+    printf("#trace 1 %u %u\n\r", (unsigned)num, (unsigned)first);
+    tasks_num = uxTaskGetSystemState(dump_tasks, DUMP_MAX_TASKS, NULL);
+    for (UBaseType_t i = 0u; i < tasks_num; i++)
+    {
+        printf("#task %u %s\n\r", (unsigned)dump_tasks[i].xTaskNumber, dump_tasks[i].pcTaskName);
+    }
+    for (uint32_t i = 0u; i < TRACE_MARKER_JOB_0; i++)
+    {
+        printf("#marker %u %s\n\r", (unsigned)i, marker_names[i]);
+    }
+    scheduler_get_stats(&sched);
+    for (scheduler_job_id_t i = 0u; i < sched.jobs_num; i++)
+    {
+        if (ESP_OK == scheduler_get_job_stats(i, &job))
+        {
+            printf("#marker %u job:%s\n\r", (unsigned)(TRACE_MARKER_JOB_0 + i), job.name);
+        }
+    }
+
+    for (uint32_t i = 0u; i < num; i++)
+    {
+        const uint8_t *bytes = (const uint8_t *)&records[(first + i) & (TRACE_RECORDS - 1u)];
+
+        if (0u == (i % DUMP_RECORDS_PER_LINE))
+        {
+            printf("%s#data ", (0u == i) ? "" : "\n\r");
+        }
+        for (uint32_t j = 0u; j < sizeof(trace_record_t); j++)
+        {
+            printf("%02x", bytes[j]);
+        }
+    }
+    printf("%s#end\n\r", (0u == num) ? "" : "\n\r");
+
+    recording = was_recording;
+    return ESP_OK;
+}
+
+#else
+
+void trace_start(void)
+{
+}
+
+void trace_stop(void)
+{
+}
+
+esp_err_t trace_get_status(bool* const is_recording, uint32_t* const num, uint32_t* const lost)
+{
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+esp_err_t trace_dump(void)
+{
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+#endif /* CONFIG_DONICZKA_TRACE */
+
+const char* trace_get_marker_name(trace_marker_t marker)
+{
+    return (TRACE_MARKER_JOB_0 > marker) ? marker_names[marker] : NULL;
+}
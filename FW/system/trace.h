@@ -0,0 +1,113 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "sdkconfig.h"
+
+/**
+ * @brief Type of a record
+ */
+typedef enum
+{
+    TRACE_TYPE_SWITCH = 0,          /*!< task switched in, id is its task number */
+    TRACE_TYPE_BEGIN,               /*!< marker began, id is the marker */
+    TRACE_TYPE_END,                 /*!< marker ended */
+} trace_type_t;
+
+/**
+ * @brief Markers around driver calls, commands and actuator writes, scheduler jobs follow them
+ */
+typedef enum
+{
+    TRACE_MARKER_DHT_READ = 0,
+    TRACE_MARKER_DS18X20_MEASURE,
+    TRACE_MARKER_ONEWIRE_RESET,
+    TRACE_MARKER_BMP280_READ,
+    TRACE_MARKER_CONSOLE_COMMAND,
+    TRACE_MARKER_ACTUATORS_APPLY,
+    TRACE_MARKER_JOB_0,             /*!< run of scheduler job 0, job n is TRACE_MARKER_JOB_0 + n */
+} trace_marker_t;
+
+/**
+ * @brief Binary record, 8 bytes, little endian when dumped
+ */
+typedef struct __attribute__((packed))
+{
+    uint32_t timestamp_us;          /*!< lower 32 bits of esp_timer_get_time, common to both cores */
+    uint8_t type;                   /*!< trace_type_t */
+    uint8_t core;
+    uint16_t id;
+} trace_record_t;
+
+#if CONFIG_DONICZKA_TRACE
+
+/**
+ * @brief Adds a record to the ring buffer, safe in interrupts and in the scheduler
+ *
+ * @param type type of the record
+ * @param id task number or marker
+ */
+void trace_record(trace_type_t type, uint16_t id);
+
+/**
+ * @brief Records end of a marker on exit from its scope
+ */
+void trace_scope_end(const uint16_t* const marker);
+
+#define TRACE_BEGIN(marker) trace_record(TRACE_TYPE_BEGIN, (uint16_t)(marker))
+#define TRACE_END(marker) trace_record(TRACE_TYPE_END, (uint16_t)(marker))
+
+/**
+ * @brief Marks from here to the end of the enclosing block, including early returns
+ */
+#define TRACE_SCOPE(marker) \
+    const uint16_t TRACE_CONCAT(trace_scope_, __LINE__) __attribute__((cleanup(trace_scope_end))) = \
+        (TRACE_BEGIN(marker), (uint16_t)(marker))
+
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+#define TRACE_CONCAT_(a, b) a##b
+
+#else
+
+#define TRACE_BEGIN(marker)
+#define TRACE_END(marker)
+#define TRACE_SCOPE(marker)
+
+#endif /* CONFIG_DONICZKA_TRACE */
+
+/**
+ * @brief Clears the buffer and starts recording
+ */
+void trace_start(void);
+
+/**
+ * @brief Stops recording, records in the buffer are kept
+ */
+void trace_stop(void);
+
+/**
+ * @brief Gets state of the tracer
+ *
+ * @param is_recording true while records are added
+ * @param num number of records in the buffer
+ * @param lost number of records overwritten since the start
+ * @return ESP_OK on success, ESP_ERR_NOT_SUPPORTED if tracing is compiled out
+ */
+esp_err_t trace_get_status(bool* const is_recording, uint32_t* const num, uint32_t* const lost);
+
+/**
+ * @brief Prints the buffer as text, records as hex, for tools/trace_to_chrome.py.
+ *        Recording is paused while the buffer is printed.
+ *
+ * @return ESP_OK on success, ESP_ERR_NOT_SUPPORTED if tracing is compiled out
+ */
+esp_err_t trace_dump(void);
+
+/**
+ * @brief Gets name of the marker
+ *
+ * @param marker the marker
+ * @return name, NULL for scheduler jobs and unknown markers
+ */
+const char* trace_get_marker_name(trace_marker_t marker);
@@ -0,0 +1,24 @@
+#pragma once
+
+/* Included into the source files of the FreeRTOS component only, see CMakeLists.txt of the project */
+
+#include "sdkconfig.h"
+
+#if CONFIG_DONICZKA_TRACE && !defined(__ASSEMBLER__)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Records the task switched in on the current core, called by the FreeRTOS scheduler
+ */
+void trace_task_switched_in(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#define traceTASK_SWITCHED_IN() trace_task_switched_in()
+
+#endif
@@ -46,6 +46,15 @@
 #include <esp_log.h>
 #include "ets_sys.h"
 #include "esp_idf_lib_helpers.h"
+#include "../system/perf.h"
+#include "../system/trace.h"
+#if CONFIG_DONICZKA_DHT_BACKEND_RMT
+#include <freertos/ringbuf.h>
+#include <driver/rmt.h>
+#include <esp_rom_gpio.h>
+#include <soc/rmt_periph.h>
+#include "../mcu/peripherals.h"
+#endif
 
 // DHT timer precision in microseconds
 #define DHT_TIMER_INTERVAL 2
@@ -82,7 +91,13 @@
 
 static const char *TAG = "dht";
 
-#if HELPER_TARGET_IS_ESP32
+#if CONFIG_DONICZKA_DHT_BACKEND_RMT
+// The start pulse is generated and the response is captured by the RMT
+// peripheral, the calling task sleeps in the meantime with interrupts enabled
+#define PORT_ENTER_CRITICAL()
+#define PORT_EXIT_CRITICAL()
+
+#elif HELPER_TARGET_IS_ESP32
 static portMUX_TYPE mux = portMUX_INITIALIZER_UNLOCKED;
 #define PORT_ENTER_CRITICAL() portENTER_CRITICAL(&mux)
 #define PORT_EXIT_CRITICAL() portEXIT_CRITICAL(&mux)
@@ -104,6 +119,152 @@ static portMUX_TYPE mux = portMUX_INITIALIZER_UNLOCKED;
     } while (0)
 
 
+#if CONFIG_DONICZKA_DHT_BACKEND_RMT
+
+// 80 MHz APB clock divided to ticks of 1 us
+#define DHT_RMT_CLK_DIV 80
+// Capture ends after the line has not changed for this time. The start pulse
+// is captured as well, so the threshold has to be longer than the pulse.
+#define DHT_RMT_RX_IDLE_US 30000
+// Glitches shorter than this number of APB cycles are ignored
+#define DHT_RMT_RX_FILTER_CYCLES 100
+#define DHT_RMT_RX_BUFFER_SIZE 1024
+#define DHT_RMT_TIMEOUT_MS 100
+
+static const rmt_channel_t tx_channel = (rmt_channel_t)ESP_RMT_CH_DHT_TX;
+static const rmt_channel_t rx_channel = (rmt_channel_t)ESP_RMT_CH_DHT_RX;
+static RingbufHandle_t rx_buffer = NULL;
+
+/**
+ * Install both RMT channels on first use and route them to the pin, which
+ * works in open drain mode with the input enabled.
+ */
+static esp_err_t dht_rmt_setup(gpio_num_t pin)
+{
+    if (!rx_buffer)
+    {
+        rmt_config_t rx_config = RMT_DEFAULT_CONFIG_RX(pin, rx_channel);
+        rx_config.clk_div = DHT_RMT_CLK_DIV;
+        rx_config.rx_config.filter_en = true;
+        rx_config.rx_config.filter_ticks_thresh = DHT_RMT_RX_FILTER_CYCLES;
+        rx_config.rx_config.idle_threshold = DHT_RMT_RX_IDLE_US;
+
+        rmt_config_t tx_config = RMT_DEFAULT_CONFIG_TX(pin, tx_channel);
+        tx_config.clk_div = DHT_RMT_CLK_DIV;
+        tx_config.tx_config.idle_output_en = true;
+        tx_config.tx_config.idle_level = RMT_IDLE_LEVEL_HIGH;
+
+        if (rmt_config(&rx_config) != ESP_OK || rmt_driver_install(rx_channel, DHT_RMT_RX_BUFFER_SIZE, 0) != ESP_OK
+            || rmt_config(&tx_config) != ESP_OK || rmt_driver_install(tx_channel, 0, 0) != ESP_OK
+            || rmt_get_ringbuf_handle(rx_channel, &rx_buffer) != ESP_OK)
+        {
+            rmt_driver_uninstall(rx_channel);
+            rmt_driver_uninstall(tx_channel);
+            rx_buffer = NULL;
+            return ESP_FAIL;
+        }
+    }
+
+    rmt_set_gpio(rx_channel, RMT_MODE_RX, pin, false);
+    rmt_set_gpio(tx_channel, RMT_MODE_TX, pin, false);
+    gpio_set_direction(pin, GPIO_MODE_INPUT_OUTPUT_OD);
+    gpio_set_pull_mode(pin, GPIO_PULLUP_ONLY);
+    esp_rom_gpio_connect_in_signal(pin, rmt_periph_signals.groups[0].channels[rx_channel].rx_sig, false);
+
+    return ESP_OK;
+}
+
+/**
+ * Decode captured line levels. Every bit is a low phase followed by a high
+ * phase, the bit is 1 if the high phase is longer. The start pulse and the
+ * response (phases B-D) form the pairs before the data, so the data bits are
+ * the last DHT_DATA_BITS pairs of the capture.
+ */
+static esp_err_t dht_decode_data(const rmt_item32_t *items, size_t count, uint8_t data[DHT_DATA_BYTES])
+{
+    uint32_t lows[DHT_DATA_BITS];
+    uint32_t highs[DHT_DATA_BITS];
+    uint32_t low = 0;
+    size_t pairs = 0;
+
+    for (size_t i = 0; i < count * 2; i++)
+    {
+        uint32_t level = (i & 1) ? items[i / 2].level1 : items[i / 2].level0;
+        uint32_t duration = (i & 1) ? items[i / 2].duration1 : items[i / 2].duration0;
+
+        // Zero duration marks the end of the capture
+        if (!duration)
+            break;
+
+        if (!level)
+        {
+            low += duration;
+        }
+        else if (low)
+        {
+            lows[pairs % DHT_DATA_BITS] = low;
+            highs[pairs % DHT_DATA_BITS] = duration;
+            pairs++;
+            low = 0;
+        }
+    }
+
+    if (pairs < DHT_DATA_BITS)
+    {
+        ESP_LOGE(TAG, "Incomplete response, %d bits captured", (int)pairs);
+        return ESP_ERR_TIMEOUT;
+    }
+
+    memset(data, 0, DHT_DATA_BYTES);
+    for (int i = 0; i < DHT_DATA_BITS; i++)
+    {
+        size_t p = (pairs - DHT_DATA_BITS + i) % DHT_DATA_BITS;
+        data[i / 8] |= (highs[p] > lows[p]) << (7 - i % 8);
+    }
+
+    return ESP_OK;
+}
+
+/**
+ * Request data from DHT and capture raw bit stream with RMT.
+ * Decoding runs after the capture with interrupts enabled.
+ */
+static esp_err_t dht_fetch_data(dht_sensor_type_t sensor_type, gpio_num_t pin, uint8_t data[DHT_DATA_BYTES])
+{
+    // Phase 'A' pulling signal low to initiate read sequence, then release
+    rmt_item32_t start = {{{ sensor_type == DHT_TYPE_SI7021 ? 500 : 20000, 0, 10, 1 }}};
+    size_t size = 0;
+    void *item;
+
+    if (dht_rmt_setup(pin) != ESP_OK)
+    {
+        ESP_LOGE(TAG, "RMT initialization failed");
+        return ESP_FAIL;
+    }
+
+    // Drop leftovers of a previous read which timed out
+    while ((item = xRingbufferReceive(rx_buffer, &size, 0)) != NULL)
+        vRingbufferReturnItem(rx_buffer, item);
+
+    rmt_rx_start(rx_channel, true);
+    esp_err_t result = rmt_write_items(tx_channel, &start, 1, true);
+    item = (result == ESP_OK) ? xRingbufferReceive(rx_buffer, &size, pdMS_TO_TICKS(DHT_RMT_TIMEOUT_MS)) : NULL;
+    rmt_rx_stop(rx_channel);
+
+    if (!item)
+    {
+        ESP_LOGE(TAG, "No response captured");
+        return ESP_ERR_TIMEOUT;
+    }
+
+    result = dht_decode_data((const rmt_item32_t *)item, size / sizeof(rmt_item32_t), data);
+    vRingbufferReturnItem(rx_buffer, item);
+
+    return result;
+}
+
+#else /* CONFIG_DONICZKA_DHT_BACKEND_RMT */
+
 /**
  * Wait specified time for pin to go to a specified state.
  * If timeout is reached and pin doesn't go to a requested state
@@ -178,6 +339,8 @@ static inline esp_err_t dht_fetch_data(dht_sensor_type_t sensor_type, gpio_num_t
     return ESP_OK;
 }
 
+#endif /* CONFIG_DONICZKA_DHT_BACKEND_RMT */
+
 /**
  * Pack two data bytes into single value and take into account sign bit.
  */
@@ -204,22 +367,31 @@ static inline int16_t dht_convert_data(dht_sensor_type_t sensor_type, uint8_t ms
 esp_err_t dht_read_data(dht_sensor_type_t sensor_type, gpio_num_t pin,
         int16_t *humidity, int16_t *temperature)
 {
+    PERF_SCOPE(PERF_PROBE_DHT_READ);
+    TRACE_SCOPE(TRACE_MARKER_DHT_READ);
     CHECK_ARG(humidity || temperature);
 
     uint8_t data[DHT_DATA_BYTES] = { 0 };
 
+#if CONFIG_DONICZKA_DHT_BACKEND_RMT
+    esp_err_t result = dht_fetch_data(sensor_type, pin, data);
+#else
     gpio_set_direction(pin, GPIO_MODE_OUTPUT_OD);
     gpio_set_level(pin, 1);
 
+    PERF_BEGIN(critical, PERF_PROBE_DHT_CRITICAL);
     PORT_ENTER_CRITICAL();
     esp_err_t result = dht_fetch_data(sensor_type, pin, data);
     if (result == ESP_OK)
         PORT_EXIT_CRITICAL();
+    // on failure the critical section was left by dht_fetch_data
+    PERF_END(critical);
 
     /* restore GPIO direction because, after calling dht_fetch_data(), the
      * GPIO direction mode changes */
     gpio_set_direction(pin, GPIO_MODE_OUTPUT_OD);
     gpio_set_level(pin, 1);
+#endif
 
     if (result != ESP_OK)
         return result;
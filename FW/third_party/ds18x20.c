@@ -46,6 +46,8 @@
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
 #include "esp_idf_lib_helpers.h"
+#include "../system/perf.h"
+#include "../system/trace.h"
 #include "ds18x20.h"
 
 #define ds18x20_WRITE_SCRATCHPAD 0x4E
@@ -64,7 +66,13 @@
 #define CHECK(x) do { esp_err_t __; if ((__ = x) != ESP_OK) return __; } while (0)
 #define CHECK_ARG(VAL) do { if (!(VAL)) return ESP_ERR_INVALID_ARG; } while (0)
 
-#if HELPER_TARGET_IS_ESP32
+#if CONFIG_DONICZKA_ONEWIRE_BACKEND_RMT
+// Bus transactions sleep until the RMT peripheral is done, they must not be
+// wrapped in a critical section
+#define PORT_ENTER_CRITICAL
+#define PORT_EXIT_CRITICAL
+
+#elif HELPER_TARGET_IS_ESP32
 static portMUX_TYPE mux = portMUX_INITIALIZER_UNLOCKED;
 #define PORT_ENTER_CRITICAL portENTER_CRITICAL(&mux)
 #define PORT_EXIT_CRITICAL portEXIT_CRITICAL(&mux)
@@ -246,6 +254,8 @@ esp_err_t ds18x20_measure_and_read(gpio_num_t pin, ds18x20_addr_t addr, float *t
 
 esp_err_t ds18x20_measure_and_read_multi(gpio_num_t pin, ds18x20_addr_t *addr_list, size_t addr_count, float *result_list)
 {
+    PERF_SCOPE(PERF_PROBE_DS18X20_MEASURE);
+    TRACE_SCOPE(TRACE_MARKER_DS18X20_MEASURE);
     CHECK_ARG(result_list && addr_count);
 
     CHECK(ds18x20_measure(pin, DS18X20_ANY, true));
@@ -289,3 +299,93 @@ esp_err_t ds18x20_read_temp_multi(gpio_num_t pin, ds18x20_addr_t *addr_list, siz
     }
     return res;
 }
+
+
+#define ds18x20_CONFIG_RESERVED_BITS 0x1F
+#define ds18x20_CONFIG_RESOLUTION_SHIFT 5
+
+esp_err_t ds18x20_set_resolution(gpio_num_t pin, ds18x20_addr_t addr, ds18x20_resolution_t resolution, bool persist)
+{
+    CHECK_ARG(resolution <= DS18X20_RESOLUTION_12_BIT);
+
+    uint8_t scratchpad[8];
+
+    if ((uint8_t)addr == DS18S20_FAMILY_ID)
+        return ESP_ERR_NOT_SUPPORTED;
+
+    CHECK(ds18x20_read_scratchpad(pin, addr, scratchpad));
+
+    // TH and TL are written back unchanged, only the configuration register changes
+    scratchpad[4] = (resolution << ds18x20_CONFIG_RESOLUTION_SHIFT) | ds18x20_CONFIG_RESERVED_BITS;
+    CHECK(ds18x20_write_scratchpad(pin, addr, &scratchpad[2]));
+
+    if (persist)
+        CHECK(ds18x20_copy_scratchpad(pin, addr));
+
+    return ESP_OK;
+}
+
+uint32_t ds18x20_conversion_time_ms(ds18x20_resolution_t resolution)
+{
+    // 93.75 ms for 9 bit, doubled with every additional bit
+    return (750 >> (DS18X20_RESOLUTION_12_BIT - resolution)) + 1;
+}
+
+static void ds18x20_conversion_timer_cb(void *arg)
+{
+    ds18x20_conversion_t *conv = (ds18x20_conversion_t *)arg;
+
+    conv->busy = false;
+    if (conv->cb)
+        conv->cb(conv->arg);
+}
+
+esp_err_t ds18x20_conversion_init(ds18x20_conversion_t *conv, ds18x20_conversion_cb_t cb, void *arg)
+{
+    CHECK_ARG(conv);
+
+    const esp_timer_create_args_t timer_args = {
+        .callback = &ds18x20_conversion_timer_cb,
+        .arg = conv,
+        .dispatch_method = ESP_TIMER_TASK,
+        .name = "ds18x20",
+    };
+
+    conv->cb = cb;
+    conv->arg = arg;
+    conv->busy = false;
+
+    return esp_timer_create(&timer_args, &conv->timer);
+}
+
+esp_err_t ds18x20_conversion_start(ds18x20_conversion_t *conv, gpio_num_t pin, ds18x20_addr_t addr, ds18x20_resolution_t resolution)
+{
+    CHECK_ARG(conv && conv->timer && resolution <= DS18X20_RESOLUTION_12_BIT);
+
+    if (conv->busy)
+        return ESP_ERR_INVALID_STATE;
+
+    // DS18S20 converts in 750 ms regardless of the requested resolution
+    if (addr != DS18X20_ANY && (uint8_t)addr == DS18S20_FAMILY_ID)
+        resolution = DS18X20_RESOLUTION_12_BIT;
+
+    CHECK(ds18x20_measure(pin, addr, false));
+
+    conv->busy = true;
+    esp_err_t res = esp_timer_start_once(conv->timer, (uint64_t)ds18x20_conversion_time_ms(resolution) * 1000);
+    if (res != ESP_OK)
+        conv->busy = false;
+
+    return res;
+}
+
+esp_err_t ds18x20_conversion_cancel(ds18x20_conversion_t *conv)
+{
+    CHECK_ARG(conv && conv->timer);
+
+    // ESP_ERR_INVALID_STATE only tells the timer is not running any more
+    esp_err_t res = esp_timer_stop(conv->timer);
+    conv->busy = false;
+
+    return (res == ESP_ERR_INVALID_STATE) ? ESP_OK : res;
+}
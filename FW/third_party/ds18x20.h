@@ -46,6 +46,7 @@
 #define __DS18X20_H__
 
 #include <esp_err.h>
+#include <esp_timer.h>
 #include "onewire.h"
 
 #ifdef __cplusplus
@@ -63,6 +64,34 @@ typedef onewire_addr_t ds18x20_addr_t;
 /** Family ID (lower address byte) of DS18S20 sensors */
 #define DS18S20_FAMILY_ID 0x10
 
+/**
+ * Conversion resolution of DS18B20 sensors (DS18S20 is always 9 bit)
+ */
+typedef enum
+{
+    DS18X20_RESOLUTION_9_BIT = 0,   //!< 0.5 deg C, 93.75 ms
+    DS18X20_RESOLUTION_10_BIT,      //!< 0.25 deg C, 187.5 ms
+    DS18X20_RESOLUTION_11_BIT,      //!< 0.125 deg C, 375 ms
+    DS18X20_RESOLUTION_12_BIT,      //!< 0.0625 deg C, 750 ms (power-on default)
+} ds18x20_resolution_t;
+
+/**
+ * Callback called when an asynchronous conversion is finished.
+ * It runs in the esp_timer task context and must not block.
+ */
+typedef void (*ds18x20_conversion_cb_t)(void *arg);
+
+/**
+ * Context of an asynchronous conversion, see ds18x20_conversion_start()
+ */
+typedef struct
+{
+    esp_timer_handle_t timer;
+    ds18x20_conversion_cb_t cb;
+    void *arg;
+    volatile bool busy;
+} ds18x20_conversion_t;
+
 /**
  * @brief Find the addresses of all ds18x20 devices on the bus.
  *
@@ -269,6 +298,80 @@ esp_err_t ds18x20_write_scratchpad(gpio_num_t pin, ds18x20_addr_t addr, uint8_t
  */
 esp_err_t ds18x20_copy_scratchpad(gpio_num_t pin, ds18x20_addr_t addr);
 
+/**
+ * @brief Set the conversion resolution of a ds18b20 device.
+ *
+ * Reads the scratchpad to keep the alarm registers, writes the new
+ * configuration register with ds18x20_write_scratchpad() and, if `persist`
+ * is set, stores it in EEPROM with ds18x20_copy_scratchpad() so it survives
+ * a power cycle (EEPROM has limited write endurance, so don't do it on
+ * every boot).
+ *
+ * @param pin         The GPIO pin connected to the ds18x20 device
+ * @param addr        The 64-bit address of the device. This can be set
+ *                    to ::DS18X20_ANY only if there is exactly one device
+ *                    connected.
+ * @param resolution  The new resolution
+ * @param persist     Copy the configuration to EEPROM
+ *
+ * @returns `ESP_OK` if the command was successfully issued,
+ *          `ESP_ERR_NOT_SUPPORTED` for ds18s20 devices
+ */
+esp_err_t ds18x20_set_resolution(gpio_num_t pin, ds18x20_addr_t addr, ds18x20_resolution_t resolution, bool persist);
+
+/**
+ * @brief Maximum conversion time for a given resolution
+ *
+ * @param resolution  The resolution
+ *
+ * @returns conversion time in milliseconds, rounded up
+ */
+uint32_t ds18x20_conversion_time_ms(ds18x20_resolution_t resolution);
+
+/**
+ * @brief Prepare a context for asynchronous conversions.
+ *
+ * @param conv  The context to initialize
+ * @param cb    Callback called when a started conversion is finished
+ * @param arg   Argument passed to the callback
+ *
+ * @returns `ESP_OK` on success
+ */
+esp_err_t ds18x20_conversion_init(ds18x20_conversion_t *conv, ds18x20_conversion_cb_t cb, void *arg);
+
+/**
+ * @brief Start a conversion (CONVERT_T) and return immediately.
+ *
+ * The callback of `conv` is called once the conversion time for `resolution`
+ * has elapsed, the result can then be fetched with
+ * ds18x20_read_temperature(). The caller is not blocked and the bus is free
+ * for other commands in the meantime (as long as the devices are not
+ * parasitically powered).
+ *
+ * @param conv        Context prepared by ds18x20_conversion_init()
+ * @param pin         The GPIO pin connected to the ds18x20 bus
+ * @param addr        The 64-bit address of the device, or ::DS18X20_ANY to
+ *                    start a conversion on all devices at once
+ * @param resolution  Resolution of the device(s), defines the waiting time.
+ *                    For ::DS18X20_ANY pass the highest resolution on the bus.
+ *
+ * @returns `ESP_OK` if the command was successfully issued,
+ *          `ESP_ERR_INVALID_STATE` if a conversion of `conv` is in progress
+ */
+esp_err_t ds18x20_conversion_start(ds18x20_conversion_t *conv, gpio_num_t pin, ds18x20_addr_t addr, ds18x20_resolution_t resolution);
+
+/**
+ * @brief Forget a conversion in progress, its callback is not called.
+ *
+ * A callback already dispatched by the timer may still run once. The
+ * context can be started again right away.
+ *
+ * @param conv  Context prepared by ds18x20_conversion_init()
+ *
+ * @returns `ESP_OK` on success
+ */
+esp_err_t ds18x20_conversion_cancel(ds18x20_conversion_t *conv);
+
 
 #ifdef __cplusplus
 }
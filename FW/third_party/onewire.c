@@ -55,11 +55,77 @@
 #include "ets_sys.h"
 #include "esp_idf_lib_helpers.h"
 #include "onewire.h"
+#include "../system/perf.h"
+#include "../system/trace.h"
+#if CONFIG_DONICZKA_ONEWIRE_BACKEND_RMT
+#include "onewire_rmt.h"
+#endif
 
 #define ONEWIRE_SELECT_ROM 0x55
 #define ONEWIRE_SKIP_ROM   0xcc
 #define ONEWIRE_SEARCH     0xf0
 
+#if CONFIG_DONICZKA_ONEWIRE_BACKEND_RMT
+
+// Slots are generated by the RMT peripheral, see onewire_rmt.c. Whole bytes
+// are sent as one RMT transaction instead of bit by bit.
+
+bool onewire_reset(gpio_num_t pin)
+{
+    PERF_SCOPE(PERF_PROBE_ONEWIRE_RESET);
+    TRACE_SCOPE(TRACE_MARKER_ONEWIRE_RESET);
+    return onewire_rmt_reset(pin);
+}
+
+static bool _onewire_write_bit(gpio_num_t pin, bool v)
+{
+    uint8_t bit = v ? 1 : 0;
+    return onewire_rmt_write_bits(pin, &bit, 1);
+}
+
+static int _onewire_read_bit(gpio_num_t pin)
+{
+    uint8_t bit;
+    if (!onewire_rmt_read_bits(pin, &bit, 1))
+        return -1;
+    return bit & 1;
+}
+
+bool onewire_write(gpio_num_t pin, uint8_t v)
+{
+    return onewire_rmt_write_bits(pin, &v, 8);
+}
+
+bool onewire_write_bytes(gpio_num_t pin, const uint8_t *buf, size_t count)
+{
+    return onewire_rmt_write_bits(pin, buf, count * 8);
+}
+
+int onewire_read(gpio_num_t pin)
+{
+    uint8_t v;
+    if (!onewire_rmt_read_bits(pin, &v, 8))
+        return -1;
+    return v;
+}
+
+bool onewire_read_bytes(gpio_num_t pin, uint8_t *buf, size_t count)
+{
+    return onewire_rmt_read_bits(pin, buf, count * 8);
+}
+
+bool onewire_power(gpio_num_t pin)
+{
+    return onewire_rmt_power(pin);
+}
+
+void onewire_depower(gpio_num_t pin)
+{
+    onewire_rmt_depower(pin);
+}
+
+#else /* CONFIG_DONICZKA_ONEWIRE_BACKEND_RMT */
+
 #if HELPER_TARGET_IS_ESP8266
 #define PORT_ENTER_CRITICAL portENTER_CRITICAL()
 #define PORT_EXIT_CRITICAL portEXIT_CRITICAL()
@@ -107,6 +173,8 @@ static void setup_pin(gpio_num_t pin, bool open_drain)
 //
 bool onewire_reset(gpio_num_t pin)
 {
+    PERF_SCOPE(PERF_PROBE_ONEWIRE_RESET);
+    TRACE_SCOPE(TRACE_MARKER_ONEWIRE_RESET);
     setup_pin(pin, true);
 
     gpio_set_level(pin, 1);
@@ -117,11 +185,13 @@ bool onewire_reset(gpio_num_t pin)
     gpio_set_level(pin, 0);
     ets_delay_us(480);
 
+    PERF_BEGIN(critical, PERF_PROBE_ONEWIRE_CRITICAL);
     PORT_ENTER_CRITICAL;
     gpio_set_level(pin, 1); // allow it to float
     ets_delay_us(70);
     bool r = !gpio_get_level(pin);
     PORT_EXIT_CRITICAL;
+    PERF_END(critical);
 
     // Wait for all devices to finish pulling the bus low before returning
     if (!_onewire_wait_for_bus(pin, 410))
@@ -134,6 +204,7 @@ static bool _onewire_write_bit(gpio_num_t pin, bool v)
 {
     if (!_onewire_wait_for_bus(pin, 10))
         return false;
+    PERF_BEGIN(critical, PERF_PROBE_ONEWIRE_CRITICAL);
     PORT_ENTER_CRITICAL;
     if (v)
     {
@@ -150,6 +221,7 @@ static bool _onewire_write_bit(gpio_num_t pin, bool v)
     }
     ets_delay_us(1);
     PORT_EXIT_CRITICAL;
+    PERF_END(critical);
 
     return true;
 }
@@ -159,6 +231,7 @@ static int _onewire_read_bit(gpio_num_t pin)
     if (!_onewire_wait_for_bus(pin, 10))
         return -1;
 
+    PERF_BEGIN(critical, PERF_PROBE_ONEWIRE_CRITICAL);
     PORT_ENTER_CRITICAL;
     gpio_set_level(pin, 0);
     ets_delay_us(2);
@@ -167,6 +240,7 @@ static int _onewire_read_bit(gpio_num_t pin)
     int r = gpio_get_level(pin);  // Must sample within 15us of start
     ets_delay_us(48);
     PORT_EXIT_CRITICAL;
+    PERF_END(critical);
 
     return r;
 }
@@ -226,6 +300,26 @@ bool onewire_read_bytes(gpio_num_t pin, uint8_t *buf, size_t count)
     return true;
 }
 
+bool onewire_power(gpio_num_t pin)
+{
+    // Make sure the bus is not being held low before driving it high, or we
+    // may end up shorting ourselves out.
+    if (!_onewire_wait_for_bus(pin, 10))
+        return false;
+
+    setup_pin(pin, false);
+    gpio_set_level(pin, 1);
+
+    return true;
+}
+
+void onewire_depower(gpio_num_t pin)
+{
+    setup_pin(pin, true);
+}
+
+#endif /* CONFIG_DONICZKA_ONEWIRE_BACKEND_RMT */
+
 bool onewire_select(gpio_num_t pin, onewire_addr_t addr)
 {
     uint8_t i;
@@ -248,24 +342,6 @@ bool onewire_skip_rom(gpio_num_t pin)
     return onewire_write(pin, ONEWIRE_SKIP_ROM);
 }
 
-bool onewire_power(gpio_num_t pin)
-{
-    // Make sure the bus is not being held low before driving it high, or we
-    // may end up shorting ourselves out.
-    if (!_onewire_wait_for_bus(pin, 10))
-        return false;
-
-    setup_pin(pin, false);
-    gpio_set_level(pin, 1);
-
-    return true;
-}
-
-void onewire_depower(gpio_num_t pin)
-{
-    setup_pin(pin, true);
-}
-
 void onewire_search_start(onewire_search_t *search)
 {
     // reset the search state
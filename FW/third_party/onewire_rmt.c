@@ -0,0 +1,190 @@
+/**
+ * @file onewire_rmt.c
+ *
+ * 1-Wire transport on the RMT peripheral. Slots are encoded to RMT symbols,
+ * transmitted by the TX channel and captured back by the RX channel attached
+ * to the same pin, so a read does not depend on the sampling moment of the CPU.
+ */
+
+#include <string.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/ringbuf.h>
+#include <driver/rmt.h>
+#include <esp_log.h>
+#include <esp_rom_gpio.h>
+#include <soc/rmt_periph.h>
+#include "../mcu/peripherals.h"
+#include "onewire_rmt_symbols.h"
+#include "onewire_rmt.h"
+
+// 80 MHz APB clock divided to ticks of 1 us
+#define ONEWIRE_RMT_CLK_DIV            80
+// Glitches shorter than this number of APB cycles are ignored by the receiver
+#define ONEWIRE_RMT_RX_FILTER_CYCLES   30
+#define ONEWIRE_RMT_RX_BUFFER_SIZE     1024
+#define ONEWIRE_RMT_TIMEOUT_MS         20
+
+_Static_assert(ONEWIRE_RMT_RX_IDLE_US > ONEWIRE_RMT_RESET_LOW_US + ONEWIRE_RMT_PRESENCE_MAX_US,
+               "Receiver must not end the capture before the presence pulse");
+_Static_assert(ONEWIRE_RMT_RX_IDLE_US <= 0xFFFFu, "Idle threshold does not fit the RMT register");
+
+static const char *TAG = "onewire_rmt";
+
+static const rmt_channel_t tx_channel = (rmt_channel_t)ESP_RMT_CH_ONEWIRE_TX;
+static const rmt_channel_t rx_channel = (rmt_channel_t)ESP_RMT_CH_ONEWIRE_RX;
+
+static gpio_num_t bus_pin = GPIO_NUM_NC;
+static RingbufHandle_t rx_buffer = NULL;
+static uint32_t symbols[ONEWIRE_RMT_MAX_BITS];
+
+// Routes both channels to the pin and switches it to open drain with the
+// input enabled, so the receiver sees the bus and not only the transmitter
+static void attach_pin(gpio_num_t pin)
+{
+    rmt_set_gpio(rx_channel, RMT_MODE_RX, pin, false);
+    rmt_set_gpio(tx_channel, RMT_MODE_TX, pin, false);
+    gpio_set_direction(pin, GPIO_MODE_INPUT_OUTPUT_OD);
+    gpio_set_pull_mode(pin, GPIO_PULLUP_ONLY);
+    esp_rom_gpio_connect_in_signal(pin, rmt_periph_signals.groups[0].channels[rx_channel].rx_sig, false);
+    bus_pin = pin;
+}
+
+static bool setup(gpio_num_t pin)
+{
+    if (NULL != rx_buffer)
+    {
+        if (pin != bus_pin)
+            attach_pin(pin);
+        return true;
+    }
+
+    rmt_config_t rx_config = RMT_DEFAULT_CONFIG_RX(pin, rx_channel);
+    rx_config.clk_div = ONEWIRE_RMT_CLK_DIV;
+    rx_config.rx_config.filter_en = true;
+    rx_config.rx_config.filter_ticks_thresh = ONEWIRE_RMT_RX_FILTER_CYCLES;
+    rx_config.rx_config.idle_threshold = ONEWIRE_RMT_RX_IDLE_US;
+
+    rmt_config_t tx_config = RMT_DEFAULT_CONFIG_TX(pin, tx_channel);
+    tx_config.clk_div = ONEWIRE_RMT_CLK_DIV;
+    tx_config.tx_config.idle_output_en = true;
+    tx_config.tx_config.idle_level = RMT_IDLE_LEVEL_HIGH;
+
+    if ((ESP_OK != rmt_config(&rx_config)) || (ESP_OK != rmt_driver_install(rx_channel, ONEWIRE_RMT_RX_BUFFER_SIZE, 0))
+        || (ESP_OK != rmt_config(&tx_config)) || (ESP_OK != rmt_driver_install(tx_channel, 0, 0))
+        || (ESP_OK != rmt_get_ringbuf_handle(rx_channel, &rx_buffer)))
+    {
+        ESP_LOGE(TAG, "RMT channels initialization failed");
+        rmt_driver_uninstall(rx_channel);
+        rmt_driver_uninstall(tx_channel);
+        rx_buffer = NULL;
+        return false;
+    }
+
+    attach_pin(pin);
+    return true;
+}
+
+// Transmits the encoded symbols. If capture is not NULL the bus is sampled
+// during the transmission and the captured symbols are copied to it.
+static size_t transfer(size_t count, uint32_t *capture)
+{
+    size_t captured = 0;
+    size_t size = 0;
+    void *item;
+
+    if (NULL != capture)
+    {
+        // Drop leftovers of a previous transaction which timed out
+        while (NULL != (item = xRingbufferReceive(rx_buffer, &size, 0)))
+            vRingbufferReturnItem(rx_buffer, item);
+        rmt_rx_start(rx_channel, true);
+    }
+
+    if (ESP_OK != rmt_write_items(tx_channel, (const rmt_item32_t *)symbols, count, true))
+    {
+        if (NULL != capture)
+            rmt_rx_stop(rx_channel);
+        return 0;
+    }
+
+    if (NULL != capture)
+    {
+        item = xRingbufferReceive(rx_buffer, &size, pdMS_TO_TICKS(ONEWIRE_RMT_TIMEOUT_MS));
+        rmt_rx_stop(rx_channel);
+        if (NULL != item)
+        {
+            captured = size / sizeof(uint32_t);
+            if (captured > ONEWIRE_RMT_MAX_BITS)
+                captured = ONEWIRE_RMT_MAX_BITS;
+            memcpy(capture, item, captured * sizeof(uint32_t));
+            vRingbufferReturnItem(rx_buffer, item);
+        }
+        return captured;
+    }
+    return count;
+}
+
+bool onewire_rmt_reset(gpio_num_t pin)
+{
+    uint32_t capture[ONEWIRE_RMT_MAX_BITS];
+
+    if (!setup(pin))
+        return false;
+
+    onewire_rmt_depower(pin);
+    size_t captured = transfer(onewire_rmt_encode_reset(symbols), capture);
+    return onewire_rmt_decode_presence(capture, captured);
+}
+
+bool onewire_rmt_write_bits(gpio_num_t pin, const uint8_t *data, size_t bit_count)
+{
+    if (!setup(pin))
+        return false;
+
+    while (bit_count)
+    {
+        size_t chunk = (bit_count > ONEWIRE_RMT_MAX_BITS) ? ONEWIRE_RMT_MAX_BITS : bit_count;
+        if (transfer(onewire_rmt_encode_write(data, chunk, symbols), NULL) != chunk)
+            return false;
+        data += chunk / 8;
+        bit_count -= chunk;
+    }
+    return true;
+}
+
+bool onewire_rmt_read_bits(gpio_num_t pin, uint8_t *data, size_t bit_count)
+{
+    uint32_t capture[ONEWIRE_RMT_MAX_BITS];
+
+    if (!setup(pin))
+        return false;
+
+    while (bit_count)
+    {
+        size_t chunk = (bit_count > ONEWIRE_RMT_MAX_BITS) ? ONEWIRE_RMT_MAX_BITS : bit_count;
+        size_t captured = transfer(onewire_rmt_encode_read(chunk, symbols), capture);
+        if (onewire_rmt_decode_read(capture, captured, data, chunk) != chunk)
+            return false;
+        data += chunk / 8;
+        bit_count -= chunk;
+    }
+    return true;
+}
+
+bool onewire_rmt_power(gpio_num_t pin)
+{
+    if (!setup(pin))
+        return false;
+
+    // The transmitter idles high, push-pull mode turns it into a strong pull-up
+    if (!gpio_get_level(pin))
+        return false;
+    gpio_set_direction(pin, GPIO_MODE_INPUT_OUTPUT);
+    return true;
+}
+
+void onewire_rmt_depower(gpio_num_t pin)
+{
+    if (pin == bus_pin)
+        gpio_set_direction(pin, GPIO_MODE_INPUT_OUTPUT_OD);
+}
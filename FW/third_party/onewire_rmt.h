@@ -0,0 +1,68 @@
+/**
+ * @file onewire_rmt.h
+ *
+ * @brief 1-Wire bus transport which generates and samples bit slots with the
+ *        RMT peripheral. One TX and one RX channel are looped back on the open
+ *        drain bus pin. The calling task sleeps while a transaction is on the bus.
+ *        The functions are not reentrant, the caller serializes access to the bus.
+ */
+#ifndef __ONEWIRE_RMT_H__
+#define __ONEWIRE_RMT_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <driver/gpio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Performs a reset and waits for the presence pulse
+ *
+ * @param pin bus pin, channels are attached to it on first use
+ * @return true if a device asserted a presence pulse
+ */
+bool onewire_rmt_reset(gpio_num_t pin);
+
+/**
+ * @brief Writes bits, least significant bit of each byte first
+ *
+ * @param pin bus pin
+ * @param data bits to write
+ * @param bit_count number of bits
+ * @return true on success
+ */
+bool onewire_rmt_write_bits(gpio_num_t pin, const uint8_t *data, size_t bit_count);
+
+/**
+ * @brief Reads bits, least significant bit of each byte first
+ *
+ * @param pin bus pin
+ * @param data destination of read bits
+ * @param bit_count number of bits
+ * @return true on success
+ */
+bool onewire_rmt_read_bits(gpio_num_t pin, uint8_t *data, size_t bit_count);
+
+/**
+ * @brief Drives the bus high actively (strong pull-up for parasite powered devices)
+ *
+ * @param pin bus pin
+ * @return true on success
+ */
+bool onewire_rmt_power(gpio_num_t pin);
+
+/**
+ * @brief Returns the bus to open drain mode
+ *
+ * @param pin bus pin
+ */
+void onewire_rmt_depower(gpio_num_t pin);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* __ONEWIRE_RMT_H__ */
@@ -0,0 +1,99 @@
+/**
+ * @file onewire_rmt_symbols.c
+ *
+ * Encoding and decoding of 1-Wire slots as RMT symbols.
+ */
+
+#include <string.h>
+#include "onewire_rmt_symbols.h"
+
+// Collects durations of consecutive low phases of the captured symbols. A phase
+// may be split between two halves of a symbol. Returns number of phases found.
+static size_t low_phases(const uint32_t *symbols, size_t count, uint32_t *lows, size_t max)
+{
+    uint32_t duration = 0;
+    size_t found = 0;
+
+    for (size_t i = 0; (i < count) && (found < max); i++)
+    {
+        for (uint8_t half = 0; (half < 2) && (found < max); half++)
+        {
+            uint32_t level = half ? ONEWIRE_RMT_SYMBOL_LEVEL1(symbols[i]) : ONEWIRE_RMT_SYMBOL_LEVEL0(symbols[i]);
+            uint32_t ticks = half ? ONEWIRE_RMT_SYMBOL_DURATION1(symbols[i]) : ONEWIRE_RMT_SYMBOL_DURATION0(symbols[i]);
+
+            if (ticks && !level)
+            {
+                duration += ticks;
+                continue;
+            }
+            if (duration)
+            {
+                lows[found++] = duration;
+                duration = 0;
+            }
+            // Zero duration marks the end of the capture
+            if (!ticks)
+                return found;
+        }
+    }
+    if (duration && (found < max))
+        lows[found++] = duration;
+    return found;
+}
+
+size_t onewire_rmt_encode_reset(uint32_t *symbols)
+{
+    symbols[0] = ONEWIRE_RMT_SYMBOL(0, ONEWIRE_RMT_RESET_LOW_US, 1, ONEWIRE_RMT_RESET_RELEASE_US);
+    return 1;
+}
+
+size_t onewire_rmt_encode_write(const uint8_t *data, size_t bit_count, uint32_t *symbols)
+{
+    for (size_t i = 0; i < bit_count; i++)
+    {
+        if (data[i / 8] & (1u << (i % 8)))
+            symbols[i] = ONEWIRE_RMT_SYMBOL(0, ONEWIRE_RMT_SLOT_1_LOW_US, 1, ONEWIRE_RMT_SLOT_1_HIGH_US);
+        else
+            symbols[i] = ONEWIRE_RMT_SYMBOL(0, ONEWIRE_RMT_SLOT_0_LOW_US, 1, ONEWIRE_RMT_SLOT_0_HIGH_US);
+    }
+    return bit_count;
+}
+
+size_t onewire_rmt_encode_read(size_t bit_count, uint32_t *symbols)
+{
+    for (size_t i = 0; i < bit_count; i++)
+        symbols[i] = ONEWIRE_RMT_SYMBOL(0, ONEWIRE_RMT_SLOT_1_LOW_US, 1, ONEWIRE_RMT_SLOT_1_HIGH_US);
+    return bit_count;
+}
+
+bool onewire_rmt_decode_presence(const uint32_t *symbols, size_t count)
+{
+    uint32_t lows[2];
+
+    // The first low phase is the reset pulse of the master, the presence
+    // pulse is the low phase which follows it
+    if (low_phases(symbols, count, lows, 2) < 2)
+        return false;
+    if (lows[0] < ONEWIRE_RMT_RESET_LOW_US - ONEWIRE_RMT_READ_THRESHOLD_US)
+        return false;
+
+    return (lows[1] >= ONEWIRE_RMT_PRESENCE_MIN_US) && (lows[1] <= ONEWIRE_RMT_PRESENCE_MAX_US);
+}
+
+size_t onewire_rmt_decode_read(const uint32_t *symbols, size_t count, uint8_t *data, size_t bit_count)
+{
+    uint32_t lows[ONEWIRE_RMT_MAX_BITS];
+
+    if (bit_count > ONEWIRE_RMT_MAX_BITS)
+        bit_count = ONEWIRE_RMT_MAX_BITS;
+
+    memset(data, 0, (bit_count + 7) / 8);
+
+    size_t found = low_phases(symbols, count, lows, bit_count);
+    for (size_t i = 0; i < found; i++)
+    {
+        if (lows[i] < ONEWIRE_RMT_READ_THRESHOLD_US)
+            data[i / 8] |= (uint8_t)(1u << (i % 8));
+    }
+    return found;
+}
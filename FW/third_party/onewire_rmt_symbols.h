@@ -0,0 +1,103 @@
+/**
+ * @file onewire_rmt_symbols.h
+ *
+ * @brief Encoding of 1-Wire reset pulses and bit slots into RMT symbols and
+ *        decoding of the symbols captured on the bus. The code does not access
+ *        any peripheral.
+ *
+ * A symbol is a 32-bit word in the layout of rmt_item32_t: duration0 in bits
+ * 0-14, level0 in bit 15, duration1 in bits 16-30 and level1 in bit 31.
+ * Durations are in RMT ticks of 1 us.
+ */
+#ifndef __ONEWIRE_RMT_SYMBOLS_H__
+#define __ONEWIRE_RMT_SYMBOLS_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ONEWIRE_RMT_SYMBOL(level0, duration0, level1, duration1) \
+    (((uint32_t)(duration0) & 0x7FFFu) | ((uint32_t)((level0) ? 1u : 0u) << 15) | \
+     (((uint32_t)(duration1) & 0x7FFFu) << 16) | ((uint32_t)((level1) ? 1u : 0u) << 31))
+
+#define ONEWIRE_RMT_SYMBOL_DURATION0(symbol) ((symbol) & 0x7FFFu)
+#define ONEWIRE_RMT_SYMBOL_LEVEL0(symbol)    (((symbol) >> 15) & 1u)
+#define ONEWIRE_RMT_SYMBOL_DURATION1(symbol) (((symbol) >> 16) & 0x7FFFu)
+#define ONEWIRE_RMT_SYMBOL_LEVEL1(symbol)    (((symbol) >> 31) & 1u)
+
+// Standard speed timing in us (Maxim application note 126)
+#define ONEWIRE_RMT_RESET_LOW_US       480u
+#define ONEWIRE_RMT_RESET_RELEASE_US   410u
+#define ONEWIRE_RMT_SLOT_1_LOW_US      6u
+#define ONEWIRE_RMT_SLOT_1_HIGH_US     64u
+#define ONEWIRE_RMT_SLOT_0_LOW_US      60u
+#define ONEWIRE_RMT_SLOT_0_HIGH_US     10u
+// A read slot with a low phase shorter than this was released by the master alone
+#define ONEWIRE_RMT_READ_THRESHOLD_US  15u
+// Range of the low phase accepted as a presence pulse
+#define ONEWIRE_RMT_PRESENCE_MIN_US    15u
+#define ONEWIRE_RMT_PRESENCE_MAX_US    300u
+// The receiver ends the capture after the bus has had no edge for this long. It has to
+// outlast the reset pulse and the presence window, otherwise the capture ends inside
+// the reset pulse and the presence pulse is never sampled.
+#define ONEWIRE_RMT_RX_IDLE_US         (ONEWIRE_RMT_RESET_LOW_US + 500u)
+
+// Maximum number of bit slots in one transaction, fits RMT memory of one channel
+#define ONEWIRE_RMT_MAX_BITS           32u
+
+/**
+ * @brief Encodes a reset pulse followed by the presence detect window
+ *
+ * @param symbols destination, one symbol
+ * @return number of encoded symbols
+ */
+size_t onewire_rmt_encode_reset(uint32_t *symbols);
+
+/**
+ * @brief Encodes write slots, least significant bit of each byte first
+ *
+ * @param data bits to write
+ * @param bit_count number of bits to write
+ * @param symbols destination, one symbol per bit
+ * @return number of encoded symbols
+ */
+size_t onewire_rmt_encode_write(const uint8_t *data, size_t bit_count, uint32_t *symbols);
+
+/**
+ * @brief Encodes read slots, which are write slots of bit 1 sampled by the receiver
+ *
+ * @param bit_count number of bits to read
+ * @param symbols destination, one symbol per bit
+ * @return number of encoded symbols
+ */
+size_t onewire_rmt_encode_read(size_t bit_count, uint32_t *symbols);
+
+/**
+ * @brief Looks for a presence pulse in symbols captured during a reset
+ *
+ * @param symbols captured symbols
+ * @param count number of captured symbols
+ * @return true if a device answered with a presence pulse
+ */
+bool onewire_rmt_decode_presence(const uint32_t *symbols, size_t count);
+
+/**
+ * @brief Decodes bits from symbols captured during read slots
+ *
+ * @param symbols captured symbols
+ * @param count number of captured symbols
+ * @param data destination, least significant bit of each byte first
+ * @param bit_count number of expected bits, at most ONEWIRE_RMT_MAX_BITS
+ * @return number of decoded bits, less than bit_count if the capture was incomplete
+ */
+size_t onewire_rmt_decode_read(const uint32_t *symbols, size_t count, uint8_t *data, size_t bit_count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* __ONEWIRE_RMT_SYMBOLS_H__ */
@@ -0,0 +1,115 @@
+#!/usr/bin/env python3
+"""Converts output of the `trace -d` console command to Chrome trace JSON.
+
+Usage: trace_to_chrome.py console.log [trace.json]
+
+The log may contain anything around the dump, the last dump in it is used.
+Open the result in chrome://tracing or https://ui.perfetto.dev.
+Cores are shown as process "cores" with the running task on each core,
+markers are shown as process "tasks" on the thread of the task which was
+running on the core when the marker began.
+"""
+
+import json
+import struct
+import sys
+
+RECORD = struct.Struct("<IBBH")
+TYPE_SWITCH = 0
+TYPE_BEGIN = 1
+TYPE_END = 2
+
+PID_CORES = 0
+PID_TASKS = 1
+
+
+def parse(lines):
+    """Returns task names, marker names and records of the last dump in the log."""
+    dump = None
+    for line in lines:
+        line = line.strip()
+        if line.startswith("#trace "):
+            dump = {"tasks": {}, "markers": {}, "data": bytearray()}
+        elif dump is None:
+            continue
+        elif line.startswith("#task "):
+            _, number, name = line.split(" ", 2)
+            dump["tasks"][int(number)] = name
+        elif line.startswith("#marker "):
+            _, marker, name = line.split(" ", 2)
+            dump["markers"][int(marker)] = name
+        elif line.startswith("#data "):
+            dump["data"] += bytes.fromhex(line[len("#data "):])
+        elif line.startswith("#end"):
+            dump["complete"] = True
+    if dump is None or not dump.get("complete"):
+        raise ValueError("no complete trace dump found")
+    records = [RECORD.unpack_from(dump["data"], offset)
+               for offset in range(0, len(dump["data"]) - RECORD.size + 1, RECORD.size)]
+    return dump["tasks"], dump["markers"], records
+
+
+def unwrap(records):
+    """Extends 32 bit microsecond timestamps, records are in order of reservation, not of time."""
+    out = []
+    base = 0
+    last = None
+    for timestamp, kind, core, ident in records:
+        if last is not None and timestamp < last and last - timestamp > 0x80000000:
+            base += 1 << 32
+        last = timestamp
+        out.append((base + timestamp, kind, core, ident))
+    if out:
+        start = min(record[0] for record in out)
+        out = [(timestamp - start, kind, core, ident) for timestamp, kind, core, ident in out]
+    return out
+
+
+def convert(tasks, markers, records):
+    events = []
+    running = {}
+    switched_at = {}
+
+    def task_name(number):
+        return tasks.get(number, "task %d" % number)
+
+    for core in sorted({record[2] for record in records}):
+        events.append({"ph": "M", "name": "thread_name", "pid": PID_CORES, "tid": core,
+                       "args": {"name": "core %d" % core}})
+    for number, name in tasks.items():
+        events.append({"ph": "M", "name": "thread_name", "pid": PID_TASKS, "tid": number,
+                       "args": {"name": name}})
+    events.append({"ph": "M", "name": "process_name", "pid": PID_CORES, "args": {"name": "cores"}})
+    events.append({"ph": "M", "name": "process_name", "pid": PID_TASKS, "args": {"name": "tasks"}})
+
+    for timestamp, kind, core, ident in records:
+        if kind == TYPE_SWITCH:
+            if core in running:
+                events.append({"ph": "X", "name": task_name(running[core]), "pid": PID_CORES, "tid": core,
+                               "ts": switched_at[core], "dur": timestamp - switched_at[core]})
+            running[core] = ident
+            switched_at[core] = timestamp
+        elif kind in (TYPE_BEGIN, TYPE_END):
+            events.append({"ph": "B" if kind == TYPE_BEGIN else "E",
+                           "name": markers.get(ident, "marker %d" % ident),
+                           "pid": PID_TASKS, "tid": running.get(core, -1), "ts": timestamp,
+                           "args": {"core": core}})
+    return {"traceEvents": events, "displayTimeUnit": "ms"}
+
+
+def main(argv):
+    if len(argv) not in (2, 3):
+        sys.stderr.write(__doc__)
+        return 1
+    with open(argv[1], "r", errors="replace") as log:
+        tasks, markers, records = parse(log)
+    trace = convert(tasks, markers, unwrap(records))
+    output = argv[2] if len(argv) == 3 else argv[1].rsplit(".", 1)[0] + ".json"
+    with open(output, "w") as out:
+        json.dump(trace, out)
+    print("%d records, written to %s" % (len(records), output))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))